@@ -1,4 +1,5 @@
 set(headers
+  include/databento/arena_metadata.hpp
   include/databento/batch.hpp
   include/databento/compat.hpp
   include/databento/constants.hpp
@@ -7,13 +8,21 @@ set(headers
   include/databento/dbn_decoder.hpp
   include/databento/dbn_encoder.hpp
   include/databento/dbn_file_store.hpp
+  include/databento/dbn_importer.hpp
   include/databento/detail/buffer.hpp
+  include/databento/detail/chunk_queue.hpp
   include/databento/detail/dbn_buffer_decoder.hpp
+  include/databento/detail/dbn_file_indexer.hpp
   include/databento/detail/http_client.hpp
   include/databento/detail/json_helpers.hpp
+  include/databento/detail/json_sax.hpp
+  include/databento/detail/merge_metadata.hpp
   include/databento/detail/scoped_fd.hpp
   include/databento/detail/scoped_thread.hpp
+  include/databento/detail/symbols_hash.hpp
   include/databento/detail/tcp_client.hpp
+  include/databento/detail/temp_path.hpp
+  include/databento/detail/worker_pool.hpp
   include/databento/detail/zstd_stream.hpp
   include/databento/enums.hpp
   include/databento/exceptions.hpp
@@ -21,27 +30,37 @@ set(headers
   include/databento/fixed_price.hpp
   include/databento/flag_set.hpp
   include/databento/historical.hpp
+  include/databento/historical_async.hpp
   include/databento/ireadable.hpp
   include/databento/live.hpp
   include/databento/live_blocking.hpp
+  include/databento/live_latency.hpp
   include/databento/live_subscription.hpp
   include/databento/live_threaded.hpp
   include/databento/log.hpp
   include/databento/metadata.hpp
+  include/databento/metrics.hpp
   include/databento/pretty.hpp
   include/databento/publishers.hpp
   include/databento/record.hpp
   include/databento/symbol_map.hpp
   include/databento/symbology.hpp
+  include/databento/symbology_cache.hpp
   include/databento/timeseries.hpp
+  include/databento/timeseries_cache.hpp
   include/databento/v1.hpp
   include/databento/v2.hpp
   include/databento/v3.hpp
   include/databento/with_ts_out.hpp
+  src/format_helper.hpp
+  src/log_helper.hpp
+  src/metrics_hooks.hpp
+  src/parse_helper.hpp
   src/stream_op_helper.hpp
 )
 
 set(sources
+  src/arena_metadata.cpp
   src/batch.cpp
   src/datetime.cpp
   src/dbn.cpp
@@ -49,28 +68,42 @@ set(sources
   src/dbn_decoder.cpp
   src/dbn_encoder.cpp
   src/dbn_file_store.cpp
+  src/dbn_importer.cpp
   src/detail/buffer.cpp
+  src/detail/chunk_queue.cpp
   src/detail/dbn_buffer_decoder.cpp
+  src/detail/dbn_file_indexer.cpp
   src/detail/http_client.cpp
   src/detail/json_helpers.cpp
+  src/detail/json_sax.cpp
+  src/detail/merge_metadata.cpp
   src/detail/scoped_fd.cpp
+  src/detail/symbols_hash.cpp
   src/detail/tcp_client.cpp
+  src/detail/temp_path.cpp
+  src/detail/worker_pool.cpp
   src/detail/zstd_stream.cpp
   src/enums.cpp
   src/exceptions.cpp
   src/file_stream.cpp
   src/flag_set.cpp
+  src/format_helper.cpp
   src/historical.cpp
+  src/historical_async.cpp
   src/live.cpp
   src/live_blocking.cpp
+  src/live_latency.cpp
   src/live_threaded.cpp
   src/log.cpp
   src/metadata.cpp
+  src/metrics.cpp
   src/pretty.cpp
   src/publishers.cpp
   src/record.cpp
   src/symbol_map.cpp
   src/symbology.cpp
+  src/symbology_cache.cpp
+  src/timeseries_cache.cpp
   src/v1.cpp
   src/v2.cpp
 )
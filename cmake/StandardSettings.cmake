@@ -5,6 +5,7 @@
 option(${PROJECT_NAME_UPPERCASE}_USE_EXTERNAL_JSON "Use an external JSON library" OFF)
 option(${PROJECT_NAME_UPPERCASE}_USE_EXTERNAL_HTTPLIB "Use an external httplib library" OFF)
 option(${PROJECT_NAME_UPPERCASE}_USE_EXTERNAL_GTEST "Use an external google test (gtest) library" ON)
+option(${PROJECT_NAME_UPPERCASE}_ENABLE_METRICS "Report internal metrics to the IMetricsSink set with SetMetricsSink. When OFF, all instrumentation is compiled out." ON)
 
 #
 # Compiler options
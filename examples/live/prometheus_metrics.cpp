@@ -0,0 +1,113 @@
+// Exports the client's internal metrics in the Prometheus text exposition
+// format, e.g. for the node_exporter textfile collector.
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>  // rename
+#include <databento/enums.hpp>
+#include <databento/live.hpp>
+#include <databento/live_threaded.hpp>
+#include <databento/metrics.hpp>
+#include <databento/record.hpp>
+#include <fstream>
+#include <iostream>
+#include <ostream>
+#include <string>
+#include <thread>
+
+namespace db = databento;
+
+class PrometheusMetricsSink : public db::IMetricsSink {
+ public:
+  void Increment(db::MetricCounter counter, std::uint64_t value) override {
+    counters_[static_cast<std::size_t>(counter)].fetch_add(value,
+                                                           std::memory_order_relaxed);
+  }
+
+  void OnRecordDecoded(db::RType rtype) override {
+    records_[static_cast<std::size_t>(rtype)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void OnCallbackTime(std::chrono::nanoseconds duration) override {
+    const auto seconds = std::chrono::duration<double>{duration}.count();
+    for (std::size_t i = 0; i < kCallbackBuckets.size(); ++i) {
+      if (seconds <= kCallbackBuckets[i]) {
+        callback_buckets_[i].fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    callback_count_.fetch_add(1, std::memory_order_relaxed);
+    callback_nanos_.fetch_add(static_cast<std::uint64_t>(duration.count()),
+                              std::memory_order_relaxed);
+  }
+
+  void WriteTo(std::ostream& out) const {
+    for (std::size_t i = 0; i < db::kMetricCounterCount; ++i) {
+      const auto name = std::string{"databento_"} +
+                        db::ToString(static_cast<db::MetricCounter>(i)) + "_total";
+      out << "# TYPE " << name << " counter\n"
+          << name << ' ' << counters_[i].load(std::memory_order_relaxed) << '\n';
+    }
+    out << "# TYPE databento_records_decoded_total counter\n";
+    for (std::size_t i = 0; i < records_.size(); ++i) {
+      const auto count = records_[i].load(std::memory_order_relaxed);
+      if (count > 0) {
+        out << "databento_records_decoded_total{rtype=\""
+            << db::ToString(static_cast<db::RType>(i)) << "\"} " << count << '\n';
+      }
+    }
+    out << "# TYPE databento_callback_seconds histogram\n";
+    for (std::size_t i = 0; i < kCallbackBuckets.size(); ++i) {
+      out << "databento_callback_seconds_bucket{le=\"" << kCallbackBuckets[i] << "\"} "
+          << callback_buckets_[i].load(std::memory_order_relaxed) << '\n';
+    }
+    const auto count = callback_count_.load(std::memory_order_relaxed);
+    out << "databento_callback_seconds_bucket{le=\"+Inf\"} " << count << '\n'
+        << "databento_callback_seconds_sum "
+        << static_cast<double>(callback_nanos_.load(std::memory_order_relaxed)) / 1e9
+        << '\n'
+        << "databento_callback_seconds_count " << count << '\n';
+  }
+
+ private:
+  static constexpr std::array<double, 6> kCallbackBuckets{1e-6, 1e-5, 1e-4,
+                                                          1e-3, 1e-2, 1e-1};
+
+  std::array<std::atomic<std::uint64_t>, db::kMetricCounterCount> counters_{};
+  std::array<std::atomic<std::uint64_t>, 256> records_{};
+  std::array<std::atomic<std::uint64_t>, kCallbackBuckets.size()> callback_buckets_{};
+  std::atomic<std::uint64_t> callback_count_{};
+  std::atomic<std::uint64_t> callback_nanos_{};
+};
+
+int main() {
+  if (!db::MetricsEnabled()) {
+    std::cerr << "databento was built with DATABENTO_ENABLE_METRICS=OFF\n";
+    return 1;
+  }
+  // Must outlive the client
+  PrometheusMetricsSink metrics_sink;
+  db::SetMetricsSink(&metrics_sink);
+
+  auto client = db::LiveThreaded::Builder()
+                    .SetKeyFromEnv()
+                    .SetDataset(db::Dataset::GlbxMdp3)
+                    .BuildThreaded();
+  client.Subscribe({"ES.FUT"}, db::Schema::Mbp1, db::SType::Parent);
+  client.Start([](const db::Record&) { return db::KeepGoing::Continue; });
+
+  for (int i = 0; i < 6; ++i) {
+    std::this_thread::sleep_for(std::chrono::seconds{5});
+    // Write to a temporary file and rename so the collector never reads a
+    // partial file
+    {
+      std::ofstream out{"databento.prom.tmp"};
+      metrics_sink.WriteTo(out);
+    }
+    std::rename("databento.prom.tmp", "databento.prom");
+    metrics_sink.WriteTo(std::cout);
+  }
+  db::SetMetricsSink(nullptr);
+  return 0;
+}
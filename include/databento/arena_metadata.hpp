@@ -0,0 +1,128 @@
+#pragma once
+
+#include <date/date.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>  // unique_ptr
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "databento/datetime.hpp"  // UnixNanos
+#include "databento/dbn.hpp"       // Metadata
+#include "databento/enums.hpp"
+
+namespace databento {
+// Forward declare
+class DbnDecoder;
+
+// A borrowed version of `MappingInterval`. `symbol` points into the storage of
+// the owning `ArenaMetadata`.
+struct MappingIntervalView {
+  // The start date of the interval (inclusive).
+  date::year_month_day start_date;
+  // The end date of the interval (exclusive).
+  date::year_month_day end_date;
+  // The resolved symbol for this interval (in `stype_out`).
+  std::string_view symbol;
+};
+
+// A borrowed version of `SymbolMapping`. The intervals are stored contiguously
+// in `ArenaMetadata::intervals` and can be accessed with
+// `ArenaMetadata::Intervals()`.
+struct SymbolMappingView {
+  // The `stype_in` symbol.
+  std::string_view raw_symbol;
+  // The index of the first interval in `ArenaMetadata::intervals`.
+  std::size_t interval_offset;
+  // The number of intervals belonging to this mapping.
+  std::size_t interval_count;
+};
+
+// A compact, read-only alternative to `Metadata` for streams with large
+// numbers of symbols and mappings.
+//
+// All strings are views into a single copy of the encoded metadata and all
+// mapping intervals are stored in a single flat array, so decoding requires a
+// constant number of allocations regardless of the number of symbols. This
+// class is move-only because the views refer to its own storage.
+class ArenaMetadata {
+ public:
+  // A contiguous range of intervals belonging to a single mapping.
+  class IntervalRange {
+   public:
+    IntervalRange(const MappingIntervalView* begin, std::size_t size)
+        : begin_{begin}, size_{size} {}
+
+    const MappingIntervalView* begin() const { return begin_; }
+    const MappingIntervalView* end() const { return begin_ + size_; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const MappingIntervalView& operator[](std::size_t i) const { return begin_[i]; }
+
+   private:
+    const MappingIntervalView* begin_;
+    std::size_t size_;
+  };
+
+  ArenaMetadata() = default;
+  ArenaMetadata(const ArenaMetadata&) = delete;
+  ArenaMetadata& operator=(const ArenaMetadata&) = delete;
+  ArenaMetadata(ArenaMetadata&&) noexcept = default;
+  ArenaMetadata& operator=(ArenaMetadata&&) noexcept = default;
+  ~ArenaMetadata() = default;
+
+  IntervalRange Intervals(const SymbolMappingView& mapping) const {
+    return {intervals.data() + mapping.interval_offset, mapping.interval_count};
+  }
+  // Creates an owned `Metadata` with the same contents.
+  Metadata ToMetadata() const;
+  // Upgrades the metadata according to `upgrade_policy` if necessary.
+  void Upgrade(VersionUpgradePolicy upgrade_policy);
+
+  // The DBN schema version number.
+  std::uint8_t version{};
+  // The dataset code.
+  std::string_view dataset;
+  // The data record schema. Will be nullopt for live where there can be a mix
+  // of `schema`s across subscriptions.
+  std::optional<Schema> schema;
+  // The UNIX timestamp of the query start, or the first record if the file was
+  // split.
+  UnixNanos start;
+  // The UNIX timestamp of the query end, or the last record if the file was
+  // split.
+  UnixNanos end;
+  // The maximum number of records for the query.
+  std::uint64_t limit{};
+  // The input symbology type. Will be nullopt for live data where there can be
+  // a mix of `stype_in`s across subscriptions.
+  std::optional<SType> stype_in;
+  // The output symbology type.
+  SType stype_out{};
+  // Whether the records contain an appended send timestamp.
+  bool ts_out{};
+  // The length in bytes of fixed-length symbol strings, including a null
+  // terminator byte.
+  std::size_t symbol_cstr_len{};
+  // The original query input symbols from the request.
+  std::vector<std::string_view> symbols;
+  // Symbols that did not resolve for _at least one day_ in the query time
+  // range.
+  std::vector<std::string_view> partial;
+  // Symbols that did not resolve for _any_ day in the query time range.
+  std::vector<std::string_view> not_found;
+  // Symbol mappings containing a native symbol and the location of its mapping
+  // intervals.
+  std::vector<SymbolMappingView> mappings;
+  // The mapping intervals of all `mappings`, in order.
+  std::vector<MappingIntervalView> intervals;
+
+ private:
+  friend DbnDecoder;
+
+  // Owns the bytes referenced by all of the string views.
+  std::unique_ptr<char[]> arena_;
+};
+}  // namespace databento
@@ -1,11 +1,14 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <filesystem>  // path
+#include <functional>  // function
 #include <ostream>
 #include <string>
 #include <vector>
 
-#include "databento/enums.hpp"  // JobState, Delivery, Schema, SType
+#include "databento/enums.hpp"  // BatchStreamMode, JobState, Delivery, Schema, SType
 
 namespace databento {
 // Description of a batch job.
@@ -60,6 +63,52 @@ struct BatchFileDesc {
   std::string ftp_url;
 };
 
+// Progress of a call to `Historical::BatchDownload` with `BatchDownloadOptions`.
+struct BatchDownloadProgress {
+  // Bytes of the job's files on disk, including any from previous attempts.
+  std::uint64_t bytes_downloaded;
+  // Total size in bytes of the files being downloaded.
+  std::uint64_t total_bytes;
+  std::size_t files_completed;
+  std::size_t total_files;
+  // Average download rate since the call began.
+  double bytes_per_second;
+};
+
+using BatchDownloadProgressCallback =
+    std::function<void(const BatchDownloadProgress& progress)>;
+
+// Options for downloading batch files concurrently.
+struct BatchDownloadOptions {
+  // The maximum number of concurrent connections.
+  std::size_t max_connections{4};
+  // Files larger than this are downloaded in byte ranges of this size over
+  // separate connections. 0 disables splitting files.
+  std::uint64_t chunk_size{64 * 1024 * 1024};
+  // Whether to resume partially-downloaded files and skip files that have
+  // already been downloaded.
+  bool resume{true};
+  // Whether to verify each file against the hash in its `BatchFileDesc`.
+  bool verify_hash{true};
+  // Called periodically from the calling thread, and once after all files have
+  // been downloaded.
+  BatchDownloadProgressCallback progress_callback;
+};
+
+// Options for `Historical::BatchStream`.
+struct BatchStreamOptions {
+  BatchStreamMode mode{BatchStreamMode::Concatenate};
+  // The maximum number of files to stream concurrently.
+  std::size_t max_connections{4};
+  // The maximum number of bytes of decoded records to buffer for each file
+  // before pausing its connection. When merging a job with more files than
+  // `max_connections`, records past this are written to a temporary file instead.
+  std::size_t max_buffered_bytes{16 * 1024 * 1024};
+  // If not empty, every file of the job is also written to this directory as
+  // it's received.
+  std::filesystem::path tee_dir;
+};
+
 std::string ToString(const BatchJob& batch_job);
 std::ostream& operator<<(std::ostream& stream, const BatchJob& batch_job);
 std::string ToString(const BatchFileDesc& file_desc);
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <ratio>  // nano
 #include <string>
+#include <string_view>
 #include <utility>
 
 namespace databento {
@@ -16,6 +18,18 @@ std::string ToString(UnixNanos unix_nanos);
 // Format the UNIX timestamp as a human-readable ISO8601 string of format
 // YYYY-MM-DDTHH:MM:SS.fffffffffZ
 std::string ToIso8601(UnixNanos unix_nanos);
+// The maximum number of characters written by `FormatIso8601`.
+constexpr std::size_t kMaxIso8601Len = 30;
+// Formats the UNIX timestamp in the same format as `ToIso8601` into `out`
+// without allocating. `out` must have room for at least `kMaxIso8601Len`
+// characters. The output isn't null-terminated. Returns the number of
+// characters written.
+std::size_t FormatIso8601(UnixNanos unix_nanos, char* out);
+// Parses an ISO 8601 timestamp in UTC of the format
+// YYYY-MM-DD[(T| )HH:MM[:SS[.f{1,9}]][Z]], e.g. the output of `ToIso8601`.
+// "UNDEF_TIMESTAMP" is parsed as `kUndefTimestamp`. Throws
+// `InvalidArgumentError` if `str` isn't a valid timestamp in that format.
+UnixNanos ParseIso8601(std::string_view str);
 std::string ToString(TimeDeltaNanos td_nanos);
 // Converts a YYYYMMDD integer to a YYYY-MM-DD string.
 std::string DateFromIso8601Int(std::uint32_t date_int);
@@ -5,9 +5,10 @@
 #include <memory>   // unique_ptr
 #include <string>
 
+#include "databento/arena_metadata.hpp"
 #include "databento/dbn.hpp"
 #include "databento/detail/buffer.hpp"
-#include "databento/enums.hpp"  // Upgrade Policy
+#include "databento/enums.hpp"  // Compression, Upgrade Policy
 #include "databento/file_stream.hpp"
 #include "databento/ireadable.hpp"
 #include "databento/log.hpp"
@@ -23,11 +24,22 @@ class DbnDecoder {
   DbnDecoder(ILogReceiver* log_receiver, std::unique_ptr<IReadable> input);
   DbnDecoder(ILogReceiver* log_receiver, std::unique_ptr<IReadable> input,
              VersionUpgradePolicy upgrade_policy);
+  // Decodes records from `input` positioned at a record after the metadata, such
+  // as a later Zstandard frame of a DBN file, using the version and `ts_out` of
+  // the file's `metadata` as encoded. `DecodeMetadata` shouldn't be called.
+  DbnDecoder(ILogReceiver* log_receiver, std::unique_ptr<IReadable> input,
+             VersionUpgradePolicy upgrade_policy, Compression compression,
+             const Metadata& metadata);
 
   static std::pair<std::uint8_t, std::size_t> DecodeMetadataVersionAndSize(
       const std::byte* buffer, std::size_t size);
   static Metadata DecodeMetadataFields(std::uint8_t version, const std::byte* buffer,
                                        const std::byte* buffer_end);
+  // Like `DecodeMetadataFields`, but decodes into a single arena with string
+  // views instead of individually-allocated strings.
+  static ArenaMetadata DecodeArenaMetadataFields(std::uint8_t version,
+                                                 const std::byte* buffer,
+                                                 const std::byte* buffer_end);
   // Decodes a record possibly applying upgrading the data according to the
   // given version and upgrade policy. If an upgrade is applied,
   // compat_buffer is modified.
@@ -38,6 +50,9 @@ class DbnDecoder {
 
   // Should be called exactly once.
   Metadata DecodeMetadata();
+  // Alternative to `DecodeMetadata` for metadata with many symbols. Should be
+  // called exactly once and not in combination with `DecodeMetadata`.
+  ArenaMetadata DecodeArenaMetadata();
   // Lifetime of returned Record is until next call to DecodeRecord. Returns
   // nullptr once the end of the input has been reached.
   const Record* DecodeRecord();
@@ -54,6 +69,14 @@ class DbnDecoder {
   static SymbolMapping DecodeSymbolMapping(std::size_t symbol_cstr_len,
                                            const std::byte*& buffer,
                                            const std::byte* buffer_end);
+  static void DecodeSymbolMappingViews(std::size_t symbol_cstr_len,
+                                       const std::byte*& buffer,
+                                       const std::byte* buffer_end, ArenaMetadata& res);
+  // Reads the metadata frame from the input and decodes it with
+  // `decode_fields`.
+  template <typename M>
+  M DecodeMetadataWith(M (*decode_fields)(std::uint8_t, const std::byte*,
+                                          const std::byte*));
   bool DetectCompression();
   std::size_t FillBuffer();
   RecordHeader* BufferRecordHeader();
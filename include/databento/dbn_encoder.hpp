@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstddef>  // byte, size_t
 #include <cstdint>  // uint32_t
+#include <memory>   // unique_ptr
+#include <vector>
 
 #include "databento/dbn.hpp"  // Metadata
 #include "databento/iwritable.hpp"
@@ -8,10 +11,29 @@
 #include "databento/with_ts_out.hpp"
 
 namespace databento {
+namespace detail {
+class Buffer;
+}  // namespace detail
+
 class DbnEncoder {
  public:
   explicit DbnEncoder(const Metadata& metadata, IWritable* output);
+  // Collects the metadata and records into a buffer of `buffer_size` bytes so
+  // `output` receives one large write per buffer instead of one per record.
+  // Writes at least as large as the buffer bypass it.
+  DbnEncoder(const Metadata& metadata, IWritable* output, std::size_t buffer_size);
+  // A copy writes to the same output, starting with an empty buffer of the same
+  // size. Data buffered by `other` is still only written by `other`.
+  DbnEncoder(const DbnEncoder& other);
+  DbnEncoder(DbnEncoder&&) noexcept;
+  // Assignment first flushes any data buffered for the current output.
+  DbnEncoder& operator=(const DbnEncoder& other);
+  DbnEncoder& operator=(DbnEncoder&& other);
+  // Flushes any buffered data, ignoring errors. Call `Flush` first to detect
+  // them.
+  ~DbnEncoder();
 
+  // Encodes `metadata` with a single write to `output`.
   static void EncodeMetadata(const Metadata& metadata, IWritable* output);
   static void EncodeRecord(const Record& record, IWritable* output);
 
@@ -32,10 +54,27 @@ class DbnEncoder {
     EncodeRecord(rec);
   }
   void EncodeRecord(const Record& record);
+  // Encodes `count` contiguous records of the same type.
+  template <typename R>
+  void EncodeRecords(const R* records, std::size_t count) {
+    static_assert(has_header<R>::value,
+                  "must be a DBN record struct with an `hd` RecordHeader field");
+    EncodeRecords(reinterpret_cast<const std::byte*>(records), count * sizeof(R));
+  }
+  // Encodes `length` bytes of contiguous DBN records, such as those from a
+  // `DbnDecoder` or a previous encoder, with a single write.
+  void EncodeRecords(const std::byte* records, std::size_t length);
+  // Writes any buffered data to the output.
+  void Flush();
 
  private:
   static std::pair<std::uint32_t, std::uint32_t> CalcLength(const Metadata& metadata);
+  static void AppendMetadata(const Metadata& metadata, std::vector<std::byte>* buffer);
+
+  void Write(const std::byte* data, std::size_t length);
 
   IWritable* output_;
+  // Null when unbuffered or moved from
+  std::unique_ptr<detail::Buffer> buffer_;
 };
 }  // namespace databento
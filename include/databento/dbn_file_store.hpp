@@ -1,15 +1,38 @@
 #pragma once
 
+#include <cstdint>     // uint64_t
 #include <filesystem>  // path
+#include <optional>
+#include <vector>
 
+#include "databento/datetime.hpp"     // UnixNanos
 #include "databento/dbn.hpp"          // DecodeMetadata
 #include "databento/dbn_decoder.hpp"  // DbnDecoder
-#include "databento/enums.hpp"        // VersionUpgradePolicy
+#include "databento/enums.hpp"        // Compression, VersionUpgradePolicy
 #include "databento/log.hpp"
 #include "databento/record.hpp"
 #include "databento/timeseries.hpp"  // MetadataCallback, RecordCallback
 
 namespace databento {
+// The positions in a DBN file where decoding can resume, which let
+// `DbnFileStore` skip decoding the metadata and the records before a timestamp.
+// Built by `detail::DbnFileIndexer` as the file is written.
+struct DbnFileIndex {
+  struct Entry {
+    // The offset in bytes of a Zstandard frame that begins with a record, or of
+    // a record in an uncompressed file.
+    std::uint64_t offset;
+    // The index timestamp of the record at `offset`.
+    UnixNanos index_ts;
+  };
+
+  Compression compression;
+  // The metadata as encoded, before any version upgrade.
+  Metadata metadata;
+  // In file order.
+  std::vector<Entry> entries;
+};
+
 // A reader for DBN files. This class provides both a callback API similar to
 // TimeseriesGetRange in historical data and LiveThreaded for live data as well
 // as a blocking API similar to that of LiveBlocking. Only one API should be
@@ -19,6 +42,10 @@ class DbnFileStore {
   explicit DbnFileStore(const std::filesystem::path& file_path);
   DbnFileStore(ILogReceiver* log_receiver, const std::filesystem::path& file_path,
                VersionUpgradePolicy upgrade_policy);
+  // Takes the metadata from `index` instead of decoding it and uses the
+  // index's entries in `Seek`.
+  DbnFileStore(ILogReceiver* log_receiver, const std::filesystem::path& file_path,
+               VersionUpgradePolicy upgrade_policy, DbnFileIndex index);
 
   // Callback API: calling Replay consumes the input.
   void Replay(const MetadataCallback& metadata_callback,
@@ -30,11 +57,26 @@ class DbnFileStore {
   // Returns the next record or `nullptr` if there are no remaining records.
   const Record* NextRecord();
 
+  // Skips to the first record with an index timestamp of at least `start`,
+  // assuming records are sorted by index timestamp. With an index, resumes
+  // decoding from the last entry before `start` so it can also move backwards.
+  // Without one, decodes and discards the records in between.
+  void Seek(UnixNanos start);
+  const std::optional<DbnFileIndex>& Index() const { return index_; }
+
  private:
   void MaybeDecodeMetadata();
 
+  ILogReceiver* log_receiver_;
+  std::filesystem::path file_path_;
+  VersionUpgradePolicy upgrade_policy_;
+  std::optional<DbnFileIndex> index_;
   DbnDecoder decoder_;
   Metadata metadata_{};
   bool has_decoded_metadata_{false};
+  // Whether `decoder_` has read past the metadata
+  bool is_at_records_{false};
+  // The record found by `Seek`, not yet returned
+  const Record* next_record_{};
 };
 }  // namespace databento
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "databento/datetime.hpp"  // UnixNanos
+#include "databento/dbn.hpp"       // Metadata
+#include "databento/enums.hpp"     // Encoding, Schema, SType
+#include "databento/ireadable.hpp"
+#include "databento/iwritable.hpp"
+
+namespace databento {
+// Options for `DbnImporter`.
+struct DbnImportOptions {
+  // The format of the input. `Encoding::Csv` for CSV with a header row, or
+  // `Encoding::Json` for JSON lines with one object per record in the same
+  // format as Databento's JSON encoding.
+  Encoding encoding{Encoding::Csv};
+  // The schema of the output records. One of mbo, mbp-1, tbbo, trades, or
+  // ohlcv-1s/1m/1h/1d.
+  Schema schema{Schema::Trades};
+  // The dataset code for the metadata.
+  std::string dataset;
+  // The time range for the metadata. Records aren't filtered.
+  UnixNanos start{};
+  UnixNanos end{};
+  // The symbols for the metadata.
+  std::vector<std::string> symbols;
+  // The symbology type of `symbols` for the metadata.
+  SType stype_in{SType::RawSymbol};
+  // The publisher ID of records without a `publisher_id` column.
+  std::uint16_t publisher_id{};
+  // Maps record field names, e.g. "ts_event" or "bid_px_00", to the name of
+  // the CSV column or JSON key they're read from when the two differ. Any other
+  // field is read from the column or key with the same name, as in Databento's
+  // CSV and JSON encodings. Input columns that don't map to a field are
+  // ignored.
+  std::map<std::string, std::string> column_names;
+  // Whether prices are decimal, e.g. "1.25". Otherwise they're integers in
+  // units of 1e-9, as in DBN.
+  bool pretty_px{true};
+  // The CSV field delimiter.
+  char delimiter{','};
+  // Whether to compress the output with zstd.
+  bool compress{};
+  // The number of threads parsing the input.
+  std::size_t num_threads{4};
+  // The approximate size in bytes of the blocks of input parsed by each thread.
+  std::size_t chunk_size{1024 * 1024};
+};
+
+// Converts CSV or JSON tick data to DBN so it can be used with the same tools
+// as Databento data.
+//
+// Input is split into blocks of whole lines which are parsed concurrently on a
+// pool of threads, and the resulting records are written in input order
+// through a `DbnEncoder`. Timestamps can be ISO 8601 or integer nanoseconds
+// since the UNIX epoch. Every input must have a `ts_event` column. Missing
+// prices default to `kUndefPrice`, missing sides and actions to `None`, and a
+// missing `ts_recv` to `ts_event`. CSV fields may be quoted but can't contain
+// line breaks.
+class DbnImporter {
+ public:
+  // Throws `InvalidArgumentError` if `options` are invalid.
+  explicit DbnImporter(DbnImportOptions options);
+
+  // Returns the metadata written at the start of the output.
+  Metadata BuildMetadata() const;
+  // Reads all of `input` and writes it to `output` as DBN. Returns the number
+  // of records written. Throws `Exception` with the line number if a line can't
+  // be parsed.
+  std::uint64_t Import(IReadable* input, IWritable* output);
+  std::uint64_t Import(const std::filesystem::path& input_path,
+                       const std::filesystem::path& output_path);
+
+ private:
+  DbnImportOptions options_;
+};
+}  // namespace databento
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>  // exception_ptr
+#include <mutex>
+#include <vector>
+
+namespace databento::detail {
+// A bounded single-producer, single-consumer queue of byte chunks backed by a
+// fixed pool of reusable buffers. Small writes are coalesced into a buffer
+// until it's full or the consumer is idle. The producer blocks once every
+// buffer is waiting to be read.
+class ChunkQueue {
+ public:
+  struct Stats {
+    std::uint64_t bytes_written;
+    std::uint64_t chunks_read;
+    std::size_t max_depth;
+    std::uint64_t producer_waits;
+  };
+
+  ChunkQueue(std::size_t num_buffers, std::size_t buffer_size);
+
+  // Producer methods
+  // Copies `data` into the queue. Returns false if the consumer has cancelled.
+  bool Write(const char* data, std::size_t length);
+  // Signals the end of the data, optionally due to `exc`, which will be rethrown
+  // from `Read`.
+  void Finish(std::exception_ptr exc);
+
+  // Consumer methods
+  // Returns the buffer in `chunk` to the pool and replaces it with the next
+  // chunk. Returns false once all data has been read.
+  bool Read(std::vector<std::byte>* chunk);
+  // Stops the producer, causing future calls to `Write` to return false.
+  void Cancel();
+
+  Stats GetStats() const;
+
+ private:
+  // Must hold `mutex_`
+  void PushCurrent();
+
+  const std::size_t buffer_size_;
+  // The buffer being filled by the producer
+  std::vector<std::byte> current_;
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<std::vector<std::byte>> free_;
+  std::deque<std::vector<std::byte>> ready_;
+  std::exception_ptr exc_;
+  Stats stats_{};
+  bool is_consumer_waiting_{};
+  bool is_done_{};
+  bool is_cancelled_{};
+};
+}  // namespace databento::detail
@@ -18,7 +18,14 @@ class DbnBufferDecoder {
   DbnBufferDecoder(VersionUpgradePolicy upgrade_policy,
                    const MetadataCallback& metadata_callback,
                    const RecordCallback& record_callback)
-      : upgrade_policy_{upgrade_policy},
+      : DbnBufferDecoder{Compression::Zstd, upgrade_policy, metadata_callback,
+                         record_callback} {}
+  // `compression` must be either `Compression::Zstd` or `Compression::None`.
+  DbnBufferDecoder(Compression compression, VersionUpgradePolicy upgrade_policy,
+                   const MetadataCallback& metadata_callback,
+                   const RecordCallback& record_callback)
+      : compression_{compression},
+        upgrade_policy_{upgrade_policy},
         metadata_callback_{metadata_callback},
         record_callback_{record_callback},
         zstd_stream_{std::make_unique<Buffer>()},
@@ -51,6 +58,10 @@ class DbnBufferDecoder {
     return stream;
   }
 
+  // Decodes as much of `dbn_buffer_` as possible.
+  KeepGoing DecodeBuffered();
+
+  const Compression compression_;
   const VersionUpgradePolicy upgrade_policy_;
   const MetadataCallback& metadata_callback_;
   const RecordCallback& record_callback_;
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <zstd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "databento/dbn.hpp"
+#include "databento/dbn_file_store.hpp"  // DbnFileIndex
+#include "databento/detail/dbn_buffer_decoder.hpp"
+#include "databento/enums.hpp"
+#include "databento/timeseries.hpp"
+
+namespace databento::detail {
+// Builds a `DbnFileIndex` from the bytes of a DBN file as it's written, e.g.
+// while downloading it. Indexes each Zstandard frame that begins with a record,
+// or a record every `kUncompressedInterval` bytes of an uncompressed file.
+class DbnFileIndexer {
+ public:
+  static constexpr std::uint64_t kUncompressedInterval = 1 << 20;
+
+  DbnFileIndexer();
+  // Neither copyable nor movable because the decoder refers to the callbacks
+  DbnFileIndexer(const DbnFileIndexer&) = delete;
+  DbnFileIndexer& operator=(const DbnFileIndexer&) = delete;
+
+  void Process(const std::byte* data, std::size_t length);
+  // Returns the index of the processed bytes. Throws `DbnResponseError` if they
+  // didn't contain the whole metadata.
+  DbnFileIndex Finish();
+
+ private:
+  void ProcessZstd(const std::byte* data, std::size_t length);
+
+  MetadataCallback metadata_callback_;
+  RecordCallback record_callback_;
+  // Always decodes uncompressed input. Created once the compression is known.
+  std::optional<DbnBufferDecoder> decoder_;
+  std::unique_ptr<ZSTD_DStream, std::size_t (*)(ZSTD_DStream*)> z_dstream_;
+  std::vector<std::byte> z_out_buffer_;
+  // The first bytes, until there are enough to detect the compression
+  std::vector<std::byte> prefix_;
+  Compression compression_{Compression::None};
+  // The number of bytes processed
+  std::uint64_t offset_{};
+  // For uncompressed input, the offset of the next record to index
+  std::uint64_t next_entry_offset_{};
+  // For Zstandard input, the offset of the frame the next record begins, if it
+  // begins one
+  std::optional<std::uint64_t> frame_offset_;
+  std::optional<Metadata> metadata_;
+  std::vector<DbnFileIndex::Entry> entries_;
+};
+}  // namespace databento::detail
@@ -8,27 +8,69 @@
 #include <httplib.h>
 #include <nlohmann/json.hpp>
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>  // unique_ptr
 #include <string>
 
 namespace databento {
 class ILogReceiver;
 namespace detail {
+// A thread-safe HTTP client. Each request borrows a keep-alive connection from a
+// pool, so concurrent requests don't serialize and sequential requests reuse an
+// established TLS session. Connections are opened lazily, up to
+// `max_connections`, after which requests wait for one to be returned.
 class HttpClient {
  public:
+  static constexpr std::size_t kDefaultMaxConnections = 8;
+
   HttpClient(ILogReceiver* log_receiver, const std::string& key,
              const std::string& gateway);
   HttpClient(ILogReceiver* log_receiver, const std::string& key,
              const std::string& gateway, std::uint16_t port);
+  // A `port` of 0 uses the default port for `gateway`.
+  HttpClient(ILogReceiver* log_receiver, const std::string& key,
+             const std::string& gateway, std::uint16_t port,
+             std::size_t max_connections);
+  HttpClient(HttpClient&&) noexcept;
+  HttpClient& operator=(HttpClient&&) noexcept;
+  ~HttpClient();
 
   nlohmann::json GetJson(const std::string& path, const httplib::Params& params);
   nlohmann::json PostJson(const std::string& path, const httplib::Params& form_params);
+  // Like `GetJson` and `PostJson`, but pass the response to `handler` as it's parsed
+  // instead of building a DOM. `handler` is responsible for reporting parse errors.
+  void GetJsonSax(const std::string& path, const httplib::Params& params,
+                  nlohmann::json_sax<nlohmann::json>* handler);
+  void PostJsonSax(const std::string& path, const httplib::Params& form_params,
+                   nlohmann::json_sax<nlohmann::json>* handler);
   void GetRawStream(const std::string& path, const httplib::Params& params,
                     const httplib::ContentReceiver& callback);
   void PostRawStream(const std::string& path, const httplib::Params& form_params,
                      const httplib::ContentReceiver& callback);
+  // Streams bytes [`offset`, `end`) of the resource at `path` with an HTTP range
+  // request, or until the end of the resource if `end` is 0. If the server
+  // ignores the range, the data outside of it is discarded.
+  void GetRangeStream(const std::string& path, std::uint64_t offset,
+                      std::uint64_t end, const httplib::ContentReceiver& callback);
 
  private:
+  struct Pool;
+  // Returns its connection to the pool when destroyed.
+  class Connection {
+   public:
+    Connection(Pool* pool, std::unique_ptr<httplib::Client> client);
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+    ~Connection();
+
+    httplib::Client* operator->() const { return client_.get(); }
+
+   private:
+    Pool* pool_;
+    std::unique_ptr<httplib::Client> client_;
+  };
+
   static bool IsErrorStatus(int status_code);
   static void CheckStatusAndStreamRes(const std::string& path, int status_code,
                                       std::string&& err_body,
@@ -37,12 +79,18 @@ class HttpClient {
   httplib::ResponseHandler MakeStreamResponseHandler(int& out_status);
   nlohmann::json CheckAndParseResponse(const std::string& path,
                                        httplib::Result&& res) const;
+  void CheckAndParseResponse(const std::string& path, httplib::Result&& res,
+                             nlohmann::json_sax<nlohmann::json>* handler) const;
+  httplib::Response& CheckResponse(const std::string& path,
+                                   httplib::Result& res) const;
   void CheckWarnings(const httplib::Response& response) const;
+  // Blocks until a connection is available.
+  Connection Acquire();
 
   static const httplib::Headers kHeaders;
 
   ILogReceiver* log_receiver_;
-  httplib::Client client_;
+  std::unique_ptr<Pool> pool_;
 };
 }  // namespace detail
 }  // namespace databento
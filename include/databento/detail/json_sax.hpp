@@ -0,0 +1,130 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "databento/batch.hpp"  // BatchJob
+#include "databento/dbn.hpp"    // MappingInterval
+#include "databento/enums.hpp"  // SType
+#include "databento/symbology.hpp"
+
+namespace databento::detail {
+// Base for SAX handlers that build response types directly while the JSON is
+// parsed, without first building a DOM of the whole response. Scalars are
+// forwarded as single-value `nlohmann::json`s and values of unrecognized keys can
+// be skipped. Errors are thrown as JsonResponseError.
+class JsonSaxHandler : public nlohmann::json_sax<nlohmann::json> {
+ public:
+  bool null() override;
+  bool boolean(bool val) override;
+  bool number_integer(number_integer_t val) override;
+  bool number_unsigned(number_unsigned_t val) override;
+  bool number_float(number_float_t val, const string_t& s) override;
+  bool string(string_t& val) override;
+  bool binary(binary_t& val) override;
+  bool start_object(std::size_t elements) override;
+  bool key(string_t& val) override;
+  bool end_object() override;
+  bool start_array(std::size_t elements) override;
+  bool end_array() override;
+  bool parse_error(std::size_t position, const std::string& last_token,
+                   const nlohmann::detail::exception& exc) override;
+
+ protected:
+  explicit JsonSaxHandler(std::string_view endpoint) : endpoint_{endpoint} {}
+
+  virtual void OnValue(nlohmann::json&& value) = 0;
+  virtual void OnStartObject() = 0;
+  virtual void OnKey(std::string&& key) = 0;
+  virtual void OnEndObject() = 0;
+  virtual void OnStartArray() = 0;
+  virtual void OnEndArray() = 0;
+
+  // Ignores the next value, including anything nested within it.
+  void SkipValue() { is_skipping_value_ = true; }
+
+  const std::string_view endpoint_;
+
+ private:
+  // Return true if the event should be ignored.
+  bool SkipStart();
+  bool SkipEnd();
+  bool OnScalar(nlohmann::json&& value);
+
+  bool is_skipping_value_{};
+  std::size_t skip_depth_{};
+};
+
+// Builds the response to `Historical::SymbologyResolve`.
+class SymbologyResolutionSax : public JsonSaxHandler {
+ public:
+  SymbologyResolutionSax(std::string_view endpoint, SType stype_in, SType stype_out);
+
+  SymbologyResolution& Result() { return res_; }
+
+ private:
+  enum class State : std::uint8_t {
+    Start,
+    Root,
+    Mappings,
+    Intervals,
+    Interval,
+    Partial,
+    NotFound,
+    Done
+  };
+
+  void OnValue(nlohmann::json&& value) override;
+  void OnStartObject() override;
+  void OnKey(std::string&& key) override;
+  void OnEndObject() override;
+  void OnStartArray() override;
+  void OnEndArray() override;
+  void OnIntervalValue(nlohmann::json&& value);
+
+  SymbologyResolution res_;
+  State state_{State::Start};
+  std::string key_;
+  std::string symbol_;
+  std::vector<MappingInterval> intervals_;
+  MappingInterval interval_{};
+  // result, partial, not_found in the root object or d0, d1, s in an interval
+  std::bitset<3> seen_;
+  std::bitset<3> interval_seen_;
+};
+
+// Parses a single job object, such as the response to
+// `Historical::BatchSubmitJob`, with the same field mapping as `BatchJobsSax`.
+BatchJob ParseBatchJob(std::string_view endpoint, const nlohmann::json& json);
+
+// Builds the response to `Historical::BatchListJobs`.
+class BatchJobsSax : public JsonSaxHandler {
+ public:
+  explicit BatchJobsSax(std::string_view endpoint);
+
+  std::vector<BatchJob>& Result() { return jobs_; }
+
+ private:
+  enum class State : std::uint8_t { Start, Jobs, Job, Symbols, Done };
+  static constexpr std::size_t kNumFields = 30;
+
+  void OnValue(nlohmann::json&& value) override;
+  void OnStartObject() override;
+  void OnKey(std::string&& key) override;
+  void OnEndObject() override;
+  void OnStartArray() override;
+  void OnEndArray() override;
+
+  std::vector<BatchJob> jobs_;
+  State state_{State::Start};
+  BatchJob job_{};
+  std::size_t field_{};
+  std::bitset<kNumFields> seen_;
+};
+}  // namespace databento::detail
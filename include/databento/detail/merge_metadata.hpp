@@ -0,0 +1,10 @@
+#pragma once
+
+#include "databento/dbn.hpp"  // Metadata
+
+namespace databento::detail {
+// Appends the symbology of `other`, the metadata of a later time range of the
+// same request, to `metadata`, joining intervals that span the boundary between
+// the ranges.
+void MergeMetadata(Metadata* metadata, Metadata&& other);
+}  // namespace databento::detail
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace databento::detail {
+// Returns a stable hash of `symbols` that's independent of their order, for
+// naming cache files.
+std::uint64_t HashSymbols(const std::vector<std::string>& symbols);
+}  // namespace databento::detail
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <filesystem>
+
+namespace databento::detail {
+// Returns a path in the same directory as `path` with a random suffix, for
+// writing a file before renaming it to `path`. Unlike a fixed suffix, it won't
+// collide with another thread or process writing the same file.
+std::filesystem::path TempPath(const std::filesystem::path& path);
+}  // namespace databento::detail
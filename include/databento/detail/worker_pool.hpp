@@ -0,0 +1,39 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "databento/detail/scoped_thread.hpp"
+
+namespace databento::detail {
+// Up to a fixed number of threads that run submitted tasks in FIFO order.
+// Threads are started as tasks are submitted, so an unused pool has no threads.
+// Tasks still queued when the pool is destroyed are discarded without being run.
+class WorkerPool {
+ public:
+  explicit WorkerPool(std::size_t max_threads);
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+  WorkerPool(WorkerPool&&) = delete;
+  WorkerPool& operator=(WorkerPool&&) = delete;
+  // Waits for running tasks to complete.
+  ~WorkerPool();
+
+  void Submit(std::function<void()> task);
+
+ private:
+  void Run();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+  bool is_stopping_{};
+  std::size_t idle_count_{};
+  const std::size_t max_threads_;
+  std::vector<ScopedThread> threads_;
+};
+}  // namespace databento::detail
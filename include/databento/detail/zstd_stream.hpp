@@ -12,10 +12,46 @@
 #include "databento/log.hpp"
 
 namespace databento::detail {
+// Options for `ZstdCompressStream`. The defaults match the `zstd` CLI.
+struct ZstdCompressOptions {
+  // The compression level. Higher levels are slower but compress better.
+  int level{ZSTD_CLEVEL_DEFAULT};
+  // The number of threads compressing in the background. Zero compresses on
+  // the calling thread. zstd must be built with multithreading support to use
+  // more than zero.
+  int num_workers{};
+  // The approximate size in bytes of the input compressed by each worker. Zero
+  // lets zstd choose based on the window size.
+  int job_size{};
+  // Whether to find matches further back than the window of the compression
+  // level. Improves the compression of large inputs with repetitive content,
+  // like full days of MBO data. Also raises the default window to 2^27 bytes.
+  bool long_distance_matching{};
+  // The base-2 log of the maximum distance to a match. Zero uses the default
+  // for the level. Must be at most 27, the largest window decoders accept by
+  // default.
+  int window_log{};
+  // A dictionary from `TrainZstdDictionary` to improve the compression of
+  // small inputs. The output can only be decompressed with the same dictionary.
+  std::vector<std::byte> dictionary;
+};
+
+// Trains a dictionary of at most `max_size` bytes from `samples`, which
+// contains samples of the sizes in `sample_sizes` back to back. Each sample
+// should resemble a compressed input, e.g. a small batch of records of a single
+// schema. zstd recommends around 100 times as much sample data as `max_size`.
+// Throws `Exception` if a dictionary couldn't be trained.
+std::vector<std::byte> TrainZstdDictionary(const std::vector<std::byte>& samples,
+                                           const std::vector<std::size_t>& sample_sizes,
+                                           std::size_t max_size);
+
 class ZstdDecodeStream : public IReadable {
  public:
   explicit ZstdDecodeStream(std::unique_ptr<IReadable> input);
   ZstdDecodeStream(std::unique_ptr<IReadable> input, detail::Buffer& in_buffer);
+  // Decompresses input compressed with `dictionary`.
+  ZstdDecodeStream(std::unique_ptr<IReadable> input,
+                   const std::vector<std::byte>& dictionary);
 
   // Read exactly `length` bytes into `buffer`.
   void ReadExact(std::byte* buffer, std::size_t length) override;
@@ -26,8 +62,13 @@ class ZstdDecodeStream : public IReadable {
   IReadable* Input() const { return input_.get(); }
 
  private:
+  // Prepares for the next frame. Returns the suggested read size.
+  std::size_t InitDStream();
+
   std::unique_ptr<IReadable> input_;
   std::unique_ptr<ZSTD_DStream, std::size_t (*)(ZSTD_DStream*)> z_dstream_;
+  // Null when decompressing without a dictionary
+  std::unique_ptr<ZSTD_DDict, std::size_t (*)(ZSTD_DDict*)> z_ddict_;
   std::size_t read_suggestion_;
   std::vector<std::byte> in_buffer_;
   ZSTD_inBuffer z_in_buffer_;
@@ -37,20 +78,29 @@ class ZstdCompressStream : public IWritable {
  public:
   explicit ZstdCompressStream(IWritable* output);
   ZstdCompressStream(ILogReceiver* log_receiver, IWritable* output);
+  // Throws `InvalidArgumentError` if `options` are invalid.
+  ZstdCompressStream(IWritable* output, const ZstdCompressOptions& options);
+  ZstdCompressStream(ILogReceiver* log_receiver, IWritable* output,
+                     const ZstdCompressOptions& options);
   ZstdCompressStream(const ZstdCompressStream&) = delete;
   ZstdCompressStream& operator=(const ZstdCompressStream&) = delete;
   ZstdCompressStream(ZstdCompressStream&&) = delete;
   ZstdCompressStream& operator=(ZstdCompressStream&&) = delete;
   ~ZstdCompressStream() override;
 
+  // Small writes are collected until there's enough input to compress
+  // efficiently. Larger writes are compressed directly from `buffer`.
   void WriteAll(const std::byte* buffer, std::size_t length) override;
 
  private:
+  void SetParameter(ZSTD_cParameter param, int value);
+  // Compresses all of `buffer` and forwards any output.
+  void Compress(const std::byte* buffer, std::size_t length, ZSTD_EndDirective mode);
+
   ILogReceiver* log_receiver_;
   IWritable* output_;
   std::unique_ptr<ZSTD_CStream, std::size_t (*)(ZSTD_CStream*)> z_cstream_;
   std::vector<std::byte> in_buffer_;
-  ZSTD_inBuffer z_in_buffer_;
   std::size_t in_size_;
   std::vector<std::byte> out_buffer_;
 };
@@ -594,6 +594,15 @@ enum class VersionUpgradePolicy {
   UpgradeToV3,
 };
 
+// How `Historical::BatchStream` combines the records of multiple files.
+enum class BatchStreamMode : std::uint8_t {
+  // Deliver all records from each file before the next, in the order the files
+  // are listed.
+  Concatenate,
+  // Deliver records from all files in order of their index timestamp.
+  Merge,
+};
+
 // An error code from the live subscription gateway.
 namespace error_code {
 enum ErrorCode : std::uint8_t {
@@ -661,6 +670,7 @@ const char* ToString(StatusReason status_reason);
 const char* ToString(TradingEvent trading_event);
 const char* ToString(TriState tri_state);
 const char* ToString(VersionUpgradePolicy version_upgrade_policy);
+const char* ToString(BatchStreamMode batch_stream_mode);
 const char* ToString(ErrorCode error_code);
 const char* ToString(SystemCode system_code);
 
@@ -690,6 +700,7 @@ std::ostream& operator<<(std::ostream& out, TradingEvent trading_event);
 std::ostream& operator<<(std::ostream& out, TriState tri_state);
 std::ostream& operator<<(std::ostream& out,
                          VersionUpgradePolicy version_upgrade_policy);
+std::ostream& operator<<(std::ostream& out, BatchStreamMode batch_stream_mode);
 std::ostream& operator<<(std::ostream& out, ErrorCode error_code);
 std::ostream& operator<<(std::ostream& out, SystemCode system_code);
 
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <cstddef>     // byte, size_t
+#include <cstdint>     // uint64_t
 #include <filesystem>  // path
 #include <fstream>     // ifstream, ofstream
+#include <vector>
 
 #include "databento/ireadable.hpp"
 #include "databento/iwritable.hpp"
@@ -17,6 +19,8 @@ class InFileStream : public IReadable {
   // Read at most `length` bytes. Returns the number of bytes read. Will only
   // return 0 if the end of the stream is reached.
   std::size_t ReadSome(std::byte* buffer, std::size_t max_length) override;
+  // Moves the read position to `offset` bytes from the start of the file.
+  void Seek(std::uint64_t offset);
 
  private:
   std::ifstream stream_;
@@ -25,10 +29,27 @@ class InFileStream : public IReadable {
 class OutFileStream : public IWritable {
  public:
   explicit OutFileStream(const std::filesystem::path& file_path);
-
+  // Collects writes into a buffer of `buffer_size` bytes so the file is written
+  // in large blocks. Writes at least as large as the buffer bypass it.
+  OutFileStream(const std::filesystem::path& file_path, std::size_t buffer_size);
+  OutFileStream(OutFileStream&&) = default;
+  // Flushes any data buffered for the current file before taking over `other`.
+  OutFileStream& operator=(OutFileStream&& other);
+  // Flushes any buffered data, ignoring errors. Call `Flush` first to detect
+  // them.
+  ~OutFileStream() override;
+
+  // Throws `Exception` if the data couldn't be written.
   void WriteAll(const std::byte* buffer, std::size_t length) override;
+  // Writes any buffered data to the file. Throws `Exception` if the data
+  // couldn't be written.
+  void Flush();
 
  private:
+  void Write(const std::byte* buffer, std::size_t length);
+
   std::ofstream stream_;
+  std::size_t buffer_size_{};
+  std::vector<std::byte> buffer_;
 };
 }  // namespace databento
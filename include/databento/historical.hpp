@@ -1,18 +1,22 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <future>
 #include <map>  // multimap
+#include <memory>  // unique_ptr
 #include <string>
 #include <vector>
 
-#include "databento/batch.hpp"     // BatchJob
+#include "databento/batch.hpp"     // BatchDownloadOptions, BatchJob, BatchStreamOptions
 #include "databento/datetime.hpp"  // DateRange, DateTimeRange, UnixNanos
 #include "databento/dbn_file_store.hpp"
 #include "databento/detail/http_client.hpp"  // HttpClient
+#include "databento/detail/worker_pool.hpp"  // WorkerPool
 #include "databento/enums.hpp"  // BatchState, Delivery, DurationInterval, Schema, SType, VersionUpgradePolicy
-#include "databento/metadata.hpp"  // DatasetConditionDetail, DatasetRange, FieldDetail, PublisherDetail, UnitPricesForMode
-#include "databento/symbology.hpp"   // SymbologyResolution
+#include "databento/metadata.hpp"  // DatasetConditionDetail, DatasetRange, FieldDetail, MetadataQuery, PlannedRequest, PublisherDetail, RequestPlanOptions, UnitPricesForMode
+#include "databento/symbology.hpp"   // SymbologyQuery, SymbologyResolution
 #include "databento/timeseries.hpp"  // KeepGoing, MetadataCallback, RecordCallback
 
 namespace databento {
@@ -79,6 +83,23 @@ class Historical {
   std::filesystem::path BatchDownload(const std::filesystem::path& output_dir,
                                       const std::string& job_id,
                                       const std::string& filename_to_download);
+  // Downloads the files concurrently over multiple connections, splitting
+  // large files into byte ranges. Files are written to a temporary `.part` file
+  // and renamed once complete and verified. Returns the paths of the downloaded
+  // files.
+  std::vector<std::filesystem::path> BatchDownload(
+      const std::filesystem::path& output_dir, const std::string& job_id,
+      const BatchDownloadOptions& options);
+  // Streams the DBN files of a batch job to the callbacks, decoding them as
+  // they're received instead of writing them to disk first. `metadata_callback`
+  // is called with each file's metadata, before any of that file's records.
+  // Files are streamed concurrently but the callbacks will be called from the
+  // current thread.
+  void BatchStream(const std::string& job_id, const MetadataCallback& metadata_callback,
+                   const RecordCallback& record_callback);
+  void BatchStream(const std::string& job_id, const BatchStreamOptions& options,
+                   const MetadataCallback& metadata_callback,
+                   const RecordCallback& record_callback);
 
   /*
    * Metadata API
@@ -144,6 +165,25 @@ class Historical {
                          const DateTimeRange<std::string>& datetime_range,
                          const std::vector<std::string>& symbols, Schema schema,
                          FeedMode mode, SType stype_in, std::uint64_t limit);
+  // Batched versions of the above methods. The queries are issued concurrently
+  // over the pooled connections from a pool of as many threads as the builder's
+  // max connections. Errors are rethrown from the corresponding future. This
+  // instance must outlive the returned futures.
+  std::vector<std::future<std::uint64_t>> MetadataGetRecordCountBatch(
+      const std::vector<MetadataQuery>& queries);
+  std::vector<std::future<std::uint64_t>> MetadataGetBillableSizeBatch(
+      const std::vector<MetadataQuery>& queries);
+  std::vector<std::future<double>> MetadataGetCostBatch(
+      const std::vector<MetadataQuery>& queries);
+  // Splits `query` into sub-requests of at most `options.max_request_size`
+  // billable bytes and `options.max_symbols` symbols each, for passing to
+  // concurrent `TimeseriesGetRange` or `BatchSubmitJob` calls. The sizes of
+  // slices of the range are queried concurrently and adjacent slices are
+  // combined. Returns the sub-requests ordered by symbols then time.
+  //
+  // `query.datetime_range.end` must be set and `query.limit` must be 0.
+  std::vector<PlannedRequest> MetadataPlanRequests(const MetadataQuery& query,
+                                                   const RequestPlanOptions& options);
 
   /*
    * Symbology API
@@ -153,6 +193,9 @@ class Historical {
                                        const std::vector<std::string>& symbols,
                                        SType stype_in, SType stype_out,
                                        const DateRange& date_range);
+  // Resolves each of `queries` concurrently. See `MetadataGetCostBatch`.
+  std::vector<std::future<SymbologyResolution>> SymbologyResolveBatch(
+      const std::vector<SymbologyQuery>& queries);
 
   /*
    * Timeseries API
@@ -163,8 +206,8 @@ class Historical {
   // This method will return only after all data has been returned or
   // `record_callback` returns `KeepGoing::Stop`.
   //
-  // NOTE: This method spawns a thread, however, the callbacks will be called
-  // from the current thread.
+  // NOTE: Data is received, decompressed, and decoded on the current thread, so
+  // slow callbacks slow the transfer. See `TimeseriesGetRangeBuffered`.
   //
   // WARNING: Calling this method will incur a cost.
   void TimeseriesGetRange(const std::string& dataset,
@@ -187,8 +230,43 @@ class Historical {
                           SType stype_in, SType stype_out, std::uint64_t limit,
                           const MetadataCallback& metadata_callback,
                           const RecordCallback& record_callback);
+  // Stream historical market data to `record_callback` like `TimeseriesGetRange`,
+  // but receive the data on a separate thread into a bounded pool of buffers so
+  // the connection isn't stalled by decoding or slow callbacks. The callbacks
+  // will be called from the current thread. Returns statistics on the transfer.
+  //
+  // WARNING: Calling this method will incur a cost.
+  TimeseriesStreamStats TimeseriesGetRangeBuffered(
+      const std::string& dataset, const DateTimeRange<UnixNanos>& datetime_range,
+      const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+      SType stype_out, std::uint64_t limit, const TimeseriesBufferOptions& options,
+      const MetadataCallback& metadata_callback, const RecordCallback& record_callback);
+  TimeseriesStreamStats TimeseriesGetRangeBuffered(
+      const std::string& dataset, const DateTimeRange<std::string>& datetime_range,
+      const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+      SType stype_out, std::uint64_t limit, const TimeseriesBufferOptions& options,
+      const MetadataCallback& metadata_callback, const RecordCallback& record_callback);
+  // Stream historical market data to `record_callback` like `TimeseriesGetRange`,
+  // but split `datetime_range` into `options.num_splits` contiguous sub-ranges
+  // that are requested concurrently over separate connections. Records are
+  // delivered from the current thread in the same order as a single request.
+  // `metadata_callback` is called once with metadata covering the full range
+  // and the merged symbol mappings of all sub-ranges.
+  //
+  // `datetime_range.end` must be set.
+  //
+  // WARNING: Calling this method will incur a cost.
+  void TimeseriesGetRangeSplit(const std::string& dataset,
+                               const DateTimeRange<UnixNanos>& datetime_range,
+                               const std::vector<std::string>& symbols,
+                               Schema schema, SType stype_in, SType stype_out,
+                               const TimeseriesSplitOptions& options,
+                               const MetadataCallback& metadata_callback,
+                               const RecordCallback& record_callback);
   // Stream historical market data to a file at `path`. Returns a `DbnFileStore`
-  // object for replaying the data in `file_path`.
+  // object for replaying the data in `file_path`. The file is indexed as it's
+  // downloaded, so the store doesn't need to decode the metadata again and
+  // `DbnFileStore::Seek` can skip to a timestamp.
   //
   // If a file at `file_path` already exists, it will be overwritten.
   //
@@ -219,10 +297,11 @@ class Historical {
   using HttplibParams = std::multimap<std::string, std::string>;
 
   Historical(ILogReceiver* log_receiver, std::string key, HistoricalGateway gateway,
-             VersionUpgradePolicy upgrade_policy, std::string user_agent_ext);
+             VersionUpgradePolicy upgrade_policy, std::string user_agent_ext,
+             std::size_t max_connections);
   Historical(ILogReceiver* log_receiver, std::string key, std::string gateway,
              std::uint16_t port, VersionUpgradePolicy upgrade_policy,
-             std::string user_agent_ext);
+             std::string user_agent_ext, std::size_t max_connections);
 
   BatchJob BatchSubmitJob(const HttplibParams& params);
   void DownloadFile(const std::string& url, const std::filesystem::path& output_path);
@@ -235,15 +314,26 @@ class Historical {
   void TimeseriesGetRange(const HttplibParams& params,
                           const MetadataCallback& metadata_callback,
                           const RecordCallback& record_callback);
+  TimeseriesStreamStats TimeseriesGetRangeBuffered(
+      const HttplibParams& params, const TimeseriesBufferOptions& options,
+      const MetadataCallback& metadata_callback, const RecordCallback& record_callback);
   DbnFileStore TimeseriesGetRangeToFile(const HttplibParams& params,
                                         const std::filesystem::path& file_path);
+  // Creates a new client with its own connection to the same gateway. Used for
+  // long-lived streams that shouldn't hold one of `client_`'s pooled connections.
+  detail::HttpClient MakeClient() const;
 
   ILogReceiver* log_receiver_;
   const std::string key_;
   const std::string gateway_;
+  // 0 if the default port for `gateway_` is used
+  const std::uint16_t port_{};
   const std::string user_agent_ext_;
   const VersionUpgradePolicy upgrade_policy_;
   detail::HttpClient client_;
+  // Runs the batched queries. Declared after `client_` so running queries finish
+  // before it's destroyed. Held by pointer so `Historical` remains movable.
+  std::unique_ptr<detail::WorkerPool> batch_pool_;
 };
 
 // A helper class for constructing an instance of Historical.
@@ -276,6 +366,9 @@ class HistoricalBuilder {
   HistoricalBuilder& SetAddress(std::string gateway, std::uint16_t port);
   // Appends to the default user agent.
   HistoricalBuilder& ExtendUserAgent(std::string extension);
+  // Sets the maximum number of keep-alive connections the client will open to the
+  // gateway for concurrent requests. Defaults to 8.
+  HistoricalBuilder& SetMaxConnections(std::size_t max_connections);
 
   // Attempts to construct an instance of Historical or throws an exception if
   // no key has been set.
@@ -289,5 +382,6 @@ class HistoricalBuilder {
   std::string key_;
   VersionUpgradePolicy upgrade_policy_{VersionUpgradePolicy::UpgradeToV3};
   std::string user_agent_ext_;
+  std::size_t max_connections_{detail::HttpClient::kDefaultMaxConnections};
 };
 }  // namespace databento
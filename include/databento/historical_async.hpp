@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>  // make_shared, shared_ptr
+#include <string>
+#include <type_traits>  // invoke_result_t
+#include <utility>      // move
+#include <vector>
+
+#include "databento/datetime.hpp"  // DateRange, DateTimeRange, UnixNanos
+#include "databento/detail/worker_pool.hpp"
+#include "databento/enums.hpp"       // Schema, SType
+#include "databento/exceptions.hpp"  // Exception
+#include "databento/historical.hpp"
+#include "databento/symbology.hpp"   // SymbologyResolution
+#include "databento/timeseries.hpp"  // MetadataCallback, RecordCallback
+
+namespace databento {
+// A flag for cancelling one or more asynchronous requests. Copies share the same
+// flag.
+class CancellationToken {
+ public:
+  CancellationToken() : is_cancelled_{std::make_shared<std::atomic<bool>>(false)} {}
+
+  void Cancel() { is_cancelled_->store(true, std::memory_order_relaxed); }
+  bool IsCancelled() const { return is_cancelled_->load(std::memory_order_relaxed); }
+
+ private:
+  std::shared_ptr<std::atomic<bool>> is_cancelled_;
+};
+
+// An asynchronous interface to a Historical client. Requests are run on a fixed
+// pool of worker threads and share the client's pooled connections. Results and
+// errors are returned through futures.
+//
+// A request whose CancellationToken is cancelled before it starts fails with
+// Exception. A timeseries request that's cancelled while streaming stops at the
+// next record as if `record_callback` returned KeepGoing::Stop.
+class HistoricalAsync {
+ public:
+  static constexpr std::size_t kDefaultNumThreads = 8;
+
+  // `historical` must outlive this instance.
+  explicit HistoricalAsync(Historical* historical);
+  HistoricalAsync(Historical* historical, std::size_t num_threads);
+
+  // Runs `func` with the Historical client on a worker thread.
+  template <typename F>
+  std::future<std::invoke_result_t<F&, Historical&>> Submit(F func) {
+    return Submit(std::move(func), CancellationToken{});
+  }
+  template <typename F>
+  std::future<std::invoke_result_t<F&, Historical&>> Submit(F func,
+                                                            CancellationToken token) {
+    using Result = std::invoke_result_t<F&, Historical&>;
+    auto task = std::make_shared<std::packaged_task<Result()>>(
+        [historical = historical_, func = std::move(func),
+         token = std::move(token)]() mutable {
+          if (token.IsCancelled()) {
+            throw Exception{"Request was cancelled before it started"};
+          }
+          return func(*historical);
+        });
+    auto future = task->get_future();
+    pool_.Submit([task] { (*task)(); });
+    return future;
+  }
+
+  std::future<std::uint64_t> MetadataGetRecordCount(
+      const std::string& dataset, const DateTimeRange<UnixNanos>& datetime_range,
+      const std::vector<std::string>& symbols, Schema schema);
+  std::future<std::uint64_t> MetadataGetRecordCount(
+      const std::string& dataset, const DateTimeRange<UnixNanos>& datetime_range,
+      const std::vector<std::string>& symbols, Schema schema,
+      CancellationToken token);
+  std::future<SymbologyResolution> SymbologyResolve(
+      const std::string& dataset, const std::vector<std::string>& symbols,
+      SType stype_in, SType stype_out, const DateRange& date_range);
+  std::future<SymbologyResolution> SymbologyResolve(
+      const std::string& dataset, const std::vector<std::string>& symbols,
+      SType stype_in, SType stype_out, const DateRange& date_range,
+      CancellationToken token);
+  // The callbacks are called from a worker thread.
+  std::future<void> TimeseriesGetRange(
+      const std::string& dataset, const DateTimeRange<UnixNanos>& datetime_range,
+      const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+      SType stype_out, std::uint64_t limit, MetadataCallback metadata_callback,
+      RecordCallback record_callback);
+  std::future<void> TimeseriesGetRange(
+      const std::string& dataset, const DateTimeRange<UnixNanos>& datetime_range,
+      const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+      SType stype_out, std::uint64_t limit, MetadataCallback metadata_callback,
+      RecordCallback record_callback, CancellationToken token);
+
+ private:
+  Historical* historical_;
+  // Last so queued tasks are discarded and workers joined before other members
+  // are destroyed
+  detail::WorkerPool pool_;
+};
+}  // namespace databento
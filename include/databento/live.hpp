@@ -12,6 +12,7 @@
 namespace databento {
 // Forward declarations
 class ILogReceiver;
+class LiveLatencyStats;
 
 // A helper class for constructing a Live client, either an instance of
 // LiveBlocking or LiveThreaded.
@@ -51,6 +52,13 @@ class LiveBuilder {
   LiveBuilder& SetBufferSize(std::size_t size);
   // Appends to the default user agent.
   LiveBuilder& ExtendUserAgent(std::string extension);
+  // Sets where to record the end-to-end latency of each record received by the
+  // client. `latency_stats` must outlive the client. Latencies from the gateway
+  // are only recorded with `SetSendTsOut(true)`. Disabled by default.
+  LiveBuilder& SetLatencyStats(LiveLatencyStats* latency_stats);
+  // Sets how often the client logs the recorded latency statistics at the info
+  // level. Requires `SetLatencyStats`.
+  LiveBuilder& SetLatencyLogInterval(std::chrono::seconds latency_log_interval);
 
   /*
    * Build a live client instance
@@ -77,5 +85,7 @@ class LiveBuilder {
   std::optional<std::chrono::seconds> heartbeat_interval_{};
   std::size_t buffer_size_;
   std::string user_agent_ext_;
+  LiveLatencyStats* latency_stats_{};
+  std::optional<std::chrono::seconds> latency_log_interval_{};
 };
 }  // namespace databento
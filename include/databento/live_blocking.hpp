@@ -21,6 +21,7 @@ namespace databento {
 // Forward declaration
 class ILogReceiver;
 class LiveBuilder;
+class LiveLatencyStats;
 class LiveThreaded;
 
 // A client for interfacing with Databento's real-time and intraday replay
@@ -46,6 +47,7 @@ class LiveBlocking {
   }
   const std::vector<LiveSubscription>& Subscriptions() const { return subscriptions_; }
   std::vector<LiveSubscription>& Subscriptions() { return subscriptions_; }
+  LiveLatencyStats* LatencyStats() const { return latency_stats_; }
 
   /*
    * Methods
@@ -93,12 +95,16 @@ class LiveBlocking {
   LiveBlocking(ILogReceiver* log_receiver, std::string key, std::string dataset,
                bool send_ts_out, VersionUpgradePolicy upgrade_policy,
                std::optional<std::chrono::seconds> heartbeat_interval,
-               std::size_t buffer_size, std::string user_agent_ext);
+               std::size_t buffer_size, std::string user_agent_ext,
+               LiveLatencyStats* latency_stats,
+               std::optional<std::chrono::seconds> latency_log_interval);
   LiveBlocking(ILogReceiver* log_receiver, std::string key, std::string dataset,
                std::string gateway, std::uint16_t port, bool send_ts_out,
                VersionUpgradePolicy upgrade_policy,
                std::optional<std::chrono::seconds> heartbeat_interval,
-               std::size_t buffer_size, std::string user_agent_ext);
+               std::size_t buffer_size, std::string user_agent_ext,
+               LiveLatencyStats* latency_stats,
+               std::optional<std::chrono::seconds> latency_log_interval);
 
   std::string DetermineGateway() const;
   std::uint64_t Authenticate();
@@ -111,6 +117,8 @@ class LiveBlocking {
                  bool use_snapshot);
   detail::TcpClient::Result FillBuffer(std::chrono::milliseconds timeout);
   RecordHeader* BufferRecordHeader();
+  void UpdateLastReadTime();
+  void RecordLatency();
 
   static constexpr std::size_t kMaxStrLen = 24L * 1024;
 
@@ -124,6 +132,12 @@ class LiveBlocking {
   std::uint8_t version_{};
   const VersionUpgradePolicy upgrade_policy_;
   const std::optional<std::chrono::seconds> heartbeat_interval_;
+  LiveLatencyStats* const latency_stats_;
+  const std::optional<std::chrono::seconds> latency_log_interval_;
+  // When data was last read from the socket. Only set when recording latencies.
+  // Initialized before `session_id_` because authentication can read records
+  UnixNanos last_read_time_{};
+  UnixNanos last_latency_log_time_{};
   detail::TcpClient client_;
   std::uint32_t sub_counter_{};
   std::vector<LiveSubscription> subscriptions_;
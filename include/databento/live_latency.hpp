@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>  // ostream
+#include <string>
+#include <vector>
+
+#include "databento/datetime.hpp"  // UnixNanos
+#include "databento/enums.hpp"     // RType
+
+namespace databento {
+// Forward declaration
+class Record;
+
+// A histogram of nanosecond latencies with log-linear buckets, similar to an
+// HDR histogram. Values are recorded with a relative error below 1/32 in a
+// fixed amount of memory.
+//
+// Values must only be added from one thread at a time, but all getters are
+// lock-free and can be called concurrently from other threads.
+class LatencyHistogram {
+ public:
+  LatencyHistogram() = default;
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+  LatencyHistogram(LatencyHistogram&&) = delete;
+  LatencyHistogram& operator=(LatencyHistogram&&) = delete;
+  ~LatencyHistogram() = default;
+
+  // Adds a latency. Negative latencies, e.g. due to clock skew, are counted as
+  // zero.
+  void Add(std::chrono::nanoseconds latency);
+
+  std::uint64_t Count() const { return count_.load(std::memory_order_relaxed); }
+  // Returns zero if empty.
+  std::chrono::nanoseconds Min() const;
+  std::chrono::nanoseconds Max() const;
+  std::chrono::nanoseconds Mean() const;
+  // Returns the latency at or below which `quantile` (between 0 and 1) of the
+  // recorded latencies fall. Returns zero if empty.
+  std::chrono::nanoseconds Percentile(double quantile) const;
+
+  // Returns the index of the bucket containing `value`.
+  static std::size_t BucketIndex(std::uint64_t value);
+  // Returns the greatest value in the bucket at `index`.
+  static std::uint64_t BucketUpperBound(std::size_t index);
+
+  // Values below this are recorded exactly.
+  static constexpr std::size_t kSubBucketCount = 64;
+  static constexpr std::size_t kBucketCount = kSubBucketCount + 57 * 32 + 32;
+
+ private:
+  // Only written by the recording thread, so plain loads and stores are
+  // sufficient
+  static void Increment(std::atomic<std::uint64_t>& counter, std::uint64_t amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount,
+                  std::memory_order_relaxed);
+  }
+
+  std::array<std::atomic<std::uint64_t>, kBucketCount> buckets_{};
+  std::atomic<std::uint64_t> count_{};
+  std::atomic<std::uint64_t> sum_{};
+  std::atomic<std::uint64_t> min_{UINT64_MAX};
+  std::atomic<std::uint64_t> max_{};
+};
+
+// End-to-end latency statistics of a live session, grouped by record type and
+// publisher. For each record, the latency from the gateway sending it
+// (`ts_out`) and from Databento receiving it (the record's index timestamp,
+// `ts_recv` for most record types) to the client receiving it from the socket
+// are recorded.
+//
+// Pass an instance to `LiveBuilder::SetLatencyStats`. Each instance should
+// only be used by one client at a time, but all getters are lock-free and can
+// be called from any thread while the client is running.
+class LiveLatencyStats {
+ public:
+  // The latencies for one combination of record type and publisher.
+  struct Entry {
+    Entry(RType rtype_, std::uint16_t publisher_id_)
+        : rtype{rtype_}, publisher_id{publisher_id_} {}
+
+    const RType rtype;
+    const std::uint16_t publisher_id;
+    // The time from the gateway sending the record to the client receiving it.
+    // Only recorded when `ts_out` is enabled.
+    LatencyHistogram ts_out_latency;
+    // The time from Databento receiving the record to the client receiving it.
+    LatencyHistogram ts_recv_latency;
+  };
+
+  LiveLatencyStats() = default;
+  LiveLatencyStats(const LiveLatencyStats&) = delete;
+  LiveLatencyStats& operator=(const LiveLatencyStats&) = delete;
+  LiveLatencyStats(LiveLatencyStats&&) = delete;
+  LiveLatencyStats& operator=(LiveLatencyStats&&) = delete;
+  ~LiveLatencyStats();
+
+  // Records the latencies of `record` received from the socket at
+  // `local_recv`. If `has_ts_out` is true, the last 8 bytes of the record are
+  // interpreted as `ts_out`.
+  void Add(const Record& record, bool has_ts_out, UnixNanos local_recv);
+
+  // The latencies across all record types and publishers.
+  const LatencyHistogram& TsOutLatency() const { return ts_out_latency_; }
+  const LatencyHistogram& TsRecvLatency() const { return ts_recv_latency_; }
+  // Returns the entry for `rtype` and `publisher_id` or `nullptr` if no such
+  // records have been received.
+  const Entry* Find(RType rtype, std::uint16_t publisher_id) const;
+  // Returns all entries ordered by record type, then publisher ID.
+  std::vector<const Entry*> Entries() const;
+  // The number of records whose entry couldn't be created because the maximum
+  // number of entries was reached. These are still included in the totals.
+  std::uint64_t DroppedEntryCount() const {
+    return dropped_entry_count_.load(std::memory_order_relaxed);
+  }
+
+  static constexpr std::size_t kMaxEntries = 256;
+
+ private:
+  Entry* FindOrInsert(RType rtype, std::uint16_t publisher_id);
+
+  LatencyHistogram ts_out_latency_;
+  LatencyHistogram ts_recv_latency_;
+  // Open-addressing hash table only inserted into by the recording thread.
+  // Entries are never removed so they can be read without locking.
+  std::array<std::atomic<Entry*>, kMaxEntries> entries_{};
+  std::atomic<std::uint64_t> dropped_entry_count_{};
+};
+
+std::string ToString(const LatencyHistogram& histogram);
+std::ostream& operator<<(std::ostream& stream, const LatencyHistogram& histogram);
+std::string ToString(const LiveLatencyStats& stats);
+std::ostream& operator<<(std::ostream& stream, const LiveLatencyStats& stats);
+}  // namespace databento
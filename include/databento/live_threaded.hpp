@@ -19,6 +19,7 @@ namespace databento {
 // Forward declaration
 class ILogReceiver;
 class LiveBuilder;
+class LiveLatencyStats;
 
 // A client for interfacing with Databento's real-time and intraday replay
 // market data API. This client provides a threaded event-driven API for
@@ -56,6 +57,7 @@ class LiveThreaded {
   std::optional<std::chrono::seconds> HeartbeatInterval() const;
   const std::vector<LiveSubscription>& Subscriptions() const;
   std::vector<LiveSubscription>& Subscriptions();
+  LiveLatencyStats* LatencyStats() const;
 
   /*
    * Methods
@@ -107,12 +109,16 @@ class LiveThreaded {
   LiveThreaded(ILogReceiver* log_receiver, std::string key, std::string dataset,
                bool send_ts_out, VersionUpgradePolicy upgrade_policy,
                std::optional<std::chrono::seconds> heartbeat_interval,
-               std::size_t buffer_size, std::string user_agent_ext);
+               std::size_t buffer_size, std::string user_agent_ext,
+               LiveLatencyStats* latency_stats,
+               std::optional<std::chrono::seconds> latency_log_interval);
   LiveThreaded(ILogReceiver* log_receiver, std::string key, std::string dataset,
                std::string gateway, std::uint16_t port, bool send_ts_out,
                VersionUpgradePolicy upgrade_policy,
                std::optional<std::chrono::seconds> heartbeat_interval,
-               std::size_t buffer_size, std::string user_agent_ext);
+               std::size_t buffer_size, std::string user_agent_ext,
+               LiveLatencyStats* latency_stats,
+               std::optional<std::chrono::seconds> latency_log_interval);
 
   // unique_ptr to be movable
   std::unique_ptr<Impl> impl_;
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <iosfwd>  // ostream
+#include <memory>  // unique_ptr
 #include <string>
 
 namespace databento {
@@ -45,6 +47,50 @@ class ConsoleLogReceiver : public ILogReceiver {
   const databento::LogLevel min_level_;
 };
 
+// A log receiver that copies messages into a preallocated ring buffer and
+// forwards them to `downstream` from a background thread, so logging never
+// blocks the calling thread on I/O. Enqueuing is lock-free; the background
+// thread is only signaled through a mutex when it's idle. When the ring buffer
+// is full, messages are dropped and a warning with the number dropped is
+// forwarded once there's space.
+//
+// `downstream` must outlive this receiver. Its `Receive` is only called from
+// the background thread, but its `ShouldLog` is called from the logging threads,
+// so `ShouldLog` must be thread-safe.
+class AsyncLogReceiver : public ILogReceiver {
+ public:
+  static constexpr std::size_t kDefaultCapacity = 1024;
+  // Messages up to this length are stored without allocating.
+  static constexpr std::size_t kMessageCapacity = 256;
+
+  explicit AsyncLogReceiver(ILogReceiver* downstream);
+  // `capacity` is the maximum number of queued messages and is rounded up to a
+  // power of two.
+  AsyncLogReceiver(ILogReceiver* downstream, std::size_t capacity);
+  AsyncLogReceiver(const AsyncLogReceiver&) = delete;
+  AsyncLogReceiver& operator=(const AsyncLogReceiver&) = delete;
+  AsyncLogReceiver(AsyncLogReceiver&&) = delete;
+  AsyncLogReceiver& operator=(AsyncLogReceiver&&) = delete;
+  // Forwards any queued messages before returning.
+  ~AsyncLogReceiver() override;
+
+  void Receive(LogLevel level, const std::string& msg) override;
+  bool ShouldLog(LogLevel level) const override {
+    return downstream_->ShouldLog(level);
+  }
+  // Blocks until all messages received before the call have been forwarded.
+  void Flush();
+  // Returns the total number of messages dropped because the ring buffer was
+  // full.
+  std::uint64_t DroppedCount() const;
+
+ private:
+  struct Impl;
+
+  ILogReceiver* downstream_;
+  std::unique_ptr<Impl> impl_;
+};
+
 std::ostream& operator<<(std::ostream& out, LogLevel level);
 const char* ToString(LogLevel level);
 
@@ -1,14 +1,16 @@
 #pragma once
 
+#include <cstddef>  // size_t
 #include <cstdint>
 #include <map>
 #include <optional>
 #include <ostream>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "databento/datetime.hpp"
-#include "databento/enums.hpp"  // FeedMode, DatasetCondition, Schema
+#include "databento/enums.hpp"  // FeedMode, DatasetCondition, Schema, SType
 
 namespace databento {
 struct PublisherDetail {
@@ -40,6 +42,42 @@ struct DatasetRange {
   std::map<Schema, DateTimeRange<std::string>> range_by_schema;
 };
 
+// The parameters of a single query to one of the batched metadata methods, such
+// as `Historical::MetadataGetCostBatch`.
+struct MetadataQuery {
+  std::string dataset;
+  DateTimeRange<UnixNanos> datetime_range;
+  std::vector<std::string> symbols;
+  Schema schema;
+  // Only used by `MetadataGetCostBatch`.
+  FeedMode mode{FeedMode::HistoricalStreaming};
+  SType stype_in{SType::RawSymbol};
+  std::uint64_t limit{};
+};
+
+// Options for `Historical::MetadataPlanRequests`.
+struct RequestPlanOptions {
+  // The maximum billable size in bytes of each planned request, unless a
+  // single slice of the range exceeds it after `max_refinements`.
+  std::uint64_t max_request_size{1ULL << 30};
+  // The maximum number of symbols in each planned request.
+  std::size_t max_symbols{2000};
+  // The number of equal slices the range is initially divided into when
+  // querying its size.
+  std::size_t num_slices{16};
+  // The number of times a slice larger than `max_request_size` is divided and
+  // queried again.
+  std::size_t max_refinements{2};
+};
+
+// A sub-request of a query planned by `Historical::MetadataPlanRequests`.
+struct PlannedRequest {
+  DateTimeRange<UnixNanos> datetime_range;
+  std::vector<std::string> symbols;
+  std::uint64_t billable_size;
+  std::uint64_t record_count;
+};
+
 inline bool operator==(const PublisherDetail& lhs, const PublisherDetail& rhs) {
   return lhs.publisher_id == rhs.publisher_id && lhs.dataset == rhs.dataset &&
          lhs.venue == rhs.venue && lhs.description == rhs.description;
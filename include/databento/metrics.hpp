@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>  // ostream
+
+#include "databento/enums.hpp"  // RType
+
+namespace databento {
+// Counters reported to an `IMetricsSink`.
+enum class MetricCounter : std::uint8_t {
+  // Bytes read from live gateway sockets.
+  TcpBytesRead,
+  // Bytes written to live gateway sockets.
+  TcpBytesWritten,
+  // HTTP requests sent to the historical API.
+  HttpRequests,
+  // Response body bytes received from the historical API.
+  HttpBytesRead,
+  // Compressed bytes read by zstd decompression.
+  ZstdBytesRead,
+  // Bytes output by zstd decompression.
+  ZstdBytesDecompressed,
+  // Records upgraded from an older DBN version.
+  CompatUpgrades,
+  // Times unread data was moved to the front of an internal buffer.
+  BufferShifts,
+  // Times an internal buffer was reallocated to grow its capacity.
+  BufferReallocations,
+  // Times a live client reconnected to the gateway.
+  LiveReconnects,
+};
+
+// The number of `MetricCounter` variants.
+constexpr std::size_t kMetricCounterCount =
+    static_cast<std::size_t>(MetricCounter::LiveReconnects) + 1;
+
+// An interface for receiving metrics about the internals of the library, such
+// as bytes transferred and records decoded. All methods default to no-ops.
+//
+// Methods are called synchronously from the thread doing the work, which may be
+// any client thread, so implementations must be thread-safe and should be
+// cheap.
+//
+// Metrics are only reported if the library was built with the CMake option
+// `DATABENTO_ENABLE_METRICS` (default ON). Otherwise all instrumentation is
+// compiled out.
+class IMetricsSink {
+ public:
+  virtual ~IMetricsSink() = default;
+
+  // Called to add `value` to `counter`.
+  virtual void Increment(MetricCounter /*counter*/, std::uint64_t /*value*/) {}
+  // Called for each record decoded from DBN, whether from a file, a historical
+  // response, or a live session.
+  virtual void OnRecordDecoded(RType /*rtype*/) {}
+  // Called with the time spent in each call to a `LiveThreaded` record
+  // callback.
+  virtual void OnCallbackTime(std::chrono::nanoseconds /*duration*/) {}
+};
+
+// Sets the process-wide sink for metrics. Pass `nullptr` to stop reporting
+// metrics, which is the default. `sink` must remain valid until it's replaced
+// and all clients using it have been destroyed.
+void SetMetricsSink(IMetricsSink* sink);
+// Returns the current process-wide sink or `nullptr` if unset.
+IMetricsSink* GetMetricsSink();
+// Returns true if the library was built with metrics instrumentation.
+bool MetricsEnabled();
+
+const char* ToString(MetricCounter counter);
+std::ostream& operator<<(std::ostream& out, MetricCounter counter);
+}  // namespace databento
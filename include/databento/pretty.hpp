@@ -1,8 +1,10 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
-#include <sstream>
+#include <iosfwd>
 #include <string>
+#include <string_view>
 
 #include "databento/constants.hpp"
 #include "databento/datetime.hpp"
@@ -20,6 +22,19 @@ struct Px {
 
 std::ostream& operator<<(std::ostream& stream, Px px);
 
+// The maximum number of characters written by `FormatPx`.
+constexpr std::size_t kMaxPxLen = 21;
+// Formats a fixed-precision price into `out` without allocating, with the same
+// output as `Px` with the given stream `precision`. `out` must have room for
+// at least `kMaxPxLen` characters. The output isn't null-terminated. Returns
+// the number of characters written.
+std::size_t FormatPx(std::int64_t px, int precision, char* out);
+// Parses a decimal price, e.g. "-12.5" or the output of `PxToString`, to the
+// fixed-precision format used in DBN. "UNDEF_PRICE" is parsed as `kUndefPrice`.
+// Throws `InvalidArgumentError` if `str` isn't a valid price, has more than 9
+// decimal places, or is out of range.
+std::int64_t ParsePx(std::string_view str);
+
 // A helper type for formatting the nanosecond UNIX timestamps used in DBN to
 // the canonical ISO 8601 format used by Databento.
 //
@@ -35,9 +50,5 @@ struct Ts {
 std::ostream& operator<<(std::ostream& stream, Ts ts);
 
 // Convert a fixed-precision price to a formatted string.
-inline std::string PxToString(std::int64_t px) {
-  std::ostringstream ss;
-  ss << Px{px};
-  return ss.str();
-}
+std::string PxToString(std::int64_t px);
 }  // namespace databento::pretty
@@ -89,6 +89,9 @@ class Record {
   }
 
   std::size_t Size() const;
+  // Returns the timestamp records of this type are sorted and filtered by in
+  // historical requests and files.
+  UnixNanos IndexTs() const;
   static std::size_t SizeOfSchema(Schema schema);
   static ::databento::RType RTypeFromSchema(Schema schema);
 
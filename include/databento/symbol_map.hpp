@@ -1,12 +1,22 @@
 #pragma once
 #include <date/date.h>
 
+#include <algorithm>  // find
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <limits>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "databento/compat.hpp"
 #include "databento/record.hpp"
@@ -14,6 +24,17 @@
 namespace databento {
 // Forward declare
 struct Metadata;
+class ArenaMetadata;
+
+namespace detail {
+// Returns the symbol in a fixed-length C string without relying on null
+// termination.
+template <std::size_t N>
+std::string_view SymbolView(const std::array<char, N>& symbol) {
+  const auto len = std::find(symbol.begin(), symbol.end(), '\0') - symbol.begin();
+  return {symbol.data(), static_cast<std::size_t>(len)};
+}
+}  // namespace detail
 
 /// A timeseries symbol map. Useful for working with historical
 /// data.
@@ -61,6 +82,83 @@ class TsSymbolMap {
   Store map_;
 };
 
+// A timeseries symbol map that stores each instrument's mappings as a sorted
+// vector of date intervals rather than one entry per day. Lookups are
+// O(log k) in the number of intervals for the instrument, and memory use is
+// independent of the length of each interval, making it suitable for large
+// universes over long date ranges. Symbols are interned so each distinct symbol
+// is stored once.
+class CompactTsSymbolMap {
+ public:
+  struct Interval {
+    // Inclusive
+    date::sys_days start_date;
+    // Exclusive
+    date::sys_days end_date;
+    const std::string* symbol;
+  };
+  // Instrument ID to intervals sorted by `start_date`.
+  using Store = std::unordered_map<std::uint32_t, std::vector<Interval>>;
+
+  CompactTsSymbolMap() = default;
+  explicit CompactTsSymbolMap(const Metadata& metadata);
+  explicit CompactTsSymbolMap(const ArenaMetadata& metadata);
+  // Interned symbols are referenced by address, so copying would leave dangling
+  // pointers.
+  CompactTsSymbolMap(const CompactTsSymbolMap&) = delete;
+  CompactTsSymbolMap& operator=(const CompactTsSymbolMap&) = delete;
+  CompactTsSymbolMap(CompactTsSymbolMap&&) = default;
+  CompactTsSymbolMap& operator=(CompactTsSymbolMap&&) = default;
+  ~CompactTsSymbolMap() = default;
+
+  bool IsEmpty() const { return map_.empty(); }
+  // The total number of intervals across all instruments.
+  std::size_t Size() const { return size_; }
+  // The number of distinct symbols.
+  std::size_t SymbolCount() const { return symbols_.size(); }
+  const Store& Map() const { return map_; }
+  // Returns `nullptr` if there's no mapping for `instrument_id` on `date`.
+  const std::string* Find(date::year_month_day date, std::uint32_t instrument_id) const;
+  template <typename R>
+  const std::string* Find(const R& rec) const {
+    static_assert(has_header<R>::value,
+                  "must be a DBN record struct with an `hd` RecordHeader field");
+    date::year_month_day index_date{
+        date::sys_days{date::floor<date::days>(rec.IndexTs())}};
+    return Find(index_date, rec.hd.instrument_id);
+  }
+  // Throws `std::out_of_range` if there's no mapping for `instrument_id` on
+  // `date`.
+  const std::string& At(date::year_month_day date, std::uint32_t instrument_id) const;
+  template <typename R>
+  const std::string& At(const R& rec) const {
+    static_assert(has_header<R>::value,
+                  "must be a DBN record struct with an `hd` RecordHeader field");
+    date::year_month_day index_date{
+        date::sys_days{date::floor<date::days>(rec.IndexTs())}};
+    return At(index_date, rec.hd.instrument_id);
+  }
+  // Where intervals for an instrument overlap, the one inserted first takes
+  // precedence, matching `TsSymbolMap`.
+  void Insert(std::uint32_t instrument_id, date::year_month_day start_date,
+              date::year_month_day end_date, const std::string& symbol);
+
+ private:
+  template <typename M>
+  void InsertMappings(const M& metadata);
+  const std::string* Intern(std::string_view symbol);
+  // Appends without maintaining order. Must be followed by a call to `Sort`,
+  // which also resolves overlaps in favor of the interval appended first.
+  void Append(std::uint32_t instrument_id, date::year_month_day start_date,
+              date::year_month_day end_date, const std::string* symbol);
+  void Sort();
+
+  // Node-based so addresses are stable
+  std::unordered_set<std::string> symbols_;
+  Store map_;
+  std::size_t size_{};
+};
+
 // A point-in-time symbol map. Useful for working with live
 // symbology or a historical request over a single day or other
 // situations where the symbol mappings are known not to change.
@@ -102,9 +200,148 @@ class PitSymbolMap {
   Store map_;
 };
 
+// A point-in-time symbol map optimized for lookups on every record. Uses an
+// open-addressing hash table with linear probing keyed by instrument ID, and
+// interns symbols so each distinct symbol is stored once and lookups return
+// views without copying. Replaced symbols remain in the pool until the map is
+// destroyed.
+class FlatPitSymbolMap {
+ public:
+  FlatPitSymbolMap() = default;
+  FlatPitSymbolMap(const Metadata& metadata, date::year_month_day date);
+  // Interned symbols are referenced by view, so copying would leave dangling
+  // views.
+  FlatPitSymbolMap(const FlatPitSymbolMap&) = delete;
+  FlatPitSymbolMap& operator=(const FlatPitSymbolMap&) = delete;
+  FlatPitSymbolMap(FlatPitSymbolMap&&) = default;
+  FlatPitSymbolMap& operator=(FlatPitSymbolMap&&) = default;
+  ~FlatPitSymbolMap() = default;
+
+  bool IsEmpty() const { return size_ == 0; }
+  std::size_t Size() const { return size_; }
+  // The number of distinct symbols that have been interned.
+  std::size_t SymbolCount() const { return symbols_.size(); }
+  // Returns `nullptr` if there's no mapping for `instrument_id`.
+  const std::string* Find(std::uint32_t instrument_id) const {
+    const auto* slot = FindSlot(instrument_id);
+    return slot == nullptr ? nullptr : &symbols_[slot->symbol_idx];
+  }
+  const std::string* Find(const Record& rec) const {
+    return Find(rec.Header().instrument_id);
+  }
+  // Throws `std::out_of_range` if there's no mapping for the record's
+  // instrument ID. Constrained rather than using `static_assert` so integer
+  // arguments select the instrument ID overload.
+  template <typename R, typename = std::enable_if_t<has_header<R>::value>>
+  std::string_view At(const R& rec) const {
+    return At(rec.hd.instrument_id);
+  }
+  std::string_view At(const Record& rec) const {
+    return At(rec.Header().instrument_id);
+  }
+  std::string_view At(std::uint32_t instrument_id) const;
+  void Insert(std::uint32_t instrument_id, std::string_view symbol);
+  void OnRecord(const Record& rec);
+  template <typename SymbolMappingRec>
+  void OnSymbolMapping(const SymbolMappingRec& symbol_mapping);
+
+ private:
+  static constexpr auto kEmptySlot = std::numeric_limits<std::uint32_t>::max();
+
+  struct Slot {
+    std::uint32_t instrument_id;
+    // Index into `symbols_` or `kEmptySlot`
+    std::uint32_t symbol_idx{kEmptySlot};
+  };
+
+  // Fibonacci hashing: the high bits of the product depend on every bit of
+  // `instrument_id`, so taking them spreads both dense and strided IDs
+  std::size_t Hash(std::uint32_t instrument_id) const {
+    return static_cast<std::size_t>((std::uint64_t{instrument_id} *
+                                     0x9E3779B97F4A7C15ULL) >>
+                                    hash_shift_);
+  }
+  const Slot* FindSlot(std::uint32_t instrument_id) const;
+  // Returns the slot for `instrument_id`, which is empty if the ID isn't
+  // present. Requires there to be at least one empty slot.
+  Slot& ProbeSlot(std::uint32_t instrument_id);
+  std::uint32_t Intern(std::string_view symbol);
+  void Grow();
+
+  std::vector<Slot> slots_;
+  // 64 - log2 of the capacity, so `Hash` returns a slot index
+  std::uint32_t hash_shift_{};
+  std::size_t size_{};
+  // Deque so references remain stable as symbols are added
+  std::deque<std::string> symbols_;
+  std::unordered_map<std::string_view, std::uint32_t> symbol_indices_;
+};
+
+// A bidirectional point-in-time symbol index for going from symbol text to
+// instrument ID as well as from instrument ID to symbol. Symbols are interned
+// and looked up by their bytes, so lookups by `std::string_view` or a
+// fixed-length symbol array like `InstrumentDefMsg::raw_symbol` don't construct
+// a `std::string`. When a symbol is remapped to a new instrument ID, the
+// reverse lookup returns the most recent instrument ID.
+class PitSymbolIndex {
+ public:
+  PitSymbolIndex() = default;
+  PitSymbolIndex(const Metadata& metadata, date::year_month_day date);
+  // Interned symbols are referenced by view, so copying would leave dangling
+  // views.
+  PitSymbolIndex(const PitSymbolIndex&) = delete;
+  PitSymbolIndex& operator=(const PitSymbolIndex&) = delete;
+  PitSymbolIndex(PitSymbolIndex&&) = default;
+  PitSymbolIndex& operator=(PitSymbolIndex&&) = default;
+  ~PitSymbolIndex() = default;
+
+  bool IsEmpty() const { return instrument_symbols_.empty(); }
+  // The number of instrument IDs with a symbol.
+  std::size_t Size() const { return instrument_symbols_.size(); }
+  // Returns `nullptr` if there's no mapping for `instrument_id`.
+  const std::string* FindSymbol(std::uint32_t instrument_id) const;
+  // Throws `std::out_of_range` if there's no mapping for `instrument_id`.
+  std::string_view SymbolAt(std::uint32_t instrument_id) const;
+  std::optional<std::uint32_t> FindInstrumentId(std::string_view symbol) const;
+  template <std::size_t N>
+  std::optional<std::uint32_t> FindInstrumentId(
+      const std::array<char, N>& symbol) const {
+    return FindInstrumentId(detail::SymbolView(symbol));
+  }
+  // Throws `std::out_of_range` if there's no mapping for `symbol`.
+  std::uint32_t InstrumentIdAt(std::string_view symbol) const;
+  template <std::size_t N>
+  std::uint32_t InstrumentIdAt(const std::array<char, N>& symbol) const {
+    return InstrumentIdAt(detail::SymbolView(symbol));
+  }
+  void Insert(std::uint32_t instrument_id, std::string_view symbol);
+  void OnRecord(const Record& rec);
+  template <typename SymbolMappingRec>
+  void OnSymbolMapping(const SymbolMappingRec& symbol_mapping);
+
+ private:
+  std::uint32_t Intern(std::string_view symbol);
+
+  // Deque so references remain stable as symbols are added
+  std::deque<std::string> symbols_;
+  std::unordered_map<std::string_view, std::uint32_t> symbol_indices_;
+  // Indexed by symbol index
+  std::vector<std::optional<std::uint32_t>> symbol_instruments_;
+  // Instrument ID to symbol index
+  std::unordered_map<std::uint32_t, std::uint32_t> instrument_symbols_;
+};
+
 // Forward declare explicit instantiation
 extern template void PitSymbolMap::OnSymbolMapping(
     const SymbolMappingMsgV1& symbol_mapping);
 extern template void PitSymbolMap::OnSymbolMapping(
     const SymbolMappingMsgV2& symbol_mapping);
+extern template void FlatPitSymbolMap::OnSymbolMapping(
+    const SymbolMappingMsgV1& symbol_mapping);
+extern template void FlatPitSymbolMap::OnSymbolMapping(
+    const SymbolMappingMsgV2& symbol_mapping);
+extern template void PitSymbolIndex::OnSymbolMapping(
+    const SymbolMappingMsgV1& symbol_mapping);
+extern template void PitSymbolIndex::OnSymbolMapping(
+    const SymbolMappingMsgV2& symbol_mapping);
 }  // namespace databento
@@ -5,6 +5,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "databento/datetime.hpp"  // DateRange
 #include "databento/dbn.hpp"
 #include "databento/enums.hpp"
 #include "databento/symbol_map.hpp"
@@ -23,6 +24,15 @@ struct SymbologyResolution {
   TsSymbolMap CreateSymbolMap() const;
 };
 
+// The parameters of a single query to `Historical::SymbologyResolveBatch`.
+struct SymbologyQuery {
+  std::string dataset;
+  std::vector<std::string> symbols;
+  SType stype_in;
+  SType stype_out;
+  DateRange date_range;
+};
+
 // Converts a vector of symbols to a comma-delineated string for sending to
 // Databento's historical and live APIs.
 //
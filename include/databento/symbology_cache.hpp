@@ -0,0 +1,59 @@
+#pragma once
+
+#include <date/date.h>
+
+#include <filesystem>  // path
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "databento/enums.hpp"
+#include "databento/symbology.hpp"
+
+namespace databento {
+// Forward declare
+class Historical;
+
+// The contents of a symbology cache file: a resolution covering every date
+// from `start_date` (inclusive) to `end_date` (exclusive).
+struct SymbologyCacheEntry {
+  std::string dataset;
+  // Sorted. Stored in full because file names only contain a hash of them.
+  std::vector<std::string> symbols;
+  date::year_month_day start_date;
+  date::year_month_day end_date;
+  SymbologyResolution resolution;
+};
+
+// A persistent on-disk cache of `Historical::SymbologyResolve` results to
+// avoid re-resolving large universes on every process start. Each combination
+// of dataset, symbols, and stypes is stored in its own compact binary file.
+// When a date range outside the cached range is requested, only the missing
+// dates are requested from the API and the cache file is extended.
+class SymbologyCache {
+ public:
+  explicit SymbologyCache(std::filesystem::path cache_dir);
+
+  // Returns the resolution of `symbols` from `start_date` (inclusive) to
+  // `end_date` (exclusive), requesting any dates not already cached with
+  // `client`. `partial` and `not_found` reflect the full cached date range.
+  // A cache file that can't be read is discarded and requested again.
+  SymbologyResolution Resolve(Historical* client, const std::string& dataset,
+                              const std::vector<std::string>& symbols, SType stype_in,
+                              SType stype_out, date::year_month_day start_date,
+                              date::year_month_day end_date);
+  std::filesystem::path CachePath(const std::string& dataset,
+                                  const std::vector<std::string>& symbols,
+                                  SType stype_in, SType stype_out) const;
+
+  // Writes `entry` to `path`, replacing any existing file.
+  static void Write(const std::filesystem::path& path,
+                    const SymbologyCacheEntry& entry);
+  // Returns `std::nullopt` if there's no file at `path`. Throws
+  // `InvalidArgumentError` if the file isn't a valid cache file.
+  static std::optional<SymbologyCacheEntry> Read(const std::filesystem::path& path);
+
+ private:
+  std::filesystem::path cache_dir_;
+};
+}  // namespace databento
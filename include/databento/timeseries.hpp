@@ -1,5 +1,8 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>  // size_t
+#include <cstdint>
 #include <functional>  // function
 
 #include "databento/dbn.hpp"     // Metadata
@@ -13,4 +16,45 @@ enum KeepGoing : std::uint8_t {
 
 using MetadataCallback = std::function<void(Metadata&&)>;
 using RecordCallback = std::function<KeepGoing(const Record&)>;
+
+// Options for `Historical::TimeseriesGetRangeSplit`.
+struct TimeseriesSplitOptions {
+  // The number of contiguous sub-ranges to request concurrently, each over its
+  // own connection.
+  std::size_t num_splits{4};
+  // The maximum number of bytes of decoded records to buffer for each
+  // sub-range before pausing its connection.
+  std::size_t max_buffered_bytes{16 * 1024 * 1024};
+};
+
+// Options for `Historical::TimeseriesGetRangeBuffered`.
+struct TimeseriesBufferOptions {
+  // The number of pooled buffers for data received but not yet decoded.
+  std::size_t num_buffers{8};
+  // The size in bytes of each buffer.
+  std::size_t buffer_size{1024 * 1024};
+};
+
+// Statistics from a call to `Historical::TimeseriesGetRangeBuffered`.
+struct TimeseriesStreamStats {
+  // The number of compressed bytes received.
+  std::uint64_t bytes_received;
+  // The number of buffers passed from the receiving thread to the decoding
+  // thread.
+  std::uint64_t buffers_decoded;
+  // The greatest number of filled buffers waiting to be decoded.
+  std::size_t max_queue_depth;
+  // The number of times the receiving thread waited for a free buffer because
+  // decoding fell behind.
+  std::uint64_t receive_waits;
+  // The time from sending the request until all data was decoded.
+  std::chrono::nanoseconds duration;
+
+  // Returns the average number of compressed bytes received per second.
+  double Throughput() const {
+    return duration.count() > 0 ? static_cast<double>(bytes_received) * 1e9 /
+                                      static_cast<double>(duration.count())
+                                : 0.0;
+  }
+};
 }  // namespace databento
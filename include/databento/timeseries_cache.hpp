@@ -0,0 +1,63 @@
+#pragma once
+
+#include <filesystem>  // path
+#include <string>
+#include <vector>
+
+#include "databento/datetime.hpp"    // DateTimeRange, UnixNanos
+#include "databento/enums.hpp"       // Schema, SType
+#include "databento/timeseries.hpp"  // MetadataCallback, RecordCallback
+
+namespace databento {
+// Forward declare
+class Historical;
+
+// A cached response covering `start` (inclusive) to `end` (exclusive).
+struct TimeseriesCacheSegment {
+  UnixNanos start;
+  UnixNanos end;
+  std::filesystem::path path;
+};
+
+// An opt-in on-disk cache of `Historical::TimeseriesGetRange` responses for
+// repeatedly replaying the same data. Each combination of dataset, schema,
+// symbols, and stypes has its own directory of zstd-compressed DBN files, one
+// per requested time range. When a request only partially overlaps the cached
+// ranges, only the missing ranges are requested from the API. Responses are
+// cached with the requesting client's `VersionUpgradePolicy` applied, and
+// replayed upgraded to the newest DBN version among the cached files.
+//
+// NOTE: Only cache ranges for which the data is complete: a range requested
+// before the end of the available data is still considered cached afterwards.
+class TimeseriesCache {
+ public:
+  explicit TimeseriesCache(std::filesystem::path cache_dir);
+
+  // Replays historical market data to the callbacks like
+  // `Historical::TimeseriesGetRange`, requesting any part of `datetime_range`
+  // not already cached with `client`. `metadata_callback` is called once with
+  // metadata covering `datetime_range` and the merged symbol mappings of the
+  // cached files. `datetime_range.end` must be set.
+  //
+  // WARNING: Requesting uncached data will incur a cost.
+  void GetRange(Historical* client, const std::string& dataset,
+                const DateTimeRange<UnixNanos>& datetime_range,
+                const std::vector<std::string>& symbols, Schema schema,
+                SType stype_in, SType stype_out,
+                const MetadataCallback& metadata_callback,
+                const RecordCallback& record_callback);
+  // Returns the directory where the responses for the given request parameters
+  // are stored. Directories record their symbols, so requests whose symbols
+  // hash the same are stored separately.
+  std::filesystem::path CacheDir(const std::string& dataset,
+                                 const std::vector<std::string>& symbols,
+                                 Schema schema, SType stype_in, SType stype_out) const;
+
+  // Returns the cached segments in `dir` ordered by start.
+  static std::vector<TimeseriesCacheSegment> ListSegments(
+      const std::filesystem::path& dir);
+
+ private:
+  std::filesystem::path cache_dir_;
+};
+}  // namespace databento
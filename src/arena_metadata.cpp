@@ -0,0 +1,56 @@
+#include "databento/arena_metadata.hpp"
+
+#include <string>
+
+#include "databento/constants.hpp"
+
+using databento::ArenaMetadata;
+
+namespace {
+std::vector<std::string> ToStrings(const std::vector<std::string_view>& views) {
+  std::vector<std::string> res;
+  res.reserve(views.size());
+  for (const auto view : views) {
+    res.emplace_back(view);
+  }
+  return res;
+}
+}  // namespace
+
+databento::Metadata ArenaMetadata::ToMetadata() const {
+  Metadata res{version,
+               std::string{dataset},
+               schema,
+               start,
+               end,
+               limit,
+               stype_in,
+               stype_out,
+               ts_out,
+               symbol_cstr_len,
+               ToStrings(symbols),
+               ToStrings(partial),
+               ToStrings(not_found),
+               {}};
+  res.mappings.reserve(mappings.size());
+  for (const auto& mapping : mappings) {
+    SymbolMapping owned{std::string{mapping.raw_symbol}, {}};
+    owned.intervals.reserve(mapping.interval_count);
+    for (const auto& interval : Intervals(mapping)) {
+      owned.intervals.emplace_back(MappingInterval{
+          interval.start_date, interval.end_date, std::string{interval.symbol}});
+    }
+    res.mappings.emplace_back(std::move(owned));
+  }
+  return res;
+}
+
+void ArenaMetadata::Upgrade(VersionUpgradePolicy upgrade_policy) {
+  if (upgrade_policy == VersionUpgradePolicy::UpgradeToV2 && version < 2) {
+    version = 2;
+    symbol_cstr_len = kSymbolCstrLen;
+  } else if (upgrade_policy == VersionUpgradePolicy::UpgradeToV3 && version < 3) {
+    version = kDbnVersion;
+    symbol_cstr_len = kSymbolCstrLen;
+  }
+}
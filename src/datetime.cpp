@@ -1,46 +1,216 @@
 #include "databento/datetime.hpp"
 
-// NOLINTNEXTLINE(modernize-deprecated-headers): no thread-safe version in STL
-#include <time.h>  // gmtime_r or gmtime_s
-
 #include <array>
 #include <chrono>
-#include <ctime>    // localtime, strftime, tm
+#include <cstddef>
+#include <cstdint>
+#include <cstring>  // memcpy
 #include <iomanip>  // setw
+#include <limits>
 #include <sstream>  // ostringstream
+#include <string_view>
 
-#include "databento/constants.hpp"  // kUndefTimestamp
+#include "databento/constants.hpp"   // kUndefTimestamp
+#include "databento/exceptions.hpp"  // InvalidArgumentError
+#include "format_helper.hpp"         // WriteDigitsBackward
+#include "parse_helper.hpp"
 #include "stream_op_helper.hpp"
 
+namespace {
+struct CivilDate {
+  std::uint32_t year;
+  std::uint32_t month;
+  std::uint32_t day;
+};
+
+// Converts days since the UNIX epoch to a proleptic Gregorian calendar date.
+// See http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+CivilDate CivilFromDays(std::uint64_t days) {
+  const std::uint64_t z = days + 719468;
+  const std::uint64_t era = z / 146097;
+  const std::uint64_t doe = z - era * 146097;
+  const std::uint64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const std::uint64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const std::uint64_t mp = (5 * doy + 2) / 153;
+  const std::uint64_t day = doy - (153 * mp + 2) / 5 + 1;
+  const std::uint64_t month = mp < 10 ? mp + 3 : mp - 9;
+  const std::uint64_t year = yoe + era * 400 + (month <= 2 ? 1 : 0);
+  return {static_cast<std::uint32_t>(year), static_cast<std::uint32_t>(month),
+          static_cast<std::uint32_t>(day)};
+}
+
+// Converts a proleptic Gregorian calendar date to days since the UNIX epoch.
+// `year` must be at least 1970. See
+// http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+std::uint64_t DaysFromCivil(CivilDate date) {
+  const std::uint64_t year = date.year - (date.month <= 2 ? 1U : 0U);
+  const std::uint64_t era = year / 400;
+  const std::uint64_t yoe = year - era * 400;
+  const std::uint64_t mp = date.month > 2 ? date.month - 3 : date.month + 9;
+  const std::uint64_t doy = (153 * mp + 2) / 5 + date.day - 1;
+  const std::uint64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+std::uint32_t DaysInMonth(std::uint32_t year, std::uint32_t month) {
+  constexpr std::array<std::uint32_t, 12> kDaysInMonth = {31, 28, 31, 30, 31, 30,
+                                                          31, 31, 30, 31, 30, 31};
+  if (month == 2 && year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)) {
+    return 29;
+  }
+  return kDaysInMonth[month - 1];
+}
+
+// Parses exactly `count` digits of `str` starting at `pos`.
+bool ParseFixedDigits(std::string_view str, std::size_t pos, std::size_t count,
+                      std::uint32_t& value) {
+  value = 0;
+  for (std::size_t i = pos; i < pos + count; ++i) {
+    const auto digit = databento::DigitValue(str[i]);
+    if (digit > 9) {
+      return false;
+    }
+    value = value * 10 + digit;
+  }
+  return true;
+}
+
+[[noreturn]] void ThrowInvalidIso8601(std::string_view str, const char* reason) {
+  throw databento::InvalidArgumentError{
+      "ParseIso8601", "str",
+      "invalid timestamp '" + std::string{str} + "': " + reason};
+}
+
+// The formatted date is the same for every timestamp within a day, and
+// consecutive timestamps are usually from the same day
+struct DatePrefixCache {
+  static constexpr std::size_t kLen = 11;  // YYYY-MM-DDT
+
+  std::uint64_t days{std::numeric_limits<std::uint64_t>::max()};
+  std::array<char, kLen> prefix{};
+};
+}  // namespace
+
 namespace databento {
 std::string ToIso8601(UnixNanos unix_nanos) {
-  if (unix_nanos.time_since_epoch().count() == kUndefTimestamp) {
-    return "UNDEF_TIMESTAMP";
+  std::array<char, kMaxIso8601Len> buf;
+  return std::string(buf.data(), FormatIso8601(unix_nanos, buf.data()));
+}
+
+std::size_t FormatIso8601(UnixNanos unix_nanos, char* out) {
+  constexpr std::string_view kUndef = "UNDEF_TIMESTAMP";
+  constexpr std::uint64_t kNanosPerSecond = 1'000'000'000;
+  constexpr std::uint64_t kSecondsPerDay = 24 * 60 * 60;
+  static_assert(DatePrefixCache::kLen + 19 == kMaxIso8601Len);
+
+  const std::uint64_t count = unix_nanos.time_since_epoch().count();
+  if (count == kUndefTimestamp) {
+    std::memcpy(out, kUndef.data(), kUndef.size());
+    return kUndef.size();
+  }
+  const std::uint64_t secs = count / kNanosPerSecond;
+  const std::uint64_t days = secs / kSecondsPerDay;
+  thread_local DatePrefixCache cache;
+  if (cache.days != days) {
+    // All years in the range of `UnixNanos` have 4 digits
+    const auto date = CivilFromDays(days);
+    char* it = cache.prefix.data() + cache.prefix.size();
+    *--it = 'T';
+    it = WriteDigitsBackward(it, date.day, 2);
+    *--it = '-';
+    it = WriteDigitsBackward(it, date.month, 2);
+    *--it = '-';
+    WriteDigitsBackward(it, date.year, 4);
+    cache.days = days;
+  }
+  std::memcpy(out, cache.prefix.data(), cache.prefix.size());
+  // HH:MM:SS.NNNNNNNNNZ
+  const std::uint64_t secs_of_day = secs % kSecondsPerDay;
+  char* it = out + kMaxIso8601Len;
+  *--it = 'Z';
+  it = WriteDigitsBackward(it, count % kNanosPerSecond, 9);
+  *--it = '.';
+  it = WriteDigitsBackward(it, secs_of_day % 60, 2);
+  *--it = ':';
+  it = WriteDigitsBackward(it, secs_of_day / 60 % 60, 2);
+  *--it = ':';
+  WriteDigitsBackward(it, secs_of_day / 3600, 2);
+  return kMaxIso8601Len;
+}
+
+UnixNanos ParseIso8601(std::string_view str) {
+  constexpr std::uint64_t kNanosPerSecond = 1'000'000'000;
+  constexpr std::array<std::uint64_t, 10> kPow10 = {
+      1, 10, 100, 1'000, 10'000, 100'000, 1'000'000, 10'000'000, 100'000'000,
+      1'000'000'000};
+  if (str == "UNDEF_TIMESTAMP") {
+    return UnixNanos{std::chrono::nanoseconds{kUndefTimestamp}};
+  }
+  // YYYY-MM-DD
+  CivilDate date;
+  if (str.size() < 10 || str[4] != '-' || str[7] != '-' ||
+      !ParseFixedDigits(str, 0, 4, date.year) ||
+      !ParseFixedDigits(str, 5, 2, date.month) ||
+      !ParseFixedDigits(str, 8, 2, date.day)) {
+    ThrowInvalidIso8601(str, "expected date in YYYY-MM-DD format");
+  }
+  if (date.year < 1970) {
+    ThrowInvalidIso8601(str, "year is before 1970");
+  }
+  if (date.month < 1 || date.month > 12) {
+    ThrowInvalidIso8601(str, "month out of range");
+  }
+  if (date.day < 1 || date.day > DaysInMonth(date.year, date.month)) {
+    ThrowInvalidIso8601(str, "day out of range");
   }
-  std::array<char, 80> buf{};
-  const std::time_t time =
-      std::chrono::duration_cast<std::chrono::seconds>(unix_nanos.time_since_epoch())
-          .count();
-  std::tm tm = {};
-#ifdef _WIN32
-  if (::gmtime_s(&tm, &time) != 0) {
-    // Fallback on printing nanos
-    return ToString(unix_nanos);
+  // Optional [T ]HH:MM[:SS[.fffffffff]][Z]
+  std::uint32_t hours = 0;
+  std::uint32_t minutes = 0;
+  std::uint32_t seconds = 0;
+  std::uint64_t nanos = 0;
+  std::size_t pos = 10;
+  if (pos < str.size()) {
+    if ((str[pos] != 'T' && str[pos] != ' ') || str.size() < 16 || str[13] != ':' ||
+        !ParseFixedDigits(str, 11, 2, hours) ||
+        !ParseFixedDigits(str, 14, 2, minutes)) {
+      ThrowInvalidIso8601(str, "expected time in HH:MM format");
+    }
+    pos = 16;
+    if (pos < str.size() && str[pos] == ':') {
+      if (str.size() < pos + 3 || !ParseFixedDigits(str, pos + 1, 2, seconds)) {
+        ThrowInvalidIso8601(str, "expected seconds in SS format");
+      }
+      pos += 3;
+      if (pos < str.size() && str[pos] == '.') {
+        ++pos;
+        const auto digits = ParseDigitRun(str.substr(pos), 9, nanos);
+        if (digits == 0) {
+          ThrowInvalidIso8601(str, "expected fractional seconds");
+        }
+        pos += digits;
+        if (pos < str.size() && DigitValue(str[pos]) <= 9) {
+          ThrowInvalidIso8601(str, "more than 9 digits of fractional seconds");
+        }
+        nanos *= kPow10[9 - digits];
+      }
+    }
+    if (pos < str.size() && str[pos] == 'Z') {
+      ++pos;
+    }
+    if (pos != str.size()) {
+      ThrowInvalidIso8601(str, "unexpected trailing characters");
+    }
+    if (hours > 23 || minutes > 59 || seconds > 59) {
+      ThrowInvalidIso8601(str, "time out of range");
+    }
   }
-#else
-  if (::gmtime_r(&time, &tm) == nullptr) {
-    // Fallback on printing nanos
-    return ToString(unix_nanos);
+  const std::uint64_t secs =
+      DaysFromCivil(date) * 24 * 60 * 60 + hours * 60 * 60 + minutes * 60 + seconds;
+  // `kUndefTimestamp` is reserved
+  if (secs > (kUndefTimestamp - 1 - nanos) / kNanosPerSecond) {
+    ThrowInvalidIso8601(str, "out of range of UnixNanos");
   }
-#endif
-  const auto nanos =
-      std::chrono::nanoseconds{unix_nanos.time_since_epoch() %
-                               std::chrono::nanoseconds{std::chrono::seconds{1}}};
-  const size_t count = std::strftime(buf.data(), sizeof(buf), "%Y-%m-%dT%H:%M:%S", &tm);
-  std::ostringstream time_ss;
-  time_ss.write(buf.data(), static_cast<std::streamsize>(count));
-  time_ss << '.' << std::setw(9) << std::setfill('0') << nanos.count() << 'Z';
-  return time_ss.str();
+  return UnixNanos{std::chrono::nanoseconds{secs * kNanosPerSecond + nanos}};
 }
 
 std::string ToString(UnixNanos unix_nanos) {
@@ -5,6 +5,7 @@
 #include <algorithm>  // copy
 #include <cstring>    // strncmp
 #include <optional>
+#include <string_view>
 #include <vector>
 
 #include "databento/compat.hpp"
@@ -14,10 +15,12 @@
 #include "databento/detail/zstd_stream.hpp"
 #include "databento/enums.hpp"
 #include "databento/exceptions.hpp"
+#include "databento/metrics.hpp"  // MetricCounter
 #include "databento/record.hpp"
 #include "databento/v3.hpp"
 #include "databento/with_ts_out.hpp"
 #include "dbn_constants.hpp"
+#include "metrics_hooks.hpp"
 
 using databento::DbnDecoder;
 
@@ -42,8 +45,8 @@ const char* Consume(const std::byte*& buf, const std::ptrdiff_t num_bytes) {
   return reinterpret_cast<const char*>(pos);
 }
 
-std::string Consume(const std::byte*& buf, const std::ptrdiff_t num_bytes,
-                    const char* context) {
+std::string_view ConsumeView(const std::byte*& buf, const std::ptrdiff_t num_bytes,
+                             const char* context) {
   const auto cstr = Consume(buf, num_bytes);
   // strnlen isn't portable
   const auto str_len = std::find(cstr, cstr + num_bytes, '\0') - cstr;
@@ -51,7 +54,12 @@ std::string Consume(const std::byte*& buf, const std::ptrdiff_t num_bytes,
     throw databento::DbnResponseError{std::string{"Invalid "} + context +
                                       " missing null terminator"};
   }
-  return std::string{cstr, static_cast<std::size_t>(str_len)};
+  return std::string_view{cstr, static_cast<std::size_t>(str_len)};
+}
+
+std::string Consume(const std::byte*& buf, const std::ptrdiff_t num_bytes,
+                    const char* context) {
+  return std::string{ConsumeView(buf, num_bytes, context)};
 }
 
 date::year_month_day DecodeIso8601Date(std::uint32_t yyyymmdd_int) {
@@ -87,6 +95,19 @@ DbnDecoder::DbnDecoder(ILogReceiver* log_receiver, std::unique_ptr<IReadable> in
   }
 }
 
+DbnDecoder::DbnDecoder(ILogReceiver* log_receiver, std::unique_ptr<IReadable> input,
+                       VersionUpgradePolicy upgrade_policy, Compression compression,
+                       const Metadata& metadata)
+    : log_receiver_{log_receiver},
+      version_{metadata.version},
+      upgrade_policy_{upgrade_policy},
+      ts_out_{metadata.ts_out},
+      input_{std::move(input)} {
+  if (compression == Compression::Zstd) {
+    input_ = std::make_unique<detail::ZstdDecodeStream>(std::move(input_));
+  }
+}
+
 std::pair<std::uint8_t, std::size_t> DbnDecoder::DecodeMetadataVersionAndSize(
     const std::byte* buffer, std::size_t size) {
   if (size < 8) {
@@ -104,19 +125,27 @@ std::pair<std::uint8_t, std::size_t> DbnDecoder::DecodeMetadataVersionAndSize(
   return {version, static_cast<std::size_t>(frame_size)};
 }
 
-databento::Metadata DbnDecoder::DecodeMetadataFields(std::uint8_t version,
-                                                     const std::byte* buffer,
-                                                     const std::byte* buffer_end) {
-  Metadata res;
+namespace {
+// Decodes the fixed-length portion of the metadata common to `Metadata` and
+// `ArenaMetadata`.
+template <typename M>
+void DecodeFixedMetadataFields(std::uint8_t version, const std::byte*& buffer,
+                               M& res) {
+  using databento::DbnResponseError;
+  using databento::kDbnVersion;
+  using databento::Schema;
+  using databento::SType;
+  using databento::UnixNanos;
+
   res.version = version;
   if (res.version > kDbnVersion) {
     throw DbnResponseError{"Can't decode newer version of DBN. Decoder version is " +
                            std::to_string(kDbnVersion) + ", input version is " +
                            std::to_string(res.version)};
   }
-  res.dataset = Consume(buffer, kDatasetCstrLen, "dataset");
+  res.dataset = ConsumeView(buffer, databento::kDatasetCstrLen, "dataset");
   const auto raw_schema = Consume<std::uint16_t>(buffer);
-  if (raw_schema == kNullSchema) {
+  if (raw_schema == databento::kNullSchema) {
     res.schema = std::nullopt;
   } else {
     res.schema = {static_cast<Schema>(raw_schema)};
@@ -129,7 +158,7 @@ databento::Metadata DbnDecoder::DecodeMetadataFields(std::uint8_t version,
     buffer += 8;
   }
   const auto raw_stype_in = Consume<std::uint8_t>(buffer);
-  if (raw_stype_in == kNullSType) {
+  if (raw_stype_in == databento::kNullSType) {
     res.stype_in = std::nullopt;
   } else {
     res.stype_in = {static_cast<SType>(raw_stype_in)};
@@ -139,19 +168,79 @@ databento::Metadata DbnDecoder::DecodeMetadataFields(std::uint8_t version,
   if (version > 1) {
     res.symbol_cstr_len = static_cast<std::size_t>(Consume<std::uint16_t>(buffer));
   } else {
-    res.symbol_cstr_len = kSymbolCstrLenV1;
+    res.symbol_cstr_len = databento::kSymbolCstrLenV1;
   }
   // skip reserved
   if (version == 1) {
-    buffer += kMetadataReservedLenV1;
+    buffer += databento::kMetadataReservedLenV1;
   } else {
-    buffer += kMetadataReservedLen;
+    buffer += databento::kMetadataReservedLen;
   }
 
   const auto schema_definition_length = Consume<std::uint32_t>(buffer);
   if (schema_definition_length != 0) {
     throw DbnResponseError{"This version of dbn can't parse schema definitions"};
   }
+}
+
+void DecodeRepeatedSymbolView(std::size_t symbol_cstr_len, const std::byte*& read_buf,
+                              const std::byte* read_buf_end,
+                              std::vector<std::string_view>& res) {
+  if (read_buf + sizeof(std::uint32_t) > read_buf_end) {
+    throw databento::DbnResponseError{
+        "Unexpected end of metadata buffer while parsing symbol"};
+  }
+  const auto count = std::size_t{Consume<std::uint32_t>(read_buf)};
+  if (read_buf + static_cast<std::ptrdiff_t>(count * symbol_cstr_len) > read_buf_end) {
+    throw databento::DbnResponseError{
+        "Unexpected end of metadata buffer while parsing symbol"};
+  }
+  res.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    res.emplace_back(ConsumeView(
+        read_buf, static_cast<std::ptrdiff_t>(symbol_cstr_len), "symbol"));
+  }
+}
+
+// Walks the encoded symbol mappings without decoding them to determine the
+// total number of intervals. Validates the counts against the size of the
+// buffer so a malformed count is reported as an error rather than a huge
+// allocation.
+std::size_t CountMappingIntervals(std::size_t symbol_cstr_len,
+                                  const std::byte* read_buf,
+                                  const std::byte* read_buf_end) {
+  if (read_buf + sizeof(std::uint32_t) > read_buf_end) {
+    throw databento::DbnResponseError{
+        "Unexpected end of metadata buffer while parsing mappings"};
+  }
+  const auto count = std::size_t{Consume<std::uint32_t>(read_buf)};
+  const auto interval_len = sizeof(std::uint32_t) * 2 + symbol_cstr_len;
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (static_cast<std::size_t>(read_buf_end - read_buf) <
+        symbol_cstr_len + sizeof(std::uint32_t)) {
+      throw databento::DbnResponseError{
+          "Unexpected end of metadata buffer while parsing symbol mapping"};
+    }
+    read_buf += static_cast<std::ptrdiff_t>(symbol_cstr_len);
+    const auto interval_count = std::size_t{Consume<std::uint32_t>(read_buf)};
+    const auto remaining = static_cast<std::size_t>(read_buf_end - read_buf);
+    if (interval_count > remaining / interval_len) {
+      throw databento::DbnResponseError{
+          "Symbol mapping interval_count doesn't match size of buffer"};
+    }
+    read_buf += static_cast<std::ptrdiff_t>(interval_count * interval_len);
+    total += interval_count;
+  }
+  return total;
+}
+}  // namespace
+
+databento::Metadata DbnDecoder::DecodeMetadataFields(std::uint8_t version,
+                                                     const std::byte* buffer,
+                                                     const std::byte* buffer_end) {
+  Metadata res;
+  DecodeFixedMetadataFields(version, buffer, res);
   res.symbols =
       DbnDecoder::DecodeRepeatedSymbol(res.symbol_cstr_len, buffer, buffer_end);
   res.partial =
@@ -164,7 +253,28 @@ databento::Metadata DbnDecoder::DecodeMetadataFields(std::uint8_t version,
   return res;
 }
 
-databento::Metadata DbnDecoder::DecodeMetadata() {
+databento::ArenaMetadata DbnDecoder::DecodeArenaMetadataFields(
+    std::uint8_t version, const std::byte* buffer, const std::byte* buffer_end) {
+  ArenaMetadata res;
+  // Copy the encoded metadata so all strings can be views into it
+  const auto size = static_cast<std::size_t>(buffer_end - buffer);
+  res.arena_ = std::make_unique<char[]>(size);
+  std::copy(buffer, buffer_end, reinterpret_cast<std::byte*>(res.arena_.get()));
+  buffer = reinterpret_cast<const std::byte*>(res.arena_.get());
+  buffer_end = buffer + size;
+
+  DecodeFixedMetadataFields(version, buffer, res);
+  DecodeRepeatedSymbolView(res.symbol_cstr_len, buffer, buffer_end, res.symbols);
+  DecodeRepeatedSymbolView(res.symbol_cstr_len, buffer, buffer_end, res.partial);
+  DecodeRepeatedSymbolView(res.symbol_cstr_len, buffer, buffer_end, res.not_found);
+  DbnDecoder::DecodeSymbolMappingViews(res.symbol_cstr_len, buffer, buffer_end, res);
+
+  return res;
+}
+
+template <typename M>
+M DbnDecoder::DecodeMetadataWith(M (*decode_fields)(std::uint8_t, const std::byte*,
+                                                    const std::byte*)) {
   // already read first 4 bytes detecting compression
   const auto read_size = kMetadataPreludeSize - kMagicSize;
   input_->ReadExact(buffer_.WriteBegin(), read_size);
@@ -176,8 +286,7 @@ databento::Metadata DbnDecoder::DecodeMetadata() {
   buffer_.Reserve(size);
   input_->ReadExact(buffer_.WriteBegin(), size);
   buffer_.Fill(size);
-  auto metadata = DbnDecoder::DecodeMetadataFields(version_, buffer_.ReadBegin(),
-                                                   buffer_.ReadEnd());
+  auto metadata = decode_fields(version_, buffer_.ReadBegin(), buffer_.ReadEnd());
   buffer_.Consume(size);
   // Metadata may leave buffer misaligned. Shift records to ensure 8-byte
   // alignment
@@ -187,11 +296,20 @@ databento::Metadata DbnDecoder::DecodeMetadata() {
   return metadata;
 }
 
+databento::Metadata DbnDecoder::DecodeMetadata() {
+  return DecodeMetadataWith(&DbnDecoder::DecodeMetadataFields);
+}
+
+databento::ArenaMetadata DbnDecoder::DecodeArenaMetadata() {
+  return DecodeMetadataWith(&DbnDecoder::DecodeArenaMetadataFields);
+}
+
 namespace {
 template <typename T, typename U>
 databento::Record UpgradeRecord(
     bool ts_out, std::array<std::byte, databento::kMaxRecordLen>* compat_buffer,
     databento::Record rec) {
+  databento::detail::IncrementMetric(databento::MetricCounter::CompatUpgrades, 1);
   if (ts_out) {
     const auto orig = rec.Get<databento::WithTsOut<T>>();
     const databento::WithTsOut<U> upgraded = {orig.rec.template Upgrade<U>(),
@@ -213,6 +331,8 @@ databento::Record UpgradeRecord(
 databento::Record DbnDecoder::DecodeRecordCompat(
     std::uint8_t version, VersionUpgradePolicy upgrade_policy, bool ts_out,
     std::array<std::byte, kMaxRecordLen>* compat_buffer, Record rec) {
+  // Every decoded record passes through here
+  detail::RecordDecodedMetric(rec.RType());
   if (version == 1 && upgrade_policy == VersionUpgradePolicy::UpgradeToV2) {
     switch (rec.RType()) {
       case RType::InstrumentDef: {
@@ -410,3 +530,43 @@ databento::SymbolMapping DbnDecoder::DecodeSymbolMapping(
   }
   return res;
 }
+
+void DbnDecoder::DecodeSymbolMappingViews(std::size_t symbol_cstr_len,
+                                          const std::byte*& read_buf,
+                                          const std::byte* read_buf_end,
+                                          ArenaMetadata& res) {
+  // Also validates the counts so the reservations below are bounded by the
+  // buffer size
+  res.intervals.reserve(CountMappingIntervals(symbol_cstr_len, read_buf, read_buf_end));
+  const auto count = std::size_t{Consume<std::uint32_t>(read_buf)};
+  const auto symbol_len = static_cast<std::ptrdiff_t>(symbol_cstr_len);
+  const auto min_symbol_mapping_encoded_len =
+      static_cast<std::ptrdiff_t>(symbol_cstr_len + sizeof(std::uint32_t));
+  const auto mapping_encoded_len = sizeof(std::uint32_t) * 2 + symbol_cstr_len;
+  res.mappings.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    if (read_buf + min_symbol_mapping_encoded_len > read_buf_end) {
+      throw DbnResponseError{
+          "Unexpected end of metadata buffer while parsing symbol "
+          "mapping"};
+    }
+    SymbolMappingView mapping;
+    mapping.raw_symbol = ConsumeView(read_buf, symbol_len, "symbol");
+    mapping.interval_offset = res.intervals.size();
+    mapping.interval_count = std::size_t{Consume<std::uint32_t>(read_buf)};
+    const auto read_size =
+        static_cast<std::ptrdiff_t>(mapping.interval_count * mapping_encoded_len);
+    if (read_buf + read_size > read_buf_end) {
+      throw DbnResponseError{
+          "Symbol mapping interval_count doesn't match size of buffer"};
+    }
+    for (std::size_t j = 0; j < mapping.interval_count; ++j) {
+      MappingIntervalView interval;
+      interval.start_date = DecodeIso8601Date(Consume<std::uint32_t>(read_buf));
+      interval.end_date = DecodeIso8601Date(Consume<std::uint32_t>(read_buf));
+      interval.symbol = ConsumeView(read_buf, symbol_len, "symbol");
+      res.intervals.emplace_back(interval);
+    }
+    res.mappings.emplace_back(mapping);
+  }
+}
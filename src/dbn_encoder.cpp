@@ -4,25 +4,33 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>  // memcpy
+#include <memory>
 #include <numeric>  // accumulate
 #include <string>
+#include <utility>  // move
 #include <vector>
 
 #include "databento/constants.hpp"
 #include "databento/dbn.hpp"
+#include "databento/detail/buffer.hpp"
 #include "databento/exceptions.hpp"
 #include "databento/iwritable.hpp"
+#include "databento/record.hpp"
 #include "dbn_constants.hpp"
 
 using databento::DbnEncoder;
 
 namespace {
-void EncodeChars(const char* bytes, std::size_t length, databento::IWritable* output) {
-  output->WriteAll(reinterpret_cast<const std::byte*>(bytes), length);
+using ByteBuffer = std::vector<std::byte>;
+
+void EncodeChars(const char* bytes, std::size_t length, ByteBuffer* buffer) {
+  const auto* begin = reinterpret_cast<const std::byte*>(bytes);
+  buffer->insert(buffer->end(), begin, begin + length);
 }
 
 void EncodeFixedLenCStr(std::size_t cstr_len, const std::string& str,
-                        databento::IWritable* output) {
+                        ByteBuffer* buffer) {
   // >= to ensure space for null padding
   if (str.size() >= cstr_len) {
     throw databento::InvalidArgumentError{
@@ -30,48 +38,48 @@ void EncodeFixedLenCStr(std::size_t cstr_len, const std::string& str,
         std::string{"String is too long to encode, maximum length of "} +
             std::to_string(cstr_len - 1)};
   }
-  output->WriteAll(reinterpret_cast<const std::byte*>(str.data()), str.length());
+  EncodeChars(str.data(), str.length(), buffer);
   // Null padding
-  std::vector<std::byte> filler(cstr_len - str.length());
-  output->WriteAll(filler.data(), filler.size());
+  buffer->resize(buffer->size() + cstr_len - str.length());
 }
 
 template <typename T>
-void EncodeAsBytes(T bytes, databento::IWritable* output) {
-  output->WriteAll(reinterpret_cast<const std::byte*>(&bytes), sizeof(bytes));
+void EncodeAsBytes(T bytes, ByteBuffer* buffer) {
+  const auto* begin = reinterpret_cast<const std::byte*>(&bytes);
+  buffer->insert(buffer->end(), begin, begin + sizeof(bytes));
 }
 
-void EncodeDate(date::year_month_day date, databento::IWritable* output) {
+void EncodeDate(date::year_month_day date, ByteBuffer* buffer) {
   auto date_int = static_cast<std::uint32_t>(std::int32_t{date.year()}) * 10000;
   date_int += std::uint32_t{date.month()} * 100;
   date_int += std::uint32_t{date.day()};
-  EncodeAsBytes(date_int, output);
+  EncodeAsBytes(date_int, buffer);
 }
 
 void EncodeRepeatedSymbolCStr(std::size_t cstr_len,
                               const std::vector<std::string>& symbols,
-                              databento::IWritable* output) {
+                              ByteBuffer* buffer) {
   const auto length = static_cast<std::uint32_t>(symbols.size());
-  EncodeAsBytes(length, output);
+  EncodeAsBytes(length, buffer);
   for (const auto& symbol : symbols) {
-    EncodeFixedLenCStr(cstr_len, symbol, output);
+    EncodeFixedLenCStr(cstr_len, symbol, buffer);
   }
 }
 
 void EncodeSymbolMappings(std::size_t cstr_len,
                           const std::vector<databento::SymbolMapping>& symbol_mappings,
-                          databento::IWritable* output) {
+                          ByteBuffer* buffer) {
   const auto mappings_length = static_cast<std::uint32_t>(symbol_mappings.size());
-  EncodeAsBytes(mappings_length, output);
+  EncodeAsBytes(mappings_length, buffer);
   for (const auto& symbol_mapping : symbol_mappings) {
-    EncodeFixedLenCStr(cstr_len, symbol_mapping.raw_symbol, output);
+    EncodeFixedLenCStr(cstr_len, symbol_mapping.raw_symbol, buffer);
     const auto interval_length =
         static_cast<std::uint32_t>(symbol_mapping.intervals.size());
-    EncodeAsBytes(interval_length, output);
+    EncodeAsBytes(interval_length, buffer);
     for (const auto& interval : symbol_mapping.intervals) {
-      EncodeDate(interval.start_date, output);
-      EncodeDate(interval.end_date, output);
-      EncodeFixedLenCStr(cstr_len, interval.symbol, output);
+      EncodeDate(interval.start_date, buffer);
+      EncodeDate(interval.end_date, buffer);
+      EncodeFixedLenCStr(cstr_len, interval.symbol, buffer);
     }
   }
 }
@@ -81,7 +89,77 @@ DbnEncoder::DbnEncoder(const Metadata& metadata, IWritable* output) : output_{ou
   EncodeMetadata(metadata, output_);
 }
 
+DbnEncoder::DbnEncoder(const Metadata& metadata, IWritable* output,
+                       std::size_t buffer_size)
+    : output_{output}, buffer_{std::make_unique<detail::Buffer>(buffer_size)} {
+  std::vector<std::byte> metadata_buffer;
+  AppendMetadata(metadata, &metadata_buffer);
+  Write(metadata_buffer.data(), metadata_buffer.size());
+}
+
+DbnEncoder::DbnEncoder(const DbnEncoder& other)
+    : output_{other.output_},
+      buffer_{other.buffer_
+                  ? std::make_unique<detail::Buffer>(other.buffer_->Capacity())
+                  : nullptr} {}
+
+DbnEncoder::DbnEncoder(DbnEncoder&&) noexcept = default;
+
+DbnEncoder& DbnEncoder::operator=(const DbnEncoder& other) {
+  if (this != &other) {
+    *this = DbnEncoder{other};
+  }
+  return *this;
+}
+
+DbnEncoder& DbnEncoder::operator=(DbnEncoder&& other) {
+  if (this != &other) {
+    Flush();
+    output_ = other.output_;
+    buffer_ = std::move(other.buffer_);
+  }
+  return *this;
+}
+
+DbnEncoder::~DbnEncoder() {
+  try {
+    Flush();
+  } catch (...) {
+    // Destructors can't throw
+  }
+}
+
 void DbnEncoder::EncodeMetadata(const Metadata& metadata, IWritable* output) {
+  std::vector<std::byte> buffer;
+  AppendMetadata(metadata, &buffer);
+  output->WriteAll(buffer.data(), buffer.size());
+}
+
+void DbnEncoder::EncodeRecord(const Record& record, IWritable* output) {
+  output->WriteAll(reinterpret_cast<const std::byte*>(&record.Header()), record.Size());
+}
+
+void DbnEncoder::EncodeRecord(const Record& record) {
+  Write(reinterpret_cast<const std::byte*>(&record.Header()), record.Size());
+}
+
+void DbnEncoder::EncodeRecords(const std::byte* records, std::size_t length) {
+  Write(records, length);
+}
+
+void DbnEncoder::Flush() {
+  if (buffer_ && buffer_->ReadCapacity() > 0) {
+    const auto* data = buffer_->ReadBegin();
+    const auto length = buffer_->ReadCapacity();
+    // Clear first so the destructor doesn't resend the data if the write fails.
+    // `Clear` only resets the positions so `data` remains valid.
+    buffer_->Clear();
+    output_->WriteAll(data, length);
+  }
+}
+
+void DbnEncoder::AppendMetadata(const Metadata& metadata,
+                                std::vector<std::byte>* buffer) {
   if (metadata.version > kDbnVersion) {
     throw databento::InvalidArgumentError{
         "EncodeMetadata", "metadata",
@@ -90,56 +168,64 @@ void DbnEncoder::EncodeMetadata(const Metadata& metadata, IWritable* output) {
             std::to_string(+kDbnVersion)};
   }
   const auto version = std::max<std::uint8_t>(1, metadata.version);
-  EncodeChars(kDbnPrefix, kMagicSize - 1, output);
-  EncodeAsBytes(version, output);
   const auto [length, end_padding] = CalcLength(metadata);
-  EncodeAsBytes(length, output);
-  EncodeFixedLenCStr(kDatasetCstrLen, metadata.dataset, output);
+  // The length excludes the prefix, version, and length itself
+  buffer->reserve(buffer->size() + kMagicSize + sizeof(length) + length);
+  EncodeChars(kDbnPrefix, kMagicSize - 1, buffer);
+  EncodeAsBytes(version, buffer);
+  EncodeAsBytes(length, buffer);
+  EncodeFixedLenCStr(kDatasetCstrLen, metadata.dataset, buffer);
   if (metadata.schema.has_value()) {
-    EncodeAsBytes(*metadata.schema, output);
+    EncodeAsBytes(*metadata.schema, buffer);
   } else {
-    EncodeAsBytes(kNullSchema, output);
+    EncodeAsBytes(kNullSchema, buffer);
   }
-  EncodeAsBytes(metadata.start, output);
-  EncodeAsBytes(metadata.end, output);
-  EncodeAsBytes(metadata.limit, output);
+  EncodeAsBytes(metadata.start, buffer);
+  EncodeAsBytes(metadata.end, buffer);
+  EncodeAsBytes(metadata.limit, buffer);
   if (version == 1) {
     // backwards compatibility for record_count
-    EncodeAsBytes(kNullRecordCount, output);
+    EncodeAsBytes(kNullRecordCount, buffer);
   }
   if (metadata.stype_in.has_value()) {
-    EncodeAsBytes(*metadata.stype_in, output);
+    EncodeAsBytes(*metadata.stype_in, buffer);
   } else {
-    EncodeAsBytes(kNullSType, output);
+    EncodeAsBytes(kNullSType, buffer);
   }
-  EncodeAsBytes(metadata.stype_out, output);
-  EncodeAsBytes(static_cast<std::uint8_t>(metadata.ts_out), output);
+  EncodeAsBytes(metadata.stype_out, buffer);
+  EncodeAsBytes(static_cast<std::uint8_t>(metadata.ts_out), buffer);
   if (version > 1) {
     const auto symbol_cstr_len = static_cast<std::uint16_t>(metadata.symbol_cstr_len);
-    EncodeAsBytes(symbol_cstr_len, output);
+    EncodeAsBytes(symbol_cstr_len, buffer);
   }
   // padding + schema definition length
   auto reserved_length = version == 1 ? kMetadataReservedLenV1 : kMetadataReservedLen;
-  const std::vector<std::byte> padding(reserved_length + sizeof(std::uint32_t));
-  output->WriteAll(padding.data(), padding.size());
+  buffer->resize(buffer->size() + reserved_length + sizeof(std::uint32_t));
 
   // variable-length data
-  EncodeRepeatedSymbolCStr(metadata.symbol_cstr_len, metadata.symbols, output);
-  EncodeRepeatedSymbolCStr(metadata.symbol_cstr_len, metadata.partial, output);
-  EncodeRepeatedSymbolCStr(metadata.symbol_cstr_len, metadata.not_found, output);
-  EncodeSymbolMappings(metadata.symbol_cstr_len, metadata.mappings, output);
-  if (end_padding > 0) {
-    std::array<std::byte, 7> end_padding_buf{};
-    output->WriteAll(end_padding_buf.data(), end_padding);
-  }
+  EncodeRepeatedSymbolCStr(metadata.symbol_cstr_len, metadata.symbols, buffer);
+  EncodeRepeatedSymbolCStr(metadata.symbol_cstr_len, metadata.partial, buffer);
+  EncodeRepeatedSymbolCStr(metadata.symbol_cstr_len, metadata.not_found, buffer);
+  EncodeSymbolMappings(metadata.symbol_cstr_len, metadata.mappings, buffer);
+  buffer->resize(buffer->size() + end_padding);
 }
 
-void DbnEncoder::EncodeRecord(const Record& record, IWritable* output) {
-  output->WriteAll(reinterpret_cast<const std::byte*>(&record.Header()), record.Size());
+void DbnEncoder::Write(const std::byte* data, std::size_t length) {
+  if (!buffer_) {
+    output_->WriteAll(data, length);
+    return;
+  }
+  if (length > buffer_->WriteCapacity()) {
+    Flush();
+    if (length >= buffer_->Capacity()) {
+      output_->WriteAll(data, length);
+      return;
+    }
+  }
+  std::memcpy(buffer_->WriteBegin(), data, length);
+  buffer_->Fill(length);
 }
 
-void DbnEncoder::EncodeRecord(const Record& record) { EncodeRecord(record, output_); }
-
 std::pair<std::uint32_t, std::uint32_t> DbnEncoder::CalcLength(
     const Metadata& metadata) {
   const auto symbol_cstr_len = metadata.symbol_cstr_len;
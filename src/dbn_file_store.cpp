@@ -1,7 +1,9 @@
 #include "databento/dbn_file_store.hpp"
 
-#include <memory>   // unique_ptr
-#include <utility>  // move
+#include <algorithm>  // partition_point
+#include <iterator>   // prev
+#include <memory>     // make_unique, unique_ptr
+#include <utility>    // exchange, move
 
 #include "databento/file_stream.hpp"
 #include "databento/record.hpp"
@@ -9,22 +11,33 @@
 using databento::DbnFileStore;
 
 DbnFileStore::DbnFileStore(const std::filesystem::path& file_path)
-    : decoder_{ILogReceiver::Default(), InFileStream{file_path}} {}
+    : DbnFileStore{ILogReceiver::Default(), file_path,
+                   VersionUpgradePolicy::UpgradeToV3} {}
 
 DbnFileStore::DbnFileStore(ILogReceiver* log_receiver,
                            const std::filesystem::path& file_path,
                            VersionUpgradePolicy upgrade_policy)
-    : decoder_{log_receiver, std::make_unique<InFileStream>(file_path),
+    : log_receiver_{log_receiver},
+      file_path_{file_path},
+      upgrade_policy_{upgrade_policy},
+      decoder_{log_receiver, std::make_unique<InFileStream>(file_path),
                upgrade_policy} {}
 
+DbnFileStore::DbnFileStore(ILogReceiver* log_receiver,
+                           const std::filesystem::path& file_path,
+                           VersionUpgradePolicy upgrade_policy, DbnFileIndex index)
+    : DbnFileStore{log_receiver, file_path, upgrade_policy} {
+  index_ = std::move(index);
+}
+
 void DbnFileStore::Replay(const MetadataCallback& metadata_callback,
                           const RecordCallback& record_callback) {
-  auto metadata = decoder_.DecodeMetadata();
+  MaybeDecodeMetadata();
   if (metadata_callback) {
-    metadata_callback(std::move(metadata));
+    metadata_callback(std::move(metadata_));
   }
   const databento::Record* record;
-  while ((record = decoder_.DecodeRecord()) != nullptr) {
+  while ((record = NextRecord()) != nullptr) {
     if (record_callback(*record) == KeepGoing::Stop) {
       break;
     }
@@ -42,12 +55,57 @@ const databento::Metadata& DbnFileStore::GetMetadata() {
 
 const databento::Record* DbnFileStore::NextRecord() {
   MaybeDecodeMetadata();
+  if (next_record_) {
+    return std::exchange(next_record_, nullptr);
+  }
+  if (!is_at_records_) {
+    // The metadata came from the index, but still needs to be read past
+    decoder_.DecodeMetadata();
+    is_at_records_ = true;
+  }
   return decoder_.DecodeRecord();
 }
 
+void DbnFileStore::Seek(UnixNanos start) {
+  MaybeDecodeMetadata();
+  next_record_ = nullptr;
+  if (index_) {
+    const auto& entries = index_->entries;
+    // Records at `start` may precede the first entry at `start`
+    const auto it = std::partition_point(
+        entries.begin(), entries.end(),
+        [start](const DbnFileIndex::Entry& entry) { return entry.index_ts < start; });
+    if (it == entries.begin()) {
+      decoder_ = DbnDecoder{log_receiver_, std::make_unique<InFileStream>(file_path_),
+                            upgrade_policy_};
+      is_at_records_ = false;
+    } else {
+      auto input = std::make_unique<InFileStream>(file_path_);
+      input->Seek(std::prev(it)->offset);
+      decoder_ = DbnDecoder{log_receiver_, std::move(input), upgrade_policy_,
+                            index_->compression, index_->metadata};
+      is_at_records_ = true;
+    }
+  }
+  const databento::Record* record;
+  while ((record = NextRecord()) != nullptr) {
+    if (record->IndexTs() >= start) {
+      next_record_ = record;
+      return;
+    }
+  }
+}
+
 void DbnFileStore::MaybeDecodeMetadata() {
-  if (!has_decoded_metadata_) {
+  if (has_decoded_metadata_) {
+    return;
+  }
+  if (index_) {
+    metadata_ = index_->metadata;
+    metadata_.Upgrade(upgrade_policy_);
+  } else {
     metadata_ = decoder_.DecodeMetadata();
-    has_decoded_metadata_ = true;
+    is_at_records_ = true;
   }
+  has_decoded_metadata_ = true;
 }
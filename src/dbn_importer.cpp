@@ -0,0 +1,642 @@
+#include "databento/dbn_importer.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>  // find_if
+#include <charconv>   // from_chars
+#include <chrono>
+#include <cstddef>  // offsetof
+#include <cstring>  // memcpy
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>  // make_shared, make_unique, unique_ptr
+#include <string_view>
+#include <system_error>  // errc
+#include <type_traits>   // is_same_v
+#include <unordered_map>
+#include <utility>  // move
+
+#include "databento/constants.hpp"  // kDbnVersion, kSymbolCstrLen, kUndefPrice
+#include "databento/dbn_encoder.hpp"
+#include "databento/detail/worker_pool.hpp"
+#include "databento/detail/zstd_stream.hpp"
+#include "databento/exceptions.hpp"  // Exception, InvalidArgumentError
+#include "databento/file_stream.hpp"
+#include "databento/flag_set.hpp"
+#include "databento/pretty.hpp"  // ParsePx
+#include "databento/record.hpp"
+
+using databento::DbnImporter;
+
+namespace {
+using databento::Action;
+using databento::BidAskPair;
+using databento::FlagSet;
+using databento::RecordHeader;
+using databento::Schema;
+using databento::Side;
+using databento::TimeDeltaNanos;
+using databento::UnixNanos;
+
+constexpr UnixNanos kUndefTs{std::chrono::nanoseconds{databento::kUndefTimestamp}};
+
+[[noreturn]] void ThrowInvalidCell(std::string_view cell, const char* expected) {
+  throw databento::InvalidArgumentError{
+      "DbnImporter::Import", "input",
+      std::string{"expected "} + expected + ", got '" + std::string{cell} + '\''};
+}
+
+template <typename T>
+void ParseInteger(std::string_view cell, T& out) {
+  const char* end = cell.data() + cell.size();
+  const auto res = std::from_chars(cell.data(), end, out);
+  if (res.ec != std::errc{} || res.ptr != end) {
+    ThrowInvalidCell(cell, "an integer");
+  }
+}
+
+UnixNanos ParseTimestamp(std::string_view cell) {
+  if (cell.empty()) {
+    return kUndefTs;
+  }
+  if (cell.find_first_not_of("0123456789") == std::string_view::npos) {
+    std::uint64_t count;
+    ParseInteger(cell, count);
+    return UnixNanos{std::chrono::nanoseconds{count}};
+  }
+  return databento::ParseIso8601(cell);
+}
+
+std::int64_t ParsePrice(std::string_view cell, bool pretty_px) {
+  if (cell.empty()) {
+    return databento::kUndefPrice;
+  }
+  if (pretty_px) {
+    return databento::pretty::ParsePx(cell);
+  }
+  std::int64_t res;
+  ParseInteger(cell, res);
+  return res;
+}
+
+template <typename E>
+E ParseCharEnum(std::string_view cell, std::string_view valid) {
+  if (cell.size() != 1 || valid.find(cell[0]) == std::string_view::npos) {
+    ThrowInvalidCell(cell, "one of the characters in the schema");
+  }
+  return static_cast<E>(cell[0]);
+}
+
+// Parses `cell` into the record field at `field`.
+using FieldParser = void (*)(std::string_view cell, bool pretty_px, std::byte* field);
+
+template <typename T>
+void ParseField(std::string_view cell, [[maybe_unused]] bool pretty_px,
+                std::byte* field) {
+  T& out = *reinterpret_cast<T*>(field);
+  if constexpr (std::is_same_v<T, UnixNanos>) {
+    out = ParseTimestamp(cell);
+  } else if constexpr (std::is_same_v<T, std::int64_t>) {
+    // All signed 64-bit fields of the supported records are prices
+    out = ParsePrice(cell, pretty_px);
+  } else if constexpr (std::is_same_v<T, TimeDeltaNanos>) {
+    TimeDeltaNanos::rep count;
+    ParseInteger(cell, count);
+    out = TimeDeltaNanos{count};
+  } else if constexpr (std::is_same_v<T, FlagSet>) {
+    FlagSet::Repr raw;
+    ParseInteger(cell, raw);
+    out = FlagSet{raw};
+  } else if constexpr (std::is_same_v<T, Action>) {
+    out = ParseCharEnum<Action>(cell, "ACFMNRT");
+  } else if constexpr (std::is_same_v<T, Side>) {
+    out = ParseCharEnum<Side>(cell, "ABN");
+  } else {
+    ParseInteger(cell, out);
+  }
+}
+
+struct FieldDesc {
+  std::string_view name;
+  // The byte offset of the field within the record.
+  std::size_t offset;
+  FieldParser parse;
+};
+
+class FieldListBuilder {
+ public:
+  explicit FieldListBuilder(const void* rec)
+      : rec_{static_cast<const std::byte*>(rec)} {}
+
+  template <typename T>
+  FieldListBuilder& Add(std::string_view name, const T& field) {
+    const auto offset = reinterpret_cast<const std::byte*>(&field) - rec_;
+    fields_.push_back({name, static_cast<std::size_t>(offset), &ParseField<T>});
+    return *this;
+  }
+
+  FieldListBuilder& AddHeader(const RecordHeader& hd) {
+    return Add("ts_event", hd.ts_event)
+        .Add("publisher_id", hd.publisher_id)
+        .Add("instrument_id", hd.instrument_id);
+  }
+
+  FieldListBuilder& AddLevel(const BidAskPair& level) {
+    return Add("bid_px_00", level.bid_px)
+        .Add("ask_px_00", level.ask_px)
+        .Add("bid_sz_00", level.bid_sz)
+        .Add("ask_sz_00", level.ask_sz)
+        .Add("bid_ct_00", level.bid_ct)
+        .Add("ask_ct_00", level.ask_ct);
+  }
+
+  std::vector<FieldDesc> Build() { return std::move(fields_); }
+
+ private:
+  const std::byte* rec_;
+  std::vector<FieldDesc> fields_;
+};
+
+// The fields of the record type of a schema and the record that's updated with
+// each line of input.
+struct SchemaLayout {
+  template <typename R>
+  SchemaLayout(const R& rec, std::vector<FieldDesc> field_descs)
+      : default_record(sizeof(R)), fields{std::move(field_descs)} {
+    std::memcpy(default_record.data(), &rec, sizeof(R));
+  }
+
+  const FieldDesc* Find(std::string_view name) const {
+    const auto it = std::find_if(fields.begin(), fields.end(),
+                                 [name](const FieldDesc& f) { return f.name == name; });
+    return it == fields.end() ? nullptr : &*it;
+  }
+
+  std::vector<std::byte> default_record;
+  std::vector<FieldDesc> fields;
+};
+
+template <typename R>
+RecordHeader DefaultHeader(Schema schema, std::uint16_t publisher_id) {
+  return {sizeof(R) / RecordHeader::kLengthMultiplier,
+          databento::Record::RTypeFromSchema(schema), publisher_id, 0, kUndefTs};
+}
+
+template <typename R>
+void SetBookDefaults(R& rec) {
+  rec.price = databento::kUndefPrice;
+  rec.action = Action::None;
+  rec.side = Side::None;
+  rec.ts_recv = kUndefTs;
+}
+
+SchemaLayout BuildLayout(Schema schema, std::uint16_t publisher_id) {
+  switch (schema) {
+    case Schema::Mbo: {
+      databento::MboMsg rec{};
+      rec.hd = DefaultHeader<databento::MboMsg>(schema, publisher_id);
+      SetBookDefaults(rec);
+      return {rec, FieldListBuilder{&rec}
+                       .AddHeader(rec.hd)
+                       .Add("order_id", rec.order_id)
+                       .Add("price", rec.price)
+                       .Add("size", rec.size)
+                       .Add("flags", rec.flags)
+                       .Add("channel_id", rec.channel_id)
+                       .Add("action", rec.action)
+                       .Add("side", rec.side)
+                       .Add("ts_recv", rec.ts_recv)
+                       .Add("ts_in_delta", rec.ts_in_delta)
+                       .Add("sequence", rec.sequence)
+                       .Build()};
+    }
+    case Schema::Trades: {
+      databento::TradeMsg rec{};
+      rec.hd = DefaultHeader<databento::TradeMsg>(schema, publisher_id);
+      SetBookDefaults(rec);
+      return {rec, FieldListBuilder{&rec}
+                       .AddHeader(rec.hd)
+                       .Add("price", rec.price)
+                       .Add("size", rec.size)
+                       .Add("action", rec.action)
+                       .Add("side", rec.side)
+                       .Add("flags", rec.flags)
+                       .Add("depth", rec.depth)
+                       .Add("ts_recv", rec.ts_recv)
+                       .Add("ts_in_delta", rec.ts_in_delta)
+                       .Add("sequence", rec.sequence)
+                       .Build()};
+    }
+    case Schema::Mbp1:
+    case Schema::Tbbo: {
+      databento::Mbp1Msg rec{};
+      rec.hd = DefaultHeader<databento::Mbp1Msg>(schema, publisher_id);
+      SetBookDefaults(rec);
+      rec.levels[0].bid_px = databento::kUndefPrice;
+      rec.levels[0].ask_px = databento::kUndefPrice;
+      return {rec, FieldListBuilder{&rec}
+                       .AddHeader(rec.hd)
+                       .Add("price", rec.price)
+                       .Add("size", rec.size)
+                       .Add("action", rec.action)
+                       .Add("side", rec.side)
+                       .Add("flags", rec.flags)
+                       .Add("depth", rec.depth)
+                       .Add("ts_recv", rec.ts_recv)
+                       .Add("ts_in_delta", rec.ts_in_delta)
+                       .Add("sequence", rec.sequence)
+                       .AddLevel(rec.levels[0])
+                       .Build()};
+    }
+    case Schema::Ohlcv1S:
+    case Schema::Ohlcv1M:
+    case Schema::Ohlcv1H:
+    case Schema::Ohlcv1D: {
+      databento::OhlcvMsg rec{};
+      rec.hd = DefaultHeader<databento::OhlcvMsg>(schema, publisher_id);
+      rec.open = databento::kUndefPrice;
+      rec.high = databento::kUndefPrice;
+      rec.low = databento::kUndefPrice;
+      rec.close = databento::kUndefPrice;
+      return {rec, FieldListBuilder{&rec}
+                       .AddHeader(rec.hd)
+                       .Add("open", rec.open)
+                       .Add("high", rec.high)
+                       .Add("low", rec.low)
+                       .Add("close", rec.close)
+                       .Add("volume", rec.volume)
+                       .Build()};
+    }
+    default: {
+      throw databento::InvalidArgumentError{
+          "DbnImporter", "options.schema",
+          std::string{"importing "} + databento::ToString(schema) +
+              " isn't supported"};
+    }
+  }
+}
+
+// Returns the next CSV field of `line` starting at `pos` and advances `pos`
+// past the following delimiter. Surrounding quotes are removed, but escaped
+// quotes aren't unescaped since no record field can contain them.
+std::string_view NextCsvField(std::string_view line, std::size_t& pos, char delimiter) {
+  if (pos < line.size() && line[pos] == '"') {
+    const auto start = pos + 1;
+    auto end = start;
+    while (true) {
+      end = line.find('"', end);
+      if (end == std::string_view::npos) {
+        throw databento::InvalidArgumentError{"DbnImporter::Import", "input",
+                                              "unterminated quoted field"};
+      }
+      // A doubled quote is an escaped quote
+      if (end + 1 < line.size() && line[end + 1] == '"') {
+        end += 2;
+        continue;
+      }
+      break;
+    }
+    pos = end + 1;
+    if (pos < line.size() && line[pos] != delimiter) {
+      throw databento::InvalidArgumentError{"DbnImporter::Import", "input",
+                                            "expected delimiter after quoted field"};
+    }
+    // Skip the delimiter, or move past the end if this was the last field
+    ++pos;
+    return line.substr(start, end - start);
+  }
+  const auto end = std::min(line.find(delimiter, pos), line.size());
+  const auto res = line.substr(pos, end - pos);
+  pos = end + 1;
+  return res;
+}
+
+// Returns the input name of each field.
+std::unordered_map<std::string, const FieldDesc*> InputNames(
+    const SchemaLayout& layout,
+    const std::map<std::string, std::string>& column_names) {
+  std::unordered_map<std::string, const FieldDesc*> res;
+  for (const auto& field : layout.fields) {
+    const auto it = column_names.find(std::string{field.name});
+    res.emplace(it == column_names.end() ? std::string{field.name} : it->second,
+                &field);
+  }
+  return res;
+}
+
+struct ChunkResult {
+  std::vector<std::byte> records;
+  std::size_t line_count{};
+  // If `error` isn't empty, the index of the line within the chunk that
+  // couldn't be parsed.
+  std::size_t error_line{};
+  std::string error;
+};
+
+// Parses blocks of whole lines to records. Shared between the worker threads
+// so it must not be modified after construction.
+class ChunkParser {
+ public:
+  ChunkParser(const databento::DbnImportOptions& options, SchemaLayout layout)
+      : encoding_{options.encoding},
+        delimiter_{options.delimiter},
+        pretty_px_{options.pretty_px},
+        layout_{std::move(layout)},
+        input_names_{InputNames(layout_, options.column_names)},
+        ts_recv_{layout_.Find("ts_recv")} {}
+
+  // Maps the columns of the CSV header `line` to fields.
+  void SetCsvHeader(std::string_view line) {
+    std::size_t pos = 0;
+    while (pos <= line.size()) {
+      const auto name = NextCsvField(line, pos, delimiter_);
+      const auto it = input_names_.find(std::string{name});
+      columns_.push_back(it == input_names_.end() ? nullptr : it->second);
+    }
+    const auto* ts_event = layout_.Find("ts_event");
+    if (std::find(columns_.begin(), columns_.end(), ts_event) == columns_.end()) {
+      throw databento::InvalidArgumentError{"DbnImporter::Import", "input",
+                                            "missing ts_event column"};
+    }
+  }
+
+  std::size_t RecordSize() const { return layout_.default_record.size(); }
+
+  ChunkResult Parse(std::string_view chunk) const {
+    ChunkResult res;
+    const auto record_size = RecordSize();
+    // Rough estimate to avoid most reallocations
+    res.records.reserve(chunk.size() / 32 * record_size);
+    std::size_t pos = 0;
+    try {
+      while (pos < chunk.size()) {
+        auto end = chunk.find('\n', pos);
+        if (end == std::string_view::npos) {
+          end = chunk.size();
+        }
+        auto line = chunk.substr(pos, end - pos);
+        pos = end + 1;
+        if (!line.empty() && line.back() == '\r') {
+          line.remove_suffix(1);
+        }
+        if (!line.empty()) {
+          const auto offset = res.records.size();
+          res.records.resize(offset + record_size);
+          std::byte* rec = res.records.data() + offset;
+          std::memcpy(rec, layout_.default_record.data(), record_size);
+          if (encoding_ == databento::Encoding::Csv) {
+            ParseCsvLine(line, rec);
+          } else {
+            ParseJsonLine(line, rec);
+          }
+          FillTsRecv(rec);
+        }
+        ++res.line_count;
+      }
+    } catch (const databento::InvalidArgumentError& exc) {
+      res.error_line = res.line_count;
+      res.error = exc.Details();
+    } catch (const std::exception& exc) {
+      res.error_line = res.line_count;
+      res.error = exc.what();
+    }
+    return res;
+  }
+
+ private:
+  void ParseCsvLine(std::string_view line, std::byte* rec) const {
+    std::size_t pos = 0;
+    for (const FieldDesc* field : columns_) {
+      if (pos > line.size()) {
+        throw databento::InvalidArgumentError{"DbnImporter::Import", "input",
+                                              "too few fields"};
+      }
+      const auto cell = NextCsvField(line, pos, delimiter_);
+      if (field != nullptr) {
+        ParseCell(*field, cell, rec);
+      }
+    }
+    if (pos <= line.size()) {
+      throw databento::InvalidArgumentError{"DbnImporter::Import", "input",
+                                            "too many fields"};
+    }
+  }
+
+  void ParseJsonLine(std::string_view line, std::byte* rec) const {
+    const auto json = nlohmann::json::parse(line);
+    if (!json.is_object()) {
+      throw databento::InvalidArgumentError{"DbnImporter::Import", "input",
+                                            "expected a JSON object"};
+    }
+    ParseJsonObject(json, "", rec);
+  }
+
+  // Fields of nested objects like `hd` are treated as top-level fields and the
+  // fields of elements of `levels` are suffixed with their index, like in CSV.
+  void ParseJsonObject(const nlohmann::json& object, std::string_view suffix,
+                       std::byte* rec) const {
+    for (const auto& [key, value] : object.items()) {
+      if (value.is_object()) {
+        ParseJsonObject(value, suffix, rec);
+      } else if (value.is_array()) {
+        for (std::size_t i = 0; i < value.size(); ++i) {
+          const std::string level_suffix =
+              std::string{"_"} + static_cast<char>('0' + i / 10 % 10) +
+              static_cast<char>('0' + i % 10);
+          if (value[i].is_object()) {
+            ParseJsonObject(value[i], level_suffix, rec);
+          }
+        }
+      } else {
+        const auto it = input_names_.find(key + std::string{suffix});
+        if (it == input_names_.end()) {
+          continue;
+        }
+        if (value.is_string()) {
+          ParseCell(*it->second, value.get_ref<const std::string&>(), rec);
+        } else if (value.is_null()) {
+          ParseCell(*it->second, {}, rec);
+        } else {
+          ParseCell(*it->second, value.dump(), rec);
+        }
+      }
+    }
+  }
+
+  void ParseCell(const FieldDesc& field, std::string_view cell, std::byte* rec) const {
+    try {
+      field.parse(cell, pretty_px_, rec + field.offset);
+    } catch (const databento::InvalidArgumentError& exc) {
+      throw databento::InvalidArgumentError{
+          "DbnImporter::Import", "input",
+          "invalid " + std::string{field.name} + ": " + exc.Details()};
+    }
+  }
+
+  // A missing `ts_recv` defaults to `ts_event`.
+  void FillTsRecv(std::byte* rec) const {
+    if (ts_recv_ == nullptr) {
+      return;
+    }
+    UnixNanos ts_recv;
+    std::memcpy(&ts_recv, rec + ts_recv_->offset, sizeof(ts_recv));
+    if (ts_recv == kUndefTs) {
+      std::memcpy(rec + ts_recv_->offset, rec + offsetof(RecordHeader, ts_event),
+                  sizeof(ts_recv));
+    }
+  }
+
+  const databento::Encoding encoding_;
+  const char delimiter_;
+  const bool pretty_px_;
+  const SchemaLayout layout_;
+  const std::unordered_map<std::string, const FieldDesc*> input_names_;
+  const FieldDesc* const ts_recv_;
+  // The field of each CSV column or nullptr if the column is ignored.
+  std::vector<const FieldDesc*> columns_;
+};
+}  // namespace
+
+DbnImporter::DbnImporter(DbnImportOptions options) : options_{std::move(options)} {
+  if (options_.encoding != Encoding::Csv && options_.encoding != Encoding::Json) {
+    throw InvalidArgumentError{"DbnImporter", "options.encoding",
+                               "must be csv or json"};
+  }
+  if (options_.chunk_size == 0) {
+    throw InvalidArgumentError{"DbnImporter", "options.chunk_size", "must be positive"};
+  }
+  const auto layout = BuildLayout(options_.schema, options_.publisher_id);
+  for (const auto& [field_name, column_name] : options_.column_names) {
+    if (layout.Find(field_name) == nullptr) {
+      throw InvalidArgumentError{
+          "DbnImporter", "options.column_names",
+          "unknown field '" + field_name + "' for " + ToString(options_.schema)};
+    }
+  }
+}
+
+databento::Metadata DbnImporter::BuildMetadata() const {
+  return Metadata{kDbnVersion,
+                  options_.dataset,
+                  options_.schema,
+                  options_.start,
+                  options_.end,
+                  0,
+                  options_.stype_in,
+                  SType::InstrumentId,
+                  false,
+                  kSymbolCstrLen,
+                  options_.symbols,
+                  {},
+                  {},
+                  {}};
+}
+
+std::uint64_t DbnImporter::Import(IReadable* input, IWritable* output) {
+  // Reads until `pending` contains at least `min_size` bytes or the end of
+  // `input`. Returns false at the end of `input`.
+  std::string pending;
+  const auto fill = [this, input, &pending](std::size_t min_size) {
+    while (pending.size() < min_size) {
+      const auto offset = pending.size();
+      pending.resize(offset + options_.chunk_size);
+      const auto read_size = input->ReadSome(
+          reinterpret_cast<std::byte*>(pending.data() + offset), options_.chunk_size);
+      pending.resize(offset + read_size);
+      if (read_size == 0) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  ChunkParser parser{options_, BuildLayout(options_.schema, options_.publisher_id)};
+  // The line number of the first line of the next chunk
+  std::size_t line_num = 1;
+  bool has_more = fill(options_.chunk_size);
+  if (options_.encoding == Encoding::Csv) {
+    auto end = pending.find('\n');
+    while (has_more && end == std::string::npos) {
+      has_more = fill(pending.size() + options_.chunk_size);
+      end = pending.find('\n');
+    }
+    std::string_view header{pending.data(), std::min(end, pending.size())};
+    if (!header.empty() && header.back() == '\r') {
+      header.remove_suffix(1);
+    }
+    parser.SetCsvHeader(header);
+    pending.erase(0, end == std::string::npos ? pending.size() : end + 1);
+    ++line_num;
+  }
+
+  std::unique_ptr<detail::ZstdCompressStream> zstd_stream;
+  if (options_.compress) {
+    zstd_stream = std::make_unique<detail::ZstdCompressStream>(output);
+    output = zstd_stream.get();
+  }
+  DbnEncoder encoder{BuildMetadata(), output};
+  std::uint64_t record_count = 0;
+  const auto record_size = parser.RecordSize();
+  const auto write_chunk = [&](ChunkResult chunk) {
+    if (!chunk.error.empty()) {
+      throw Exception{"Failed to import line " +
+                      std::to_string(line_num + chunk.error_line) + ": " +
+                      chunk.error};
+    }
+    encoder.EncodeRecords(chunk.records.data(), chunk.records.size());
+    record_count += chunk.records.size() / record_size;
+    line_num += chunk.line_count;
+  };
+
+  // Declared after `parser` so running tasks finish before it's destroyed
+  detail::WorkerPool pool{options_.num_threads};
+  // Chunks are written in the order they're read
+  std::deque<std::future<ChunkResult>> in_flight;
+  const auto max_in_flight = std::max<std::size_t>(options_.num_threads, 1) * 2;
+  while (true) {
+    auto end = pending.rfind('\n');
+    // Lines longer than `chunk_size` need more input
+    while (has_more && end == std::string::npos) {
+      has_more = fill(pending.size() + options_.chunk_size);
+      end = pending.rfind('\n');
+    }
+    if (pending.empty()) {
+      break;
+    }
+    std::string chunk;
+    if (has_more) {
+      // Keep the incomplete last line for the next chunk
+      chunk = pending.substr(0, end + 1);
+      pending.erase(0, end + 1);
+    } else {
+      chunk = std::move(pending);
+      pending.clear();
+    }
+    auto task = std::make_shared<std::packaged_task<ChunkResult()>>(
+        [&parser, chunk = std::move(chunk)] { return parser.Parse(chunk); });
+    in_flight.emplace_back(task->get_future());
+    pool.Submit([task] { (*task)(); });
+    if (in_flight.size() >= max_in_flight) {
+      write_chunk(in_flight.front().get());
+      in_flight.pop_front();
+    }
+    if (has_more) {
+      has_more = fill(options_.chunk_size);
+    }
+  }
+  while (!in_flight.empty()) {
+    write_chunk(in_flight.front().get());
+    in_flight.pop_front();
+  }
+  return record_count;
+}
+
+std::uint64_t DbnImporter::Import(const std::filesystem::path& input_path,
+                                  const std::filesystem::path& output_path) {
+  InFileStream input{input_path};
+  OutFileStream output{output_path, options_.chunk_size};
+  const auto record_count = Import(&input, &output);
+  output.Flush();
+  return record_count;
+}
@@ -4,6 +4,8 @@
 #include <sstream>
 
 #include "databento/exceptions.hpp"
+#include "databento/metrics.hpp"  // MetricCounter
+#include "metrics_hooks.hpp"
 #include "stream_op_helper.hpp"
 
 using databento::detail::Buffer;
@@ -55,6 +57,7 @@ void Buffer::Reserve(std::size_t capacity) {
   if (capacity <= Capacity()) {
     return;
   }
+  IncrementMetric(MetricCounter::BufferReallocations, 1);
   UniqueBufPtr new_buf{AlignedNew(capacity), AlignedDelete};
   const auto unread_bytes = ReadCapacity();
   std::copy(ReadBegin(), ReadEnd(), new_buf.get());
@@ -67,6 +70,7 @@ void Buffer::Reserve(std::size_t capacity) {
 void Buffer::Shift() {
   const auto unread_bytes = ReadCapacity();
   if (unread_bytes) {
+    IncrementMetric(MetricCounter::BufferShifts, 1);
     std::copy(ReadBegin(), ReadEnd(), buf_.get());
   }
   read_pos_ = buf_.get();
@@ -0,0 +1,95 @@
+#include "databento/detail/chunk_queue.hpp"
+
+#include <algorithm>  // max, min
+#include <utility>    // move
+
+using databento::detail::ChunkQueue;
+
+ChunkQueue::ChunkQueue(std::size_t num_buffers, std::size_t buffer_size)
+    : buffer_size_{buffer_size}, free_(num_buffers) {}
+
+bool ChunkQueue::Write(const char* data, std::size_t length) {
+  const auto* bytes = reinterpret_cast<const std::byte*>(data);
+  std::unique_lock<std::mutex> lock{mutex_};
+  stats_.bytes_written += length;
+  while (length > 0) {
+    if (is_cancelled_) {
+      return false;
+    }
+    // Buffers are only allocated once they're first needed
+    if (current_.capacity() == 0) {
+      if (free_.empty()) {
+        ++stats_.producer_waits;
+        cv_.wait(lock, [this] { return !free_.empty() || is_cancelled_; });
+        continue;
+      }
+      current_ = std::move(free_.back());
+      free_.pop_back();
+      current_.reserve(buffer_size_);
+    }
+    const auto copy_size = std::min(length, buffer_size_ - current_.size());
+    // `current_` is only accessed by the producer
+    lock.unlock();
+    current_.insert(current_.end(), bytes, bytes + copy_size);
+    lock.lock();
+    bytes += copy_size;
+    length -= copy_size;
+    if (current_.size() == buffer_size_ || is_consumer_waiting_) {
+      PushCurrent();
+    }
+  }
+  return !is_cancelled_;
+}
+
+void ChunkQueue::Finish(std::exception_ptr exc) {
+  const std::lock_guard<std::mutex> lock{mutex_};
+  if (!current_.empty()) {
+    PushCurrent();
+  }
+  exc_ = std::move(exc);
+  is_done_ = true;
+  cv_.notify_all();
+}
+
+bool ChunkQueue::Read(std::vector<std::byte>* chunk) {
+  std::unique_lock<std::mutex> lock{mutex_};
+  if (chunk->capacity() > 0) {
+    chunk->clear();
+    free_.emplace_back(std::move(*chunk));
+    *chunk = {};
+    cv_.notify_all();
+  }
+  if (ready_.empty() && !is_done_) {
+    is_consumer_waiting_ = true;
+    cv_.wait(lock, [this] { return !ready_.empty() || is_done_; });
+    is_consumer_waiting_ = false;
+  }
+  if (ready_.empty()) {
+    if (exc_) {
+      std::rethrow_exception(exc_);
+    }
+    return false;
+  }
+  *chunk = std::move(ready_.front());
+  ready_.pop_front();
+  ++stats_.chunks_read;
+  return true;
+}
+
+void ChunkQueue::Cancel() {
+  const std::lock_guard<std::mutex> lock{mutex_};
+  is_cancelled_ = true;
+  cv_.notify_all();
+}
+
+ChunkQueue::Stats ChunkQueue::GetStats() const {
+  const std::lock_guard<std::mutex> lock{mutex_};
+  return stats_;
+}
+
+void ChunkQueue::PushCurrent() {
+  ready_.emplace_back(std::move(current_));
+  current_ = {};
+  stats_.max_depth = std::max(stats_.max_depth, ready_.size());
+  cv_.notify_all();
+}
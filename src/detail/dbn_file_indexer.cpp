@@ -0,0 +1,91 @@
+#include "databento/detail/dbn_file_indexer.hpp"
+
+#include <cstring>  // strncmp
+#include <string>
+#include <utility>  // move
+
+#include "databento/exceptions.hpp"
+#include "databento/record.hpp"
+#include "dbn_constants.hpp"
+
+using databento::detail::DbnFileIndexer;
+
+DbnFileIndexer::DbnFileIndexer()
+    : metadata_callback_{[this](Metadata&& metadata) {
+        metadata_ = std::move(metadata);
+      }},
+      record_callback_{[this](const Record& record) {
+        if (compression_ == Compression::Zstd) {
+          if (frame_offset_) {
+            entries_.push_back({*frame_offset_, record.IndexTs()});
+            frame_offset_.reset();
+          }
+          return KeepGoing::Continue;
+        }
+        // `record` is the first unread record
+        const auto record_offset = offset_ - decoder_->UnreadBytes();
+        if (record_offset >= next_entry_offset_) {
+          entries_.push_back({record_offset, record.IndexTs()});
+          next_entry_offset_ = record_offset + kUncompressedInterval;
+        }
+        return KeepGoing::Continue;
+      }},
+      z_dstream_{::ZSTD_createDStream(), ::ZSTD_freeDStream},
+      z_out_buffer_(::ZSTD_DStreamOutSize()) {}
+
+void DbnFileIndexer::Process(const std::byte* data, std::size_t length) {
+  if (!decoder_) {
+    prefix_.insert(prefix_.end(), data, data + length);
+    if (prefix_.size() < kMagicSize) {
+      return;
+    }
+    if (std::strncmp(reinterpret_cast<const char*>(prefix_.data()), kDbnPrefix, 3) !=
+        0) {
+      compression_ = Compression::Zstd;
+    }
+    // Records are indexed as encoded, which is sufficient for `IndexTs`
+    decoder_.emplace(Compression::None, VersionUpgradePolicy::AsIs, metadata_callback_,
+                     record_callback_);
+    const auto prefix = std::move(prefix_);
+    prefix_.clear();
+    Process(prefix.data(), prefix.size());
+    return;
+  }
+  if (compression_ == Compression::Zstd) {
+    ProcessZstd(data, length);
+    return;
+  }
+  offset_ += length;
+  decoder_->Process(reinterpret_cast<const char*>(data), length);
+}
+
+void DbnFileIndexer::ProcessZstd(const std::byte* data, std::size_t length) {
+  ZSTD_inBuffer z_in_buffer{data, length, 0};
+  bool is_out_buffer_full = true;
+  // Output may remain after all the input is consumed if the buffer filled
+  while (z_in_buffer.pos < z_in_buffer.size || is_out_buffer_full) {
+    ZSTD_outBuffer z_out_buffer{z_out_buffer_.data(), z_out_buffer_.size(), 0};
+    const auto res =
+        ::ZSTD_decompressStream(z_dstream_.get(), &z_out_buffer, &z_in_buffer);
+    if (::ZSTD_isError(res)) {
+      throw DbnResponseError{std::string{"Zstd error decompressing: "} +
+                             ::ZSTD_getErrorName(res)};
+    }
+    is_out_buffer_full = z_out_buffer.pos == z_out_buffer.size;
+    decoder_->Process(reinterpret_cast<const char*>(z_out_buffer_.data()),
+                      z_out_buffer.pos);
+    // Decompression stops at the end of each frame. If the frame ended with a
+    // whole record, decoding can resume at the next one.
+    if (res == 0 && metadata_ && decoder_->UnreadBytes() == 0) {
+      frame_offset_ = offset_ + z_in_buffer.pos;
+    }
+  }
+  offset_ += length;
+}
+
+databento::DbnFileIndex DbnFileIndexer::Finish() {
+  if (!metadata_) {
+    throw DbnResponseError{"Reached the end of the DBN data before the metadata"};
+  }
+  return DbnFileIndex{compression_, std::move(*metadata_), std::move(entries_)};
+}
@@ -1,11 +1,18 @@
 #include "databento/detail/http_client.hpp"
 
-#include <chrono>   // seconds
+#include <algorithm>  // max, min
+#include <chrono>     // seconds
+#include <condition_variable>
+#include <mutex>
 #include <sstream>  // ostringstream
+#include <utility>  // move
+#include <vector>
 
 #include "databento/constants.hpp"  // kUserAgent
 #include "databento/exceptions.hpp"  // HttpResponseError, HttpRequestError, JsonResponseError
 #include "databento/log.hpp"         // ILogReceiver, LogLevel
+#include "databento/metrics.hpp"     // MetricCounter
+#include "metrics_hooks.hpp"
 
 using databento::detail::HttpClient;
 
@@ -15,45 +22,127 @@ const httplib::Headers HttpClient::kHeaders{
     {"user-agent", kUserAgent},
 };
 
+struct HttpClient::Pool {
+  Pool(std::string api_key, std::string host, std::uint16_t host_port,
+       std::size_t max_conns)
+      : key{std::move(api_key)},
+        gateway{std::move(host)},
+        port{host_port},
+        max_connections{std::max<std::size_t>(max_conns, 1)} {}
+
+  std::unique_ptr<httplib::Client> MakeClient() const;
+  void Release(std::unique_ptr<httplib::Client> client);
+
+  const std::string key;
+  const std::string gateway;
+  // 0 if the default port for `gateway` is used
+  const std::uint16_t port;
+  const std::size_t max_connections;
+  std::mutex mutex;
+  std::condition_variable cv;
+  // Most recently used last
+  std::vector<std::unique_ptr<httplib::Client>> idle;
+  std::size_t num_open{};
+};
+
+std::unique_ptr<httplib::Client> HttpClient::Pool::MakeClient() const {
+  auto client = port == 0 ? std::make_unique<httplib::Client>(gateway)
+                          : std::make_unique<httplib::Client>(gateway, port);
+  client->set_default_headers(HttpClient::kHeaders);
+  client->set_basic_auth(key, "");
+  client->set_read_timeout(kTimeout);
+  client->set_write_timeout(kTimeout);
+  client->set_keep_alive(true);
+  return client;
+}
+
+void HttpClient::Pool::Release(std::unique_ptr<httplib::Client> client) {
+  const std::lock_guard<std::mutex> lock{mutex};
+  idle.emplace_back(std::move(client));
+  cv.notify_one();
+}
+
+HttpClient::Connection::Connection(Pool* pool, std::unique_ptr<httplib::Client> client)
+    : pool_{pool}, client_{std::move(client)} {}
+
+HttpClient::Connection::~Connection() { pool_->Release(std::move(client_)); }
+
 HttpClient::HttpClient(databento::ILogReceiver* log_receiver, const std::string& key,
                        const std::string& gateway)
-    : log_receiver_{log_receiver}, client_{gateway} {
-  client_.set_default_headers(HttpClient::kHeaders);
-  client_.set_basic_auth(key, "");
-  client_.set_read_timeout(kTimeout);
-  client_.set_write_timeout(kTimeout);
-}
+    : HttpClient{log_receiver, key, gateway, 0, kDefaultMaxConnections} {}
 
 HttpClient::HttpClient(databento::ILogReceiver* log_receiver, const std::string& key,
                        const std::string& gateway, std::uint16_t port)
-    : log_receiver_{log_receiver}, client_{gateway, port} {
-  client_.set_default_headers(HttpClient::kHeaders);
-  client_.set_basic_auth(key, "");
-  client_.set_read_timeout(kTimeout);
-  client_.set_write_timeout(kTimeout);
+    : HttpClient{log_receiver, key, gateway, port, kDefaultMaxConnections} {}
+
+HttpClient::HttpClient(databento::ILogReceiver* log_receiver, const std::string& key,
+                       const std::string& gateway, std::uint16_t port,
+                       std::size_t max_connections)
+    : log_receiver_{log_receiver},
+      pool_{std::make_unique<Pool>(key, gateway, port, max_connections)} {}
+
+HttpClient::HttpClient(HttpClient&&) noexcept = default;
+HttpClient& HttpClient::operator=(HttpClient&&) noexcept = default;
+HttpClient::~HttpClient() = default;
+
+HttpClient::Connection HttpClient::Acquire() {
+  // Every request acquires a connection
+  IncrementMetric(MetricCounter::HttpRequests, 1);
+  std::unique_lock<std::mutex> lock{pool_->mutex};
+  pool_->cv.wait(lock, [this] {
+    return !pool_->idle.empty() || pool_->num_open < pool_->max_connections;
+  });
+  if (!pool_->idle.empty()) {
+    auto client = std::move(pool_->idle.back());
+    pool_->idle.pop_back();
+    return Connection{pool_.get(), std::move(client)};
+  }
+  ++pool_->num_open;
+  lock.unlock();
+  // Connecting is deferred until the first request
+  return Connection{pool_.get(), pool_->MakeClient()};
 }
 
 nlohmann::json HttpClient::GetJson(const std::string& path,
                                    const httplib::Params& params) {
-  httplib::Result res = client_.Get(path, params, httplib::Headers{});
+  const auto client = Acquire();
+  httplib::Result res = client->Get(path, params, httplib::Headers{});
   return HttpClient::CheckAndParseResponse(path, std::move(res));
 }
 
 nlohmann::json HttpClient::PostJson(const std::string& path,
                                     const httplib::Params& form_params) {
   // params will be encoded as form data
-  httplib::Result res = client_.Post(path, {}, form_params);
+  const auto client = Acquire();
+  httplib::Result res = client->Post(path, {}, form_params);
   return HttpClient::CheckAndParseResponse(path, std::move(res));
 }
 
+void HttpClient::GetJsonSax(const std::string& path, const httplib::Params& params,
+                            nlohmann::json_sax<nlohmann::json>* handler) {
+  const auto client = Acquire();
+  httplib::Result res = client->Get(path, params, httplib::Headers{});
+  HttpClient::CheckAndParseResponse(path, std::move(res), handler);
+}
+
+void HttpClient::PostJsonSax(const std::string& path,
+                             const httplib::Params& form_params,
+                             nlohmann::json_sax<nlohmann::json>* handler) {
+  const auto client = Acquire();
+  httplib::Result res = client->Post(path, {}, form_params);
+  HttpClient::CheckAndParseResponse(path, std::move(res), handler);
+}
+
 void HttpClient::GetRawStream(const std::string& path, const httplib::Params& params,
                               const httplib::ContentReceiver& callback) {
   const std::string full_path = httplib::append_query_params(path, params);
   std::string err_body{};
   int err_status{};
-  const httplib::Result res = client_.Get(
+  const auto client = Acquire();
+  const httplib::Result res = client->Get(
       full_path, MakeStreamResponseHandler(err_status),
       [&callback, &err_body, &err_status](const char* data, std::size_t length) {
+        IncrementMetric(MetricCounter::HttpBytesRead, length);
         // if an error response was received, read all content into
         // err_body
         if (err_status > 0) {
@@ -65,6 +154,66 @@ void HttpClient::GetRawStream(const std::string& path, const httplib::Params& pa
   CheckStatusAndStreamRes(path, err_status, std::move(err_body), res);
 }
 
+void HttpClient::GetRangeStream(const std::string& path, std::uint64_t offset,
+                                std::uint64_t end,
+                                const httplib::ContentReceiver& callback) {
+  httplib::Headers headers{};
+  if (offset > 0 || end > 0) {
+    std::ostringstream range;
+    range << "bytes=" << offset << '-';
+    if (end > 0) {
+      range << end - 1;
+    }
+    headers.emplace("Range", range.str());
+  }
+  std::string err_body{};
+  int err_status{};
+  // The offset of the next byte received within the resource
+  std::uint64_t pos{};
+  const auto client = Acquire();
+  const httplib::Result res = client->Get(
+      path, headers,
+      [this, &err_status, &pos, offset](const httplib::Response& resp) {
+        if (HttpClient::IsErrorStatus(resp.status)) {
+          err_status = resp.status;
+        } else if (resp.status == 206) {
+          // Partial Content: the server honored the range
+          pos = offset;
+        }
+        CheckWarnings(resp);
+        return true;
+      },
+      [&callback, &err_body, &err_status, &pos, offset, end](const char* data,
+                                                             std::size_t length) {
+        IncrementMetric(MetricCounter::HttpBytesRead, length);
+        if (err_status > 0) {
+          err_body.append(data, length);
+          return true;
+        }
+        if (pos < offset) {
+          const std::size_t skip = std::min<std::uint64_t>(offset - pos, length);
+          data += skip;
+          length -= skip;
+          pos += skip;
+          if (length == 0) {
+            return true;
+          }
+        }
+        if (end > 0 && pos + length > end) {
+          const std::size_t remaining = end - pos;
+          pos = end;
+          // Stop receiving since the rest of the data is outside the range
+          if (remaining > 0) {
+            callback(data, remaining);
+          }
+          return false;
+        }
+        pos += length;
+        return callback(data, length);
+      });
+  CheckStatusAndStreamRes(path, err_status, std::move(err_body), res);
+}
+
 void HttpClient::PostRawStream(const std::string& path,
                                const httplib::Params& form_params,
                                const httplib::ContentReceiver& callback) {
@@ -79,6 +228,7 @@ void HttpClient::PostRawStream(const std::string& path,
   req.content_receiver = [&callback, &err_body, &err_status](
                              const char* data, std::size_t length, std::uint64_t,
                              std::uint64_t) {
+    IncrementMetric(MetricCounter::HttpBytesRead, length);
     // if an error response was received, read all content into
     // err_body
     if (err_status > 0) {
@@ -87,8 +237,9 @@ void HttpClient::PostRawStream(const std::string& path,
     }
     return callback(data, length);
   };
+  const auto client = Acquire();
   // NOLINTNEXTLINE(clang-analyzer-unix.BlockInCriticalSection): dependency code
-  const httplib::Result res = client_.send(req);
+  const httplib::Result res = client->send(req);
   CheckStatusAndStreamRes(path, err_status, std::move(err_body), res);
 }
 
@@ -118,20 +269,34 @@ void HttpClient::CheckStatusAndStreamRes(const std::string& path, int status_cod
 
 nlohmann::json HttpClient::CheckAndParseResponse(const std::string& path,
                                                  httplib::Result&& res) const {
+  auto& response = CheckResponse(path, res);
+  try {
+    return nlohmann::json::parse(std::move(response.body));
+  } catch (const nlohmann::json::parse_error& parse_err) {
+    throw JsonResponseError::ParseError(path, parse_err);
+  }
+}
+
+void HttpClient::CheckAndParseResponse(
+    const std::string& path, httplib::Result&& res,
+    nlohmann::json_sax<nlohmann::json>* handler) const {
+  const auto& response = CheckResponse(path, res);
+  nlohmann::json::sax_parse(response.body, handler);
+}
+
+httplib::Response& HttpClient::CheckResponse(const std::string& path,
+                                             httplib::Result& res) const {
   if (res.error() != httplib::Error::Success) {
     throw HttpRequestError{path, res.error()};
   }
   auto& response = res.value();
+  IncrementMetric(MetricCounter::HttpBytesRead, response.body.size());
   const auto status_code = response.status;
   if (HttpClient::IsErrorStatus(status_code)) {
     throw HttpResponseError{path, status_code, std::move(response.body)};
   }
   CheckWarnings(response);
-  try {
-    return nlohmann::json::parse(std::move(response.body));
-  } catch (const nlohmann::json::parse_error& parse_err) {
-    throw JsonResponseError::ParseError(path, parse_err);
-  }
+  return response;
 }
 
 void HttpClient::CheckWarnings(const httplib::Response& response) const {
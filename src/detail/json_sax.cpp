@@ -0,0 +1,585 @@
+#include "databento/detail/json_sax.hpp"
+
+#include <date/date.h>
+
+#include <algorithm>  // all_of
+#include <array>
+#include <utility>  // move
+
+#include "databento/detail/json_helpers.hpp"  // CheckedAt
+#include "databento/exceptions.hpp"           // Exception, JsonResponseError
+
+using databento::detail::BatchJobsSax;
+using databento::detail::CheckedAt;
+using databento::detail::JsonSaxHandler;
+using databento::detail::SymbologyResolutionSax;
+
+namespace {
+using databento::BatchJob;
+using databento::JsonResponseError;
+
+std::string StringOrEmpty(std::string_view endpoint, std::string_view key,
+                          nlohmann::json&& value) {
+  if (value.is_null()) {
+    return {};
+  }
+  if (!value.is_string()) {
+    throw JsonResponseError::TypeMismatch(endpoint, std::string{key} + " string",
+                                          value);
+  }
+  return std::move(value.get_ref<std::string&>());
+}
+
+std::uint64_t UnsignedOrZero(std::string_view endpoint, std::string_view key,
+                             nlohmann::json&& value) {
+  if (value.is_null()) {
+    return 0;
+  }
+  if (!value.is_number_unsigned()) {
+    throw JsonResponseError::TypeMismatch(
+        endpoint, std::string{key} + " unsigned number", value);
+  }
+  return value.get<std::uint64_t>();
+}
+
+double NumberOrZero(std::string_view endpoint, std::string_view key,
+                    nlohmann::json&& value) {
+  if (value.is_null()) {
+    return 0;
+  }
+  if (!value.is_number()) {
+    throw JsonResponseError::TypeMismatch(endpoint, std::string{key} + " number",
+                                          value);
+  }
+  return value.get<double>();
+}
+
+bool Boolean(std::string_view endpoint, std::string_view key, nlohmann::json&& value) {
+  if (!value.is_boolean()) {
+    throw JsonResponseError::TypeMismatch(endpoint, std::string{key} + " bool", value);
+  }
+  return value.get<bool>();
+}
+
+template <typename T>
+T FromJsonString(std::string_view endpoint, std::string_view key,
+                 nlohmann::json&& value) {
+  if (!value.is_string()) {
+    throw JsonResponseError::TypeMismatch(endpoint, std::string{key} + " string",
+                                          value);
+  }
+  return databento::FromString<T>(value.get_ref<const std::string&>());
+}
+
+template <typename T, T kNullValue>
+T FromJsonStringOrNull(std::string_view endpoint, std::string_view key,
+                       nlohmann::json&& value) {
+  if (value.is_null()) {
+    return kNullValue;
+  }
+  if (!value.is_string()) {
+    throw JsonResponseError::TypeMismatch(
+        endpoint, std::string{key} + " null or string", value);
+  }
+  return databento::FromString<T>(value.get_ref<const std::string&>());
+}
+
+// Only called with arrays from `ParseBatchJob`. `BatchJobsSax` handles them
+// itself.
+std::vector<std::string> Symbols(std::string_view endpoint, std::string_view key,
+                                 nlohmann::json&& value) {
+  // if there's only one symbol, it returns a string not an array
+  if (value.is_string()) {
+    return {std::move(value.get_ref<std::string&>())};
+  }
+  if (!value.is_array()) {
+    throw JsonResponseError::TypeMismatch(endpoint, std::string{key} + " array",
+                                          value);
+  }
+  std::vector<std::string> res;
+  res.reserve(value.size());
+  for (auto& symbol : value) {
+    if (!symbol.is_string()) {
+      throw JsonResponseError::TypeMismatch(endpoint, "nested string", key, symbol);
+    }
+    res.emplace_back(std::move(symbol.get_ref<std::string&>()));
+  }
+  return res;
+}
+
+template <auto kMember, auto kConvert>
+void SetField(std::string_view endpoint, std::string_view key, nlohmann::json&& value,
+              BatchJob* job) {
+  job->*kMember = kConvert(endpoint, key, std::move(value));
+}
+
+struct BatchJobField {
+  std::string_view name;
+  void (*set)(std::string_view endpoint, std::string_view key, nlohmann::json&& value,
+              BatchJob* job);
+};
+
+using databento::Compression;
+using databento::Delivery;
+using databento::Encoding;
+using databento::JobState;
+using databento::Schema;
+using databento::SplitDuration;
+using databento::SType;
+
+// In the order of `BatchJob`'s members
+constexpr std::array<BatchJobField, 30> kBatchJobFields{{
+    {"id", &SetField<&BatchJob::id, &StringOrEmpty>},
+    {"user_id", &SetField<&BatchJob::user_id, &StringOrEmpty>},
+    {"cost_usd", &SetField<&BatchJob::cost_usd, &NumberOrZero>},
+    {"dataset", &SetField<&BatchJob::dataset, &StringOrEmpty>},
+    {"symbols", &SetField<&BatchJob::symbols, &Symbols>},
+    {"stype_in", &SetField<&BatchJob::stype_in, &FromJsonString<SType>>},
+    {"stype_out", &SetField<&BatchJob::stype_out, &FromJsonString<SType>>},
+    {"schema", &SetField<&BatchJob::schema, &FromJsonString<Schema>>},
+    {"start", &SetField<&BatchJob::start, &StringOrEmpty>},
+    {"end", &SetField<&BatchJob::end, &StringOrEmpty>},
+    {"limit", &SetField<&BatchJob::limit, &UnsignedOrZero>},
+    {"encoding", &SetField<&BatchJob::encoding, &FromJsonString<Encoding>>},
+    {"compression",
+     &SetField<&BatchJob::compression,
+               &FromJsonStringOrNull<Compression, Compression::None>>},
+    {"pretty_px", &SetField<&BatchJob::pretty_px, &Boolean>},
+    {"pretty_ts", &SetField<&BatchJob::pretty_ts, &Boolean>},
+    {"map_symbols", &SetField<&BatchJob::map_symbols, &Boolean>},
+    {"split_duration",
+     &SetField<&BatchJob::split_duration,
+               &FromJsonStringOrNull<SplitDuration, SplitDuration::None>>},
+    {"split_size", &SetField<&BatchJob::split_size, &UnsignedOrZero>},
+    {"split_symbols", &SetField<&BatchJob::split_symbols, &Boolean>},
+    {"delivery", &SetField<&BatchJob::delivery, &FromJsonString<Delivery>>},
+    {"record_count", &SetField<&BatchJob::record_count, &UnsignedOrZero>},
+    {"billed_size", &SetField<&BatchJob::billed_size, &UnsignedOrZero>},
+    {"actual_size", &SetField<&BatchJob::actual_size, &UnsignedOrZero>},
+    {"package_size", &SetField<&BatchJob::package_size, &UnsignedOrZero>},
+    {"state", &SetField<&BatchJob::state, &FromJsonString<JobState>>},
+    {"ts_received", &SetField<&BatchJob::ts_received, &StringOrEmpty>},
+    {"ts_queued", &SetField<&BatchJob::ts_queued, &StringOrEmpty>},
+    {"ts_process_start", &SetField<&BatchJob::ts_process_start, &StringOrEmpty>},
+    {"ts_process_done", &SetField<&BatchJob::ts_process_done, &StringOrEmpty>},
+    {"ts_expiration", &SetField<&BatchJob::ts_expiration, &StringOrEmpty>},
+}};
+
+bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+int ParseDigits(const std::string& str, std::size_t pos, std::size_t count) {
+  int res = 0;
+  for (std::size_t i = pos; i < pos + count; ++i) {
+    res = res * 10 + (str[i] - '0');
+  }
+  return res;
+}
+
+// Parses a YYYY-MM-DD date without the overhead of a stream.
+date::year_month_day ParseDate(std::string_view endpoint, const nlohmann::json& value) {
+  if (value.is_string()) {
+    const auto& str = value.get_ref<const std::string&>();
+    if (str.size() == 10 && str[4] == '-' && str[7] == '-' &&
+        std::all_of(str.begin(), str.begin() + 4, IsDigit) && IsDigit(str[5]) &&
+        IsDigit(str[6]) && IsDigit(str[8]) && IsDigit(str[9])) {
+      const date::year_month_day res{
+          date::year{ParseDigits(str, 0, 4)},
+          date::month{static_cast<unsigned>(ParseDigits(str, 5, 2))},
+          date::day{static_cast<unsigned>(ParseDigits(str, 8, 2))}};
+      if (res.ok()) {
+        return res;
+      }
+    }
+  }
+  throw JsonResponseError::TypeMismatch(endpoint, "YYYY-MM-DD date string", value);
+}
+}  // namespace
+
+bool JsonSaxHandler::null() { return OnScalar(nullptr); }
+bool JsonSaxHandler::boolean(bool val) { return OnScalar(val); }
+bool JsonSaxHandler::number_integer(number_integer_t val) { return OnScalar(val); }
+bool JsonSaxHandler::number_unsigned(number_unsigned_t val) { return OnScalar(val); }
+bool JsonSaxHandler::number_float(number_float_t val, const string_t&) {
+  return OnScalar(val);
+}
+bool JsonSaxHandler::string(string_t& val) { return OnScalar(std::move(val)); }
+bool JsonSaxHandler::binary(binary_t& val) {
+  return OnScalar(nlohmann::json::binary(std::move(val)));
+}
+
+bool JsonSaxHandler::start_object(std::size_t) {
+  if (!SkipStart()) {
+    OnStartObject();
+  }
+  return true;
+}
+
+bool JsonSaxHandler::key(string_t& val) {
+  if (skip_depth_ == 0) {
+    OnKey(std::move(val));
+  }
+  return true;
+}
+
+bool JsonSaxHandler::end_object() {
+  if (!SkipEnd()) {
+    OnEndObject();
+  }
+  return true;
+}
+
+bool JsonSaxHandler::start_array(std::size_t) {
+  if (!SkipStart()) {
+    OnStartArray();
+  }
+  return true;
+}
+
+bool JsonSaxHandler::end_array() {
+  if (!SkipEnd()) {
+    OnEndArray();
+  }
+  return true;
+}
+
+bool JsonSaxHandler::parse_error(std::size_t, const std::string&,
+                                 const nlohmann::detail::exception& exc) {
+  const auto* parse_err = dynamic_cast<const nlohmann::json::parse_error*>(&exc);
+  if (parse_err != nullptr) {
+    throw JsonResponseError::ParseError(endpoint_, *parse_err);
+  }
+  throw Exception{exc.what()};
+}
+
+bool JsonSaxHandler::SkipStart() {
+  if (skip_depth_ > 0 || is_skipping_value_) {
+    is_skipping_value_ = false;
+    ++skip_depth_;
+    return true;
+  }
+  return false;
+}
+
+bool JsonSaxHandler::SkipEnd() {
+  if (skip_depth_ > 0) {
+    --skip_depth_;
+    return true;
+  }
+  return false;
+}
+
+bool JsonSaxHandler::OnScalar(nlohmann::json&& value) {
+  if (skip_depth_ > 0) {
+    return true;
+  }
+  if (is_skipping_value_) {
+    is_skipping_value_ = false;
+    return true;
+  }
+  OnValue(std::move(value));
+  return true;
+}
+
+SymbologyResolutionSax::SymbologyResolutionSax(std::string_view endpoint,
+                                               SType stype_in, SType stype_out)
+    : JsonSaxHandler{endpoint}, res_{{}, {}, {}, stype_in, stype_out} {}
+
+void SymbologyResolutionSax::OnValue(nlohmann::json&& value) {
+  switch (state_) {
+    case State::Start: {
+      throw JsonResponseError::TypeMismatch(endpoint_, "object", value);
+    }
+    case State::Root: {
+      throw JsonResponseError::TypeMismatch(
+          endpoint_, key_ == "result" ? "mappings object" : key_ + " array", value);
+    }
+    case State::Mappings: {
+      throw JsonResponseError::TypeMismatch(endpoint_, "array", symbol_, value);
+    }
+    case State::Intervals: {
+      throw JsonResponseError::MissingKey(endpoint_, "d0");
+    }
+    case State::Interval: {
+      OnIntervalValue(std::move(value));
+      break;
+    }
+    case State::Partial:
+    case State::NotFound: {
+      auto& symbols = state_ == State::Partial ? res_.partial : res_.not_found;
+      if (!value.is_string()) {
+        throw JsonResponseError::TypeMismatch(endpoint_, "nested string",
+                                              symbols.size(), value);
+      }
+      symbols.emplace_back(std::move(value.get_ref<std::string&>()));
+      break;
+    }
+    case State::Done: {
+      break;
+    }
+  }
+}
+
+void SymbologyResolutionSax::OnIntervalValue(nlohmann::json&& value) {
+  if (key_ == "d0") {
+    interval_.start_date = ParseDate(endpoint_, value);
+    interval_seen_.set(0);
+  } else if (key_ == "d1") {
+    interval_.end_date = ParseDate(endpoint_, value);
+    interval_seen_.set(1);
+  } else {
+    if (!value.is_string()) {
+      throw JsonResponseError::TypeMismatch(endpoint_, "s string", value);
+    }
+    interval_.symbol = std::move(value.get_ref<std::string&>());
+    interval_seen_.set(2);
+  }
+}
+
+void SymbologyResolutionSax::OnStartObject() {
+  switch (state_) {
+    case State::Start: {
+      state_ = State::Root;
+      break;
+    }
+    case State::Intervals: {
+      interval_ = {};
+      interval_seen_.reset();
+      state_ = State::Interval;
+      break;
+    }
+    case State::Root: {
+      if (key_ == "result") {
+        res_.mappings.clear();
+        state_ = State::Mappings;
+        break;
+      }
+      OnValue(nlohmann::json::object());
+      break;
+    }
+    default: {
+      OnValue(nlohmann::json::object());
+    }
+  }
+}
+
+void SymbologyResolutionSax::OnKey(std::string&& key) {
+  switch (state_) {
+    case State::Root: {
+      if (key == "result") {
+        seen_.set(0);
+      } else if (key == "partial") {
+        seen_.set(1);
+      } else if (key == "not_found") {
+        seen_.set(2);
+      } else {
+        SkipValue();
+      }
+      key_ = std::move(key);
+      break;
+    }
+    case State::Mappings: {
+      symbol_ = std::move(key);
+      break;
+    }
+    case State::Interval: {
+      if (key != "d0" && key != "d1" && key != "s") {
+        SkipValue();
+      }
+      key_ = std::move(key);
+      break;
+    }
+    default: {
+      break;
+    }
+  }
+}
+
+void SymbologyResolutionSax::OnEndObject() {
+  switch (state_) {
+    case State::Root: {
+      constexpr std::array<const char*, 3> kKeys{"result", "partial", "not_found"};
+      for (std::size_t i = 0; i < kKeys.size(); ++i) {
+        if (!seen_.test(i)) {
+          throw JsonResponseError::MissingKey(endpoint_, kKeys[i]);
+        }
+      }
+      state_ = State::Done;
+      break;
+    }
+    case State::Mappings: {
+      state_ = State::Root;
+      break;
+    }
+    case State::Interval: {
+      constexpr std::array<const char*, 3> kKeys{"d0", "d1", "s"};
+      for (std::size_t i = 0; i < kKeys.size(); ++i) {
+        if (!interval_seen_.test(i)) {
+          throw JsonResponseError::MissingKey(endpoint_, kKeys[i]);
+        }
+      }
+      intervals_.emplace_back(std::move(interval_));
+      state_ = State::Intervals;
+      break;
+    }
+    default: {
+      break;
+    }
+  }
+}
+
+void SymbologyResolutionSax::OnStartArray() {
+  if (state_ == State::Root && key_ == "partial") {
+    res_.partial.clear();
+    state_ = State::Partial;
+  } else if (state_ == State::Root && key_ == "not_found") {
+    res_.not_found.clear();
+    state_ = State::NotFound;
+  } else if (state_ == State::Mappings) {
+    intervals_.clear();
+    state_ = State::Intervals;
+  } else {
+    OnValue(nlohmann::json::array());
+  }
+}
+
+void SymbologyResolutionSax::OnEndArray() {
+  switch (state_) {
+    case State::Intervals: {
+      res_.mappings.insert_or_assign(std::move(symbol_), std::move(intervals_));
+      intervals_ = {};
+      state_ = State::Mappings;
+      break;
+    }
+    case State::Partial:
+    case State::NotFound: {
+      state_ = State::Root;
+      break;
+    }
+    default: {
+      break;
+    }
+  }
+}
+
+BatchJob databento::detail::ParseBatchJob(std::string_view endpoint,
+                                          const nlohmann::json& json) {
+  if (!json.is_object()) {
+    throw JsonResponseError::TypeMismatch(endpoint, "object", json);
+  }
+  BatchJob res;
+  for (const auto& field : kBatchJobFields) {
+    // Copy as the setters consume the value
+    nlohmann::json value = CheckedAt(endpoint, json, field.name);
+    field.set(endpoint, field.name, std::move(value), &res);
+  }
+  return res;
+}
+
+BatchJobsSax::BatchJobsSax(std::string_view endpoint) : JsonSaxHandler{endpoint} {
+  static_assert(kBatchJobFields.size() == kNumFields);
+}
+
+void BatchJobsSax::OnValue(nlohmann::json&& value) {
+  switch (state_) {
+    case State::Start: {
+      throw JsonResponseError::TypeMismatch(endpoint_, "array", value);
+    }
+    case State::Jobs: {
+      throw JsonResponseError::TypeMismatch(endpoint_, "object", value);
+    }
+    case State::Job: {
+      const auto& field = kBatchJobFields[field_];
+      field.set(endpoint_, field.name, std::move(value), &job_);
+      seen_.set(field_);
+      break;
+    }
+    case State::Symbols: {
+      if (!value.is_string()) {
+        throw JsonResponseError::TypeMismatch(endpoint_, "nested string", "symbols",
+                                              value);
+      }
+      job_.symbols.emplace_back(std::move(value.get_ref<std::string&>()));
+      break;
+    }
+    case State::Done: {
+      break;
+    }
+  }
+}
+
+void BatchJobsSax::OnStartObject() {
+  switch (state_) {
+    case State::Jobs: {
+      job_ = {};
+      seen_.reset();
+      state_ = State::Job;
+      break;
+    }
+    default: {
+      OnValue(nlohmann::json::object());
+    }
+  }
+}
+
+void BatchJobsSax::OnKey(std::string&& key) {
+  // Keys are usually in the same order, so start searching after the last one
+  for (std::size_t i = 1; i <= kBatchJobFields.size(); ++i) {
+    const auto idx = (field_ + i) % kBatchJobFields.size();
+    if (kBatchJobFields[idx].name == key) {
+      field_ = idx;
+      return;
+    }
+  }
+  SkipValue();
+}
+
+void BatchJobsSax::OnEndObject() {
+  if (state_ != State::Job) {
+    return;
+  }
+  for (std::size_t i = 0; i < kBatchJobFields.size(); ++i) {
+    if (!seen_.test(i)) {
+      throw JsonResponseError::MissingKey(endpoint_, kBatchJobFields[i].name);
+    }
+  }
+  jobs_.emplace_back(std::move(job_));
+  state_ = State::Jobs;
+}
+
+void BatchJobsSax::OnStartArray() {
+  switch (state_) {
+    case State::Start: {
+      state_ = State::Jobs;
+      break;
+    }
+    case State::Job: {
+      if (kBatchJobFields[field_].name == "symbols") {
+        job_.symbols.clear();
+        seen_.set(field_);
+        state_ = State::Symbols;
+        break;
+      }
+      OnValue(nlohmann::json::array());
+      break;
+    }
+    default: {
+      OnValue(nlohmann::json::array());
+    }
+  }
+}
+
+void BatchJobsSax::OnEndArray() {
+  switch (state_) {
+    case State::Symbols: {
+      state_ = State::Job;
+      break;
+    }
+    case State::Jobs: {
+      state_ = State::Done;
+      break;
+    }
+    default: {
+      break;
+    }
+  }
+}
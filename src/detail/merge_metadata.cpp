@@ -0,0 +1,42 @@
+#include "databento/detail/merge_metadata.hpp"
+
+#include <algorithm>  // find, find_if, max
+#include <string>
+#include <utility>  // move
+#include <vector>
+
+namespace databento::detail {
+void MergeMetadata(Metadata* metadata, Metadata&& other) {
+  for (auto& other_mapping : other.mappings) {
+    auto mapping_it = std::find_if(
+        metadata->mappings.begin(), metadata->mappings.end(),
+        [&other_mapping](const auto& mapping) {
+          return mapping.raw_symbol == other_mapping.raw_symbol;
+        });
+    if (mapping_it == metadata->mappings.end()) {
+      metadata->mappings.emplace_back(std::move(other_mapping));
+      continue;
+    }
+    auto& intervals = mapping_it->intervals;
+    for (auto& interval : other_mapping.intervals) {
+      if (!intervals.empty() && intervals.back().symbol == interval.symbol &&
+          intervals.back().end_date >= interval.start_date) {
+        intervals.back().end_date =
+            std::max(intervals.back().end_date, interval.end_date);
+      } else {
+        intervals.emplace_back(std::move(interval));
+      }
+    }
+  }
+  const auto merge_symbols = [](std::vector<std::string>* symbols,
+                                std::vector<std::string>&& other_symbols) {
+    for (auto& symbol : other_symbols) {
+      if (std::find(symbols->begin(), symbols->end(), symbol) == symbols->end()) {
+        symbols->emplace_back(std::move(symbol));
+      }
+    }
+  };
+  merge_symbols(&metadata->partial, std::move(other.partial));
+  merge_symbols(&metadata->not_found, std::move(other.not_found));
+}
+}  // namespace databento::detail
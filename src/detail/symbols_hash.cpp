@@ -0,0 +1,22 @@
+#include "databento/detail/symbols_hash.hpp"
+
+#include <algorithm>  // sort
+
+namespace databento::detail {
+std::uint64_t HashSymbols(const std::vector<std::string>& symbols) {
+  auto sorted_symbols = symbols;
+  std::sort(sorted_symbols.begin(), sorted_symbols.end());
+  // FNV-1a
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (const auto& symbol : sorted_symbols) {
+    for (const char c : symbol) {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 1099511628211ULL;
+    }
+    // Separator so {"AB", "C"} and {"A", "BC"} differ
+    hash ^= std::uint64_t{','};
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+}  // namespace databento::detail
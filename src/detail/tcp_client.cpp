@@ -18,6 +18,8 @@
 #include <thread>
 
 #include "databento/exceptions.hpp"  // TcpError
+#include "databento/metrics.hpp"     // MetricCounter
+#include "metrics_hooks.hpp"
 
 using databento::detail::TcpClient;
 
@@ -49,6 +51,7 @@ void TcpClient::WriteAll(const std::byte* buffer, std::size_t size) {
     if (res < 0) {
       throw TcpError{::GetErrNo(), "Error writing to socket"};
     }
+    IncrementMetric(MetricCounter::TcpBytesWritten, static_cast<std::size_t>(res));
     size -= static_cast<std::size_t>(res);
     buffer += res;
   } while (size > 0);
@@ -60,6 +63,7 @@ void TcpClient::ReadExact(std::byte* buffer, std::size_t size) {
   if (res != static_cast<::ssize_t>(size)) {
     throw TcpError{::GetErrNo(), "Error reading from socket"};
   }
+  IncrementMetric(MetricCounter::TcpBytesRead, size);
 }
 
 TcpClient::Result TcpClient::ReadSome(std::byte* buffer, std::size_t max_size) {
@@ -68,6 +72,7 @@ TcpClient::Result TcpClient::ReadSome(std::byte* buffer, std::size_t max_size) {
   if (res < 0) {
     throw TcpError{::GetErrNo(), "Error reading from socket"};
   }
+  IncrementMetric(MetricCounter::TcpBytesRead, static_cast<std::size_t>(res));
   return {static_cast<std::size_t>(res), res == 0 ? Status::Closed : Status::Ok};
 }
 
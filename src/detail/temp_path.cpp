@@ -0,0 +1,17 @@
+#include "databento/detail/temp_path.hpp"
+
+#include <cstdint>
+#include <iomanip>  // setfill, setw
+#include <random>   // mt19937_64, random_device
+#include <sstream>
+
+namespace databento::detail {
+std::filesystem::path TempPath(const std::filesystem::path& path) {
+  thread_local std::mt19937_64 rng{std::random_device{}()};
+  std::ostringstream suffix;
+  suffix << '.' << std::hex << std::setfill('0') << std::setw(16) << rng() << ".tmp";
+  auto res = path;
+  res += suffix.str();
+  return res;
+}
+}  // namespace databento::detail
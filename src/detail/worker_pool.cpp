@@ -0,0 +1,48 @@
+#include "databento/detail/worker_pool.hpp"
+
+#include <algorithm>  // max
+#include <utility>    // move
+
+using databento::detail::WorkerPool;
+
+WorkerPool::WorkerPool(std::size_t max_threads)
+    : max_threads_{std::max<std::size_t>(max_threads, 1)} {
+  threads_.reserve(max_threads_);
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    const std::lock_guard<std::mutex> lock{mutex_};
+    is_stopping_ = true;
+    cv_.notify_all();
+  }
+  threads_.clear();  // joins
+}
+
+void WorkerPool::Submit(std::function<void()> task) {
+  const std::lock_guard<std::mutex> lock{mutex_};
+  tasks_.emplace_back(std::move(task));
+  if (tasks_.size() > idle_count_ && threads_.size() < max_threads_) {
+    threads_.emplace_back([this] { Run(); });
+  } else {
+    cv_.notify_one();
+  }
+}
+
+void WorkerPool::Run() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      ++idle_count_;
+      cv_.wait(lock, [this] { return !tasks_.empty() || is_stopping_; });
+      --idle_count_;
+      if (is_stopping_) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
@@ -1,19 +1,56 @@
 #include "databento/detail/zstd_stream.hpp"
 
+#include <zdict.h>
+
 #include <algorithm>
+#include <cassert>
+#include <exception>
+#include <numeric>  // accumulate
 #include <sstream>
+#include <string>
 #include <utility>  // move
 
 #include "databento/detail/buffer.hpp"
 #include "databento/exceptions.hpp"
 #include "databento/log.hpp"
+#include "databento/metrics.hpp"  // MetricCounter
+#include "metrics_hooks.hpp"
+
+namespace {
+// The largest window zstd decoders accept without raising their limit
+constexpr int kMaxWindowLog = 27;
+}  // namespace
+
+std::vector<std::byte> databento::detail::TrainZstdDictionary(
+    const std::vector<std::byte>& samples, const std::vector<std::size_t>& sample_sizes,
+    std::size_t max_size) {
+  const auto samples_size =
+      std::accumulate(sample_sizes.begin(), sample_sizes.end(), std::size_t{});
+  if (samples_size > samples.size()) {
+    throw InvalidArgumentError{
+        "TrainZstdDictionary", "sample_sizes",
+        "Sum of sample sizes " + std::to_string(samples_size) +
+            " exceeds the size of samples " + std::to_string(samples.size())};
+  }
+  std::vector<std::byte> dictionary(max_size);
+  const auto size = ::ZDICT_trainFromBuffer(
+      dictionary.data(), dictionary.size(), samples.data(), sample_sizes.data(),
+      static_cast<unsigned>(sample_sizes.size()));
+  if (::ZDICT_isError(size)) {
+    throw Exception{std::string{"Zstd error training dictionary: "} +
+                    ::ZDICT_getErrorName(size)};
+  }
+  dictionary.resize(size);
+  return dictionary;
+}
 
 using databento::detail::ZstdDecodeStream;
 
 ZstdDecodeStream::ZstdDecodeStream(std::unique_ptr<IReadable> input)
     : input_{std::move(input)},
       z_dstream_{::ZSTD_createDStream(), ::ZSTD_freeDStream},
-      read_suggestion_{::ZSTD_initDStream(z_dstream_.get())},
+      z_ddict_{nullptr, ::ZSTD_freeDDict},
+      read_suggestion_{InitDStream()},
       in_buffer_{},
       z_in_buffer_{in_buffer_.data(), 0, 0} {}
 
@@ -21,12 +58,41 @@ ZstdDecodeStream::ZstdDecodeStream(std::unique_ptr<IReadable> input,
                                    detail::Buffer& in_buffer)
     : input_{std::move(input)},
       z_dstream_{::ZSTD_createDStream(), ::ZSTD_freeDStream},
-      read_suggestion_{::ZSTD_initDStream(z_dstream_.get())},
+      z_ddict_{nullptr, ::ZSTD_freeDDict},
+      read_suggestion_{InitDStream()},
       in_buffer_{in_buffer.ReadBegin(), in_buffer.ReadEnd()},
       z_in_buffer_{in_buffer_.data(), in_buffer_.size(), 0} {
   in_buffer.Consume(in_buffer.ReadCapacity());
 }
 
+ZstdDecodeStream::ZstdDecodeStream(std::unique_ptr<IReadable> input,
+                                   const std::vector<std::byte>& dictionary)
+    : input_{std::move(input)},
+      z_dstream_{::ZSTD_createDStream(), ::ZSTD_freeDStream},
+      z_ddict_{::ZSTD_createDDict(dictionary.data(), dictionary.size()),
+               ::ZSTD_freeDDict},
+      read_suggestion_{InitDStream()},
+      in_buffer_{},
+      z_in_buffer_{in_buffer_.data(), 0, 0} {
+  if (!z_ddict_) {
+    throw InvalidArgumentError{"ZstdDecodeStream", "dictionary",
+                               "Invalid Zstd dictionary"};
+  }
+}
+
+std::size_t ZstdDecodeStream::InitDStream() {
+  const auto read_suggestion = ::ZSTD_initDStream(z_dstream_.get());
+  // Initializing clears any dictionary
+  if (z_ddict_) {
+    const auto res = ::ZSTD_DCtx_refDDict(z_dstream_.get(), z_ddict_.get());
+    if (::ZSTD_isError(res)) {
+      throw DbnResponseError{std::string{"Zstd error referencing dictionary: "} +
+                             ::ZSTD_getErrorName(res)};
+    }
+  }
+  return read_suggestion;
+}
+
 void ZstdDecodeStream::ReadExact(std::byte* buffer, std::size_t length) {
   std::size_t size{};
   do {
@@ -52,7 +118,7 @@ std::size_t ZstdDecodeStream::ReadSome(std::byte* buffer, std::size_t max_length
     }
     if (read_suggestion_ == 0) {
       // next frame
-      read_suggestion_ = ::ZSTD_initDStream(z_dstream_.get());
+      read_suggestion_ = InitDStream();
     }
     const auto new_size = unread_input + read_suggestion_;
     if (new_size != in_buffer_.size()) {
@@ -60,6 +126,7 @@ std::size_t ZstdDecodeStream::ReadSome(std::byte* buffer, std::size_t max_length
       z_in_buffer_.src = in_buffer_.data();
     }
     read_size = input_->ReadSome(&in_buffer_[unread_input], read_suggestion_);
+    IncrementMetric(MetricCounter::ZstdBytesRead, read_size);
     z_in_buffer_.size = unread_input + read_size;
     z_in_buffer_.pos = 0;
 
@@ -70,6 +137,7 @@ std::size_t ZstdDecodeStream::ReadSome(std::byte* buffer, std::size_t max_length
                              ::ZSTD_getErrorName(read_suggestion_)};
     }
   } while (z_out_buffer.pos == 0 && read_size > 0);
+  IncrementMetric(MetricCounter::ZstdBytesDecompressed, z_out_buffer.pos);
   return z_out_buffer.pos;
 }
 
@@ -78,63 +146,103 @@ using databento::detail::ZstdCompressStream;
 ZstdCompressStream::ZstdCompressStream(IWritable* output)
     : ZstdCompressStream{ILogReceiver::Default(), output} {}
 ZstdCompressStream::ZstdCompressStream(ILogReceiver* log_receiver, IWritable* output)
+    : ZstdCompressStream{log_receiver, output, {}} {}
+ZstdCompressStream::ZstdCompressStream(IWritable* output,
+                                       const ZstdCompressOptions& options)
+    : ZstdCompressStream{ILogReceiver::Default(), output, options} {}
+ZstdCompressStream::ZstdCompressStream(ILogReceiver* log_receiver, IWritable* output,
+                                       const ZstdCompressOptions& options)
     : log_receiver_{log_receiver},
       output_{output},
       z_cstream_{::ZSTD_createCStream(), ::ZSTD_freeCStream},
       in_buffer_{},
-      z_in_buffer_{in_buffer_.data(), 0, 0},
       in_size_{::ZSTD_CStreamInSize()},
       out_buffer_(::ZSTD_CStreamOutSize()) {
+  if (options.window_log > kMaxWindowLog) {
+    throw InvalidArgumentError{
+        "ZstdCompressStream", "options.window_log",
+        "Must be at most " + std::to_string(kMaxWindowLog) + ", got " +
+            std::to_string(options.window_log)};
+  }
   in_buffer_.reserve(in_size_);
-  z_in_buffer_.src = in_buffer_.data();
   // enable checksums
-  ::ZSTD_CCtx_setParameter(z_cstream_.get(), ZSTD_c_checksumFlag, 1);
+  SetParameter(ZSTD_c_checksumFlag, 1);
+  SetParameter(ZSTD_c_compressionLevel, options.level);
+  if (options.long_distance_matching) {
+    SetParameter(ZSTD_c_enableLongDistanceMatching, 1);
+  }
+  if (options.window_log > 0) {
+    SetParameter(ZSTD_c_windowLog, options.window_log);
+  }
+  if (options.num_workers > 0) {
+    SetParameter(ZSTD_c_nbWorkers, options.num_workers);
+    if (options.job_size > 0) {
+      SetParameter(ZSTD_c_jobSize, options.job_size);
+    }
+  }
+  if (!options.dictionary.empty()) {
+    const auto res = ::ZSTD_CCtx_loadDictionary(
+        z_cstream_.get(), options.dictionary.data(), options.dictionary.size());
+    if (::ZSTD_isError(res)) {
+      throw InvalidArgumentError{"ZstdCompressStream", "options.dictionary",
+                                 ::ZSTD_getErrorName(res)};
+    }
+  }
 }
 
 ZstdCompressStream::~ZstdCompressStream() {
-  ZSTD_outBuffer z_out_buffer{out_buffer_.data(), out_buffer_.size(), 0};
-  while (true) {
-    const std::size_t remaining = ::ZSTD_compressStream2(
-        z_cstream_.get(), &z_out_buffer, &z_in_buffer_, ::ZSTD_e_end);
-    if (remaining == 0) {
-      break;
-    }
-    if (::ZSTD_isError(remaining) && log_receiver_) {
-      log_receiver_->Receive(LogLevel::Error,
-                             std::string{"Zstd error compressing end of stream: "} +
-                                 ::ZSTD_getErrorName(remaining));
-      break;
+  try {
+    Compress(in_buffer_.data(), in_buffer_.size(), ::ZSTD_e_end);
+  } catch (const std::exception& exc) {
+    if (log_receiver_) {
+      log_receiver_->Receive(
+          LogLevel::Error,
+          std::string{"Error compressing end of Zstd stream: "} + exc.what());
     }
   }
-  assert(z_in_buffer_.pos == z_in_buffer_.size);
-  // Forward compressed output
-  if (z_out_buffer.pos > 0) {
-    output_->WriteAll(out_buffer_.data(), z_out_buffer.pos);
-  }
 }
 
 void ZstdCompressStream::WriteAll(const std::byte* buffer, std::size_t length) {
+  if (in_buffer_.empty() && length >= in_size_) {
+    // Avoid copying input that's already large enough
+    Compress(buffer, length, ::ZSTD_e_continue);
+    return;
+  }
   in_buffer_.insert(in_buffer_.end(), buffer, buffer + length);
-  z_in_buffer_ = {in_buffer_.data(), in_buffer_.size(), 0};
   // Wait for sufficient data before compressing
   if (in_buffer_.size() >= in_size_) {
+    Compress(in_buffer_.data(), in_buffer_.size(), ::ZSTD_e_continue);
+    in_buffer_.clear();
+  }
+}
+
+void ZstdCompressStream::SetParameter(ZSTD_cParameter param, int value) {
+  const auto res = ::ZSTD_CCtx_setParameter(z_cstream_.get(), param, value);
+  if (::ZSTD_isError(res)) {
+    throw InvalidArgumentError{"ZstdCompressStream", "options",
+                               ::ZSTD_getErrorName(res)};
+  }
+}
+
+void ZstdCompressStream::Compress(const std::byte* buffer, std::size_t length,
+                                  ZSTD_EndDirective mode) {
+  ZSTD_inBuffer z_in_buffer{buffer, length, 0};
+  while (true) {
     ZSTD_outBuffer z_out_buffer{out_buffer_.data(), out_buffer_.size(), 0};
-    const std::size_t remaining = ::ZSTD_compressStream2(
-        z_cstream_.get(), &z_out_buffer, &z_in_buffer_, ::ZSTD_e_continue);
+    const std::size_t remaining =
+        ::ZSTD_compressStream2(z_cstream_.get(), &z_out_buffer, &z_in_buffer, mode);
     if (::ZSTD_isError(remaining)) {
       throw DbnResponseError{std::string{"Zstd error compressing: "} +
                              ::ZSTD_getErrorName(remaining)};
     }
-    // Shift unread input to front
-    const auto unread_input = z_in_buffer_.size - z_in_buffer_.pos;
-    if (unread_input > 0) {
-      std::copy(in_buffer_.cbegin() + static_cast<std::ptrdiff_t>(z_in_buffer_.pos),
-                in_buffer_.cend(), in_buffer_.begin());
-    }
-    in_buffer_.resize(unread_input);
     if (z_out_buffer.pos > 0) {
       // Forward compressed output
       output_->WriteAll(out_buffer_.data(), z_out_buffer.pos);
     }
+    // Ending the frame must also flush all buffered output
+    if (mode == ::ZSTD_e_end ? remaining == 0 : z_in_buffer.pos == z_in_buffer.size) {
+      break;
+    }
   }
+  assert(z_in_buffer.pos == z_in_buffer.size);
 }
@@ -756,6 +756,19 @@ const char* ToString(VersionUpgradePolicy version_upgrade_policy) {
     }
   }
 }
+const char* ToString(BatchStreamMode batch_stream_mode) {
+  switch (batch_stream_mode) {
+    case BatchStreamMode::Concatenate: {
+      return "Concatenate";
+    }
+    case BatchStreamMode::Merge: {
+      return "Merge";
+    }
+    default: {
+      return "Unknown";
+    }
+  }
+}
 const char* ToString(ErrorCode error_code) {
   switch (error_code) {
     case ErrorCode::AuthFailed: {
@@ -904,6 +917,10 @@ std::ostream& operator<<(std::ostream& out,
   out << ToString(version_upgrade_policy);
   return out;
 }
+std::ostream& operator<<(std::ostream& out, BatchStreamMode batch_stream_mode) {
+  out << ToString(batch_stream_mode);
+  return out;
+}
 std::ostream& operator<<(std::ostream& out, ErrorCode error_code) {
   out << ToString(error_code);
   return out;
@@ -1,7 +1,9 @@
 #include "databento/file_stream.hpp"
 
-#include <ios>  // ios, streamsize
+#include <ios>  // ios, streamoff, streamsize
 #include <sstream>
+#include <string>  // to_string
+#include <utility>  // move
 
 #include "databento/exceptions.hpp"
 
@@ -30,6 +32,16 @@ std::size_t InFileStream::ReadSome(std::byte* buffer, std::size_t max_length) {
   return static_cast<std::size_t>(stream_.gcount());
 }
 
+void InFileStream::Seek(std::uint64_t offset) {
+  // Clear any end of file state from previous reads
+  stream_.clear();
+  stream_.seekg(static_cast<std::streamoff>(offset));
+  if (stream_.fail()) {
+    throw InvalidArgumentError{"InFileStream::Seek", "offset",
+                               "Unable to seek to " + std::to_string(offset)};
+  }
+}
+
 using databento::OutFileStream;
 
 OutFileStream::OutFileStream(const std::filesystem::path& file_path)
@@ -40,7 +52,69 @@ OutFileStream::OutFileStream(const std::filesystem::path& file_path)
   }
 }
 
+OutFileStream::OutFileStream(const std::filesystem::path& file_path,
+                             std::size_t buffer_size)
+    : buffer_size_{buffer_size} {
+  // Writes are already buffered, so avoid copying them into the stream's buffer
+  stream_.rdbuf()->pubsetbuf(nullptr, 0);
+  stream_.open(file_path, std::ios::binary);
+  if (stream_.fail()) {
+    throw InvalidArgumentError{"OutFileStream", "file_path",
+                               "Non-existent or invalid file"};
+  }
+  buffer_.reserve(buffer_size_);
+}
+
+OutFileStream::~OutFileStream() {
+  if (!buffer_.empty()) {
+    stream_.write(reinterpret_cast<const char*>(buffer_.data()),
+                  static_cast<std::streamsize>(buffer_.size()));
+  }
+}
+
+OutFileStream& OutFileStream::operator=(OutFileStream&& other) {
+  if (this != &other) {
+    Flush();
+    stream_ = std::move(other.stream_);
+    buffer_size_ = other.buffer_size_;
+    buffer_ = std::move(other.buffer_);
+    // Nothing is left for `other` to write on destruction
+    other.buffer_.clear();
+  }
+  return *this;
+}
+
 void OutFileStream::WriteAll(const std::byte* buffer, std::size_t length) {
+  if (buffer_.size() + length <= buffer_size_) {
+    buffer_.insert(buffer_.end(), buffer, buffer + length);
+    return;
+  }
+  if (!buffer_.empty()) {
+    Write(buffer_.data(), buffer_.size());
+    buffer_.clear();
+  }
+  if (length < buffer_size_) {
+    buffer_.insert(buffer_.end(), buffer, buffer + length);
+  } else {
+    Write(buffer, length);
+  }
+}
+
+void OutFileStream::Flush() {
+  if (!buffer_.empty()) {
+    Write(buffer_.data(), buffer_.size());
+    buffer_.clear();
+  }
+  stream_.flush();
+  if (stream_.fail()) {
+    throw Exception{"Failed to write to file"};
+  }
+}
+
+void OutFileStream::Write(const std::byte* buffer, std::size_t length) {
   stream_.write(reinterpret_cast<const char*>(buffer),
                 static_cast<std::streamsize>(length));
+  if (stream_.fail()) {
+    throw Exception{"Failed to write to file"};
+  }
 }
@@ -0,0 +1,86 @@
+#include "format_helper.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>  // pair
+
+using databento::FormatBuffer;
+
+namespace {
+// "00", "01", ..., "99"
+constexpr auto kDigitPairs = [] {
+  std::array<char, 200> res{};
+  for (std::size_t i = 0; i < 100; ++i) {
+    res[i * 2] = static_cast<char>('0' + i / 10);
+    res[i * 2 + 1] = static_cast<char>('0' + i % 10);
+  }
+  return res;
+}();
+}  // namespace
+
+char* databento::WriteDigitsBackward(char* end, std::uint64_t value, int width) {
+  while (width >= 2) {
+    end -= 2;
+    const auto pair = value % 100 * 2;
+    end[0] = kDigitPairs[pair];
+    end[1] = kDigitPairs[pair + 1];
+    value /= 100;
+    width -= 2;
+  }
+  if (width == 1) {
+    *--end = static_cast<char>('0' + value % 10);
+  }
+  return end;
+}
+
+void FormatBuffer::AppendQuoted(std::string_view str) {
+  out_.push_back('"');
+  for (const char c : str) {
+    if (c == '"' || c == '\\') {
+      out_.push_back('\\');
+    }
+    out_.push_back(c);
+  }
+  out_.push_back('"');
+}
+
+void FormatBuffer::AppendIso8601(UnixNanos unix_nanos) {
+  std::array<char, kMaxIso8601Len> buf;
+  out_.append(buf.data(), FormatIso8601(unix_nanos, buf.data()));
+}
+
+void FormatBuffer::AppendPx(pretty::Px px) {
+  std::array<char, pretty::kMaxPxLen> buf;
+  out_.append(buf.data(), pretty::FormatPx(px.val, precision_, buf.data()));
+}
+
+void FormatBuffer::AppendFlagSet(FlagSet flag_set) {
+  constexpr std::array<std::pair<FlagSet::Repr, const char*>, 7> kFlagsAndNames = {{
+      {FlagSet::kLast, "LAST"},
+      {FlagSet::kTob, "TOB"},
+      {FlagSet::kSnapshot, "SNAPSHOT"},
+      {FlagSet::kMbp, "MBP"},
+      {FlagSet::kBadTsRecv, "BAD_TS_RECV"},
+      {FlagSet::kMaybeBadBook, "MAYBE_BAD_BOOK"},
+      {FlagSet::kPublisherSpecific, "PUBLISHER_SPECIFIC"},
+  }};
+
+  bool has_written_flag = false;
+  for (const auto& [flag, name] : kFlagsAndNames) {
+    if ((flag_set.Raw() & flag) != 0) {
+      if (has_written_flag) {
+        Append(" | ");
+      }
+      Append(std::string_view{name});
+      has_written_flag = true;
+    }
+  }
+  if (has_written_flag) {
+    Append(" (");
+    AppendInt(flag_set.Raw());
+    Append(')');
+  } else {
+    AppendInt(flag_set.Raw());
+  }
+}
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>  // find
+#include <array>
+#include <charconv>  // to_chars
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "databento/datetime.hpp"  // TimeDeltaNanos, UnixNanos
+#include "databento/flag_set.hpp"
+#include "databento/pretty.hpp"  // Px
+
+namespace databento {
+// Writes exactly `width` digits of `value`, zero-padded, ending at `end`.
+// Returns the start of the written digits.
+char* WriteDigitsBackward(char* end, std::uint64_t value, int width);
+
+// Appends formatted values to a caller-provided string without going through
+// iostreams.
+class FormatBuffer {
+ public:
+  // `precision` is the stream precision used for formatting prices, see
+  // `pretty::Px`.
+  FormatBuffer(std::string& out, int precision) : out_{out}, precision_{precision} {}
+
+  std::string& Out() { return out_; }
+  int Precision() const { return precision_; }
+
+  void Append(char c) { out_.push_back(c); }
+  void Append(std::string_view str) { out_.append(str); }
+  template <typename T>
+  void AppendInt(T val) {
+    std::array<char, 20> buf;
+    const auto res = std::to_chars(buf.data(), buf.data() + buf.size(), val);
+    out_.append(buf.data(), static_cast<std::size_t>(res.ptr - buf.data()));
+  }
+  // Appends `str` surrounded by double quotes and with any double quotes or
+  // backslashes escaped, like `std::quoted`.
+  void AppendQuoted(std::string_view str);
+  void AppendIso8601(UnixNanos unix_nanos);
+  void AppendPx(pretty::Px px);
+  void AppendFlagSet(FlagSet flag_set);
+
+ private:
+  std::string& out_;
+  const int precision_;
+};
+
+// Overloads for types nested in records, other overloads are defined alongside
+// each record's stream operator
+struct BidAskPair;
+struct ConsolidatedBidAskPair;
+struct RecordHeader;
+void FormatTo(FormatBuffer& buffer, const RecordHeader& header);
+void FormatTo(FormatBuffer& buffer, const BidAskPair& bid_ask_pair);
+void FormatTo(FormatBuffer& buffer,
+              const ConsolidatedBidAskPair& consolidated_bid_ask_pair);
+
+// Formats the fields of a type into a `FormatBuffer` with the same output as
+// `StreamOpHelper`.
+class FormatHelper {
+ private:
+  template <typename T>
+  void Format(const T& val) {
+    if constexpr (std::is_same_v<T, bool>) {
+      buffer_.Append(val ? "true" : "false");
+    } else if constexpr (std::is_same_v<T, char>) {
+      buffer_.Append('\'');
+      buffer_.Append(val);
+      buffer_.Append('\'');
+    } else if constexpr (std::is_integral_v<T>) {
+      // Includes `std::uint8_t` and `std::int8_t`, which are formatted as
+      // numbers, not characters
+      buffer_.AppendInt(val);
+    } else if constexpr (std::is_enum_v<T>) {
+      buffer_.Append(std::string_view{ToString(val)});
+    } else if constexpr (std::is_invocable_v<const T&, FormatBuffer&>) {
+      // Nested structures
+      val(buffer_);
+    } else {
+      FormatTo(buffer_, val);
+    }
+  }
+
+  void Format(std::string_view val) { buffer_.AppendQuoted(val); }
+
+  void Format(const std::string& val) { buffer_.AppendQuoted(val); }
+
+  void Format(UnixNanos val) { buffer_.AppendIso8601(val); }
+
+  void Format(TimeDeltaNanos val) { buffer_.AppendInt(val.count()); }
+
+  void Format(pretty::Px val) { buffer_.AppendPx(val); }
+
+  void Format(FlagSet val) { buffer_.AppendFlagSet(val); }
+
+  template <std::size_t N>
+  void Format(const std::array<char, N>& val) {
+    const auto* end = std::find(val.begin(), val.end(), '\0');
+    buffer_.Append('"');
+    buffer_.Append(
+        std::string_view{val.data(), static_cast<std::size_t>(end - val.begin())});
+    buffer_.Append('"');
+  }
+
+ public:
+  FormatHelper(FormatBuffer& buffer, std::string_view type_name,
+               std::string_view spacer, std::string_view indent)
+      : buffer_{buffer}, spacer_{spacer}, indent_{indent} {
+    if (!type_name.empty()) {
+      buffer_.Append(type_name);
+      buffer_.Append(' ');
+    }
+    buffer_.Append('{');
+  }
+
+  template <typename T>
+  FormatHelper& AddField(std::string_view field_name, const T& field_val) {
+    AppendSeparator();
+    buffer_.Append(field_name);
+    buffer_.Append(" = ");
+    Format(field_val);
+    return *this;
+  }
+
+  template <typename T>
+  FormatHelper& AddItem(const T& item) {
+    AppendSeparator();
+    Format(item);
+    return *this;
+  }
+
+  FormatBuffer& Finish() {
+    if (spacer_.find('\n') == std::string_view::npos) {
+      // no spacing required if empty
+      if (!is_first_) {
+        buffer_.Append(spacer_);
+      }
+    } else {
+      buffer_.Append('\n');
+      buffer_.Append(indent_);
+    }
+    buffer_.Append('}');
+    return buffer_;
+  }
+
+ private:
+  void AppendSeparator() {
+    if (!is_first_) {
+      buffer_.Append(',');
+    }
+    buffer_.Append(spacer_);
+    buffer_.Append(indent_);
+    is_first_ = false;
+  }
+
+  FormatBuffer& buffer_;
+  std::string_view spacer_;
+  std::string_view indent_;
+  bool is_first_{true};
+};
+
+// Has the same interface as `StreamOpBuilder`, but all strings must outlive the
+// `FormatHelper`.
+class FormatBuilder {
+ public:
+  explicit FormatBuilder(FormatBuffer& buffer) : buffer_{buffer} {}
+
+  FormatBuilder& SetTypeName(std::string_view type_name) {
+    type_name_ = type_name;
+    return *this;
+  }
+
+  // Sets what's inserted between the comma and the next element
+  FormatBuilder& SetSpacer(std::string_view spacer) {
+    spacer_ = spacer;
+    return *this;
+  }
+
+  // Sets any indentation that should be applied to all elements including the
+  // closing '}'. Primarily used for nested structures.
+  FormatBuilder& SetIndent(std::string_view indent) {
+    indent_ = indent;
+    return *this;
+  }
+
+  FormatHelper Build() { return FormatHelper{buffer_, type_name_, spacer_, indent_}; }
+
+ private:
+  FormatBuffer& buffer_;
+  std::string_view indent_;
+  std::string_view type_name_;
+  std::string_view spacer_;
+};
+
+// Formats `val` with its `FormatTo` overload into a new string. Used to
+// implement `ToString`.
+template <typename T>
+std::string FormatToString(const T& val) {
+  std::string res;
+  // The default stream precision
+  FormatBuffer buffer{res, 6};
+  FormatTo(buffer, val);
+  return res;
+}
+
+// Formats `val` with its `FormatTo` overload and writes it to `stream`. Used to
+// implement `operator<<`.
+template <typename T>
+std::ostream& FormatToStream(std::ostream& stream, const T& val) {
+  // Reused to avoid allocating for every call
+  thread_local std::string buf;
+  buf.clear();
+  FormatBuffer buffer{buf, static_cast<int>(stream.precision())};
+  FormatTo(buffer, val);
+  return stream.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+}
+}  // namespace databento
@@ -5,27 +5,54 @@
 #endif
 #include <httplib.h>
 #include <nlohmann/json.hpp>
+#include <openssl/evp.h>  // EVP_MD_CTX, EVP_Digest*, EVP_sha256
 
-#include <algorithm>  // find_if
-#include <cstddef>    // size_t
-#include <cstdlib>    // get_env
+#include <algorithm>  // find, find_if, max, min, sort
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>  // byte, size_t
+#include <cstdlib>  // get_env
+#include <deque>
+#include <exception>  // current_exception, exception_ptr, rethrow_exception
 #include <filesystem>
-#include <iterator>  // back_inserter
+#include <fstream>
+#include <functional>  // greater
+#include <future>      // future, packaged_task
+#include <iomanip>     // setfill, setw
+#include <limits>
+#include <memory>      // make_shared, make_unique, unique_ptr
+#include <mutex>
+#include <optional>
+#include <queue>  // priority_queue
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <system_error>
-#include <utility>  // move
+#include <tuple>        // tie
+#include <type_traits>  // invoke_result_t
+#include <utility>      // forward, move, pair
+#include <vector>
 
 #include "databento/constants.hpp"
 #include "databento/datetime.hpp"
 #include "databento/dbn_file_store.hpp"
+#include "databento/detail/chunk_queue.hpp"
 #include "databento/detail/dbn_buffer_decoder.hpp"
+#include "databento/detail/dbn_file_indexer.hpp"
 #include "databento/detail/json_helpers.hpp"
+#include "databento/detail/json_sax.hpp"
+#include "databento/detail/merge_metadata.hpp"
+#include "databento/detail/scoped_thread.hpp"
+#include "databento/detail/temp_path.hpp"
+#include "databento/detail/worker_pool.hpp"
 #include "databento/enums.hpp"
 #include "databento/exceptions.hpp"  // Exception, JsonResponseError
 #include "databento/file_stream.hpp"
 #include "databento/log.hpp"
 #include "databento/metadata.hpp"
+#include "databento/record.hpp"
 #include "databento/timeseries.hpp"
 
 using databento::Historical;
@@ -51,58 +78,63 @@ constexpr auto kDefaultSTypeIn = databento::SType::RawSymbol;
 constexpr auto kDefaultEncoding = databento::Encoding::Dbn;
 constexpr auto kDefaultCompression = databento::Compression::Zstd;
 constexpr auto kDefaultSTypeOut = databento::SType::InstrumentId;
+// Responses are received in chunks of a few KiB, so downloads to disk are
+// buffered into larger writes
+constexpr std::size_t kFileWriteBufferSize = 1 << 20;
 
-databento::BatchJob Parse(const std::string& endpoint, const nlohmann::json& json) {
-  using databento::Compression;
-  using databento::Delivery;
-  using databento::Encoding;
-  using databento::JobState;
-  using databento::JsonResponseError;
-  using databento::Schema;
-  using databento::SplitDuration;
-  using databento::SType;
-  using databento::detail::CheckedAt;
-  using databento::detail::FromCheckedAtString;
-  using databento::detail::FromCheckedAtStringOrNull;
-  using databento::detail::ParseAt;
+// Extracts the path from a batch file URL.
+std::string PathFromUrl(const std::string& method_name, const std::string& url) {
+  const auto protocol_divider = url.find("://");
+  if (protocol_divider == std::string::npos) {
+    const auto slash = url.find_first_of('/');
+    if (slash == std::string::npos) {
+      throw databento::InvalidArgumentError{method_name, "url", "No slashes"};
+    }
+    return url.substr(slash);
+  }
+  const auto slash = url.find('/', protocol_divider + 3);
+  if (slash == std::string::npos) {
+    throw databento::InvalidArgumentError{method_name, "url", "No slashes"};
+  }
+  return url.substr(slash);
+}
 
-  if (!json.is_object()) {
-    throw JsonResponseError::TypeMismatch(endpoint, "object", json);
-  }
-  databento::BatchJob res;
-  res.id = CheckedAt(endpoint, json, "id");
-  res.user_id = ParseAt<std::string>(endpoint, json, "user_id");
-  res.cost_usd = ParseAt<double>(endpoint, json, "cost_usd");
-  res.dataset = ParseAt<std::string>(endpoint, json, "dataset");
-  res.symbols = ParseAt<std::vector<std::string>>(endpoint, json, "symbols");
-  res.stype_in = FromCheckedAtString<SType>(endpoint, json, "stype_in");
-  res.stype_out = FromCheckedAtString<SType>(endpoint, json, "stype_out");
-  res.schema = FromCheckedAtString<Schema>(endpoint, json, "schema");
-  res.start = ParseAt<std::string>(endpoint, json, "start");
-  res.end = ParseAt<std::string>(endpoint, json, "end");
-  res.limit = ParseAt<std::uint64_t>(endpoint, json, "limit");
-  res.encoding = FromCheckedAtString<Encoding>(endpoint, json, "encoding");
-  res.compression = FromCheckedAtStringOrNull<Compression>(
-      endpoint, json, "compression", Compression::None);
-  res.pretty_px = ParseAt<bool>(endpoint, json, "pretty_px");
-  res.pretty_ts = ParseAt<bool>(endpoint, json, "pretty_ts");
-  res.map_symbols = ParseAt<bool>(endpoint, json, "map_symbols");
-  res.split_duration = FromCheckedAtStringOrNull<SplitDuration>(
-      endpoint, json, "split_duration", SplitDuration::None);
-  res.split_size = ParseAt<std::uint64_t>(endpoint, json, "split_size");
-  res.split_symbols = ParseAt<bool>(endpoint, json, "split_symbols");
-  res.delivery = FromCheckedAtString<Delivery>(endpoint, json, "delivery");
-  res.record_count = ParseAt<std::uint64_t>(endpoint, json, "record_count");
-  res.billed_size = ParseAt<std::uint64_t>(endpoint, json, "billed_size");
-  res.actual_size = ParseAt<std::uint64_t>(endpoint, json, "actual_size");
-  res.package_size = ParseAt<std::uint64_t>(endpoint, json, "package_size");
-  res.state = FromCheckedAtString<JobState>(endpoint, json, "state");
-  res.ts_received = ParseAt<std::string>(endpoint, json, "ts_received");
-  res.ts_queued = ParseAt<std::string>(endpoint, json, "ts_queued");
-  res.ts_process_start = ParseAt<std::string>(endpoint, json, "ts_process_start");
-  res.ts_process_done = ParseAt<std::string>(endpoint, json, "ts_process_done");
-  res.ts_expiration = ParseAt<std::string>(endpoint, json, "ts_expiration");
-  return res;
+// Returns the lowercase hex SHA-256 digest of the file at `path`.
+std::string Sha256FileDigest(const std::filesystem::path& path) {
+  const std::unique_ptr<EVP_MD_CTX, decltype(&::EVP_MD_CTX_free)> ctx{
+      ::EVP_MD_CTX_new(), &::EVP_MD_CTX_free};
+  if (!ctx || ::EVP_DigestInit_ex(ctx.get(), ::EVP_sha256(), nullptr) != 1) {
+    throw databento::Exception{"Unable to initialize SHA 256"};
+  }
+  databento::InFileStream file{path};
+  std::vector<std::byte> buffer(1024 * 1024);
+  while (const auto read_size = file.ReadSome(buffer.data(), buffer.size())) {
+    if (::EVP_DigestUpdate(ctx.get(), buffer.data(), read_size) != 1) {
+      throw databento::Exception{"Unable to update SHA 256"};
+    }
+  }
+  std::array<unsigned char, EVP_MAX_MD_SIZE> digest{};
+  unsigned int digest_len{};
+  if (::EVP_DigestFinal_ex(ctx.get(), digest.data(), &digest_len) != 1) {
+    throw databento::Exception{"Unable to finalize SHA 256"};
+  }
+  std::ostringstream hex;
+  for (unsigned int i = 0; i < digest_len; ++i) {
+    hex << std::hex << std::setw(2) << std::setfill('0')
+        << static_cast<std::uint16_t>(digest[i]);
+  }
+  return hex.str();
+}
+
+// Returns whether the file at `path` matches the `hash` of a `BatchFileDesc`,
+// or `std::nullopt` if the hash is missing or uses an unsupported algorithm.
+std::optional<bool> MatchesHash(const std::filesystem::path& path,
+                                const std::string& hash) {
+  constexpr std::string_view kSha256Prefix = "sha256:";
+  if (hash.compare(0, kSha256Prefix.size(), kSha256Prefix) != 0) {
+    return std::nullopt;
+  }
+  return Sha256FileDigest(path) == hash.substr(kSha256Prefix.size());
 }
 
 void TryCreateDir(const std::filesystem::path& dir_name) {
@@ -118,6 +150,243 @@ void TryCreateDir(const std::filesystem::path& dir_name) {
   throw databento::Exception{"Unable to create directory "s +
                              dir_name.generic_string() + ": " + ec.message()};
 }
+
+// Buffers the records decoded by a worker thread from one of several concurrent
+// requests so they can be delivered in order from the calling thread. The
+// worker thread pauses once `max_buffered_bytes` are buffered, which in turn
+// applies backpressure to its connection. If constructed with a `spill_path`,
+// the worker thread instead writes further batches to that file, so it can move
+// on to another request before this one's records are consumed.
+class RecordBuffer {
+ public:
+  explicit RecordBuffer(std::size_t max_buffered_bytes)
+      : max_buffered_bytes_{max_buffered_bytes} {}
+  RecordBuffer(std::size_t max_buffered_bytes, std::filesystem::path spill_path)
+      : max_buffered_bytes_{max_buffered_bytes}, spill_path_{std::move(spill_path)} {}
+  RecordBuffer(const RecordBuffer&) = delete;
+  RecordBuffer& operator=(const RecordBuffer&) = delete;
+  ~RecordBuffer() {
+    if (spill_out_ || spill_in_) {
+      // Close the file before removing it
+      spill_out_.reset();
+      spill_in_.reset();
+      std::error_code ec{};
+      std::filesystem::remove(spill_path_, ec);
+    }
+  }
+
+  // Worker thread methods
+  void SetMetadata(databento::Metadata&& metadata) {
+    const std::lock_guard<std::mutex> lock{mutex_};
+    metadata_ = std::move(metadata);
+    cv_.notify_all();
+  }
+  databento::KeepGoing Push(const databento::Record& record) {
+    const auto* begin = reinterpret_cast<const std::byte*>(&record.Header());
+    batch_.insert(batch_.end(), begin, begin + record.Size());
+    if (batch_.size() < kBatchSize) {
+      return databento::KeepGoing::Continue;
+    }
+    return Flush();
+  }
+  void Finish(std::exception_ptr exc) {
+    if (!exc) {
+      Flush();
+    }
+    const std::lock_guard<std::mutex> lock{mutex_};
+    exc_ = std::move(exc);
+    is_done_ = true;
+    cv_.notify_all();
+  }
+
+  // Calling thread methods
+  // Returns `std::nullopt` if the sub-request finished without metadata.
+  std::optional<databento::Metadata> WaitForMetadata() {
+    std::unique_lock<std::mutex> lock{mutex_};
+    cv_.wait(lock, [this] { return metadata_.has_value() || is_done_; });
+    if (exc_) {
+      std::rethrow_exception(exc_);
+    }
+    return std::move(metadata_);
+  }
+  // Moves the next batch of records into `batch`. Returns false once all records
+  // have been delivered.
+  bool Pop(std::vector<std::byte>* batch) {
+    std::unique_lock<std::mutex> lock{mutex_};
+    cv_.wait(lock, [this] {
+      return !queue_.empty() || !spilled_sizes_.empty() || is_done_;
+    });
+    // Batches are only spilled while the queue is full, so the queue's are older
+    if (!queue_.empty()) {
+      *batch = std::move(queue_.front());
+      queue_.pop_front();
+      buffered_bytes_ -= batch->size();
+      cv_.notify_all();
+      return true;
+    }
+    if (!spilled_sizes_.empty()) {
+      const auto size = spilled_sizes_.front();
+      spilled_sizes_.pop_front();
+      lock.unlock();
+      if (!spill_in_) {
+        spill_in_.emplace(spill_path_);
+      }
+      batch->resize(size);
+      spill_in_->ReadExact(batch->data(), size);
+      return true;
+    }
+    if (exc_) {
+      std::rethrow_exception(exc_);
+    }
+    return false;
+  }
+  void Cancel() {
+    const std::lock_guard<std::mutex> lock{mutex_};
+    is_cancelled_ = true;
+    cv_.notify_all();
+  }
+  bool IsCancelled() const {
+    const std::lock_guard<std::mutex> lock{mutex_};
+    return is_cancelled_;
+  }
+
+ private:
+  static constexpr std::size_t kBatchSize = 64 * 1024;
+
+  databento::KeepGoing Flush() {
+    std::unique_lock<std::mutex> lock{mutex_};
+    if (spill_path_.empty()) {
+      cv_.wait(lock, [this] {
+        return buffered_bytes_ < max_buffered_bytes_ || is_cancelled_;
+      });
+    }
+    if (is_cancelled_) {
+      return databento::KeepGoing::Stop;
+    }
+    if (batch_.empty()) {
+      return databento::KeepGoing::Continue;
+    }
+    // Once spilling, later batches are also spilled until the calling thread has
+    // read the file's batches to keep them in order
+    if (buffered_bytes_ < max_buffered_bytes_ && spilled_sizes_.empty()) {
+      buffered_bytes_ += batch_.size();
+      queue_.emplace_back(std::move(batch_));
+      batch_ = {};
+      cv_.notify_all();
+      return databento::KeepGoing::Continue;
+    }
+    lock.unlock();
+    if (!spill_out_) {
+      spill_out_.emplace(spill_path_);
+    }
+    spill_out_->WriteAll(batch_.data(), batch_.size());
+    spill_out_->Flush();
+    lock.lock();
+    spilled_sizes_.push_back(batch_.size());
+    batch_.clear();
+    cv_.notify_all();
+    return databento::KeepGoing::Continue;
+  }
+
+  const std::size_t max_buffered_bytes_;
+  const std::filesystem::path spill_path_;
+  // Only accessed from the worker thread
+  std::vector<std::byte> batch_;
+  std::optional<databento::OutFileStream> spill_out_;
+  // Only accessed from the calling thread
+  std::optional<databento::InFileStream> spill_in_;
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::optional<databento::Metadata> metadata_;
+  std::deque<std::vector<std::byte>> queue_;
+  std::size_t buffered_bytes_{};
+  // The sizes of the batches in the spill file that haven't been popped
+  std::deque<std::size_t> spilled_sizes_;
+  std::exception_ptr exc_;
+  bool is_done_{};
+  bool is_cancelled_{};
+};
+
+// The worker threads filling a set of `RecordBuffer`s. On destruction, cancels
+// any still running, e.g. if a callback throws, and joins them.
+class RecordBufferWorkers {
+ public:
+  explicit RecordBufferWorkers(std::deque<RecordBuffer>* buffers)
+      : buffers_{buffers} {}
+  RecordBufferWorkers(const RecordBufferWorkers&) = delete;
+  RecordBufferWorkers& operator=(const RecordBufferWorkers&) = delete;
+  ~RecordBufferWorkers() {
+    for (auto& buffer : *buffers_) {
+      buffer.Cancel();
+    }
+  }
+
+  template <typename F>
+  void Spawn(F&& func) {
+    threads_.emplace_back(std::forward<F>(func));
+  }
+
+ private:
+  std::deque<RecordBuffer>* buffers_;
+  std::vector<databento::detail::ScopedThread> threads_;
+};
+
+// Calls `record_callback` with each record in a batch from a `RecordBuffer`.
+databento::KeepGoing ForEachRecord(std::vector<std::byte>* batch,
+                                   const databento::RecordCallback& record_callback) {
+  std::byte* pos = batch->data();
+  const std::byte* const end = pos + batch->size();
+  while (pos < end) {
+    // The vector's storage is suitably aligned for records and every record
+    // length preserves that alignment
+    const databento::Record record{reinterpret_cast<databento::RecordHeader*>(pos)};
+    if (record_callback(record) == databento::KeepGoing::Stop) {
+      return databento::KeepGoing::Stop;
+    }
+    pos += record.Size();
+  }
+  return databento::KeepGoing::Continue;
+}
+
+// Splits `range` into `count` consecutive sub-ranges of nearly equal length, or
+// fewer if `range` is shorter than `count` nanoseconds. Each boundary is
+// computed from the quotient and remainder of the duration because multiplying
+// the whole duration by the index can overflow for long ranges.
+std::vector<databento::DateTimeRange<databento::UnixNanos>> SplitDateTimeRange(
+    const databento::DateTimeRange<databento::UnixNanos>& range, std::uint64_t count) {
+  using Duration = databento::UnixNanos::duration;
+  const std::uint64_t duration = (range.end - range.start).count();
+  // Keeps `rem * i` from overflowing because both are less than `count`
+  count = std::min<std::uint64_t>(
+      {count, duration, std::numeric_limits<std::uint32_t>::max()});
+  const auto quot = duration / count;
+  const auto rem = duration % count;
+  const auto boundary = [&range, quot, rem, count](std::uint64_t i) {
+    return range.start + Duration{quot * i + rem * i / count};
+  };
+  std::vector<databento::DateTimeRange<databento::UnixNanos>> res;
+  res.reserve(count);
+  for (std::uint64_t i = 0; i < count; ++i) {
+    res.emplace_back(boundary(i), boundary(i + 1));
+  }
+  return res;
+}
+
+// Runs `func` on each of `queries` on `pool`.
+template <typename Q, typename F>
+std::vector<std::future<std::invoke_result_t<const F&, const Q&>>> LaunchEach(
+    databento::detail::WorkerPool* pool, const std::vector<Q>& queries, const F& func) {
+  using Result = std::invoke_result_t<const F&, const Q&>;
+  std::vector<std::future<Result>> futures;
+  futures.reserve(queries.size());
+  for (const auto& query : queries) {
+    auto task = std::make_shared<std::packaged_task<Result()>>(
+        [func, query] { return func(query); });
+    futures.emplace_back(task->get_future());
+    pool->Submit([task] { (*task)(); });
+  }
+  return futures;
+}
 }  // namespace
 
 databento::HistoricalBuilder Historical::Builder() {
@@ -130,27 +399,32 @@ Historical::Historical(ILogReceiver* log_receiver, std::string key,
       key_{std::move(key)},
       gateway_{UrlFromGateway(gateway)},
       upgrade_policy_{VersionUpgradePolicy::UpgradeToV3},
-      client_{log_receiver, key_, gateway_} {}
+      client_{log_receiver, key_, gateway_},
+      batch_pool_{std::make_unique<detail::WorkerPool>(
+          detail::HttpClient::kDefaultMaxConnections)} {}
 
 Historical::Historical(ILogReceiver* log_receiver, std::string key,
                        HistoricalGateway gateway, VersionUpgradePolicy upgrade_policy,
-                       std::string user_agent_ext)
+                       std::string user_agent_ext, std::size_t max_connections)
     : log_receiver_{log_receiver},
       key_{std::move(key)},
       gateway_{UrlFromGateway(gateway)},
       user_agent_ext_{std::move(user_agent_ext)},
       upgrade_policy_{upgrade_policy},
-      client_{log_receiver, key_, gateway_} {}
+      client_{log_receiver, key_, gateway_, 0, max_connections},
+      batch_pool_{std::make_unique<detail::WorkerPool>(max_connections)} {}
 
 Historical::Historical(ILogReceiver* log_receiver, std::string key, std::string gateway,
                        std::uint16_t port, VersionUpgradePolicy upgrade_policy,
-                       std::string user_agent_ext)
+                       std::string user_agent_ext, std::size_t max_connections)
     : log_receiver_{log_receiver},
       key_{std::move(key)},
       gateway_{std::move(gateway)},
+      port_{port},
       user_agent_ext_{std::move(user_agent_ext)},
       upgrade_policy_{upgrade_policy},
-      client_{log_receiver, key_, gateway_, port} {}
+      client_{log_receiver, key_, gateway_, port, max_connections},
+      batch_pool_{std::make_unique<detail::WorkerPool>(max_connections)} {}
 
 static const std::string kBatchSubmitJobEndpoint = "Historical::BatchSubmitJob";
 
@@ -225,7 +499,7 @@ databento::BatchJob Historical::BatchSubmitJob(
 databento::BatchJob Historical::BatchSubmitJob(const httplib::Params& params) {
   static const std::string kPath = ::BuildBatchPath(".submit_job");
   const nlohmann::json json = client_.PostJson(kPath, params);
-  return ::Parse("BatchSubmitJob", json);
+  return detail::ParseBatchJob("BatchSubmitJob", json);
 }
 
 std::vector<databento::BatchJob> Historical::BatchListJobs() {
@@ -251,14 +525,9 @@ std::vector<databento::BatchJob> Historical::BatchListJobs(
     const httplib::Params& params) {
   static const std::string kEndpoint = "Historical::BatchListJobs";
   static const std::string kPath = ::BuildBatchPath(".list_jobs");
-  const nlohmann::json json = client_.GetJson(kPath, params);
-  if (!json.is_array()) {
-    throw JsonResponseError::TypeMismatch(kEndpoint, "array", json);
-  }
-  std::vector<BatchJob> jobs;
-  std::transform(json.begin(), json.end(), std::back_inserter(jobs),
-                 [](const nlohmann::json& item) { return ::Parse(kEndpoint, item); });
-  return jobs;
+  detail::BatchJobsSax handler{kEndpoint};
+  client_.GetJsonSax(kPath, params, &handler);
+  return std::move(handler.Result());
 }
 
 std::vector<databento::BatchFileDesc> Historical::BatchListFiles(
@@ -322,36 +591,503 @@ std::filesystem::path Historical::BatchDownload(
   return output_path;
 }
 
-void Historical::DownloadFile(const std::string& url,
-                              const std::filesystem::path& output_path) {
-  static const std::string kMethod = "Historical::DownloadFile";
-  // extract path from URL
-  const auto protocol_divider = url.find("://");
-  std::string path;
+namespace {
+// A batch file being downloaded by `Historical::BatchDownload` with options.
+struct BatchFileDownload {
+  const databento::BatchFileDesc* desc;
+  std::filesystem::path path;
+  // Where the file is written until it's complete and verified
+  std::filesystem::path part_path;
+  // Records the completed chunks of files split into multiple ranges
+  std::filesystem::path chunks_path;
+  std::string url_path;
+  std::size_t num_chunks;
+  std::size_t remaining_chunks;
+};
 
-  if (protocol_divider == std::string::npos) {
-    const auto slash = url.find_first_of('/');
-    if (slash == std::string::npos) {
-      throw InvalidArgumentError{kMethod, "url", "No slashes"};
+// A byte range [`offset`, `end`) of a batch file. An `end` of 0 means the end
+// of the file.
+struct BatchChunkTask {
+  std::size_t file_idx;
+  std::size_t chunk_idx;
+  std::uint64_t offset;
+  std::uint64_t end;
+};
+
+// Returns the indices of chunks recorded as complete in `chunks_path`, or an
+// empty vector if it was written with a different `chunk_size`.
+std::vector<bool> ReadCompletedChunks(const std::filesystem::path& chunks_path,
+                                      std::uint64_t chunk_size,
+                                      std::size_t num_chunks) {
+  std::vector<bool> completed;
+  std::ifstream chunks_file{chunks_path};
+  std::uint64_t file_chunk_size{};
+  if (!(chunks_file >> file_chunk_size) || file_chunk_size != chunk_size) {
+    return completed;
+  }
+  completed.resize(num_chunks);
+  std::size_t chunk_idx{};
+  while (chunks_file >> chunk_idx) {
+    if (chunk_idx < num_chunks) {
+      completed[chunk_idx] = true;
     }
-    path = url.substr(slash);
-  } else {
-    const auto slash = url.find('/', protocol_divider + 3);
-    if (slash == std::string::npos) {
-      throw InvalidArgumentError{kMethod, "url", "No slashes"};
+  }
+  return completed;
+}
+}  // namespace
+
+std::vector<std::filesystem::path> Historical::BatchDownload(
+    const std::filesystem::path& output_dir, const std::string& job_id,
+    const BatchDownloadOptions& options) {
+  static const std::string kMethod = "Historical::BatchDownload";
+  constexpr std::chrono::milliseconds kProgressInterval{250};
+
+  if (options.max_connections == 0) {
+    throw InvalidArgumentError{kMethod, "options.max_connections", "must be positive"};
+  }
+  const auto start_time = std::chrono::steady_clock::now();
+  TryCreateDir(output_dir);
+  const std::filesystem::path job_dir = output_dir / job_id;
+  TryCreateDir(job_dir);
+  const auto file_descs = BatchListFiles(job_id);
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<BatchFileDownload> files;
+  files.reserve(file_descs.size());
+  std::vector<BatchChunkTask> tasks;
+  std::atomic<std::uint64_t> bytes_downloaded{};
+  std::uint64_t resumed_bytes{};
+  std::uint64_t total_bytes{};
+  std::size_t files_completed{};
+  std::vector<std::filesystem::path> paths;
+  paths.reserve(file_descs.size());
+
+  // Verifies a downloaded file and moves it to its final path
+  const auto finish_file = [&options](const BatchFileDownload& file) {
+    if (options.verify_hash &&
+        MatchesHash(file.part_path, file.desc->hash) == std::optional<bool>{false}) {
+      std::filesystem::remove(file.part_path);
+      std::filesystem::remove(file.chunks_path);
+      throw Exception{"Hash mismatch for downloaded batch file " +
+                      file.path.generic_string() + ", expected " + file.desc->hash};
+    }
+    std::filesystem::rename(file.part_path, file.path);
+    std::filesystem::remove(file.chunks_path);
+  };
+
+  for (const auto& file_desc : file_descs) {
+    total_bytes += file_desc.size;
+    BatchFileDownload file{&file_desc,
+                           job_dir / file_desc.filename,
+                           {},
+                           {},
+                           PathFromUrl(kMethod, file_desc.https_url),
+                           1,
+                           0};
+    file.part_path = file.path;
+    file.part_path += ".part";
+    file.chunks_path = file.part_path;
+    file.chunks_path += ".chunks";
+    paths.emplace_back(file.path);
+    const auto file_idx = files.size();
+
+    if (!options.resume) {
+      std::filesystem::remove(file.part_path);
+      std::filesystem::remove(file.chunks_path);
+    } else if (file_desc.size > 0 && std::filesystem::exists(file.path) &&
+               std::filesystem::file_size(file.path) == file_desc.size &&
+               (!options.verify_hash ||
+                MatchesHash(file.path, file_desc.hash) != std::optional<bool>{false})) {
+      std::ostringstream ss;
+      ss << '[' << kMethod << "] Skipping already downloaded batch file "
+         << file.path;
+      log_receiver_->Receive(LogLevel::Info, ss.str());
+      resumed_bytes += file_desc.size;
+      ++files_completed;
+      continue;
+    }
+    if (options.chunk_size > 0 && file_desc.size > options.chunk_size) {
+      file.num_chunks =
+          (file_desc.size + options.chunk_size - 1) / options.chunk_size;
+      std::vector<bool> completed;
+      if (std::filesystem::exists(file.part_path) &&
+          std::filesystem::file_size(file.part_path) == file_desc.size) {
+        completed =
+            ReadCompletedChunks(file.chunks_path, options.chunk_size, file.num_chunks);
+      }
+      if (completed.empty()) {
+        completed.resize(file.num_chunks);
+        // Preallocate the file so each chunk can be written at its offset
+        { std::ofstream part_file{file.part_path, std::ios::binary}; }
+        std::filesystem::resize_file(file.part_path, file_desc.size);
+        std::ofstream chunks_file{file.chunks_path, std::ios::trunc};
+        chunks_file << options.chunk_size << '\n';
+      }
+      for (std::size_t chunk_idx = 0; chunk_idx < file.num_chunks; ++chunk_idx) {
+        const std::uint64_t offset = chunk_idx * options.chunk_size;
+        const std::uint64_t end =
+            std::min<std::uint64_t>(offset + options.chunk_size, file_desc.size);
+        if (completed[chunk_idx]) {
+          resumed_bytes += end - offset;
+        } else {
+          tasks.push_back(BatchChunkTask{file_idx, chunk_idx, offset, end});
+          ++file.remaining_chunks;
+        }
+      }
+    } else {
+      std::uint64_t offset{};
+      if (std::filesystem::exists(file.part_path)) {
+        offset = std::filesystem::file_size(file.part_path);
+      }
+      if (file_desc.size > 0 && offset > file_desc.size) {
+        offset = 0;
+      }
+      if (offset == 0) {
+        const std::ofstream part_file{file.part_path, std::ios::binary};
+      }
+      resumed_bytes += offset;
+      if (file_desc.size == 0 || offset < file_desc.size) {
+        tasks.push_back(BatchChunkTask{file_idx, 0, offset, file_desc.size});
+        ++file.remaining_chunks;
+      }
+    }
+    if (file.remaining_chunks == 0) {
+      // Downloaded by a previous attempt but not yet verified
+      finish_file(file);
+      ++files_completed;
+      continue;
+    }
+    std::ostringstream ss;
+    ss << '[' << kMethod << "] Downloading batch file " << file.url_path << " to "
+       << file.path;
+    log_receiver_->Receive(LogLevel::Info, ss.str());
+    files.emplace_back(std::move(file));
+  }
+
+  std::atomic<std::size_t> next_task{};
+  std::atomic<bool> is_cancelled{};
+  std::exception_ptr exc;
+  std::size_t workers_running =
+      std::min<std::size_t>(options.max_connections, tasks.size());
+  const auto run_task = [&](detail::HttpClient& client, const BatchChunkTask& task) {
+    auto& file = files[task.file_idx];
+    std::fstream part_file{file.part_path,
+                           std::ios::binary | std::ios::in | std::ios::out};
+    if (!part_file.is_open()) {
+      throw Exception{"Unable to open file " + file.part_path.generic_string()};
+    }
+    part_file.seekp(static_cast<std::streamoff>(task.offset));
+    std::uint64_t chunk_bytes{};
+    client.GetRangeStream(file.url_path, task.offset, task.end,
+                          [&](const char* data, std::size_t length) {
+                            part_file.write(data, static_cast<std::streamsize>(length));
+                            chunk_bytes += length;
+                            bytes_downloaded += length;
+                            return !is_cancelled.load() && part_file.good();
+                          });
+    part_file.close();
+    if (part_file.fail()) {
+      throw Exception{"Error writing to file " + file.part_path.generic_string()};
+    }
+    if (is_cancelled.load()) {
+      return;
+    }
+    if (task.end > 0 && chunk_bytes != task.end - task.offset) {
+      std::ostringstream ss;
+      ss << "Incomplete download of batch file " << file.path << ": received "
+         << chunk_bytes << " of " << task.end - task.offset << " bytes";
+      throw Exception{ss.str()};
+    }
+    bool is_file_done{};
+    {
+      const std::lock_guard<std::mutex> lock{mutex};
+      if (file.num_chunks > 1) {
+        std::ofstream chunks_file{file.chunks_path, std::ios::app};
+        chunks_file << task.chunk_idx << '\n';
+      }
+      is_file_done = --file.remaining_chunks == 0;
+    }
+    if (is_file_done) {
+      finish_file(file);
+      const std::lock_guard<std::mutex> lock{mutex};
+      ++files_completed;
+    }
+  };
+  const auto make_progress = [&] {
+    const auto downloaded = bytes_downloaded.load();
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start_time;
+    const std::lock_guard<std::mutex> lock{mutex};
+    return BatchDownloadProgress{
+        resumed_bytes + downloaded, total_bytes, files_completed, file_descs.size(),
+        elapsed.count() > 0 ? static_cast<double>(downloaded) / elapsed.count() : 0.0};
+  };
+  {
+    std::vector<detail::ScopedThread> workers;
+    workers.reserve(workers_running);
+    for (std::size_t i = 0; i < workers_running; ++i) {
+      workers.emplace_back([&] {
+        try {
+          auto client = MakeClient();
+          for (auto task_idx = next_task++; task_idx < tasks.size() && !is_cancelled;
+               task_idx = next_task++) {
+            run_task(client, tasks[task_idx]);
+          }
+        } catch (...) {
+          const std::lock_guard<std::mutex> lock{mutex};
+          if (!exc) {
+            exc = std::current_exception();
+          }
+          is_cancelled = true;
+        }
+        const std::lock_guard<std::mutex> lock{mutex};
+        --workers_running;
+        cv.notify_all();
+      });
+    }
+    try {
+      std::unique_lock<std::mutex> lock{mutex};
+      while (!cv.wait_for(lock, kProgressInterval,
+                          [&workers_running] { return workers_running == 0; })) {
+        if (options.progress_callback) {
+          lock.unlock();
+          options.progress_callback(make_progress());
+          lock.lock();
+        }
+      }
+    } catch (...) {
+      // Stop the workers so they can be joined
+      is_cancelled = true;
+      throw;
+    }
+  }  // Join workers
+  if (exc) {
+    std::rethrow_exception(exc);
+  }
+  if (options.progress_callback) {
+    options.progress_callback(make_progress());
+  }
+  return paths;
+}
+
+namespace {
+// Returns the compression of a batch file based on its name, or `std::nullopt`
+// if it isn't DBN-encoded.
+std::optional<databento::Compression> DbnFileCompression(const std::string& filename) {
+  constexpr std::string_view kDbnZstdSuffix = ".dbn.zst";
+  constexpr std::string_view kDbnSuffix = ".dbn";
+  const auto ends_with = [&filename](std::string_view suffix) {
+    return filename.size() >= suffix.size() &&
+           filename.compare(filename.size() - suffix.size(), suffix.size(),
+                            suffix) == 0;
+  };
+  if (ends_with(kDbnZstdSuffix)) {
+    return databento::Compression::Zstd;
+  }
+  if (ends_with(kDbnSuffix)) {
+    return databento::Compression::None;
+  }
+  return std::nullopt;
+}
+}  // namespace
+
+void Historical::BatchStream(const std::string& job_id,
+                             const MetadataCallback& metadata_callback,
+                             const RecordCallback& record_callback) {
+  this->BatchStream(job_id, {}, metadata_callback, record_callback);
+}
+void Historical::BatchStream(const std::string& job_id,
+                             const BatchStreamOptions& options,
+                             const MetadataCallback& metadata_callback,
+                             const RecordCallback& record_callback) {
+  static const std::string kMethod = "Historical::BatchStream";
+  if (options.max_connections == 0) {
+    throw InvalidArgumentError{kMethod, "options.max_connections", "must be positive"};
+  }
+  if (options.max_buffered_bytes == 0) {
+    throw InvalidArgumentError{kMethod, "options.max_buffered_bytes",
+                               "must be positive"};
+  }
+  TryCreateDir(options.tee_dir);
+  std::vector<BatchFileDesc> file_descs = BatchListFiles(job_id);
+  if (options.tee_dir.empty()) {
+    // Other files are only downloaded when teeing
+    file_descs.erase(std::remove_if(file_descs.begin(), file_descs.end(),
+                                    [](const BatchFileDesc& file_desc) {
+                                      return !DbnFileCompression(file_desc.filename);
+                                    }),
+                     file_descs.end());
+  }
+  if (file_descs.empty()) {
+    return;
+  }
+  std::vector<std::string> url_paths;
+  url_paths.reserve(file_descs.size());
+  for (const auto& file_desc : file_descs) {
+    url_paths.emplace_back(PathFromUrl(kMethod, file_desc.https_url));
+  }
+
+  // Files are assigned to workers in order so the file being delivered always
+  // has a worker
+  const std::size_t num_workers = std::min(options.max_connections, file_descs.size());
+  // Merging needs records from every file, so when there are more files than
+  // workers, each worker spills the records it can't buffer to disk rather than
+  // waiting for them to be consumed, leaving it free for the remaining files
+  const bool spill = options.mode == BatchStreamMode::Merge &&
+                     file_descs.size() > options.max_connections;
+  // `RecordBuffer` isn't movable
+  std::deque<RecordBuffer> buffers;
+  for (const auto& file_desc : file_descs) {
+    if (spill) {
+      buffers.emplace_back(
+          options.max_buffered_bytes,
+          detail::TempPath(std::filesystem::temp_directory_path() /
+                           std::filesystem::path{file_desc.filename}.filename()));
+    } else {
+      buffers.emplace_back(options.max_buffered_bytes);
+    }
+  }
+  std::atomic<std::size_t> next_file{};
+  const auto stream_file = [this, &options](detail::HttpClient& client,
+                                            const BatchFileDesc& file_desc,
+                                            const std::string& url_path,
+                                            RecordBuffer& buffer) {
+    std::optional<OutFileStream> tee_file;
+    if (!options.tee_dir.empty()) {
+      tee_file.emplace(options.tee_dir / file_desc.filename, kFileWriteBufferSize);
+    }
+    const auto tee = [&tee_file](const char* data, std::size_t length) {
+      if (tee_file) {
+        tee_file->WriteAll(reinterpret_cast<const std::byte*>(data), length);
+      }
+    };
+    const auto compression = DbnFileCompression(file_desc.filename);
+    if (!compression) {
+      client.GetRawStream(url_path, {},
+                          [&tee, &buffer](const char* data, std::size_t length) {
+                            tee(data, length);
+                            return !buffer.IsCancelled();
+                          });
+      if (tee_file) {
+        // The destructor would ignore errors writing the last block
+        tee_file->Flush();
+      }
+      return;
+    }
+    const MetadataCallback file_metadata_callback = [&buffer](Metadata&& metadata) {
+      buffer.SetMetadata(std::move(metadata));
+    };
+    const RecordCallback file_record_callback = [&buffer](const Record& record) {
+      return buffer.Push(record);
+    };
+    detail::DbnBufferDecoder decoder{*compression, upgrade_policy_,
+                                     file_metadata_callback, file_record_callback};
+    client.GetRawStream(url_path, {},
+                        [&tee, &decoder](const char* data, std::size_t length) {
+                          tee(data, length);
+                          return decoder.Process(data, length) == KeepGoing::Continue;
+                        });
+    if (tee_file) {
+      tee_file->Flush();
+    }
+  };
+  RecordBufferWorkers workers{&buffers};
+  for (std::size_t i = 0; i < num_workers; ++i) {
+    workers.Spawn([this, &file_descs, &url_paths, &buffers, &next_file, &stream_file] {
+      std::optional<detail::HttpClient> client;
+      for (auto file_idx = next_file++; file_idx < file_descs.size();
+           file_idx = next_file++) {
+        auto& buffer = buffers[file_idx];
+        try {
+          if (!buffer.IsCancelled()) {
+            if (!client) {
+              client.emplace(MakeClient());
+            }
+            stream_file(*client, file_descs[file_idx], url_paths[file_idx], buffer);
+          }
+          buffer.Finish({});
+        } catch (...) {
+          buffer.Finish(std::current_exception());
+        }
+      }
+    });
+  }
+
+  std::vector<std::byte> batch;
+  if (options.mode == BatchStreamMode::Concatenate) {
+    for (auto& buffer : buffers) {
+      auto metadata = buffer.WaitForMetadata();
+      if (metadata && metadata_callback) {
+        metadata_callback(std::move(*metadata));
+      }
+      while (buffer.Pop(&batch)) {
+        if (ForEachRecord(&batch, record_callback) == KeepGoing::Stop) {
+          return;
+        }
+      }
+    }
+    return;
+  }
+
+  for (auto& buffer : buffers) {
+    auto metadata = buffer.WaitForMetadata();
+    if (metadata && metadata_callback) {
+      metadata_callback(std::move(*metadata));
     }
-    path = url.substr(slash);
   }
+  // A k-way merge of the buffered records of each file by index timestamp,
+  // breaking ties by file order
+  struct Cursor {
+    std::vector<std::byte> batch;
+    std::size_t pos;
+
+    Record Current() {
+      return Record{reinterpret_cast<RecordHeader*>(&batch[pos])};
+    }
+  };
+  std::vector<Cursor> cursors(buffers.size());
+  using HeapEntry = std::pair<UnixNanos, std::size_t>;
+  std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<>> heap;
+  for (std::size_t i = 0; i < buffers.size(); ++i) {
+    if (buffers[i].Pop(&cursors[i].batch)) {
+      heap.emplace(cursors[i].Current().IndexTs(), i);
+    }
+  }
+  while (!heap.empty()) {
+    const auto file_idx = heap.top().second;
+    heap.pop();
+    auto& cursor = cursors[file_idx];
+    const auto record = cursor.Current();
+    if (record_callback(record) == KeepGoing::Stop) {
+      return;
+    }
+    cursor.pos += record.Size();
+    if (cursor.pos == cursor.batch.size()) {
+      cursor.pos = 0;
+      if (!buffers[file_idx].Pop(&cursor.batch)) {
+        continue;
+      }
+    }
+    heap.emplace(cursor.Current().IndexTs(), file_idx);
+  }
+}
+
+void Historical::DownloadFile(const std::string& url,
+                              const std::filesystem::path& output_path) {
+  static const std::string kMethod = "Historical::DownloadFile";
+  const std::string path = PathFromUrl(kMethod, url);
   std::ostringstream ss;
   ss << '[' << kMethod << "] Downloading batch file " << path << " to " << output_path;
   log_receiver_->Receive(LogLevel::Info, ss.str());
 
-  OutFileStream out_file{output_path};
+  OutFileStream out_file{output_path, kFileWriteBufferSize};
   this->client_.GetRawStream(
       path, {}, [&out_file](const char* data, std::size_t length) {
         out_file.WriteAll(reinterpret_cast<const std::byte*>(data), length);
         return true;
       });
+  out_file.Flush();
 
   if (log_receiver_->ShouldLog(LogLevel::Debug)) {
     ss.str("");
@@ -716,6 +1452,155 @@ double Historical::MetadataGetCost(const HttplibParams& params) {
   return json;
 }
 
+std::vector<std::future<std::uint64_t>> Historical::MetadataGetRecordCountBatch(
+    const std::vector<MetadataQuery>& queries) {
+  return LaunchEach(batch_pool_.get(), queries, [this](const MetadataQuery& query) {
+    return this->MetadataGetRecordCount(query.dataset, query.datetime_range,
+                                        query.symbols, query.schema, query.stype_in,
+                                        query.limit);
+  });
+}
+
+std::vector<std::future<std::uint64_t>> Historical::MetadataGetBillableSizeBatch(
+    const std::vector<MetadataQuery>& queries) {
+  return LaunchEach(batch_pool_.get(), queries, [this](const MetadataQuery& query) {
+    return this->MetadataGetBillableSize(query.dataset, query.datetime_range,
+                                         query.symbols, query.schema, query.stype_in,
+                                         query.limit);
+  });
+}
+
+std::vector<std::future<double>> Historical::MetadataGetCostBatch(
+    const std::vector<MetadataQuery>& queries) {
+  return LaunchEach(batch_pool_.get(), queries, [this](const MetadataQuery& query) {
+    return this->MetadataGetCost(query.dataset, query.datetime_range, query.symbols,
+                                 query.schema, query.mode, query.stype_in,
+                                 query.limit);
+  });
+}
+
+static const std::string kMetadataPlanRequestsEndpoint =
+    "Historical::MetadataPlanRequests";
+
+std::vector<databento::PlannedRequest> Historical::MetadataPlanRequests(
+    const MetadataQuery& query, const RequestPlanOptions& options) {
+  if (options.max_request_size == 0) {
+    throw InvalidArgumentError{kMetadataPlanRequestsEndpoint,
+                               "options.max_request_size", "must be positive"};
+  }
+  if (options.max_symbols == 0) {
+    throw InvalidArgumentError{kMetadataPlanRequestsEndpoint, "options.max_symbols",
+                               "must be positive"};
+  }
+  if (options.num_slices == 0) {
+    throw InvalidArgumentError{kMetadataPlanRequestsEndpoint, "options.num_slices",
+                               "must be positive"};
+  }
+  if (query.datetime_range.end <= query.datetime_range.start) {
+    throw InvalidArgumentError{kMetadataPlanRequestsEndpoint, "query.datetime_range",
+                               "end must be set and after start"};
+  }
+  if (query.limit != 0) {
+    throw InvalidArgumentError{kMetadataPlanRequestsEndpoint, "query.limit",
+                               "can't be split"};
+  }
+  if (query.symbols.empty()) {
+    throw InvalidArgumentError{kMetadataPlanRequestsEndpoint, "query.symbols",
+                               "Cannot be empty"};
+  }
+  std::vector<std::vector<std::string>> symbol_chunks;
+  for (std::size_t i = 0; i < query.symbols.size(); i += options.max_symbols) {
+    const auto chunk_begin = query.symbols.begin() + static_cast<std::ptrdiff_t>(i);
+    const auto chunk_size = std::min(options.max_symbols, query.symbols.size() - i);
+    symbol_chunks.emplace_back(chunk_begin,
+                               chunk_begin + static_cast<std::ptrdiff_t>(chunk_size));
+  }
+
+  struct Slice {
+    std::size_t chunk;
+    DateTimeRange<UnixNanos> datetime_range;
+    std::uint64_t billable_size;
+    std::uint64_t record_count;
+  };
+  // Divides `range` into at most `count` slices, none shorter than a nanosecond
+  const auto divide = [](std::size_t chunk, const DateTimeRange<UnixNanos>& range,
+                         std::uint64_t count, std::vector<Slice>* slices) {
+    for (const auto& sub_range : SplitDateTimeRange(range, count)) {
+      slices->emplace_back(Slice{chunk, sub_range, 0, 0});
+    }
+  };
+  // Queries the sizes of `slices[first..]` concurrently
+  const auto query_sizes = [this, &query, &symbol_chunks](std::vector<Slice>* slices,
+                                                          std::size_t first) {
+    std::vector<MetadataQuery> queries;
+    queries.reserve(slices->size() - first);
+    for (auto it = slices->begin() + static_cast<std::ptrdiff_t>(first);
+         it != slices->end(); ++it) {
+      queries.emplace_back(MetadataQuery{query.dataset, it->datetime_range,
+                                         symbol_chunks[it->chunk], query.schema,
+                                         query.mode, query.stype_in, 0});
+    }
+    auto sizes = MetadataGetBillableSizeBatch(queries);
+    auto counts = MetadataGetRecordCountBatch(queries);
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+      (*slices)[first + i].billable_size = sizes[i].get();
+      (*slices)[first + i].record_count = counts[i].get();
+    }
+  };
+
+  std::vector<Slice> slices;
+  for (std::size_t chunk = 0; chunk < symbol_chunks.size(); ++chunk) {
+    divide(chunk, query.datetime_range, options.num_slices, &slices);
+  }
+  query_sizes(&slices, 0);
+  // Data is rarely evenly distributed over time, so only the slices that are
+  // too large are divided further
+  for (std::size_t round = 0; round < options.max_refinements; ++round) {
+    std::vector<Slice> kept;
+    std::vector<Slice> refined;
+    for (const auto& slice : slices) {
+      if (slice.billable_size > options.max_request_size &&
+          slice.datetime_range.end - slice.datetime_range.start >
+              std::chrono::nanoseconds{1}) {
+        // Round up so each part is expected to fit
+        const auto parts = (slice.billable_size + options.max_request_size - 1) /
+                           options.max_request_size;
+        divide(slice.chunk, slice.datetime_range, parts, &refined);
+      } else {
+        kept.emplace_back(slice);
+      }
+    }
+    if (refined.empty()) {
+      break;
+    }
+    const auto first_refined = kept.size();
+    kept.insert(kept.end(), refined.begin(), refined.end());
+    query_sizes(&kept, first_refined);
+    std::sort(kept.begin(), kept.end(), [](const Slice& lhs, const Slice& rhs) {
+      return std::tie(lhs.chunk, lhs.datetime_range.start) <
+             std::tie(rhs.chunk, rhs.datetime_range.start);
+    });
+    slices = std::move(kept);
+  }
+
+  // Greedily combine adjacent slices up to the maximum size
+  std::vector<PlannedRequest> res;
+  std::size_t res_chunk{};
+  for (const auto& slice : slices) {
+    if (!res.empty() && res_chunk == slice.chunk &&
+        res.back().billable_size + slice.billable_size <= options.max_request_size) {
+      res.back().datetime_range.end = slice.datetime_range.end;
+      res.back().billable_size += slice.billable_size;
+      res.back().record_count += slice.record_count;
+    } else {
+      res.emplace_back(PlannedRequest{slice.datetime_range, symbol_chunks[slice.chunk],
+                                      slice.billable_size, slice.record_count});
+      res_chunk = slice.chunk;
+    }
+  }
+  return res;
+}
+
 databento::SymbologyResolution Historical::SymbologyResolve(
     const std::string& dataset, const std::vector<std::string>& symbols, SType stype_in,
     SType stype_out, const DateRange& date_range) {
@@ -727,59 +1612,19 @@ databento::SymbologyResolution Historical::SymbologyResolve(
                          {"stype_in", ToString(stype_in)},
                          {"stype_out", ToString(stype_out)}};
   detail::SetIfNotEmpty(&params, "end_date", date_range.end);
-  const nlohmann::json json = client_.PostJson(kPath, params);
-  if (!json.is_object()) {
-    throw JsonResponseError::TypeMismatch(kEndpoint, "object", json);
-  }
-  const auto& mappings_json = detail::CheckedAt(kEndpoint, json, "result");
-  const auto& partial_json = detail::CheckedAt(kEndpoint, json, "partial");
-  const auto& not_found_json = detail::CheckedAt(kEndpoint, json, "not_found");
-  SymbologyResolution res{{}, {}, {}, stype_in, stype_out};
-  if (!mappings_json.is_object()) {
-    throw JsonResponseError::TypeMismatch(kEndpoint, "mappings object", mappings_json);
-  }
-  res.mappings.reserve(mappings_json.size());
-  for (const auto& mapping : mappings_json.items()) {
-    const auto& mapping_json = mapping.value();
-    if (!mapping_json.is_array()) {
-      throw JsonResponseError::TypeMismatch(kEndpoint, "array", mapping.key(),
-                                            mapping_json);
-    }
-    std::vector<MappingInterval> mapping_intervals;
-    std::transform(
-        mapping_json.begin(), mapping_json.end(), std::back_inserter(mapping_intervals),
-        [](const nlohmann::json& interval_json) {
-          return MappingInterval{
-              detail::ParseAt<date::year_month_day>(kEndpoint, interval_json, "d0"),
-              detail::ParseAt<date::year_month_day>(kEndpoint, interval_json, "d1"),
-              detail::CheckedAt(kEndpoint, interval_json, "s"),
-          };
-        });
-    res.mappings.emplace(mapping.key(), std::move(mapping_intervals));
-  }
-  if (!partial_json.is_array()) {
-    throw JsonResponseError::TypeMismatch(kEndpoint, "partial array", partial_json);
-  }
-  res.partial.reserve(partial_json.size());
-  for (const auto& symbol : partial_json.items()) {
-    if (!symbol.value().is_string()) {
-      throw JsonResponseError::TypeMismatch(kEndpoint, "nested string", symbol.key(),
-                                            symbol.value());
-    }
-    res.partial.emplace_back(symbol.value());
-  }
-  if (!not_found_json.is_array()) {
-    throw JsonResponseError::TypeMismatch(kEndpoint, "not_found array", not_found_json);
-  }
-  res.not_found.reserve(not_found_json.size());
-  for (const auto& symbol : not_found_json.items()) {
-    if (!symbol.value().is_string()) {
-      throw JsonResponseError::TypeMismatch(kEndpoint, "nested string", symbol.key(),
-                                            symbol.value());
-    }
-    res.not_found.emplace_back(symbol.value());
-  }
-  return res;
+  // Parsed without an intermediate DOM since responses for large universes can
+  // contain hundreds of thousands of mappings
+  detail::SymbologyResolutionSax handler{kEndpoint, stype_in, stype_out};
+  client_.PostJsonSax(kPath, params, &handler);
+  return std::move(handler.Result());
+}
+
+std::vector<std::future<databento::SymbologyResolution>>
+Historical::SymbologyResolveBatch(const std::vector<SymbologyQuery>& queries) {
+  return LaunchEach(batch_pool_.get(), queries, [this](const SymbologyQuery& query) {
+    return this->SymbologyResolve(query.dataset, query.symbols, query.stype_in,
+                                  query.stype_out, query.date_range);
+  });
 }
 
 static const std::string kTimeseriesGetRangeEndpoint = "Historical::TimeseriesGetRange";
@@ -873,6 +1718,206 @@ void Historical::TimeseriesGetRange(const HttplibParams& params,
   }
 }
 
+static const std::string kTimeseriesGetRangeBufferedEndpoint =
+    "Historical::TimeseriesGetRangeBuffered";
+
+databento::TimeseriesStreamStats Historical::TimeseriesGetRangeBuffered(
+    const std::string& dataset, const DateTimeRange<UnixNanos>& datetime_range,
+    const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+    SType stype_out, std::uint64_t limit, const TimeseriesBufferOptions& options,
+    const MetadataCallback& metadata_callback, const RecordCallback& record_callback) {
+  httplib::Params params{
+      {"dataset", dataset},
+      {"encoding", "dbn"},
+      {"compression", "zstd"},
+      {"start", ToString(datetime_range.start)},
+      {"symbols", JoinSymbolStrings(kTimeseriesGetRangeBufferedEndpoint, symbols)},
+      {"schema", ToString(schema)},
+      {"stype_in", ToString(stype_in)},
+      {"stype_out", ToString(stype_out)}};
+  detail::SetIfPositive(&params, "end", datetime_range.end);
+  detail::SetIfPositive(&params, "limit", limit);
+  return this->TimeseriesGetRangeBuffered(params, options, metadata_callback,
+                                          record_callback);
+}
+databento::TimeseriesStreamStats Historical::TimeseriesGetRangeBuffered(
+    const std::string& dataset, const DateTimeRange<std::string>& datetime_range,
+    const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+    SType stype_out, std::uint64_t limit, const TimeseriesBufferOptions& options,
+    const MetadataCallback& metadata_callback, const RecordCallback& record_callback) {
+  httplib::Params params{
+      {"dataset", dataset},
+      {"encoding", "dbn"},
+      {"compression", "zstd"},
+      {"start", datetime_range.start},
+      {"symbols", JoinSymbolStrings(kTimeseriesGetRangeBufferedEndpoint, symbols)},
+      {"schema", ToString(schema)},
+      {"stype_in", ToString(stype_in)},
+      {"stype_out", ToString(stype_out)}};
+  detail::SetIfNotEmpty(&params, "end", datetime_range.end);
+  detail::SetIfPositive(&params, "limit", limit);
+  return this->TimeseriesGetRangeBuffered(params, options, metadata_callback,
+                                          record_callback);
+}
+databento::TimeseriesStreamStats Historical::TimeseriesGetRangeBuffered(
+    const HttplibParams& params, const TimeseriesBufferOptions& options,
+    const MetadataCallback& metadata_callback, const RecordCallback& record_callback) {
+  if (options.num_buffers == 0) {
+    throw InvalidArgumentError{kTimeseriesGetRangeBufferedEndpoint,
+                               "options.num_buffers", "must be positive"};
+  }
+  if (options.buffer_size == 0) {
+    throw InvalidArgumentError{kTimeseriesGetRangeBufferedEndpoint,
+                               "options.buffer_size", "must be positive"};
+  }
+  const auto start = std::chrono::steady_clock::now();
+  detail::ChunkQueue queue{options.num_buffers, options.buffer_size};
+  detail::DbnBufferDecoder decoder{upgrade_policy_, metadata_callback, record_callback};
+  bool early_exit = false;
+  {
+    const detail::ScopedThread receive_thread{[this, &params, &queue] {
+      try {
+        this->client_.PostRawStream(kTimeseriesGetRangePath, params,
+                                    [&queue](const char* data, std::size_t length) {
+                                      return queue.Write(data, length);
+                                    });
+        queue.Finish({});
+      } catch (...) {
+        queue.Finish(std::current_exception());
+      }
+    }};
+    std::vector<std::byte> chunk;
+    try {
+      while (queue.Read(&chunk)) {
+        if (decoder.Process(reinterpret_cast<const char*>(chunk.data()),
+                            chunk.size()) == KeepGoing::Stop) {
+          early_exit = true;
+          queue.Cancel();
+          break;
+        }
+      }
+    } catch (...) {
+      // Unblock the receiving thread so it can be joined
+      queue.Cancel();
+      throw;
+    }
+  }  // Join receive_thread
+  if (!early_exit && decoder.UnreadBytes() > 0) {
+    std::ostringstream ss;
+    ss << "[Historical::TimeseriesGetRangeBuffered] Partial or incomplete record "
+          "remaining of "
+       << decoder.UnreadBytes() << " bytes";
+    log_receiver_->Receive(LogLevel::Warning, ss.str());
+  }
+  const auto queue_stats = queue.GetStats();
+  return TimeseriesStreamStats{
+      queue_stats.bytes_written, queue_stats.chunks_read, queue_stats.max_depth,
+      queue_stats.producer_waits,
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start)};
+}
+
+static const std::string kTimeseriesGetRangeSplitEndpoint =
+    "Historical::TimeseriesGetRangeSplit";
+
+void Historical::TimeseriesGetRangeSplit(const std::string& dataset,
+                                         const DateTimeRange<UnixNanos>& datetime_range,
+                                         const std::vector<std::string>& symbols,
+                                         Schema schema, SType stype_in,
+                                         SType stype_out,
+                                         const TimeseriesSplitOptions& options,
+                                         const MetadataCallback& metadata_callback,
+                                         const RecordCallback& record_callback) {
+  if (options.num_splits == 0) {
+    throw InvalidArgumentError{kTimeseriesGetRangeSplitEndpoint, "options.num_splits",
+                               "must be positive"};
+  }
+  if (options.max_buffered_bytes == 0) {
+    throw InvalidArgumentError{kTimeseriesGetRangeSplitEndpoint,
+                               "options.max_buffered_bytes", "must be positive"};
+  }
+  if (datetime_range.end <= datetime_range.start) {
+    throw InvalidArgumentError{kTimeseriesGetRangeSplitEndpoint, "datetime_range",
+                               "end must be set and after start"};
+  }
+  const std::string symbols_str =
+      JoinSymbolStrings(kTimeseriesGetRangeSplitEndpoint, symbols);
+  // Doesn't create sub-ranges shorter than a nanosecond
+  const auto split_ranges = SplitDateTimeRange(datetime_range, options.num_splits);
+  const auto num_splits = split_ranges.size();
+
+  // `RecordBuffer` isn't movable
+  std::deque<RecordBuffer> buffers;
+  for (std::size_t i = 0; i < num_splits; ++i) {
+    buffers.emplace_back(options.max_buffered_bytes);
+  }
+  RecordBufferWorkers workers{&buffers};
+  for (std::size_t i = 0; i < num_splits; ++i) {
+    httplib::Params params{{"dataset", dataset},
+                           {"encoding", "dbn"},
+                           {"compression", "zstd"},
+                           {"start", ToString(split_ranges[i].start)},
+                           {"end", ToString(split_ranges[i].end)},
+                           {"symbols", symbols_str},
+                           {"schema", ToString(schema)},
+                           {"stype_in", ToString(stype_in)},
+                           {"stype_out", ToString(stype_out)}};
+    workers.Spawn([this, &buffer = buffers[i], params = std::move(params)] {
+      try {
+        auto client = MakeClient();
+        const MetadataCallback split_metadata_callback =
+            [&buffer](Metadata&& metadata) { buffer.SetMetadata(std::move(metadata)); };
+        const RecordCallback split_record_callback = [&buffer](const Record& record) {
+          return buffer.Push(record);
+        };
+        detail::DbnBufferDecoder decoder{upgrade_policy_, split_metadata_callback,
+                                         split_record_callback};
+        client.PostRawStream(kTimeseriesGetRangePath, params,
+                             [&decoder](const char* data, std::size_t length) {
+                               return decoder.Process(data, length) ==
+                                      KeepGoing::Continue;
+                             });
+        buffer.Finish({});
+      } catch (...) {
+        buffer.Finish(std::current_exception());
+      }
+    });
+  }
+
+  std::optional<Metadata> metadata;
+  for (auto& buffer : buffers) {
+    auto split_metadata = buffer.WaitForMetadata();
+    if (!split_metadata) {
+      continue;
+    }
+    if (metadata) {
+      detail::MergeMetadata(&*metadata, std::move(*split_metadata));
+    } else {
+      metadata = std::move(split_metadata);
+    }
+  }
+  if (!metadata) {
+    return;
+  }
+  metadata->start = datetime_range.start;
+  metadata->end = datetime_range.end;
+  if (metadata_callback) {
+    metadata_callback(std::move(*metadata));
+  }
+  std::vector<std::byte> batch;
+  for (auto& buffer : buffers) {
+    while (buffer.Pop(&batch)) {
+      if (ForEachRecord(&batch, record_callback) == KeepGoing::Stop) {
+        return;
+      }
+    }
+  }
+}
+
+databento::detail::HttpClient Historical::MakeClient() const {
+  return detail::HttpClient{log_receiver_, key_, gateway_, port_, 1};
+}
+
 static const std::string kTimeseriesGetRangeToFileEndpoint =
     "Historical::TimeseriesGetRangeToFile";
 
@@ -928,16 +1973,22 @@ databento::DbnFileStore Historical::TimeseriesGetRangeToFile(
 }
 databento::DbnFileStore Historical::TimeseriesGetRangeToFile(
     const HttplibParams& params, const std::filesystem::path& file_path) {
+  // Indexed while downloading so the returned store can seek without decoding
+  // the whole file
+  detail::DbnFileIndexer indexer;
   {
-    OutFileStream out_file{file_path};
-    this->client_.PostRawStream(kTimeseriesGetRangePath, params,
-                                [&out_file](const char* data, std::size_t length) {
-                                  out_file.WriteAll(
-                                      reinterpret_cast<const std::byte*>(data), length);
-                                  return true;
-                                });
-  }  // Flush out_file
-  return DbnFileStore{log_receiver_, file_path, upgrade_policy_};
+    OutFileStream out_file{file_path, kFileWriteBufferSize};
+    this->client_.PostRawStream(
+        kTimeseriesGetRangePath, params,
+        [&out_file, &indexer](const char* data, std::size_t length) {
+          const auto* bytes = reinterpret_cast<const std::byte*>(data);
+          out_file.WriteAll(bytes, length);
+          indexer.Process(bytes, length);
+          return true;
+        });
+    out_file.Flush();
+  }
+  return DbnFileStore{log_receiver_, file_path, upgrade_policy_, indexer.Finish()};
 }
 
 using databento::HistoricalBuilder;
@@ -983,6 +2034,15 @@ HistoricalBuilder& HistoricalBuilder::ExtendUserAgent(std::string extension) {
   return *this;
 }
 
+HistoricalBuilder& HistoricalBuilder::SetMaxConnections(std::size_t max_connections) {
+  if (max_connections == 0) {
+    throw InvalidArgumentError{"HistoricalBuilder::SetMaxConnections",
+                               "max_connections", "must be greater than 0"};
+  }
+  max_connections_ = max_connections;
+  return *this;
+}
+
 Historical HistoricalBuilder::Build() {
   if (key_.empty()) {
     throw Exception{"'key' is unset"};
@@ -991,8 +2051,9 @@ Historical HistoricalBuilder::Build() {
     log_receiver_ = databento::ILogReceiver::Default();
   }
   if (gateway_override_.empty()) {
-    return Historical{log_receiver_, key_, gateway_, upgrade_policy_, user_agent_ext_};
+    return Historical{log_receiver_,   key_,            gateway_,
+                      upgrade_policy_, user_agent_ext_, max_connections_};
   }
-  return Historical{log_receiver_,   key_,           gateway_override_, port_,
-                    upgrade_policy_, user_agent_ext_};
+  return Historical{log_receiver_,   key_,            gateway_override_, port_,
+                    upgrade_policy_, user_agent_ext_, max_connections_};
 }
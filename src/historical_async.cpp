@@ -0,0 +1,77 @@
+#include "databento/historical_async.hpp"
+
+using databento::HistoricalAsync;
+
+HistoricalAsync::HistoricalAsync(Historical* historical)
+    : HistoricalAsync{historical, kDefaultNumThreads} {}
+
+HistoricalAsync::HistoricalAsync(Historical* historical, std::size_t num_threads)
+    : historical_{historical}, pool_{num_threads} {}
+
+std::future<std::uint64_t> HistoricalAsync::MetadataGetRecordCount(
+    const std::string& dataset, const DateTimeRange<UnixNanos>& datetime_range,
+    const std::vector<std::string>& symbols, Schema schema) {
+  return MetadataGetRecordCount(dataset, datetime_range, symbols, schema,
+                                CancellationToken{});
+}
+std::future<std::uint64_t> HistoricalAsync::MetadataGetRecordCount(
+    const std::string& dataset, const DateTimeRange<UnixNanos>& datetime_range,
+    const std::vector<std::string>& symbols, Schema schema, CancellationToken token) {
+  return Submit(
+      [dataset, datetime_range, symbols, schema](Historical& historical) {
+        return historical.MetadataGetRecordCount(dataset, datetime_range, symbols,
+                                                 schema);
+      },
+      std::move(token));
+}
+
+std::future<databento::SymbologyResolution> HistoricalAsync::SymbologyResolve(
+    const std::string& dataset, const std::vector<std::string>& symbols,
+    SType stype_in, SType stype_out, const DateRange& date_range) {
+  return SymbologyResolve(dataset, symbols, stype_in, stype_out, date_range,
+                          CancellationToken{});
+}
+std::future<databento::SymbologyResolution> HistoricalAsync::SymbologyResolve(
+    const std::string& dataset, const std::vector<std::string>& symbols,
+    SType stype_in, SType stype_out, const DateRange& date_range,
+    CancellationToken token) {
+  return Submit(
+      [dataset, symbols, stype_in, stype_out, date_range](Historical& historical) {
+        return historical.SymbologyResolve(dataset, symbols, stype_in, stype_out,
+                                           date_range);
+      },
+      std::move(token));
+}
+
+std::future<void> HistoricalAsync::TimeseriesGetRange(
+    const std::string& dataset, const DateTimeRange<UnixNanos>& datetime_range,
+    const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+    SType stype_out, std::uint64_t limit, MetadataCallback metadata_callback,
+    RecordCallback record_callback) {
+  return TimeseriesGetRange(dataset, datetime_range, symbols, schema, stype_in,
+                            stype_out, limit, std::move(metadata_callback),
+                            std::move(record_callback), CancellationToken{});
+}
+std::future<void> HistoricalAsync::TimeseriesGetRange(
+    const std::string& dataset, const DateTimeRange<UnixNanos>& datetime_range,
+    const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+    SType stype_out, std::uint64_t limit, MetadataCallback metadata_callback,
+    RecordCallback record_callback, CancellationToken token) {
+  // Checked for every record so cancelling stops the stream promptly
+  RecordCallback cancellable_callback =
+      [token, record_callback = std::move(record_callback)](const Record& record) {
+        if (token.IsCancelled()) {
+          return KeepGoing::Stop;
+        }
+        return record_callback(record);
+      };
+  return Submit(
+      [dataset, datetime_range, symbols, schema, stype_in, stype_out, limit,
+       metadata_callback = std::move(metadata_callback),
+       record_callback = std::move(cancellable_callback)](Historical& historical) {
+        historical.TimeseriesGetRange(dataset, datetime_range, symbols, schema,
+                                      stype_in, stype_out, limit, metadata_callback,
+                                      record_callback);
+      },
+      std::move(token));
+}
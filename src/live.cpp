@@ -79,18 +79,30 @@ LiveBuilder& LiveBuilder::ExtendUserAgent(std::string extension) {
   return *this;
 }
 
+LiveBuilder& LiveBuilder::SetLatencyStats(LiveLatencyStats* latency_stats) {
+  latency_stats_ = latency_stats;
+  return *this;
+}
+
+LiveBuilder& LiveBuilder::SetLatencyLogInterval(
+    std::chrono::seconds latency_log_interval) {
+  latency_log_interval_ = latency_log_interval;
+  return *this;
+}
+
 databento::LiveBlocking LiveBuilder::BuildBlocking() {
   Validate();
   if (gateway_.empty()) {
     return databento::LiveBlocking{log_receiver_,   key_,
                                    dataset_,        send_ts_out_,
                                    upgrade_policy_, heartbeat_interval_,
-                                   buffer_size_,    user_agent_ext_};
+                                   buffer_size_,    user_agent_ext_,
+                                   latency_stats_,  latency_log_interval_};
   }
   return databento::LiveBlocking{
-      log_receiver_, key_,           dataset_,        gateway_,
-      port_,         send_ts_out_,   upgrade_policy_, heartbeat_interval_,
-      buffer_size_,  user_agent_ext_};
+      log_receiver_, key_,            dataset_,        gateway_,
+      port_,         send_ts_out_,    upgrade_policy_, heartbeat_interval_,
+      buffer_size_,  user_agent_ext_, latency_stats_,  latency_log_interval_};
 }
 
 databento::LiveThreaded LiveBuilder::BuildThreaded() {
@@ -99,12 +111,13 @@ databento::LiveThreaded LiveBuilder::BuildThreaded() {
     return databento::LiveThreaded{log_receiver_,   key_,
                                    dataset_,        send_ts_out_,
                                    upgrade_policy_, heartbeat_interval_,
-                                   buffer_size_,    user_agent_ext_};
+                                   buffer_size_,    user_agent_ext_,
+                                   latency_stats_,  latency_log_interval_};
   }
   return databento::LiveThreaded{
-      log_receiver_, key_,           dataset_,        gateway_,
-      port_,         send_ts_out_,   upgrade_policy_, heartbeat_interval_,
-      buffer_size_,  user_agent_ext_};
+      log_receiver_, key_,            dataset_,        gateway_,
+      port_,         send_ts_out_,    upgrade_policy_, heartbeat_interval_,
+      buffer_size_,  user_agent_ext_, latency_stats_,  latency_log_interval_};
 }
 
 void LiveBuilder::Validate() {
@@ -114,6 +127,9 @@ void LiveBuilder::Validate() {
   if (dataset_.empty()) {
     throw Exception{"'dataset' is unset"};
   }
+  if (latency_log_interval_ && latency_stats_ == nullptr) {
+    throw Exception{"'latency_log_interval' is set without 'latency_stats'"};
+  }
   if (log_receiver_ == nullptr) {
     log_receiver_ = databento::ILogReceiver::Default();
   }
@@ -15,12 +15,16 @@
 #include "databento/constants.hpp"  //  kApiKeyLength
 #include "databento/dbn_decoder.hpp"
 #include "databento/detail/tcp_client.hpp"
-#include "databento/exceptions.hpp"  // LiveApiError
-#include "databento/live.hpp"        // LiveBuilder
-#include "databento/log.hpp"         // ILogReceiver
-#include "databento/record.hpp"      // Record
-#include "databento/symbology.hpp"   // JoinSymbolStrings
-#include "dbn_constants.hpp"         // kMetadataPreludeSize
+#include "databento/exceptions.hpp"    // LiveApiError
+#include "databento/live.hpp"          // LiveBuilder
+#include "databento/live_latency.hpp"  // LiveLatencyStats
+#include "databento/log.hpp"           // ILogReceiver
+#include "databento/metrics.hpp"       // MetricCounter
+#include "databento/record.hpp"        // Record
+#include "databento/symbology.hpp"     // JoinSymbolStrings
+#include "dbn_constants.hpp"           // kMetadataPreludeSize
+#include "log_helper.hpp"              // LazyLog
+#include "metrics_hooks.hpp"
 
 using databento::LiveBlocking;
 
@@ -34,7 +38,9 @@ LiveBlocking::LiveBlocking(ILogReceiver* log_receiver, std::string key,
                            std::string dataset, bool send_ts_out,
                            VersionUpgradePolicy upgrade_policy,
                            std::optional<std::chrono::seconds> heartbeat_interval,
-                           std::size_t buffer_size, std::string user_agent_ext)
+                           std::size_t buffer_size, std::string user_agent_ext,
+                           LiveLatencyStats* latency_stats,
+                           std::optional<std::chrono::seconds> latency_log_interval)
 
     : log_receiver_{log_receiver},
       key_{std::move(key)},
@@ -45,6 +51,8 @@ LiveBlocking::LiveBlocking(ILogReceiver* log_receiver, std::string key,
       send_ts_out_{send_ts_out},
       upgrade_policy_{upgrade_policy},
       heartbeat_interval_{heartbeat_interval},
+      latency_stats_{latency_stats},
+      latency_log_interval_{latency_log_interval},
       client_{gateway_, port_},
       buffer_{buffer_size},
       session_id_{this->Authenticate()} {}
@@ -53,7 +61,9 @@ LiveBlocking::LiveBlocking(ILogReceiver* log_receiver, std::string key,
                            std::string dataset, std::string gateway, std::uint16_t port,
                            bool send_ts_out, VersionUpgradePolicy upgrade_policy,
                            std::optional<std::chrono::seconds> heartbeat_interval,
-                           std::size_t buffer_size, std::string user_agent_ext)
+                           std::size_t buffer_size, std::string user_agent_ext,
+                           LiveLatencyStats* latency_stats,
+                           std::optional<std::chrono::seconds> latency_log_interval)
     : log_receiver_{log_receiver},
       key_{std::move(key)},
       dataset_{std::move(dataset)},
@@ -63,6 +73,8 @@ LiveBlocking::LiveBlocking(ILogReceiver* log_receiver, std::string key,
       send_ts_out_{send_ts_out},
       upgrade_policy_{upgrade_policy},
       heartbeat_interval_{heartbeat_interval},
+      latency_stats_{latency_stats},
+      latency_log_interval_{latency_log_interval},
       client_{gateway_, port_},
       buffer_{buffer_size},
       session_id_{this->Authenticate()} {}
@@ -137,12 +149,10 @@ void LiveBlocking::Subscribe(std::string_view sub_msg,
                     << "|snapshot=" << use_snapshot
                     << "|is_last=" << (distance_from_end <= kSymbolMaxChunkSize)
                     << '\n';
-    if (log_receiver_->ShouldLog(LogLevel::Debug)) {
-      std::ostringstream log_ss;
+    detail::LazyLog(log_receiver_, LogLevel::Debug, [&](std::ostream& log_ss) {
       log_ss << '[' << kMethodName
              << "] Sending subscription request: " << chunked_sub_msg.str();
-      log_receiver_->Receive(LogLevel::Debug, log_ss.str());
-    }
+    });
     client_.WriteAll(chunked_sub_msg.str());
 
     symbols_it += chunk_size;
@@ -150,7 +160,9 @@ void LiveBlocking::Subscribe(std::string_view sub_msg,
 }
 
 databento::Metadata LiveBlocking::Start() {
-  log_receiver_->Receive(LogLevel::Info, "[LiveBlocking::Start] Starting session");
+  detail::LazyLog(log_receiver_, LogLevel::Info, [](std::ostream& log_ss) {
+    log_ss << "[LiveBlocking::Start] Starting session";
+  });
 
   client_.WriteAll("start_session\n");
   client_.ReadExact(buffer_.WriteBegin(), kMetadataPreludeSize);
@@ -201,17 +213,19 @@ const databento::Record* LiveBlocking::NextRecord(std::chrono::milliseconds time
   buffer_.ConsumeNoShift(bytes_to_consume);
   current_record_ = DbnDecoder::DecodeRecordCompat(
       version_, upgrade_policy_, send_ts_out_, &compat_buffer_, current_record_);
+  if (latency_stats_ != nullptr) {
+    RecordLatency();
+  }
   return &current_record_;
 }
 
 void LiveBlocking::Stop() { client_.Close(); }
 
 void LiveBlocking::Reconnect() {
-  if (log_receiver_->ShouldLog(LogLevel::Info)) {
-    std::ostringstream log_msg;
-    log_msg << "Reconnecting to " << gateway_ << ':' << port_;
-    log_receiver_->Receive(LogLevel::Info, log_msg.str());
-  }
+  detail::IncrementMetric(MetricCounter::LiveReconnects, 1);
+  detail::LazyLog(log_receiver_, LogLevel::Info, [this](std::ostream& log_ss) {
+    log_ss << "Reconnecting to " << gateway_ << ':' << port_;
+  });
   client_ = detail::TcpClient{gateway_, port_};
   buffer_.Clear();
   sub_counter_ = 0;
@@ -249,12 +263,10 @@ std::string LiveBlocking::DecodeChallenge() {
   if (first_nl_pos == std::string::npos) {
     throw LiveApiError::UnexpectedMsg("Received malformed initial message", response);
   }
-  if (log_receiver_->ShouldLog(LogLevel::Debug)) {
-    std::ostringstream log_ss;
-    log_ss << '[' << kMethodName
-           << "] Received greeting: " << response.substr(0, first_nl_pos);
-    log_receiver_->Receive(LogLevel::Debug, log_ss.str());
-  }
+  detail::LazyLog(log_receiver_, LogLevel::Debug, [&](std::ostream& log_ss) {
+    log_ss << '[' << kMethodName << "] Received greeting: "
+           << std::string_view{response}.substr(0, first_nl_pos);
+  });
   const auto find_start = first_nl_pos + 1;
   auto next_nl_pos = find_start == response.length() ? std::string::npos
                                                      : response.find('\n', find_start);
@@ -270,11 +282,9 @@ std::string LiveBlocking::DecodeChallenge() {
     next_nl_pos = response.find('\n', find_start);
   }
   const auto challenge_line = response.substr(find_start, next_nl_pos - find_start);
-  if (log_receiver_->ShouldLog(LogLevel::Debug)) {
-    std::ostringstream log_ss;
+  detail::LazyLog(log_receiver_, LogLevel::Debug, [&](std::ostream& log_ss) {
     log_ss << '[' << kMethodName << "] Received CRAM challenge: " << challenge_line;
-    log_receiver_->Receive(LogLevel::Debug, log_ss.str());
-  }
+  });
   if (challenge_line.compare(0, 4, "cram") != 0) {
     throw LiveApiError::UnexpectedMsg("Did not receive CRAM challenge when expected",
                                       challenge_line);
@@ -302,20 +312,16 @@ std::uint64_t LiveBlocking::Authenticate() {
 
   const std::string auth = GenerateCramReply(challenge_key);
   const std::string req = EncodeAuthReq(auth);
-  if (log_receiver_->ShouldLog(LogLevel::Debug)) {
-    std::ostringstream log_ss;
+  detail::LazyLog(log_receiver_, LogLevel::Debug, [&](std::ostream& log_ss) {
     log_ss << '[' << kMethodName << "] Sending CRAM reply: " << req;
-    log_receiver_->Receive(LogLevel::Debug, log_ss.str());
-  }
+  });
   client_.WriteAll(req);
   const std::uint64_t session_id = DecodeAuthResp();
 
-  if (log_receiver_->ShouldLog(LogLevel::Info)) {
-    std::ostringstream log_ss;
+  detail::LazyLog(log_receiver_, LogLevel::Info, [session_id](std::ostream& log_ss) {
     log_ss << '[' << kMethodName << "] Successfully authenticated with session_id "
            << session_id;
-    log_receiver_->Receive(LogLevel::Info, log_ss.str());
-  }
+  });
   return session_id;
 }
 
@@ -364,17 +370,17 @@ std::uint64_t LiveBlocking::DecodeAuthResp() {
           "CRAM"};
     }
     buffer_.Fill(read_size);
+    // The read may include the first records
+    UpdateLastReadTime();
     newline_ptr =
         std::find(buffer_.ReadBegin(), buffer_.ReadEnd(), static_cast<std::byte>('\n'));
   } while (newline_ptr == buffer_.ReadEnd());
   const std::string response{
       reinterpret_cast<const char*>(buffer_.ReadBegin()),
       static_cast<std::size_t>(newline_ptr - buffer_.ReadBegin())};
-  {
-    std::ostringstream log_ss;
+  detail::LazyLog(log_receiver_, LogLevel::Debug, [&response](std::ostream& log_ss) {
     log_ss << "[LiveBlocking::DecodeAuthResp] Authentication response: " << response;
-    log_receiver_->Receive(LogLevel::Debug, log_ss.str());
-  }
+  });
   // set in case Read call also read records. One beyond newline
   buffer_.Consume(response.length() + 1);
 
@@ -423,8 +429,9 @@ std::uint64_t LiveBlocking::DecodeAuthResp() {
 
 void LiveBlocking::IncrementSubCounter() {
   if (sub_counter_ == std::numeric_limits<uint32_t>::max()) {
-    log_receiver_->Receive(LogLevel::Warning,
-                           "[LiveBlocking::Subscribe] Exhausted all subscription IDs");
+    detail::LazyLog(log_receiver_, LogLevel::Warning, [](std::ostream& log_ss) {
+      log_ss << "[LiveBlocking::Subscribe] Exhausted all subscription IDs";
+    });
   } else {
     ++sub_counter_;
   }
@@ -436,9 +443,37 @@ databento::detail::TcpClient::Result LiveBlocking::FillBuffer(
   const auto read_res =
       client_.ReadSome(buffer_.WriteBegin(), buffer_.WriteCapacity(), timeout);
   buffer_.Fill(read_res.read_size);
+  if (read_res.read_size > 0) {
+    UpdateLastReadTime();
+  }
   return read_res;
 }
 
 databento::RecordHeader* LiveBlocking::BufferRecordHeader() {
   return reinterpret_cast<RecordHeader*>(buffer_.ReadBegin());
 }
+
+void LiveBlocking::UpdateLastReadTime() {
+  // Records are only read from the socket when the buffer doesn't contain a
+  // complete record, so every record returned before the next read was
+  // completed by this one
+  if (latency_stats_ != nullptr) {
+    last_read_time_ = std::chrono::time_point_cast<UnixNanos::duration>(
+        std::chrono::system_clock::now());
+  }
+}
+
+void LiveBlocking::RecordLatency() {
+  latency_stats_->Add(current_record_, send_ts_out_, last_read_time_);
+  if (!latency_log_interval_) {
+    return;
+  }
+  if (last_latency_log_time_ == UnixNanos{}) {
+    last_latency_log_time_ = last_read_time_;
+  } else if (last_read_time_ - last_latency_log_time_ >= *latency_log_interval_) {
+    last_latency_log_time_ = last_read_time_;
+    detail::LazyLog(log_receiver_, LogLevel::Info, [this](std::ostream& log_ss) {
+      log_ss << "[LiveBlocking::NextRecord] " << *latency_stats_;
+    });
+  }
+}
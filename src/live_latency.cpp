@@ -0,0 +1,255 @@
+#include "databento/live_latency.hpp"
+
+#include <algorithm>  // min, sort
+#include <cmath>      // ceil
+#include <cstring>    // memcpy
+#include <ostream>
+#include <sstream>
+#include <tuple>  // tie
+
+#include "databento/constants.hpp"  // kUndefTimestamp
+#include "databento/record.hpp"
+#include "stream_op_helper.hpp"
+
+using databento::LatencyHistogram;
+using databento::LiveLatencyStats;
+
+namespace {
+constexpr std::size_t kHalfSubBucketCount = LatencyHistogram::kSubBucketCount / 2;
+constexpr int kSubBucketBits = 6;
+static_assert(std::size_t{1} << kSubBucketBits == LatencyHistogram::kSubBucketCount);
+
+// Returns the index of the most significant set bit of a non-zero `value`.
+int HighestBit(std::uint64_t value) {
+  int res = 0;
+  for (int shift = 32; shift > 0; shift /= 2) {
+    if (value >> shift != 0) {
+      value >>= shift;
+      res += shift;
+    }
+  }
+  return res;
+}
+
+std::chrono::nanoseconds Latency(databento::UnixNanos ts,
+                                 databento::UnixNanos local_recv) {
+  // Unsigned subtraction wraps, so negative latencies are preserved by the cast
+  return std::chrono::nanoseconds{static_cast<std::int64_t>(
+      local_recv.time_since_epoch().count() - ts.time_since_epoch().count())};
+}
+
+std::size_t EntryHash(databento::RType rtype, std::uint16_t publisher_id) {
+  const auto key = static_cast<std::uint32_t>(rtype) << 16 | publisher_id;
+  // Fibonacci hashing
+  return static_cast<std::size_t>((key * 0x9E3779B9U) >> 24) %
+         LiveLatencyStats::kMaxEntries;
+}
+}  // namespace
+
+void LatencyHistogram::Add(std::chrono::nanoseconds latency) {
+  const auto value =
+      latency.count() > 0 ? static_cast<std::uint64_t>(latency.count()) : 0;
+  Increment(buckets_[BucketIndex(value)], 1);
+  Increment(sum_, value);
+  if (value < min_.load(std::memory_order_relaxed)) {
+    min_.store(value, std::memory_order_relaxed);
+  }
+  if (value > max_.load(std::memory_order_relaxed)) {
+    max_.store(value, std::memory_order_relaxed);
+  }
+  Increment(count_, 1);
+}
+
+std::chrono::nanoseconds LatencyHistogram::Min() const {
+  if (Count() == 0) {
+    return {};
+  }
+  return std::chrono::nanoseconds{min_.load(std::memory_order_relaxed)};
+}
+
+std::chrono::nanoseconds LatencyHistogram::Max() const {
+  return std::chrono::nanoseconds{max_.load(std::memory_order_relaxed)};
+}
+
+std::chrono::nanoseconds LatencyHistogram::Mean() const {
+  const auto count = Count();
+  if (count == 0) {
+    return {};
+  }
+  return std::chrono::nanoseconds{sum_.load(std::memory_order_relaxed) / count};
+}
+
+std::chrono::nanoseconds LatencyHistogram::Percentile(double quantile) const {
+  const auto count = Count();
+  if (count == 0) {
+    return {};
+  }
+  const auto max = max_.load(std::memory_order_relaxed);
+  const auto rank = std::max<std::uint64_t>(
+      1, static_cast<std::uint64_t>(std::ceil(quantile * static_cast<double>(count))));
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i < kBucketCount; ++i) {
+    seen += buckets_[i].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      return std::chrono::nanoseconds{std::min(BucketUpperBound(i), max)};
+    }
+  }
+  // Buckets may lag behind the count while a value is being added
+  return std::chrono::nanoseconds{max};
+}
+
+std::size_t LatencyHistogram::BucketIndex(std::uint64_t value) {
+  if (value < kSubBucketCount) {
+    return value;
+  }
+  // Keep the top `kSubBucketBits` bits of `value`
+  const auto shift = HighestBit(value) - (kSubBucketBits - 1);
+  const std::size_t sub_bucket = value >> shift;
+  return kSubBucketCount + static_cast<std::size_t>(shift - 1) * kHalfSubBucketCount +
+         (sub_bucket - kHalfSubBucketCount);
+}
+
+std::uint64_t LatencyHistogram::BucketUpperBound(std::size_t index) {
+  if (index < kSubBucketCount) {
+    return index;
+  }
+  const auto shift = (index - kSubBucketCount) / kHalfSubBucketCount + 1;
+  const auto sub_bucket =
+      std::uint64_t{(index - kSubBucketCount) % kHalfSubBucketCount} +
+      kHalfSubBucketCount;
+  // Wraps to the maximum value for the last bucket
+  return ((sub_bucket + 1) << shift) - 1;
+}
+
+LiveLatencyStats::~LiveLatencyStats() {
+  for (auto& entry : entries_) {
+    delete entry.load(std::memory_order_relaxed);
+  }
+}
+
+void LiveLatencyStats::Add(const Record& record, bool has_ts_out,
+                           UnixNanos local_recv) {
+  auto* entry = FindOrInsert(record.RType(), record.Header().publisher_id);
+  const auto index_ts = record.IndexTs();
+  if (index_ts.time_since_epoch().count() != kUndefTimestamp) {
+    const auto latency = Latency(index_ts, local_recv);
+    ts_recv_latency_.Add(latency);
+    if (entry != nullptr) {
+      entry->ts_recv_latency.Add(latency);
+    }
+  }
+  if (has_ts_out && record.Size() >= sizeof(RecordHeader) + sizeof(UnixNanos)) {
+    // `ts_out` is always appended as the last field
+    UnixNanos ts_out;
+    std::memcpy(&ts_out,
+                reinterpret_cast<const std::byte*>(&record.Header()) + record.Size() -
+                    sizeof(UnixNanos),
+                sizeof(UnixNanos));
+    const auto latency = Latency(ts_out, local_recv);
+    ts_out_latency_.Add(latency);
+    if (entry != nullptr) {
+      entry->ts_out_latency.Add(latency);
+    }
+  }
+}
+
+const LiveLatencyStats::Entry* LiveLatencyStats::Find(
+    RType rtype, std::uint16_t publisher_id) const {
+  const auto hash = EntryHash(rtype, publisher_id);
+  for (std::size_t i = 0; i < kMaxEntries; ++i) {
+    const auto* entry =
+        entries_[(hash + i) % kMaxEntries].load(std::memory_order_acquire);
+    if (entry == nullptr) {
+      return nullptr;
+    }
+    if (entry->rtype == rtype && entry->publisher_id == publisher_id) {
+      return entry;
+    }
+  }
+  return nullptr;
+}
+
+std::vector<const LiveLatencyStats::Entry*> LiveLatencyStats::Entries() const {
+  std::vector<const Entry*> res;
+  for (const auto& slot : entries_) {
+    const auto* entry = slot.load(std::memory_order_acquire);
+    if (entry != nullptr) {
+      res.emplace_back(entry);
+    }
+  }
+  std::sort(res.begin(), res.end(), [](const Entry* lhs, const Entry* rhs) {
+    return std::tie(lhs->rtype, lhs->publisher_id) <
+           std::tie(rhs->rtype, rhs->publisher_id);
+  });
+  return res;
+}
+
+LiveLatencyStats::Entry* LiveLatencyStats::FindOrInsert(RType rtype,
+                                                         std::uint16_t publisher_id) {
+  const auto hash = EntryHash(rtype, publisher_id);
+  for (std::size_t i = 0; i < kMaxEntries; ++i) {
+    auto& slot = entries_[(hash + i) % kMaxEntries];
+    auto* entry = slot.load(std::memory_order_relaxed);
+    if (entry == nullptr) {
+      entry = new Entry{rtype, publisher_id};
+      // Publish the fully-constructed entry to readers
+      slot.store(entry, std::memory_order_release);
+      return entry;
+    }
+    if (entry->rtype == rtype && entry->publisher_id == publisher_id) {
+      return entry;
+    }
+  }
+  dropped_entry_count_.store(dropped_entry_count_.load(std::memory_order_relaxed) + 1,
+                             std::memory_order_relaxed);
+  return nullptr;
+}
+
+namespace databento {
+std::string ToString(const LatencyHistogram& histogram) {
+  return MakeString(histogram);
+}
+std::ostream& operator<<(std::ostream& stream, const LatencyHistogram& histogram) {
+  return StreamOpBuilder{stream}
+      .SetSpacer(" ")
+      .SetTypeName("LatencyHistogram")
+      .Build()
+      .AddField("count", histogram.Count())
+      .AddField("min", histogram.Min().count())
+      .AddField("mean", histogram.Mean().count())
+      .AddField("p50", histogram.Percentile(0.5).count())
+      .AddField("p90", histogram.Percentile(0.9).count())
+      .AddField("p99", histogram.Percentile(0.99).count())
+      .AddField("p99.9", histogram.Percentile(0.999).count())
+      .AddField("max", histogram.Max().count())
+      .Finish();
+}
+
+std::string ToString(const LiveLatencyStats& stats) { return MakeString(stats); }
+std::ostream& operator<<(std::ostream& stream, const LiveLatencyStats& stats) {
+  std::ostringstream entries;
+  auto entries_helper =
+      StreamOpBuilder{entries}.SetIndent("    ").SetSpacer("\n    ").Build();
+  for (const auto* entry : stats.Entries()) {
+    std::ostringstream entry_stream;
+    StreamOpBuilder{entry_stream}
+        .SetSpacer(" ")
+        .Build()
+        .AddField("rtype", entry->rtype)
+        .AddField("publisher_id", entry->publisher_id)
+        .AddField("ts_out_latency", entry->ts_out_latency)
+        .AddField("ts_recv_latency", entry->ts_recv_latency)
+        .Finish();
+    entries_helper.AddItem(entry_stream);
+  }
+  return StreamOpBuilder{stream}
+      .SetSpacer("\n    ")
+      .SetTypeName("LiveLatencyStats")
+      .Build()
+      .AddField("ts_out_latency", stats.TsOutLatency())
+      .AddField("ts_recv_latency", stats.TsRecvLatency())
+      .AddField("dropped_entry_count", stats.DroppedEntryCount())
+      .AddField("entries", static_cast<std::ostringstream&>(entries_helper.Finish()))
+      .Finish();
+}
+}  // namespace databento
@@ -5,7 +5,7 @@
 #include <condition_variable>
 #include <exception>
 #include <mutex>
-#include <sstream>
+#include <ostream>
 #include <thread>
 #include <utility>  // forward, move, swap
 
@@ -13,6 +13,8 @@
 #include "databento/live.hpp"                  // LiveBuilder
 #include "databento/live_blocking.hpp"         // LiveBlocking
 #include "databento/log.hpp"                   // ILogReceiver
+#include "log_helper.hpp"                      // LazyLog
+#include "metrics_hooks.hpp"
 
 using databento::LiveThreaded;
 
@@ -61,20 +63,26 @@ LiveThreaded::LiveThreaded(ILogReceiver* log_receiver, std::string key,
                            std::string dataset, bool send_ts_out,
                            VersionUpgradePolicy upgrade_policy,
                            std::optional<std::chrono::seconds> heartbeat_interval,
-                           std::size_t buffer_size, std::string user_agent_ext)
+                           std::size_t buffer_size, std::string user_agent_ext,
+                           LiveLatencyStats* latency_stats,
+                           std::optional<std::chrono::seconds> latency_log_interval)
     : impl_{std::make_unique<Impl>(log_receiver, std::move(key), std::move(dataset),
                                    send_ts_out, upgrade_policy, heartbeat_interval,
-                                   buffer_size, std::move(user_agent_ext))} {}
+                                   buffer_size, std::move(user_agent_ext),
+                                   latency_stats, latency_log_interval)} {}
 
 LiveThreaded::LiveThreaded(ILogReceiver* log_receiver, std::string key,
                            std::string dataset, std::string gateway, std::uint16_t port,
                            bool send_ts_out, VersionUpgradePolicy upgrade_policy,
                            std::optional<std::chrono::seconds> heartbeat_interval,
-                           std::size_t buffer_size, std::string user_agent_ext)
+                           std::size_t buffer_size, std::string user_agent_ext,
+                           LiveLatencyStats* latency_stats,
+                           std::optional<std::chrono::seconds> latency_log_interval)
     : impl_{std::make_unique<Impl>(log_receiver, std::move(key), std::move(dataset),
                                    std::move(gateway), port, send_ts_out,
                                    upgrade_policy, heartbeat_interval, buffer_size,
-                                   std::move(user_agent_ext))} {}
+                                   std::move(user_agent_ext), latency_stats,
+                                   latency_log_interval)} {}
 
 const std::string& LiveThreaded::Key() const { return impl_->blocking.Key(); }
 
@@ -102,6 +110,10 @@ std::vector<databento::LiveSubscription>& LiveThreaded::Subscriptions() {
   return impl_->blocking.Subscriptions();
 }
 
+databento::LiveLatencyStats* LiveThreaded::LatencyStats() const {
+  return impl_->blocking.LatencyStats();
+}
+
 void LiveThreaded::Subscribe(const std::vector<std::string>& symbols, Schema schema,
                              SType stype_in) {
   impl_->blocking.Subscribe(symbols, schema, stype_in);
@@ -136,10 +148,10 @@ void LiveThreaded::Start(MetadataCallback metadata_callback,
                          ExceptionCallback exception_callback) {
   // Deadlock check
   if (std::this_thread::get_id() == impl_->thread_id_) {
-    std::ostringstream log_ss;
-    log_ss << "[LiveThreaded::Start] Called Start from callback thread, which "
-              "would cause a deadlock. Ignoring.";
-    impl_->log_receiver->Receive(LogLevel::Warning, log_ss.str());
+    detail::LazyLog(impl_->log_receiver, LogLevel::Warning, [](std::ostream& log_ss) {
+      log_ss << "[LiveThreaded::Start] Called Start from callback thread, which "
+                "would cause a deadlock. Ignoring.";
+    });
     return;
   }
   // Safe to pass raw pointer because `thread_` cannot outlive `impl_`
@@ -205,7 +217,9 @@ void LiveThreaded::ProcessingThread(Impl* impl, MetadataCallback&& metadata_call
       try {
         const Record* rec = impl->blocking.NextRecord(kTimeout);
         if (rec) {
-          if (record_cb(*rec) == KeepGoing::Stop) {
+          const auto keep_going =
+              detail::TimeCallbackMetric([&record_cb, rec] { return record_cb(*rec); });
+          if (keep_going == KeepGoing::Stop) {
             impl->blocking.Stop();
             impl->NotifyOfStop();
             return;
@@ -229,16 +243,16 @@ LiveThreaded::ExceptionAction LiveThreaded::ExceptionHandler(
     Impl* impl, const ExceptionCallback& exception_callback, const std::exception& exc,
     std::string_view pretty_function_name, std::string_view message) {
   if (exception_callback && exception_callback(exc) == ExceptionAction::Restart) {
-    std::ostringstream log_ss;
-    log_ss << pretty_function_name << ' ' << message << exc.what()
-           << ". Attempting to restart session.";
-    impl->log_receiver->Receive(LogLevel::Warning, log_ss.str());
+    detail::LazyLog(impl->log_receiver, LogLevel::Warning, [&](std::ostream& log_ss) {
+      log_ss << pretty_function_name << ' ' << message << exc.what()
+             << ". Attempting to restart session.";
+    });
     return ExceptionAction::Restart;
   }
   impl->blocking.Stop();
-  std::ostringstream log_ss;
-  log_ss << pretty_function_name << ' ' << message << exc.what()
-         << ". Stopping thread.";
-  impl->log_receiver->Receive(LogLevel::Error, log_ss.str());
+  detail::LazyLog(impl->log_receiver, LogLevel::Error, [&](std::ostream& log_ss) {
+    log_ss << pretty_function_name << ' ' << message << exc.what()
+           << ". Stopping thread.";
+  });
   return ExceptionAction::Stop;
 }
@@ -1,9 +1,17 @@
 #include "databento/log.hpp"
 
+#include <algorithm>  // max
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <sstream>
+#include <vector>
 
+#include "databento/detail/scoped_thread.hpp"
 #include "databento/system.hpp"
 #include "databento/version.hpp"
 #include "stream_op_helper.hpp"
@@ -35,6 +43,213 @@ void ConsoleLogReceiver::Receive(LogLevel level, const std::string& msg) {
   }
 }
 
+using databento::AsyncLogReceiver;
+
+namespace {
+std::size_t RoundUpToPowerOfTwo(std::size_t value) {
+  std::size_t res = 1;
+  while (res < value) {
+    res <<= 1;
+  }
+  return res;
+}
+}  // namespace
+
+// A bounded multi-producer, single-consumer queue where each slot has a
+// sequence number indicating whether it's free for the producer claiming
+// position `pos` (`sequence == pos`) or ready for the consumer
+// (`sequence == pos + 1`).
+struct AsyncLogReceiver::Impl {
+  struct Slot {
+    std::atomic<std::size_t> sequence;
+    LogLevel level;
+    std::string msg;
+  };
+
+  Impl(ILogReceiver* downstream_receiver, std::size_t capacity)
+      : downstream{downstream_receiver},
+        mask{capacity - 1},
+        slots{std::make_unique<Slot[]>(capacity)} {
+    for (std::size_t i = 0; i < capacity; ++i) {
+      slots[i].sequence.store(i, std::memory_order_relaxed);
+      slots[i].msg.reserve(kMessageCapacity);
+    }
+    thread = detail::ScopedThread{[this] { Run(); }};
+  }
+
+  bool TryPush(LogLevel level, const std::string& msg) {
+    auto pos = enqueue_pos.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+      slot = &slots[pos & mask];
+      const auto sequence = slot->sequence.load(std::memory_order_acquire);
+      const auto diff =
+          static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos.compare_exchange_weak(pos, pos + 1,
+                                              std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        // Full
+        return false;
+      } else {
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+    slot->level = level;
+    // Doesn't allocate when `msg` fits in the slot's existing capacity
+    slot->msg.assign(msg);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool HasPending() const {
+    const auto pos = dequeue_pos.load(std::memory_order_relaxed);
+    return slots[pos & mask].sequence.load(std::memory_order_acquire) == pos + 1;
+  }
+
+  // Wakes the background thread if it's waiting for messages.
+  void Wake() {
+    // Pairs with the fence in `Run` so either this thread sees `is_idle` or the
+    // background thread sees the new message
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (is_idle.load(std::memory_order_relaxed) &&
+        is_idle.exchange(false, std::memory_order_relaxed)) {
+      const std::lock_guard<std::mutex> lock{mutex};
+      wake_cv.notify_one();
+    }
+  }
+
+  // Forwards all ready messages, followed by a warning if any were dropped, and
+  // returns the number forwarded.
+  std::size_t Drain() {
+    std::size_t count = 0;
+    auto pos = dequeue_pos.load(std::memory_order_relaxed);
+    while (true) {
+      auto& slot = slots[pos & mask];
+      if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+        break;
+      }
+      Forward(slot.level, slot.msg);
+      // Release the slot to producers
+      slot.sequence.store(pos + mask + 1, std::memory_order_release);
+      ++pos;
+      ++count;
+    }
+    const auto dropped = dropped_count.load(std::memory_order_acquire);
+    const auto reported = reported_dropped_count.load(std::memory_order_relaxed);
+    if (dropped != reported) {
+      std::ostringstream ss;
+      ss << "[AsyncLogReceiver::Receive] Dropped " << dropped - reported
+         << " log messages because the queue was full";
+      Forward(LogLevel::Warning, ss.str());
+      ++count;
+    }
+    // Published after forwarding so `Flush` waits for all of the above
+    reported_dropped_count.store(dropped, std::memory_order_release);
+    dequeue_pos.store(pos, std::memory_order_release);
+    return count;
+  }
+
+  void Forward(LogLevel level, const std::string& msg) {
+    try {
+      downstream->Receive(level, msg);
+    } catch (...) {
+      // There's nowhere to report the failure without risking recursion
+    }
+  }
+
+  void Run() {
+    while (true) {
+      const bool is_stopping_snapshot = is_stopping.load(std::memory_order_acquire);
+      if (Drain() > 0) {
+        const std::lock_guard<std::mutex> lock{mutex};
+        drained_cv.notify_all();
+        continue;
+      }
+      if (is_stopping_snapshot) {
+        return;
+      }
+      is_idle.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (HasPending()) {
+        is_idle.store(false, std::memory_order_relaxed);
+        continue;
+      }
+      std::unique_lock<std::mutex> lock{mutex};
+      // The timeout is only a safeguard, producers wake this thread
+      wake_cv.wait_for(lock, std::chrono::milliseconds{100}, [this] {
+        return !is_idle.load(std::memory_order_relaxed) ||
+               is_stopping.load(std::memory_order_relaxed);
+      });
+      is_idle.store(false, std::memory_order_relaxed);
+    }
+  }
+
+  ILogReceiver* const downstream;
+  const std::size_t mask;
+  const std::unique_ptr<Slot[]> slots;
+  alignas(64) std::atomic<std::size_t> enqueue_pos{};
+  alignas(64) std::atomic<std::size_t> dequeue_pos{};
+  std::atomic<std::uint64_t> dropped_count{};
+  std::atomic<std::uint64_t> reported_dropped_count{};
+  std::atomic<bool> is_idle{};
+  std::atomic<bool> is_stopping{};
+  std::mutex mutex;
+  std::condition_variable wake_cv;
+  std::condition_variable drained_cv;
+  // Declared last so it starts after and joins before the other members are
+  // destroyed
+  detail::ScopedThread thread;
+};
+
+AsyncLogReceiver::AsyncLogReceiver(ILogReceiver* downstream)
+    : AsyncLogReceiver{downstream, kDefaultCapacity} {}
+
+AsyncLogReceiver::AsyncLogReceiver(ILogReceiver* downstream, std::size_t capacity)
+    : downstream_{downstream},
+      impl_{std::make_unique<Impl>(
+          downstream, RoundUpToPowerOfTwo(std::max<std::size_t>(capacity, 2)))} {}
+
+AsyncLogReceiver::~AsyncLogReceiver() {
+  impl_->is_stopping.store(true, std::memory_order_release);
+  {
+    const std::lock_guard<std::mutex> lock{impl_->mutex};
+    impl_->is_idle.store(false, std::memory_order_relaxed);
+    impl_->wake_cv.notify_one();
+  }
+  impl_->thread.Join();
+}
+
+void AsyncLogReceiver::Receive(LogLevel level, const std::string& msg) {
+  if (!ShouldLog(level)) {
+    return;
+  }
+  if (impl_->TryPush(level, msg)) {
+    impl_->Wake();
+  } else {
+    impl_->dropped_count.fetch_add(1, std::memory_order_release);
+  }
+}
+
+void AsyncLogReceiver::Flush() {
+  const auto target_pos = impl_->enqueue_pos.load(std::memory_order_acquire);
+  const auto target_dropped = impl_->dropped_count.load(std::memory_order_acquire);
+  std::unique_lock<std::mutex> lock{impl_->mutex};
+  impl_->is_idle.store(false, std::memory_order_relaxed);
+  impl_->wake_cv.notify_one();
+  impl_->drained_cv.wait(lock, [this, target_pos, target_dropped] {
+    return impl_->dequeue_pos.load(std::memory_order_acquire) >= target_pos &&
+           impl_->reported_dropped_count.load(std::memory_order_acquire) >=
+               target_dropped;
+  });
+}
+
+std::uint64_t AsyncLogReceiver::DroppedCount() const {
+  return impl_->dropped_count.load(std::memory_order_relaxed);
+}
+
 namespace databento {
 std::ostream& operator<<(std::ostream& out, LogLevel level) {
   out << ToString(level);
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <sstream>
+
+#include "databento/log.hpp"
+
+namespace databento::detail {
+// Sends a message to `log_receiver` only if it will log `level`. `format` is
+// called with an `std::ostream&` to write the message to, so disabled log
+// statements don't format or allocate anything.
+template <typename F>
+void LazyLog(ILogReceiver* log_receiver, LogLevel level, const F& format) {
+  if (log_receiver->ShouldLog(level)) {
+    std::ostringstream ss;
+    format(ss);
+    log_receiver->Receive(level, ss.str());
+  }
+}
+}  // namespace databento::detail
@@ -0,0 +1,71 @@
+#include "databento/metrics.hpp"
+
+#include <atomic>
+#include <ostream>
+
+#include "metrics_hooks.hpp"
+
+namespace databento {
+namespace detail {
+std::atomic<IMetricsSink*> gMetricsSink{nullptr};
+}  // namespace detail
+
+void SetMetricsSink(IMetricsSink* sink) {
+  detail::gMetricsSink.store(sink, std::memory_order_release);
+}
+
+IMetricsSink* GetMetricsSink() {
+  return detail::gMetricsSink.load(std::memory_order_acquire);
+}
+
+bool MetricsEnabled() {
+#ifdef DATABENTO_ENABLE_METRICS
+  return true;
+#else
+  return false;
+#endif
+}
+
+std::ostream& operator<<(std::ostream& out, MetricCounter counter) {
+  out << ToString(counter);
+  return out;
+}
+
+const char* ToString(MetricCounter counter) {
+  switch (counter) {
+    case MetricCounter::TcpBytesRead: {
+      return "tcp_bytes_read";
+    }
+    case MetricCounter::TcpBytesWritten: {
+      return "tcp_bytes_written";
+    }
+    case MetricCounter::HttpRequests: {
+      return "http_requests";
+    }
+    case MetricCounter::HttpBytesRead: {
+      return "http_bytes_read";
+    }
+    case MetricCounter::ZstdBytesRead: {
+      return "zstd_bytes_read";
+    }
+    case MetricCounter::ZstdBytesDecompressed: {
+      return "zstd_bytes_decompressed";
+    }
+    case MetricCounter::CompatUpgrades: {
+      return "compat_upgrades";
+    }
+    case MetricCounter::BufferShifts: {
+      return "buffer_shifts";
+    }
+    case MetricCounter::BufferReallocations: {
+      return "buffer_reallocations";
+    }
+    case MetricCounter::LiveReconnects: {
+      return "live_reconnects";
+    }
+    default: {
+      return "unknown";
+    }
+  }
+}
+}  // namespace databento
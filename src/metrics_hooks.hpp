@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "databento/enums.hpp"  // RType
+#include "databento/metrics.hpp"
+
+// Instrumentation points for reporting to the `IMetricsSink`. Each is a single
+// load and branch when no sink is set, and compiles to nothing when the library
+// is built without `DATABENTO_ENABLE_METRICS`.
+namespace databento::detail {
+extern std::atomic<IMetricsSink*> gMetricsSink;
+
+#ifdef DATABENTO_ENABLE_METRICS
+inline IMetricsSink* MetricsSink() {
+  return gMetricsSink.load(std::memory_order_acquire);
+}
+
+inline void IncrementMetric(MetricCounter counter, std::uint64_t value) {
+  if (auto* sink = MetricsSink()) {
+    sink->Increment(counter, value);
+  }
+}
+
+inline void RecordDecodedMetric(RType rtype) {
+  if (auto* sink = MetricsSink()) {
+    sink->OnRecordDecoded(rtype);
+  }
+}
+
+// Calls `callback` and reports how long it took.
+template <typename F>
+auto TimeCallbackMetric(const F& callback) {
+  auto* sink = MetricsSink();
+  if (sink == nullptr) {
+    return callback();
+  }
+  const auto start = std::chrono::steady_clock::now();
+  auto res = callback();
+  sink->OnCallbackTime(std::chrono::steady_clock::now() - start);
+  return res;
+}
+#else
+inline void IncrementMetric(MetricCounter, std::uint64_t) {}
+
+inline void RecordDecodedMetric(RType) {}
+
+template <typename F>
+auto TimeCallbackMetric(const F& callback) {
+  return callback();
+}
+#endif
+}  // namespace databento::detail
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>  // memcpy
+#include <string_view>
+
+namespace databento {
+// Loads 8 bytes starting at `ptr` with the first byte in the least significant
+// position. Like the rest of the library, assumes a little-endian host.
+inline std::uint64_t LoadEightBytes(const char* ptr) {
+  std::uint64_t val;
+  std::memcpy(&val, ptr, sizeof(val));
+  return val;
+}
+
+// Returns true if all 8 bytes of `val` are ASCII digits. Checks all bytes at
+// once by verifying each high nibble is 3 and that adding 6 to each byte
+// doesn't carry into the high nibble.
+inline bool IsEightDigits(std::uint64_t val) {
+  return ((val & 0xF0F0F0F0F0F0F0F0) |
+          (((val + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+         0x3333333333333333;
+}
+
+// Converts 8 ASCII digits loaded with `LoadEightBytes` to their value using
+// three multiplications instead of eight.
+inline std::uint32_t ParseEightDigits(std::uint64_t val) {
+  constexpr std::uint64_t kMask = 0x000000FF000000FF;
+  constexpr std::uint64_t kMul1 = 0x000F424000000064;  // 100 + (1000000 << 32)
+  constexpr std::uint64_t kMul2 = 0x0000271000000001;  // 1 + (10000 << 32)
+  val -= 0x3030303030303030;
+  // Combine adjacent digits into 2-digit values in every other byte
+  val = (val * 10) + (val >> 8);
+  val = (((val & kMask) * kMul1) + (((val >> 16) & kMask) * kMul2)) >> 32;
+  return static_cast<std::uint32_t>(val);
+}
+
+// Returns the value of `c` if it's an ASCII digit, otherwise a value greater
+// than 9.
+inline std::uint32_t DigitValue(char c) {
+  return static_cast<std::uint32_t>(static_cast<unsigned char>(c)) - '0';
+}
+
+// Parses the run of ASCII digits at the start of `str`, stopping at the first
+// non-digit or after `max_digits`. `max_digits` must be at most 19 so the
+// result can't overflow. Adds the digits to `value` and returns the number of
+// digits parsed.
+inline std::size_t ParseDigitRun(std::string_view str, std::size_t max_digits,
+                                 std::uint64_t& value) {
+  const std::size_t limit = str.size() < max_digits ? str.size() : max_digits;
+  std::size_t i = 0;
+  while (i + 8 <= limit) {
+    const auto chunk = LoadEightBytes(str.data() + i);
+    if (!IsEightDigits(chunk)) {
+      break;
+    }
+    value = value * 100'000'000 + ParseEightDigits(chunk);
+    i += 8;
+  }
+  for (; i < limit; ++i) {
+    const auto digit = DigitValue(str[i]);
+    if (digit > 9) {
+      break;
+    }
+    value = value * 10 + digit;
+  }
+  return i;
+}
+}  // namespace databento
@@ -1,47 +1,124 @@
 #include "databento/pretty.hpp"
 
 #include <array>
+#include <charconv>  // to_chars
+#include <cstddef>
 #include <cstdint>
-#include <iomanip>
-#include <sstream>
+#include <cstring>  // memcpy
+#include <limits>
+#include <ostream>
+#include <string>
+#include <string_view>
 
+#include "databento/constants.hpp"  // kFixedPriceScale
 #include "databento/datetime.hpp"
+#include "databento/exceptions.hpp"  // InvalidArgumentError
+#include "format_helper.hpp"         // WriteDigitsBackward
+#include "parse_helper.hpp"
+
+namespace {
+[[noreturn]] void ThrowInvalidPx(std::string_view str, const char* reason) {
+  throw databento::InvalidArgumentError{
+      "ParsePx", "str", "invalid price '" + std::string{str} + "': " + reason};
+}
+}  // namespace
 
 namespace databento::pretty {
-std::ostream& operator<<(std::ostream& stream, Px px) {
-  constexpr std::array<std::int64_t, 6> kDivisors = {0,         100'000'000, 10'000'000,
-                                                     1'000'000, 100'000,     10'000};
-  if (px.IsUndefined()) {
-    stream << "UNDEF_PRICE";
-    return stream;
-  }
-  const bool is_negative = (px.val < 0);
-  const int64_t px_abs = is_negative ? -px.val : px.val;
-  const int64_t price_integer = px_abs / kFixedPriceScale;
-  const int64_t price_fraction = px_abs % kFixedPriceScale;
-  std::ostringstream ss;
+std::size_t FormatPx(std::int64_t px, int precision, char* out) {
+  constexpr std::string_view kUndef = "UNDEF_PRICE";
+  constexpr std::array<std::uint64_t, 6> kDivisors = {
+      0, 100'000'000, 10'000'000, 1'000'000, 100'000, 10'000};
+  if (px == kUndefPrice) {
+    std::memcpy(out, kUndef.data(), kUndef.size());
+    return kUndef.size();
+  }
+  char* it = out;
+  const bool is_negative = (px < 0);
+  // Negate as unsigned to handle the minimum value
+  const std::uint64_t px_abs = is_negative ? 0 - static_cast<std::uint64_t>(px)
+                                           : static_cast<std::uint64_t>(px);
   if (is_negative) {
-    ss << '-';
+    *it++ = '-';
+  }
+  it = std::to_chars(it, out + kMaxPxLen, px_abs / kFixedPriceScale).ptr;
+  if (precision == 0) {
+    return static_cast<std::size_t>(it - out);
   }
-  const auto orig_precision = static_cast<int>(stream.precision());
-  if (orig_precision == 0) {
-    ss << price_integer;
+  *it++ = '.';
+  const std::uint64_t price_fraction = px_abs % kFixedPriceScale;
+  // Don't support precision 6-8 (inclusive). 6 is the default and there's no
+  // way to disambiguate between explicitly set 6 and the default value,
+  // however by default we want to print all 9 digits
+  if (precision > 0 && precision < 6) {
+    it += precision;
+    const auto divisor = kDivisors[static_cast<std::size_t>(precision)];
+    WriteDigitsBackward(it, price_fraction / divisor, precision);
   } else {
-    // Don't support precision 6-8 (inclusive). 6 is the default and there's no
-    // way to disambiguate between explicitly set 6 and the default value,
-    // however by default we want to print all 9 digits
-    const auto precision = orig_precision < 6 ? orig_precision : 9;
-    ss << price_integer << '.' << std::setw(precision) << std::setfill('0')
-       << (precision == 9
-               ? price_fraction
-               : price_fraction / kDivisors[static_cast<std::size_t>(precision)]);
-  }
-  stream << ss.str();
-  return stream;
+    it += 9;
+    WriteDigitsBackward(it, price_fraction, 9);
+  }
+  return static_cast<std::size_t>(it - out);
+}
+
+std::string PxToString(std::int64_t px) {
+  std::array<char, kMaxPxLen> buf;
+  // The default stream precision
+  return std::string(buf.data(), FormatPx(px, 6, buf.data()));
+}
+
+std::int64_t ParsePx(std::string_view str) {
+  constexpr std::array<std::uint64_t, 10> kPow10 = {
+      1, 10, 100, 1'000, 10'000, 100'000, 1'000'000, 10'000'000, 100'000'000,
+      1'000'000'000};
+  constexpr std::uint64_t kMax = std::numeric_limits<std::int64_t>::max();
+  if (str == "UNDEF_PRICE") {
+    return kUndefPrice;
+  }
+  const bool is_negative = !str.empty() && str[0] == '-';
+  std::size_t pos = is_negative ? 1 : 0;
+  std::uint64_t price_integer = 0;
+  const auto integer_digits = ParseDigitRun(str.substr(pos), 19, price_integer);
+  if (integer_digits == 0) {
+    ThrowInvalidPx(str, "expected a digit");
+  }
+  pos += integer_digits;
+  if (pos < str.size() && DigitValue(str[pos]) <= 9) {
+    ThrowInvalidPx(str, "out of range");
+  }
+  std::uint64_t price_fraction = 0;
+  if (pos < str.size() && str[pos] == '.') {
+    ++pos;
+    const auto fraction_digits = ParseDigitRun(str.substr(pos), 9, price_fraction);
+    if (fraction_digits == 0) {
+      ThrowInvalidPx(str, "expected a digit after the decimal point");
+    }
+    pos += fraction_digits;
+    if (pos < str.size() && DigitValue(str[pos]) <= 9) {
+      ThrowInvalidPx(str, "more than 9 decimal places");
+    }
+    price_fraction *= kPow10[9 - fraction_digits];
+  }
+  if (pos != str.size()) {
+    ThrowInvalidPx(str, "unexpected trailing characters");
+  }
+  // The magnitude of the minimum value is one greater than the maximum
+  const std::uint64_t limit = is_negative ? kMax + 1 : kMax;
+  if (price_integer > (limit - price_fraction) / kFixedPriceScale) {
+    ThrowInvalidPx(str, "out of range");
+  }
+  const std::uint64_t px_abs = price_integer * kFixedPriceScale + price_fraction;
+  return static_cast<std::int64_t>(is_negative ? 0 - px_abs : px_abs);
+}
+
+std::ostream& operator<<(std::ostream& stream, Px px) {
+  std::array<char, kMaxPxLen> buf;
+  const auto len = FormatPx(px.val, static_cast<int>(stream.precision()), buf.data());
+  // Inserting a `string_view` respects the stream's fill and width
+  return stream << std::string_view{buf.data(), len};
 }
 
 std::ostream& operator<<(std::ostream& stream, Ts ts) {
-  stream << ToIso8601(ts.val);
-  return stream;
+  std::array<char, kMaxIso8601Len> buf;
+  return stream << std::string_view{buf.data(), FormatIso8601(ts.val, buf.data())};
 }
 }  // namespace databento::pretty
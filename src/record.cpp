@@ -5,7 +5,7 @@
 #include "databento/enums.hpp"
 #include "databento/exceptions.hpp"  // InvalidArgumentError
 #include "databento/pretty.hpp"      // Px
-#include "stream_op_helper.hpp"
+#include "format_helper.hpp"
 
 using databento::Record;
 using databento::RecordHeader;
@@ -16,6 +16,45 @@ std::size_t RecordHeader::Size() const {
 
 std::size_t Record::Size() const { return record_->Size(); }
 
+databento::UnixNanos Record::IndexTs() const {
+  if (const auto* mbo = GetIf<MboMsg>()) {
+    return mbo->IndexTs();
+  }
+  if (const auto* trade = GetIf<TradeMsg>()) {
+    return trade->IndexTs();
+  }
+  if (const auto* mbp1 = GetIf<Mbp1Msg>()) {
+    return mbp1->IndexTs();
+  }
+  if (const auto* mbp10 = GetIf<Mbp10Msg>()) {
+    return mbp10->IndexTs();
+  }
+  if (const auto* bbo = GetIf<BboMsg>()) {
+    return bbo->IndexTs();
+  }
+  if (const auto* cmbp1 = GetIf<Cmbp1Msg>()) {
+    return cmbp1->IndexTs();
+  }
+  if (const auto* cbbo = GetIf<CbboMsg>()) {
+    return cbbo->IndexTs();
+  }
+  if (const auto* status = GetIf<StatusMsg>()) {
+    return status->IndexTs();
+  }
+  // `ts_recv` is at the same offset in all versions of definitions and
+  // statistics
+  if (const auto* def = GetIf<InstrumentDefMsg>()) {
+    return def->IndexTs();
+  }
+  if (const auto* imbalance = GetIf<ImbalanceMsg>()) {
+    return imbalance->IndexTs();
+  }
+  if (const auto* stat = GetIf<StatMsg>()) {
+    return stat->IndexTs();
+  }
+  return Header().ts_event;
+}
+
 std::size_t Record::SizeOfSchema(const Schema schema) {
   switch (schema) {
     case Schema::Mbo: {
@@ -191,18 +230,20 @@ bool databento::operator==(const ImbalanceMsg& lhs, const ImbalanceMsg& rhs) {
 }
 
 namespace databento {
-std::string ToString(const Record& record) { return MakeString(record); }
-std::ostream& operator<<(std::ostream& stream, const Record& record) {
-  return StreamOpBuilder{stream}
+void FormatTo(FormatBuffer& buffer, const Record& record) {
+  FormatBuilder{buffer}
       .SetSpacer(" ")
       .SetTypeName("Record")
       .Build()
       .AddField("ptr", record.Header())
       .Finish();
 }
-std::string ToString(const RecordHeader& header) { return MakeString(header); }
-std::ostream& operator<<(std::ostream& stream, const RecordHeader& header) {
-  return StreamOpBuilder{stream}
+std::string ToString(const Record& record) { return FormatToString(record); }
+std::ostream& operator<<(std::ostream& stream, const Record& record) {
+  return FormatToStream(stream, record);
+}
+void FormatTo(FormatBuffer& buffer, const RecordHeader& header) {
+  FormatBuilder{buffer}
       .SetSpacer(" ")
       .SetTypeName("RecordHeader")
       .Build()
@@ -213,10 +254,13 @@ std::ostream& operator<<(std::ostream& stream, const RecordHeader& header) {
       .AddField("ts_event", header.ts_event)
       .Finish();
 }
+std::string ToString(const RecordHeader& header) { return FormatToString(header); }
+std::ostream& operator<<(std::ostream& stream, const RecordHeader& header) {
+  return FormatToStream(stream, header);
+}
 
-std::string ToString(const MboMsg& mbo_msg) { return MakeString(mbo_msg); }
-std::ostream& operator<<(std::ostream& stream, const MboMsg& mbo_msg) {
-  return StreamOpBuilder{stream}
+void FormatTo(FormatBuffer& buffer, const MboMsg& mbo_msg) {
+  FormatBuilder{buffer}
       .SetSpacer("\n    ")
       .SetTypeName("MboMsg")
       .Build()
@@ -233,12 +277,13 @@ std::ostream& operator<<(std::ostream& stream, const MboMsg& mbo_msg) {
       .AddField("sequence", mbo_msg.sequence)
       .Finish();
 }
-
-std::string ToString(const BidAskPair& bid_ask_pair) {
-  return MakeString(bid_ask_pair);
+std::string ToString(const MboMsg& mbo_msg) { return FormatToString(mbo_msg); }
+std::ostream& operator<<(std::ostream& stream, const MboMsg& mbo_msg) {
+  return FormatToStream(stream, mbo_msg);
 }
-std::ostream& operator<<(std::ostream& stream, const BidAskPair& bid_ask_pair) {
-  return StreamOpBuilder{stream}
+
+void FormatTo(FormatBuffer& buffer, const BidAskPair& bid_ask_pair) {
+  FormatBuilder{buffer}
       .SetSpacer(" ")
       .SetTypeName("BidAskPair")
       .Build()
@@ -250,13 +295,16 @@ std::ostream& operator<<(std::ostream& stream, const BidAskPair& bid_ask_pair) {
       .AddField("ask_ct", bid_ask_pair.ask_ct)
       .Finish();
 }
-
-std::string ToString(const ConsolidatedBidAskPair& consolidated_bid_ask_pair) {
-  return MakeString(consolidated_bid_ask_pair);
+std::string ToString(const BidAskPair& bid_ask_pair) {
+  return FormatToString(bid_ask_pair);
 }
-std::ostream& operator<<(std::ostream& stream,
-                         const ConsolidatedBidAskPair& consolidated_bid_ask_pair) {
-  return StreamOpBuilder{stream}
+std::ostream& operator<<(std::ostream& stream, const BidAskPair& bid_ask_pair) {
+  return FormatToStream(stream, bid_ask_pair);
+}
+
+void FormatTo(FormatBuffer& buffer,
+              const ConsolidatedBidAskPair& consolidated_bid_ask_pair) {
+  FormatBuilder{buffer}
       .SetSpacer(" ")
       .SetTypeName("ConsolidatedBidAskPair")
       .Build()
@@ -268,10 +316,16 @@ std::ostream& operator<<(std::ostream& stream,
       .AddField("ask_pb", consolidated_bid_ask_pair.ask_pb)
       .Finish();
 }
+std::string ToString(const ConsolidatedBidAskPair& consolidated_bid_ask_pair) {
+  return FormatToString(consolidated_bid_ask_pair);
+}
+std::ostream& operator<<(std::ostream& stream,
+                         const ConsolidatedBidAskPair& consolidated_bid_ask_pair) {
+  return FormatToStream(stream, consolidated_bid_ask_pair);
+}
 
-std::string ToString(const TradeMsg& trade_msg) { return MakeString(trade_msg); }
-std::ostream& operator<<(std::ostream& stream, const TradeMsg& trade_msg) {
-  return StreamOpBuilder{stream}
+void FormatTo(FormatBuffer& buffer, const TradeMsg& trade_msg) {
+  FormatBuilder{buffer}
       .SetSpacer("\n    ")
       .SetTypeName("TradeMsg")
       .Build()
@@ -287,10 +341,13 @@ std::ostream& operator<<(std::ostream& stream, const TradeMsg& trade_msg) {
       .AddField("sequence", trade_msg.sequence)
       .Finish();
 }
+std::string ToString(const TradeMsg& trade_msg) { return FormatToString(trade_msg); }
+std::ostream& operator<<(std::ostream& stream, const TradeMsg& trade_msg) {
+  return FormatToStream(stream, trade_msg);
+}
 
-std::string ToString(const Mbp1Msg& mbp1_msg) { return MakeString(mbp1_msg); }
-std::ostream& operator<<(std::ostream& stream, const Mbp1Msg& mbp1_msg) {
-  return StreamOpBuilder{stream}
+void FormatTo(FormatBuffer& buffer, const Mbp1Msg& mbp1_msg) {
+  FormatBuilder{buffer}
       .SetSpacer("\n    ")
       .SetTypeName("Mbp1Msg")
       .Build()
@@ -304,20 +361,26 @@ std::ostream& operator<<(std::ostream& stream, const Mbp1Msg& mbp1_msg) {
       .AddField("ts_recv", mbp1_msg.ts_recv)
       .AddField("ts_in_delta", mbp1_msg.ts_in_delta)
       .AddField("sequence", mbp1_msg.sequence)
-
       .AddField("levels", std::get<0>(mbp1_msg.levels))
       .Finish();
 }
+std::string ToString(const Mbp1Msg& mbp1_msg) { return FormatToString(mbp1_msg); }
+std::ostream& operator<<(std::ostream& stream, const Mbp1Msg& mbp1_msg) {
+  return FormatToStream(stream, mbp1_msg);
+}
 
-std::string ToString(const Mbp10Msg& mbp10_msg) { return MakeString(mbp10_msg); }
-std::ostream& operator<<(std::ostream& stream, const Mbp10Msg& mbp10_msg) {
-  std::ostringstream sub_ss;
-  auto helper = StreamOpBuilder{sub_ss}.SetSpacer("\n    ").SetIndent("    ").Build();
-  for (const auto& level : mbp10_msg.levels) {
-    helper.AddItem(level);
-  }
-
-  return StreamOpBuilder{stream}
+void FormatTo(FormatBuffer& buffer, const Mbp10Msg& mbp10_msg) {
+  const auto format_levels = [&mbp10_msg](FormatBuffer& parent_buffer) {
+    // Levels are always formatted with the default precision
+    FormatBuffer levels_buffer{parent_buffer.Out(), 6};
+    auto helper =
+        FormatBuilder{levels_buffer}.SetSpacer("\n    ").SetIndent("    ").Build();
+    for (const auto& level : mbp10_msg.levels) {
+      helper.AddItem(level);
+    }
+    helper.Finish();
+  };
+  FormatBuilder{buffer}
       .SetSpacer("\n    ")
       .SetTypeName("Mbp10Msg")
       .Build()
@@ -331,13 +394,16 @@ std::ostream& operator<<(std::ostream& stream, const Mbp10Msg& mbp10_msg) {
       .AddField("ts_recv", mbp10_msg.ts_recv)
       .AddField("ts_in_delta", mbp10_msg.ts_in_delta)
       .AddField("sequence", mbp10_msg.sequence)
-      .AddField("levels", static_cast<std::ostringstream&>(helper.Finish()))
+      .AddField("levels", format_levels)
       .Finish();
 }
+std::string ToString(const Mbp10Msg& mbp10_msg) { return FormatToString(mbp10_msg); }
+std::ostream& operator<<(std::ostream& stream, const Mbp10Msg& mbp10_msg) {
+  return FormatToStream(stream, mbp10_msg);
+}
 
-std::string ToString(const BboMsg& bbo_msg) { return MakeString(bbo_msg); }
-std::ostream& operator<<(std::ostream& stream, const BboMsg& bbo_msg) {
-  return StreamOpBuilder{stream}
+void FormatTo(FormatBuffer& buffer, const BboMsg& bbo_msg) {
+  FormatBuilder{buffer}
       .SetSpacer("\n    ")
       .SetTypeName("BboMsg")
       .Build()
@@ -348,14 +414,16 @@ std::ostream& operator<<(std::ostream& stream, const BboMsg& bbo_msg) {
       .AddField("flags", bbo_msg.flags)
       .AddField("ts_recv", bbo_msg.ts_recv)
       .AddField("sequence", bbo_msg.sequence)
-
       .AddField("levels", std::get<0>(bbo_msg.levels))
       .Finish();
 }
+std::string ToString(const BboMsg& bbo_msg) { return FormatToString(bbo_msg); }
+std::ostream& operator<<(std::ostream& stream, const BboMsg& bbo_msg) {
+  return FormatToStream(stream, bbo_msg);
+}
 
-std::string ToString(const Cmbp1Msg& cmbp1_msg) { return MakeString(cmbp1_msg); }
-std::ostream& operator<<(std::ostream& stream, const Cmbp1Msg& cmbp1_msg) {
-  return StreamOpBuilder{stream}
+void FormatTo(FormatBuffer& buffer, const Cmbp1Msg& cmbp1_msg) {
+  FormatBuilder{buffer}
       .SetSpacer("\n    ")
       .SetTypeName("Cmbp1Msg")
       .Build()
@@ -367,14 +435,16 @@ std::ostream& operator<<(std::ostream& stream, const Cmbp1Msg& cmbp1_msg) {
       .AddField("flags", cmbp1_msg.flags)
       .AddField("ts_recv", cmbp1_msg.ts_recv)
       .AddField("ts_in_delta", cmbp1_msg.ts_in_delta)
-
       .AddField("levels", std::get<0>(cmbp1_msg.levels))
       .Finish();
 }
+std::string ToString(const Cmbp1Msg& cmbp1_msg) { return FormatToString(cmbp1_msg); }
+std::ostream& operator<<(std::ostream& stream, const Cmbp1Msg& cmbp1_msg) {
+  return FormatToStream(stream, cmbp1_msg);
+}
 
-std::string ToString(const CbboMsg& cbbo_msg) { return MakeString(cbbo_msg); }
-std::ostream& operator<<(std::ostream& stream, const CbboMsg& cbbo_msg) {
-  return StreamOpBuilder{stream}
+void FormatTo(FormatBuffer& buffer, const CbboMsg& cbbo_msg) {
+  FormatBuilder{buffer}
       .SetSpacer("\n    ")
       .SetTypeName("CbboMsg")
       .Build()
@@ -384,14 +454,16 @@ std::ostream& operator<<(std::ostream& stream, const CbboMsg& cbbo_msg) {
       .AddField("side", cbbo_msg.side)
       .AddField("flags", cbbo_msg.flags)
       .AddField("ts_recv", cbbo_msg.ts_recv)
-
       .AddField("levels", std::get<0>(cbbo_msg.levels))
       .Finish();
 }
+std::string ToString(const CbboMsg& cbbo_msg) { return FormatToString(cbbo_msg); }
+std::ostream& operator<<(std::ostream& stream, const CbboMsg& cbbo_msg) {
+  return FormatToStream(stream, cbbo_msg);
+}
 
-std::string ToString(const OhlcvMsg& ohlcv_msg) { return MakeString(ohlcv_msg); }
-std::ostream& operator<<(std::ostream& stream, const OhlcvMsg& ohlcv_msg) {
-  return StreamOpBuilder{stream}
+void FormatTo(FormatBuffer& buffer, const OhlcvMsg& ohlcv_msg) {
+  FormatBuilder{buffer}
       .SetSpacer("\n    ")
       .SetTypeName("OhlcvMsg")
       .Build()
@@ -403,10 +475,13 @@ std::ostream& operator<<(std::ostream& stream, const OhlcvMsg& ohlcv_msg) {
       .AddField("volume", ohlcv_msg.volume)
       .Finish();
 }
+std::string ToString(const OhlcvMsg& ohlcv_msg) { return FormatToString(ohlcv_msg); }
+std::ostream& operator<<(std::ostream& stream, const OhlcvMsg& ohlcv_msg) {
+  return FormatToStream(stream, ohlcv_msg);
+}
 
-std::string ToString(const StatusMsg& status_msg) { return MakeString(status_msg); }
-std::ostream& operator<<(std::ostream& stream, const StatusMsg& status_msg) {
-  return StreamOpBuilder{stream}
+void FormatTo(FormatBuffer& buffer, const StatusMsg& status_msg) {
+  FormatBuilder{buffer}
       .SetSpacer("\n    ")
       .SetTypeName("StatusMsg")
       .Build()
@@ -420,13 +495,13 @@ std::ostream& operator<<(std::ostream& stream, const StatusMsg& status_msg) {
       .AddField("is_short_sell_restricted", status_msg.is_short_sell_restricted)
       .Finish();
 }
-
-std::string ToString(const InstrumentDefMsg& instrument_def_msg) {
-  return MakeString(instrument_def_msg);
+std::string ToString(const StatusMsg& status_msg) { return FormatToString(status_msg); }
+std::ostream& operator<<(std::ostream& stream, const StatusMsg& status_msg) {
+  return FormatToStream(stream, status_msg);
 }
-std::ostream& operator<<(std::ostream& stream,
-                         const InstrumentDefMsg& instrument_def_msg) {
-  return StreamOpBuilder{stream}
+
+void FormatTo(FormatBuffer& buffer, const InstrumentDefMsg& instrument_def_msg) {
+  FormatBuilder{buffer}
       .SetSpacer("\n    ")
       .SetTypeName("InstrumentDefMsg")
       .Build()
@@ -509,12 +584,16 @@ std::ostream& operator<<(std::ostream& stream,
       .AddField("leg_side", instrument_def_msg.leg_side)
       .Finish();
 }
-
-std::string ToString(const ImbalanceMsg& imbalance_msg) {
-  return MakeString(imbalance_msg);
+std::string ToString(const InstrumentDefMsg& instrument_def_msg) {
+  return FormatToString(instrument_def_msg);
 }
-std::ostream& operator<<(std::ostream& stream, const ImbalanceMsg& imbalance_msg) {
-  return StreamOpBuilder{stream}
+std::ostream& operator<<(std::ostream& stream,
+                         const InstrumentDefMsg& instrument_def_msg) {
+  return FormatToStream(stream, instrument_def_msg);
+}
+
+void FormatTo(FormatBuffer& buffer, const ImbalanceMsg& imbalance_msg) {
+  FormatBuilder{buffer}
       .SetSpacer("\n    ")
       .SetTypeName("ImbalanceMsg")
       .Build()
@@ -542,10 +621,15 @@ std::ostream& operator<<(std::ostream& stream, const ImbalanceMsg& imbalance_msg
       .AddField("significant_imbalance", imbalance_msg.significant_imbalance)
       .Finish();
 }
+std::string ToString(const ImbalanceMsg& imbalance_msg) {
+  return FormatToString(imbalance_msg);
+}
+std::ostream& operator<<(std::ostream& stream, const ImbalanceMsg& imbalance_msg) {
+  return FormatToStream(stream, imbalance_msg);
+}
 
-std::string ToString(const StatMsg& stat_msg) { return MakeString(stat_msg); }
-std::ostream& operator<<(std::ostream& stream, const StatMsg& stat_msg) {
-  return StreamOpBuilder{stream}
+void FormatTo(FormatBuffer& buffer, const StatMsg& stat_msg) {
+  FormatBuilder{buffer}
       .SetSpacer("\n    ")
       .SetTypeName("StatMsg")
       .Build()
@@ -562,10 +646,13 @@ std::ostream& operator<<(std::ostream& stream, const StatMsg& stat_msg) {
       .AddField("stat_flags", stat_msg.stat_flags)
       .Finish();
 }
+std::string ToString(const StatMsg& stat_msg) { return FormatToString(stat_msg); }
+std::ostream& operator<<(std::ostream& stream, const StatMsg& stat_msg) {
+  return FormatToStream(stream, stat_msg);
+}
 
-std::string ToString(const ErrorMsg& error_msg) { return MakeString(error_msg); }
-std::ostream& operator<<(std::ostream& stream, const ErrorMsg& error_msg) {
-  return StreamOpBuilder{stream}
+void FormatTo(FormatBuffer& buffer, const ErrorMsg& error_msg) {
+  FormatBuilder{buffer}
       .SetSpacer("\n    ")
       .SetTypeName("ErrorMsg")
       .Build()
@@ -575,13 +662,13 @@ std::ostream& operator<<(std::ostream& stream, const ErrorMsg& error_msg) {
       .AddField("is_last", error_msg.is_last)
       .Finish();
 }
-
-std::string ToString(const SymbolMappingMsg& symbol_mapping_msg) {
-  return MakeString(symbol_mapping_msg);
+std::string ToString(const ErrorMsg& error_msg) { return FormatToString(error_msg); }
+std::ostream& operator<<(std::ostream& stream, const ErrorMsg& error_msg) {
+  return FormatToStream(stream, error_msg);
 }
-std::ostream& operator<<(std::ostream& stream,
-                         const SymbolMappingMsg& symbol_mapping_msg) {
-  return StreamOpBuilder{stream}
+
+void FormatTo(FormatBuffer& buffer, const SymbolMappingMsg& symbol_mapping_msg) {
+  FormatBuilder{buffer}
       .SetSpacer("\n    ")
       .SetTypeName("SymbolMappingMsg")
       .Build()
@@ -594,10 +681,16 @@ std::ostream& operator<<(std::ostream& stream,
       .AddField("end_ts", symbol_mapping_msg.end_ts)
       .Finish();
 }
+std::string ToString(const SymbolMappingMsg& symbol_mapping_msg) {
+  return FormatToString(symbol_mapping_msg);
+}
+std::ostream& operator<<(std::ostream& stream,
+                         const SymbolMappingMsg& symbol_mapping_msg) {
+  return FormatToStream(stream, symbol_mapping_msg);
+}
 
-std::string ToString(const SystemMsg& system_msg) { return MakeString(system_msg); }
-std::ostream& operator<<(std::ostream& stream, const SystemMsg& system_msg) {
-  return StreamOpBuilder{stream}
+void FormatTo(FormatBuffer& buffer, const SystemMsg& system_msg) {
+  FormatBuilder{buffer}
       .SetSpacer("\n    ")
       .SetTypeName("SystemMsg")
       .Build()
@@ -606,5 +699,9 @@ std::ostream& operator<<(std::ostream& stream, const SystemMsg& system_msg) {
       .AddField("code", system_msg.code)
       .Finish();
 }
+std::string ToString(const SystemMsg& system_msg) { return FormatToString(system_msg); }
+std::ostream& operator<<(std::ostream& stream, const SystemMsg& system_msg) {
+  return FormatToStream(stream, system_msg);
+}
 
 }  // namespace databento
@@ -51,7 +51,11 @@ class StreamOpHelper {
     stream_ << static_cast<std::int16_t>(val);
   }
 
-  void FmtToStream(const UnixNanos& val) { stream_ << ToIso8601(val); }
+  void FmtToStream(const UnixNanos& val) {
+    std::array<char, kMaxIso8601Len> buf;
+    stream_.write(buf.data(),
+                  static_cast<std::streamsize>(FormatIso8601(val, buf.data())));
+  }
 
   void FmtToStream(const TimeDeltaNanos& val) { stream_ << ToString(val); }
 
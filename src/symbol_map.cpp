@@ -2,18 +2,30 @@
 
 #include <date/date.h>
 
+#include <algorithm>  // adjacent_find, find, find_if, upper_bound
+#include <array>
+#include <charconv>  // from_chars
+#include <iterator>  // prev
 #include <memory>
+#include <stdexcept>  // out_of_range
 #include <string>
+#include <string_view>
+#include <type_traits>  // is_same_v
+#include <utility>      // move
+#include <vector>
 
+#include "databento/arena_metadata.hpp"
 #include "databento/datetime.hpp"
 #include "databento/dbn.hpp"
 #include "databento/enums.hpp"
 #include "databento/exceptions.hpp"
 
 using databento::TsSymbolMap;
+using databento::detail::SymbolView;
 
 namespace {
-bool IsInverse(const databento::Metadata& metadata) {
+template <typename M>
+bool IsInverse(const M& metadata) {
   if (metadata.stype_in.has_value()) {
     if (*metadata.stype_in == databento::SType::InstrumentId) {
       return true;
@@ -27,6 +39,79 @@ bool IsInverse(const databento::Metadata& metadata) {
       "Can only create symbol maps from metadata where InstrumentId is one "
       "of the stypes"};
 }
+
+std::uint32_t ParseInstrumentId(std::string_view symbol) {
+  std::uint32_t res{};
+  const auto* end = symbol.data() + symbol.size();
+  const auto [ptr, ec] = std::from_chars(symbol.data(), end, res);
+  if (ec != std::errc{} || ptr != end) {
+    throw databento::InvalidArgumentError{"SymbolMap", "metadata",
+                                          "Invalid instrument ID '" +
+                                              std::string{symbol} + '\''};
+  }
+  return res;
+}
+
+using Interval = databento::CompactTsSymbolMap::Interval;
+
+// Inserts the parts of `interval` not already covered by the sorted,
+// non-overlapping `intervals`, so the earliest insertion takes precedence like
+// in `TsSymbolMap`. Returns the number of intervals inserted.
+std::size_t InsertUncovered(std::vector<Interval>* intervals, Interval interval) {
+  std::size_t count{};
+  // First interval ending after `interval` starts. As they don't overlap,
+  // `intervals` are also sorted by `end_date`
+  auto it = std::upper_bound(
+      intervals->begin(), intervals->end(), interval.start_date,
+      [](date::sys_days lhs, const Interval& rhs) { return lhs < rhs.end_date; });
+  while (interval.start_date < interval.end_date) {
+    if (it == intervals->end() || interval.end_date <= it->start_date) {
+      intervals->insert(it, interval);
+      return count + 1;
+    }
+    if (interval.start_date < it->start_date) {
+      // Fill the gap before `it`
+      it = intervals->insert(
+          it, Interval{interval.start_date, it->start_date, interval.symbol});
+      ++it;
+      ++count;
+    }
+    interval.start_date = it->end_date;
+    ++it;
+  }
+  return count;
+}
+
+// Calls `insert` with the instrument ID and symbol of each mapping active on
+// `date`.
+template <typename F>
+void ForEachPitMapping(const databento::Metadata& metadata, date::year_month_day date,
+                       const char* method_name, F insert) {
+  if (date::sys_days{date} < date::floor<date::days>(metadata.start) ||
+      // need to compare with `end` as datetime to handle midnight case
+      databento::UnixNanos{date::sys_days{date}} >= metadata.end) {
+    throw databento::InvalidArgumentError{method_name, "date", "Outside query range"};
+  }
+  const auto is_inverse = IsInverse(metadata);
+  for (const auto& mapping : metadata.mappings) {
+    const auto interval_it =
+        std::find_if(mapping.intervals.begin(), mapping.intervals.end(),
+                     [date](const databento::MappingInterval& interval) {
+                       return date >= interval.start_date && date < interval.end_date;
+                     });
+    // Empty symbols in old symbology format
+    if (interval_it == mapping.intervals.end() || interval_it->symbol.empty()) {
+      continue;
+    }
+    if (is_inverse) {
+      const auto iid = static_cast<std::uint32_t>(std::stoul(mapping.raw_symbol));
+      insert(iid, interval_it->symbol);
+    } else {
+      const auto iid = static_cast<std::uint32_t>(std::stoul(interval_it->symbol));
+      insert(iid, mapping.raw_symbol);
+    }
+  }
+}
 }  // namespace
 
 TsSymbolMap::TsSymbolMap(const Metadata& metadata) {
@@ -73,34 +158,148 @@ void TsSymbolMap::Insert(std::uint32_t instrument_id, date::year_month_day start
   }
 }
 
-using databento::PitSymbolMap;
+using databento::CompactTsSymbolMap;
 
-PitSymbolMap::PitSymbolMap(const Metadata& metadata, date::year_month_day date) {
-  if (date::sys_days{date} < date::floor<date::days>(metadata.start) ||
-      // need to compare with `end` as datetime to handle midnight case
-      UnixNanos{date::sys_days{date}} >= metadata.end) {
-    throw InvalidArgumentError{"PitSymbolMap::PitSymbolMap", "date",
-                               "Outside query range"};
-  }
-  const auto is_inverse = IsInverse(metadata);
+CompactTsSymbolMap::CompactTsSymbolMap(const Metadata& metadata) {
+  InsertMappings(metadata);
+}
+
+CompactTsSymbolMap::CompactTsSymbolMap(const ArenaMetadata& metadata) {
+  InsertMappings(metadata);
+}
+
+template <typename M>
+void CompactTsSymbolMap::InsertMappings(const M& metadata) {
+  const auto is_inverse = ::IsInverse(metadata);
   for (const auto& mapping : metadata.mappings) {
-    const auto interval_it =
-        std::find_if(mapping.intervals.begin(), mapping.intervals.end(),
-                     [date](const MappingInterval& interval) {
-                       return date >= interval.start_date && date < interval.end_date;
-                     });
-    // Empty symbols in old symbology format
-    if (interval_it == mapping.intervals.end() || interval_it->symbol.empty()) {
-      continue;
-    }
+    const std::string* symbol = nullptr;
+    std::uint32_t iid{};
     if (is_inverse) {
-      const auto iid = static_cast<std::uint32_t>(std::stoul(mapping.raw_symbol));
-      map_.emplace(iid, interval_it->symbol);
+      iid = ParseInstrumentId(mapping.raw_symbol);
     } else {
-      const auto iid = static_cast<std::uint32_t>(std::stoul(interval_it->symbol));
-      map_.emplace(iid, mapping.raw_symbol);
+      symbol = Intern(mapping.raw_symbol);
+    }
+    const auto add_interval = [&](const auto& interval) {
+      // Handle old symbology format
+      if (interval.symbol.empty()) {
+        return;
+      }
+      if (is_inverse) {
+        Append(iid, interval.start_date, interval.end_date, Intern(interval.symbol));
+      } else {
+        Append(ParseInstrumentId(interval.symbol), interval.start_date,
+               interval.end_date, symbol);
+      }
+    };
+    if constexpr (std::is_same_v<M, ArenaMetadata>) {
+      for (const auto& interval : metadata.Intervals(mapping)) {
+        add_interval(interval);
+      }
+    } else {
+      for (const auto& interval : mapping.intervals) {
+        add_interval(interval);
+      }
     }
   }
+  Sort();
+}
+
+const std::string* CompactTsSymbolMap::Find(date::year_month_day date,
+                                            std::uint32_t instrument_id) const {
+  const auto map_it = map_.find(instrument_id);
+  if (map_it == map_.end()) {
+    return nullptr;
+  }
+  const date::sys_days day{date};
+  const auto& intervals = map_it->second;
+  // First interval starting after `day`
+  const auto it =
+      std::upper_bound(intervals.begin(), intervals.end(), day,
+                       [](date::sys_days lhs, const Interval& rhs) {
+                         return lhs < rhs.start_date;
+                       });
+  if (it == intervals.begin()) {
+    return nullptr;
+  }
+  const auto& interval = *std::prev(it);
+  if (day >= interval.end_date) {
+    return nullptr;
+  }
+  return interval.symbol;
+}
+
+const std::string& CompactTsSymbolMap::At(date::year_month_day date,
+                                          std::uint32_t instrument_id) const {
+  const auto* symbol = Find(date, instrument_id);
+  if (symbol == nullptr) {
+    throw std::out_of_range{"CompactTsSymbolMap::At"};
+  }
+  return *symbol;
+}
+
+void CompactTsSymbolMap::Insert(std::uint32_t instrument_id,
+                                date::year_month_day start_date,
+                                date::year_month_day end_date,
+                                const std::string& symbol) {
+  if (start_date > end_date) {
+    throw InvalidArgumentError{"CompactTsSymbolMap::Insert", "end_date",
+                               "can't be before start_date"};
+  }
+  if (start_date == end_date) {
+    // Ignore
+    return;
+  }
+  size_ += InsertUncovered(&map_[instrument_id],
+                           Interval{start_date, end_date, Intern(symbol)});
+}
+
+const std::string* CompactTsSymbolMap::Intern(std::string_view symbol) {
+  return &*symbols_.emplace(symbol).first;
+}
+
+void CompactTsSymbolMap::Append(std::uint32_t instrument_id,
+                                date::year_month_day start_date,
+                                date::year_month_day end_date,
+                                const std::string* symbol) {
+  if (start_date > end_date) {
+    throw InvalidArgumentError{"CompactTsSymbolMap::Insert", "end_date",
+                               "can't be before start_date"};
+  }
+  if (start_date == end_date) {
+    return;
+  }
+  map_[instrument_id].emplace_back(Interval{start_date, end_date, symbol});
+  ++size_;
+}
+
+void CompactTsSymbolMap::Sort() {
+  // Also true when `rhs` starts before `lhs` because intervals are non-empty
+  const auto overlaps = [](const Interval& lhs, const Interval& rhs) {
+    return rhs.start_date < lhs.end_date;
+  };
+  size_ = 0;
+  for (auto& [_, intervals] : map_) {
+    // Intervals from metadata are typically already in order without overlaps
+    if (std::adjacent_find(intervals.begin(), intervals.end(), overlaps) !=
+        intervals.end()) {
+      std::vector<Interval> resolved;
+      for (const auto& interval : intervals) {
+        InsertUncovered(&resolved, interval);
+      }
+      intervals = std::move(resolved);
+    }
+    intervals.shrink_to_fit();
+    size_ += intervals.size();
+  }
+}
+
+using databento::PitSymbolMap;
+
+PitSymbolMap::PitSymbolMap(const Metadata& metadata, date::year_month_day date) {
+  ForEachPitMapping(metadata, date, "PitSymbolMap::PitSymbolMap",
+                    [this](std::uint32_t iid, const std::string& symbol) {
+                      map_.emplace(iid, symbol);
+                    });
 }
 
 template <typename SymbolMappingRec>
@@ -108,7 +307,7 @@ void PitSymbolMap::OnSymbolMapping(const SymbolMappingRec& symbol_mapping) {
   const auto it = map_.find(symbol_mapping.hd.instrument_id);
   if (it == map_.end()) {
     map_.emplace(symbol_mapping.hd.instrument_id, symbol_mapping.STypeOutSymbol());
-  } else {
+  } else if (it->second != SymbolView(symbol_mapping.stype_out_symbol)) {
     it->second = symbol_mapping.STypeOutSymbol();
   }
 }
@@ -127,3 +326,206 @@ void PitSymbolMap::OnRecord(const Record& record) {
 // Explicit instantiation
 template void PitSymbolMap::OnSymbolMapping(const SymbolMappingMsgV1& symbol_mapping);
 template void PitSymbolMap::OnSymbolMapping(const SymbolMappingMsgV2& symbol_mapping);
+
+using databento::FlatPitSymbolMap;
+
+FlatPitSymbolMap::FlatPitSymbolMap(const Metadata& metadata,
+                                   date::year_month_day date) {
+  ForEachPitMapping(metadata, date, "FlatPitSymbolMap::FlatPitSymbolMap",
+                    [this](std::uint32_t iid, const std::string& symbol) {
+                      // Match `PitSymbolMap`, where the first mapping wins
+                      if (FindSlot(iid) == nullptr) {
+                        Insert(iid, symbol);
+                      }
+                    });
+}
+
+std::string_view FlatPitSymbolMap::At(std::uint32_t instrument_id) const {
+  const auto* slot = FindSlot(instrument_id);
+  if (slot == nullptr) {
+    throw std::out_of_range{"FlatPitSymbolMap::At"};
+  }
+  return symbols_[slot->symbol_idx];
+}
+
+void FlatPitSymbolMap::Insert(std::uint32_t instrument_id, std::string_view symbol) {
+  // Keep load factor at or below 1/2
+  if ((size_ + 1) * 2 > slots_.size()) {
+    Grow();
+  }
+  auto& slot = ProbeSlot(instrument_id);
+  if (slot.symbol_idx == kEmptySlot) {
+    slot.instrument_id = instrument_id;
+    slot.symbol_idx = Intern(symbol);
+    ++size_;
+  } else if (symbols_[slot.symbol_idx] != symbol) {
+    slot.symbol_idx = Intern(symbol);
+  }
+}
+
+template <typename SymbolMappingRec>
+void FlatPitSymbolMap::OnSymbolMapping(const SymbolMappingRec& symbol_mapping) {
+  Insert(symbol_mapping.hd.instrument_id, SymbolView(symbol_mapping.stype_out_symbol));
+}
+
+void FlatPitSymbolMap::OnRecord(const Record& record) {
+  if (record.RType() == RType::SymbolMapping) {
+    // Version compat
+    if (record.Header().Size() >= sizeof(SymbolMappingMsgV2)) {
+      OnSymbolMapping(record.Get<SymbolMappingMsgV2>());
+    } else {
+      OnSymbolMapping(record.Get<SymbolMappingMsgV1>());
+    }
+  }
+}
+
+const FlatPitSymbolMap::Slot* FlatPitSymbolMap::FindSlot(
+    std::uint32_t instrument_id) const {
+  if (slots_.empty()) {
+    return nullptr;
+  }
+  const auto mask = slots_.size() - 1;
+  for (auto i = Hash(instrument_id);; i = (i + 1) & mask) {
+    const auto& slot = slots_[i];
+    if (slot.symbol_idx == kEmptySlot) {
+      return nullptr;
+    }
+    if (slot.instrument_id == instrument_id) {
+      return &slot;
+    }
+  }
+}
+
+FlatPitSymbolMap::Slot& FlatPitSymbolMap::ProbeSlot(std::uint32_t instrument_id) {
+  const auto mask = slots_.size() - 1;
+  for (auto i = Hash(instrument_id);; i = (i + 1) & mask) {
+    auto& slot = slots_[i];
+    if (slot.symbol_idx == kEmptySlot || slot.instrument_id == instrument_id) {
+      return slot;
+    }
+  }
+}
+
+std::uint32_t FlatPitSymbolMap::Intern(std::string_view symbol) {
+  const auto it = symbol_indices_.find(symbol);
+  if (it != symbol_indices_.end()) {
+    return it->second;
+  }
+  const auto idx = static_cast<std::uint32_t>(symbols_.size());
+  symbols_.emplace_back(symbol);
+  symbol_indices_.emplace(symbols_.back(), idx);
+  return idx;
+}
+
+void FlatPitSymbolMap::Grow() {
+  static constexpr std::size_t kInitialCapacity = 64;
+  std::vector<Slot> old_slots(slots_.empty() ? kInitialCapacity : slots_.size() * 2);
+  old_slots.swap(slots_);
+  hash_shift_ = 64;
+  for (auto capacity = slots_.size(); capacity > 1; capacity >>= 1) {
+    --hash_shift_;
+  }
+  for (const auto& slot : old_slots) {
+    if (slot.symbol_idx != kEmptySlot) {
+      ProbeSlot(slot.instrument_id) = slot;
+    }
+  }
+}
+
+// Explicit instantiation
+template void FlatPitSymbolMap::OnSymbolMapping(
+    const SymbolMappingMsgV1& symbol_mapping);
+template void FlatPitSymbolMap::OnSymbolMapping(
+    const SymbolMappingMsgV2& symbol_mapping);
+
+using databento::PitSymbolIndex;
+
+PitSymbolIndex::PitSymbolIndex(const Metadata& metadata, date::year_month_day date) {
+  ForEachPitMapping(metadata, date, "PitSymbolIndex::PitSymbolIndex",
+                    [this](std::uint32_t iid, const std::string& symbol) {
+                      // Match `PitSymbolMap`, where the first mapping wins
+                      if (FindSymbol(iid) == nullptr) {
+                        Insert(iid, symbol);
+                      }
+                    });
+}
+
+const std::string* PitSymbolIndex::FindSymbol(std::uint32_t instrument_id) const {
+  const auto it = instrument_symbols_.find(instrument_id);
+  if (it == instrument_symbols_.end()) {
+    return nullptr;
+  }
+  return &symbols_[it->second];
+}
+
+std::string_view PitSymbolIndex::SymbolAt(std::uint32_t instrument_id) const {
+  return symbols_[instrument_symbols_.at(instrument_id)];
+}
+
+std::optional<std::uint32_t> PitSymbolIndex::FindInstrumentId(
+    std::string_view symbol) const {
+  const auto it = symbol_indices_.find(symbol);
+  if (it == symbol_indices_.end()) {
+    return std::nullopt;
+  }
+  return symbol_instruments_[it->second];
+}
+
+std::uint32_t PitSymbolIndex::InstrumentIdAt(std::string_view symbol) const {
+  const auto instrument_id = FindInstrumentId(symbol);
+  if (!instrument_id) {
+    throw std::out_of_range{"PitSymbolIndex::InstrumentIdAt"};
+  }
+  return *instrument_id;
+}
+
+void PitSymbolIndex::Insert(std::uint32_t instrument_id, std::string_view symbol) {
+  const auto symbol_idx = Intern(symbol);
+  const auto [it, inserted] = instrument_symbols_.emplace(instrument_id, symbol_idx);
+  if (!inserted && it->second != symbol_idx) {
+    // Remove stale reverse mapping
+    auto& prev_instrument = symbol_instruments_[it->second];
+    if (prev_instrument == instrument_id) {
+      prev_instrument = std::nullopt;
+    }
+    it->second = symbol_idx;
+  }
+  auto& prev_instrument = symbol_instruments_[symbol_idx];
+  if (prev_instrument && *prev_instrument != instrument_id) {
+    // Remove stale forward mapping of the instrument previously with `symbol`
+    instrument_symbols_.erase(*prev_instrument);
+  }
+  prev_instrument = instrument_id;
+}
+
+template <typename SymbolMappingRec>
+void PitSymbolIndex::OnSymbolMapping(const SymbolMappingRec& symbol_mapping) {
+  Insert(symbol_mapping.hd.instrument_id, SymbolView(symbol_mapping.stype_out_symbol));
+}
+
+void PitSymbolIndex::OnRecord(const Record& record) {
+  if (record.RType() == RType::SymbolMapping) {
+    // Version compat
+    if (record.Header().Size() >= sizeof(SymbolMappingMsgV2)) {
+      OnSymbolMapping(record.Get<SymbolMappingMsgV2>());
+    } else {
+      OnSymbolMapping(record.Get<SymbolMappingMsgV1>());
+    }
+  }
+}
+
+std::uint32_t PitSymbolIndex::Intern(std::string_view symbol) {
+  const auto it = symbol_indices_.find(symbol);
+  if (it != symbol_indices_.end()) {
+    return it->second;
+  }
+  const auto idx = static_cast<std::uint32_t>(symbols_.size());
+  symbols_.emplace_back(symbol);
+  symbol_indices_.emplace(symbols_.back(), idx);
+  symbol_instruments_.emplace_back();
+  return idx;
+}
+
+// Explicit instantiation
+template void PitSymbolIndex::OnSymbolMapping(const SymbolMappingMsgV1& symbol_mapping);
+template void PitSymbolIndex::OnSymbolMapping(const SymbolMappingMsgV2& symbol_mapping);
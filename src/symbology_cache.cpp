@@ -0,0 +1,365 @@
+#include "databento/symbology_cache.hpp"
+
+#include <date/date.h>
+
+#include <algorithm>  // copy_n, find, max, min, sort
+#include <cstddef>
+#include <cstdint>
+#include <cstring>  // memcpy
+#include <iomanip>  // setfill, setw
+#include <limits>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>  // error_code
+#include <utility>       // move
+
+#include "databento/datetime.hpp"  // DateRange
+#include "databento/detail/symbols_hash.hpp"
+#include "databento/detail/temp_path.hpp"
+#include "databento/exceptions.hpp"  // Exception, InvalidArgumentError
+#include "databento/file_stream.hpp"
+#include "databento/historical.hpp"
+
+using databento::SymbologyCache;
+using databento::SymbologyCacheEntry;
+
+namespace {
+constexpr char kMagic[] = "DBSC";
+constexpr std::size_t kMagicSize = 4;
+constexpr std::uint8_t kFormatVersion = 2;
+constexpr auto kReadMethod = "SymbologyCache::Read";
+
+std::uint32_t EncodeDate(date::year_month_day date) {
+  return static_cast<std::uint32_t>(static_cast<int>(date.year())) * 10000 +
+         static_cast<unsigned>(date.month()) * 100 + static_cast<unsigned>(date.day());
+}
+
+date::year_month_day DecodeDate(std::uint32_t yyyymmdd) {
+  const date::year_month_day res{
+      date::year{static_cast<std::int32_t>(yyyymmdd / 10000)},
+      date::month{yyyymmdd / 100 % 100}, date::day{yyyymmdd % 100}};
+  if (!res.ok()) {
+    throw databento::InvalidArgumentError{
+        kReadMethod, "path",
+        "Invalid date " + std::to_string(yyyymmdd) + " in symbology cache file"};
+  }
+  return res;
+}
+
+std::string ToDateString(date::year_month_day date) {
+  std::ostringstream ss;
+  ss << date;
+  return ss.str();
+}
+
+class Encoder {
+ public:
+  template <typename T>
+  void Put(T val) {
+    const auto pos = buf_.size();
+    buf_.resize(pos + sizeof(T));
+    std::memcpy(&buf_[pos], &val, sizeof(T));
+  }
+  void PutStr(std::string_view str) {
+    if (str.size() > std::numeric_limits<std::uint16_t>::max()) {
+      throw databento::InvalidArgumentError{"SymbologyCache::Write", "entry",
+                                            "String too long: " + std::string{str}};
+    }
+    Put(static_cast<std::uint16_t>(str.size()));
+    buf_.append(str);
+  }
+  void PutStrs(const std::vector<std::string>& strs) {
+    Put(static_cast<std::uint32_t>(strs.size()));
+    for (const auto& str : strs) {
+      PutStr(str);
+    }
+  }
+  const std::string& Buffer() const { return buf_; }
+
+ private:
+  std::string buf_;
+};
+
+class Decoder {
+ public:
+  Decoder(const std::byte* buf, const std::byte* end) : buf_{buf}, end_{end} {}
+
+  template <typename T>
+  T Get() {
+    Check(sizeof(T));
+    T res;
+    std::memcpy(&res, buf_, sizeof(T));
+    buf_ += sizeof(T);
+    return res;
+  }
+  std::string GetStr() {
+    const auto len = Get<std::uint16_t>();
+    Check(len);
+    std::string res{reinterpret_cast<const char*>(buf_), len};
+    buf_ += len;
+    return res;
+  }
+  std::vector<std::string> GetStrs() {
+    const auto count = Get<std::uint32_t>();
+    CheckCount(count, sizeof(std::uint16_t));
+    std::vector<std::string> res;
+    res.reserve(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+      res.emplace_back(GetStr());
+    }
+    return res;
+  }
+  // Checks there's room for `count` elements of at least `min_size` bytes so a
+  // corrupt count fails before reserving memory for it.
+  void CheckCount(std::size_t count, std::size_t min_size) const {
+    if (count > static_cast<std::size_t>(end_ - buf_) / min_size) {
+      throw databento::InvalidArgumentError{
+          kReadMethod, "path",
+          "Count " + std::to_string(count) +
+              " exceeds the size of the symbology cache file"};
+    }
+  }
+  bool IsDone() const { return buf_ == end_; }
+
+ private:
+  void Check(std::size_t size) const {
+    if (static_cast<std::size_t>(end_ - buf_) < size) {
+      throw databento::InvalidArgumentError{kReadMethod, "path",
+                                            "Unexpected end of symbology cache file"};
+    }
+  }
+
+  const std::byte* buf_;
+  const std::byte* end_;
+};
+
+void AppendUnique(std::vector<std::string>* dest, const std::vector<std::string>& src) {
+  for (const auto& symbol : src) {
+    if (std::find(dest->begin(), dest->end(), symbol) == dest->end()) {
+      dest->emplace_back(symbol);
+    }
+  }
+}
+
+// Merges `src` into `dest`, joining adjacent intervals with the same symbol.
+void Merge(databento::SymbologyResolution* dest, databento::SymbologyResolution&& src) {
+  for (auto& [key, intervals] : src.mappings) {
+    auto& dest_intervals = dest->mappings[key];
+    dest_intervals.insert(dest_intervals.end(), intervals.begin(), intervals.end());
+    std::sort(dest_intervals.begin(), dest_intervals.end(),
+              [](const databento::MappingInterval& lhs,
+                 const databento::MappingInterval& rhs) {
+                return lhs.start_date < rhs.start_date;
+              });
+    std::vector<databento::MappingInterval> joined;
+    joined.reserve(dest_intervals.size());
+    for (auto& interval : dest_intervals) {
+      if (!joined.empty() && joined.back().end_date == interval.start_date &&
+          joined.back().symbol == interval.symbol) {
+        joined.back().end_date = interval.end_date;
+      } else {
+        joined.emplace_back(std::move(interval));
+      }
+    }
+    dest_intervals = std::move(joined);
+  }
+  AppendUnique(&dest->partial, src.partial);
+  AppendUnique(&dest->not_found, src.not_found);
+  // A symbol not found in one date range but resolved in another is partial
+  std::vector<std::string> not_found;
+  for (auto& symbol : dest->not_found) {
+    if (dest->mappings.count(symbol) > 0) {
+      AppendUnique(&dest->partial, {symbol});
+    } else {
+      not_found.emplace_back(std::move(symbol));
+    }
+  }
+  dest->not_found = std::move(not_found);
+}
+
+// Returns the subset of `entry` within the requested date range.
+databento::SymbologyResolution Clip(const SymbologyCacheEntry& entry,
+                                    date::year_month_day start_date,
+                                    date::year_month_day end_date) {
+  const auto& cached = entry.resolution;
+  databento::SymbologyResolution res{
+      {}, cached.partial, cached.not_found, cached.stype_in, cached.stype_out};
+  for (const auto& [key, intervals] : cached.mappings) {
+    std::vector<databento::MappingInterval> clipped;
+    for (const auto& interval : intervals) {
+      if (interval.end_date <= start_date || interval.start_date >= end_date) {
+        continue;
+      }
+      clipped.emplace_back(databento::MappingInterval{
+          std::max(interval.start_date, start_date),
+          std::min(interval.end_date, end_date), interval.symbol});
+    }
+    if (!clipped.empty()) {
+      res.mappings.emplace(key, std::move(clipped));
+    }
+  }
+  return res;
+}
+}  // namespace
+
+SymbologyCache::SymbologyCache(std::filesystem::path cache_dir)
+    : cache_dir_{std::move(cache_dir)} {
+  std::filesystem::create_directories(cache_dir_);
+}
+
+databento::SymbologyResolution SymbologyCache::Resolve(
+    Historical* client, const std::string& dataset,
+    const std::vector<std::string>& symbols, SType stype_in, SType stype_out,
+    date::year_month_day start_date, date::year_month_day end_date) {
+  if (start_date >= end_date) {
+    throw InvalidArgumentError{"SymbologyCache::Resolve", "end_date",
+                               "must be after start_date"};
+  }
+  const auto fetch = [&](date::year_month_day start, date::year_month_day end) {
+    return client->SymbologyResolve(dataset, symbols, stype_in, stype_out,
+                                    DateRange{ToDateString(start), ToDateString(end)});
+  };
+  const auto path = CachePath(dataset, symbols, stype_in, stype_out);
+  auto sorted_symbols = symbols;
+  std::sort(sorted_symbols.begin(), sorted_symbols.end());
+  std::optional<SymbologyCacheEntry> entry;
+  try {
+    entry = Read(path);
+  } catch (const Exception&) {
+    // Treat a corrupt or truncated file as a miss so it's replaced
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+  }
+  if (entry && (entry->dataset != dataset || entry->symbols != sorted_symbols ||
+                entry->resolution.stype_in != stype_in ||
+                entry->resolution.stype_out != stype_out)) {
+    // Hash collision in the file name
+    entry.reset();
+  }
+  if (!entry) {
+    entry = SymbologyCacheEntry{dataset, std::move(sorted_symbols), start_date,
+                                end_date, fetch(start_date, end_date)};
+    Write(path, *entry);
+  } else if (start_date < entry->start_date || end_date > entry->end_date) {
+    // Extend the cached range, keeping it contiguous
+    if (start_date < entry->start_date) {
+      Merge(&entry->resolution, fetch(start_date, entry->start_date));
+      entry->start_date = start_date;
+    }
+    if (end_date > entry->end_date) {
+      Merge(&entry->resolution, fetch(entry->end_date, end_date));
+      entry->end_date = end_date;
+    }
+    Write(path, *entry);
+  }
+  return Clip(*entry, start_date, end_date);
+}
+
+std::filesystem::path SymbologyCache::CachePath(const std::string& dataset,
+                                                const std::vector<std::string>& symbols,
+                                                SType stype_in, SType stype_out) const {
+  // Order of symbols doesn't affect the resolution
+  const auto hash = detail::HashSymbols(symbols);
+  std::ostringstream file_name;
+  file_name << dataset << '_' << stype_in << '_' << stype_out << '_' << std::hex
+            << std::setfill('0') << std::setw(16) << hash << ".dbsc";
+  return cache_dir_ / file_name.str();
+}
+
+void SymbologyCache::Write(const std::filesystem::path& path,
+                           const SymbologyCacheEntry& entry) {
+  Encoder encoder;
+  for (std::size_t i = 0; i < kMagicSize; ++i) {
+    encoder.Put(kMagic[i]);
+  }
+  encoder.Put(kFormatVersion);
+  encoder.Put(static_cast<std::uint8_t>(entry.resolution.stype_in));
+  encoder.Put(static_cast<std::uint8_t>(entry.resolution.stype_out));
+  encoder.Put(std::uint8_t{});  // reserved
+  encoder.Put(EncodeDate(entry.start_date));
+  encoder.Put(EncodeDate(entry.end_date));
+  encoder.PutStr(entry.dataset);
+  encoder.PutStrs(entry.symbols);
+  encoder.Put(static_cast<std::uint32_t>(entry.resolution.mappings.size()));
+  for (const auto& [key, intervals] : entry.resolution.mappings) {
+    encoder.PutStr(key);
+    encoder.Put(static_cast<std::uint32_t>(intervals.size()));
+    for (const auto& interval : intervals) {
+      encoder.Put(EncodeDate(interval.start_date));
+      encoder.Put(EncodeDate(interval.end_date));
+      encoder.PutStr(interval.symbol);
+    }
+  }
+  encoder.PutStrs(entry.resolution.partial);
+  encoder.PutStrs(entry.resolution.not_found);
+
+  // Write to a temporary file and rename so readers never see a partial file
+  const auto tmp_path = detail::TempPath(path);
+  {
+    OutFileStream out{tmp_path};
+    const auto& buf = encoder.Buffer();
+    out.WriteAll(reinterpret_cast<const std::byte*>(buf.data()), buf.size());
+  }
+  std::filesystem::rename(tmp_path, path);
+}
+
+std::optional<SymbologyCacheEntry> SymbologyCache::Read(
+    const std::filesystem::path& path) {
+  std::error_code ec;
+  const auto size = std::filesystem::file_size(path, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  // Read the whole file at once, then decode from memory
+  std::vector<std::byte> buf(static_cast<std::size_t>(size));
+  InFileStream{path}.ReadExact(buf.data(), buf.size());
+
+  Decoder decoder{buf.data(), buf.data() + buf.size()};
+  char magic[kMagicSize];
+  for (auto& c : magic) {
+    c = decoder.Get<char>();
+  }
+  if (std::string_view{magic, kMagicSize} != std::string_view{kMagic, kMagicSize}) {
+    throw InvalidArgumentError{kReadMethod, "path",
+                               "Not a symbology cache file: " + path.string()};
+  }
+  if (decoder.Get<std::uint8_t>() != kFormatVersion) {
+    throw InvalidArgumentError{kReadMethod, "path",
+                               "Unsupported symbology cache version"};
+  }
+  SymbologyCacheEntry res;
+  res.resolution.stype_in = static_cast<SType>(decoder.Get<std::uint8_t>());
+  res.resolution.stype_out = static_cast<SType>(decoder.Get<std::uint8_t>());
+  decoder.Get<std::uint8_t>();  // reserved
+  res.start_date = DecodeDate(decoder.Get<std::uint32_t>());
+  res.end_date = DecodeDate(decoder.Get<std::uint32_t>());
+  res.dataset = decoder.GetStr();
+  res.symbols = decoder.GetStrs();
+  const auto mapping_count = decoder.Get<std::uint32_t>();
+  // Key length and interval count
+  decoder.CheckCount(mapping_count, sizeof(std::uint16_t) + sizeof(std::uint32_t));
+  res.resolution.mappings.reserve(mapping_count);
+  for (std::uint32_t i = 0; i < mapping_count; ++i) {
+    auto key = decoder.GetStr();
+    const auto interval_count = decoder.Get<std::uint32_t>();
+    // Dates and symbol length
+    decoder.CheckCount(interval_count,
+                       sizeof(std::uint32_t) * 2 + sizeof(std::uint16_t));
+    std::vector<MappingInterval> intervals;
+    intervals.reserve(interval_count);
+    for (std::uint32_t j = 0; j < interval_count; ++j) {
+      const auto start_date = DecodeDate(decoder.Get<std::uint32_t>());
+      const auto end_date = DecodeDate(decoder.Get<std::uint32_t>());
+      intervals.emplace_back(MappingInterval{start_date, end_date, decoder.GetStr()});
+    }
+    res.resolution.mappings.emplace(std::move(key), std::move(intervals));
+  }
+  res.resolution.partial = decoder.GetStrs();
+  res.resolution.not_found = decoder.GetStrs();
+  if (!decoder.IsDone()) {
+    throw InvalidArgumentError{kReadMethod, "path",
+                               "Unexpected trailing bytes in symbology cache file"};
+  }
+  return res;
+}
@@ -0,0 +1,328 @@
+#include "databento/timeseries_cache.hpp"
+
+#include <algorithm>  // max, min, sort
+#include <charconv>   // from_chars
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <iomanip>  // setfill, setw
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>  // errc, error_code
+#include <utility>       // move, pair
+
+#include "databento/dbn.hpp"  // Metadata
+#include "databento/dbn_encoder.hpp"
+#include "databento/dbn_file_store.hpp"
+#include "databento/detail/merge_metadata.hpp"
+#include "databento/detail/symbols_hash.hpp"
+#include "databento/detail/temp_path.hpp"
+#include "databento/detail/zstd_stream.hpp"
+#include "databento/exceptions.hpp"  // Exception, InvalidArgumentError
+#include "databento/file_stream.hpp"
+#include "databento/historical.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+
+using databento::TimeseriesCache;
+using databento::TimeseriesCacheSegment;
+
+namespace {
+constexpr std::string_view kSegmentExtension = ".dbn.zst";
+constexpr auto kSymbolsFileName = "symbols.txt";
+constexpr auto kGetRangeMethod = "TimeseriesCache::GetRange";
+
+std::vector<std::string> SortSymbols(std::vector<std::string> symbols) {
+  std::sort(symbols.begin(), symbols.end());
+  return symbols;
+}
+
+// Returns `std::nullopt` if `dir` doesn't have a symbols file.
+std::optional<std::vector<std::string>> ReadSymbolsFile(
+    const std::filesystem::path& dir) {
+  std::ifstream file{dir / kSymbolsFileName};
+  if (!file) {
+    return std::nullopt;
+  }
+  std::vector<std::string> symbols;
+  std::string symbol;
+  while (std::getline(file, symbol)) {
+    symbols.emplace_back(std::move(symbol));
+  }
+  return symbols;
+}
+
+// Records the symbols `dir` is for, one per line.
+void WriteSymbolsFile(const std::filesystem::path& dir,
+                      const std::vector<std::string>& sorted_symbols) {
+  const auto path = dir / kSymbolsFileName;
+  const auto tmp_path = databento::detail::TempPath(path);
+  {
+    std::ofstream file{tmp_path};
+    for (const auto& symbol : sorted_symbols) {
+      file << symbol << '\n';
+    }
+    if (!file.flush()) {
+      throw databento::Exception{"Unable to write " + tmp_path.string()};
+    }
+  }
+  std::filesystem::rename(tmp_path, path);
+  // Another process may have claimed the directory for other symbols
+  if (ReadSymbolsFile(dir) != sorted_symbols) {
+    throw databento::Exception{"Cache directory " + dir.string() +
+                               " was concurrently claimed for other symbols"};
+  }
+}
+
+// Returns the policy that upgrades DBN data to `version`.
+databento::VersionUpgradePolicy UpgradePolicyTo(std::uint8_t version) {
+  switch (version) {
+    case 1: {
+      return databento::VersionUpgradePolicy::AsIs;
+    }
+    case 2: {
+      return databento::VersionUpgradePolicy::UpgradeToV2;
+    }
+    default: {
+      return databento::VersionUpgradePolicy::UpgradeToV3;
+    }
+  }
+}
+
+// Encodes the records of `store`, which have had its upgrade policy applied, to
+// a zstd-compressed file at `path`.
+void Reencode(databento::DbnFileStore* store, const std::filesystem::path& path) {
+  databento::OutFileStream out_file{path};
+  {
+    databento::detail::ZstdCompressStream stream{&out_file};
+    databento::DbnEncoder encoder{store->GetMetadata(), &stream};
+    while (const auto* record = store->NextRecord()) {
+      encoder.EncodeRecord(*record);
+    }
+  }
+  out_file.Flush();
+}
+
+std::string SegmentFileName(databento::UnixNanos start, databento::UnixNanos end) {
+  std::ostringstream file_name;
+  file_name << start.time_since_epoch().count() << '_'
+            << end.time_since_epoch().count() << kSegmentExtension;
+  return file_name.str();
+}
+
+// Returns `std::nullopt` if `file_name` isn't the name of a segment file.
+std::optional<std::pair<databento::UnixNanos, databento::UnixNanos>>
+ParseSegmentFileName(std::string_view file_name) {
+  if (file_name.size() <= kSegmentExtension.size() ||
+      file_name.substr(file_name.size() - kSegmentExtension.size()) !=
+          kSegmentExtension) {
+    return std::nullopt;
+  }
+  file_name.remove_suffix(kSegmentExtension.size());
+  const auto* const end = file_name.data() + file_name.size();
+  std::uint64_t start_ns{};
+  const auto [sep, start_ec] = std::from_chars(file_name.data(), end, start_ns);
+  if (start_ec != std::errc{} || sep == end || *sep != '_') {
+    return std::nullopt;
+  }
+  std::uint64_t end_ns{};
+  const auto [last, end_ec] = std::from_chars(sep + 1, end, end_ns);
+  if (end_ec != std::errc{} || last != end || end_ns <= start_ns) {
+    return std::nullopt;
+  }
+  return std::pair{databento::UnixNanos{std::chrono::nanoseconds{start_ns}},
+                   databento::UnixNanos{std::chrono::nanoseconds{end_ns}}};
+}
+}  // namespace
+
+TimeseriesCache::TimeseriesCache(std::filesystem::path cache_dir)
+    : cache_dir_{std::move(cache_dir)} {
+  std::filesystem::create_directories(cache_dir_);
+}
+
+void TimeseriesCache::GetRange(Historical* client, const std::string& dataset,
+                               const DateTimeRange<UnixNanos>& datetime_range,
+                               const std::vector<std::string>& symbols, Schema schema,
+                               SType stype_in, SType stype_out,
+                               const MetadataCallback& metadata_callback,
+                               const RecordCallback& record_callback) {
+  if (datetime_range.end <= datetime_range.start) {
+    throw InvalidArgumentError{kGetRangeMethod, "datetime_range",
+                               "end must be set and after start"};
+  }
+  const auto dir = CacheDir(dataset, symbols, schema, stype_in, stype_out);
+  std::filesystem::create_directories(dir);
+  if (!ReadSymbolsFile(dir)) {
+    WriteSymbolsFile(dir, SortSymbols(symbols));
+  }
+  const auto fetch = [&](UnixNanos start, UnixNanos end) {
+    if (client == nullptr) {
+      throw InvalidArgumentError{kGetRangeMethod, "client",
+                                 "must be set to request uncached data"};
+    }
+    const auto path = dir / SegmentFileName(start, end);
+    // Write to a temporary file and rename so a failed request is never
+    // considered cached
+    const auto tmp_path = detail::TempPath(path);
+    const auto upgraded_path = detail::TempPath(path);
+    bool is_upgraded{};
+    try {
+      auto store = client->TimeseriesGetRangeToFile(
+          dataset, {start, end}, symbols, schema, stype_in, stype_out, {}, tmp_path);
+      // Cache the data as the client returns it, with its upgrade policy applied
+      const auto& index = store.Index();
+      if (index && index->metadata.version != store.GetMetadata().version) {
+        Reencode(&store, upgraded_path);
+        is_upgraded = true;
+      }
+    } catch (...) {
+      std::error_code ec;
+      std::filesystem::remove(tmp_path, ec);
+      std::filesystem::remove(upgraded_path, ec);
+      throw;
+    }
+    if (is_upgraded) {
+      std::filesystem::rename(upgraded_path, path);
+      std::error_code ec;
+      std::filesystem::remove(tmp_path, ec);
+    } else {
+      std::filesystem::rename(tmp_path, path);
+    }
+  };
+
+  // Request the ranges not covered by existing segments
+  auto cursor = datetime_range.start;
+  for (const auto& segment : ListSegments(dir)) {
+    if (segment.start >= datetime_range.end) {
+      break;
+    }
+    if (segment.end <= cursor) {
+      continue;
+    }
+    if (segment.start > cursor) {
+      fetch(cursor, segment.start);
+    }
+    cursor = std::max(cursor, segment.end);
+  }
+  if (cursor < datetime_range.end) {
+    fetch(cursor, datetime_range.end);
+  }
+
+  // Open the segments covering the range. Segments written concurrently by
+  // another process may overlap, so each record is only replayed from the
+  // first segment containing its timestamp.
+  struct ReplayRange {
+    UnixNanos start;
+    UnixNanos end;
+  };
+  std::vector<ReplayRange> replays;
+  std::vector<std::filesystem::path> paths;
+  cursor = datetime_range.start;
+  for (const auto& segment : ListSegments(dir)) {
+    if (segment.start >= datetime_range.end) {
+      break;
+    }
+    if (segment.end <= cursor) {
+      continue;
+    }
+    replays.emplace_back(
+        ReplayRange{cursor, std::min(segment.end, datetime_range.end)});
+    paths.emplace_back(segment.path);
+    cursor = segment.end;
+  }
+  // Segments fetched by clients with different upgrade policies or from
+  // different API versions may differ in DBN version, so upgrade all of them to
+  // the newest rather than replaying a mix
+  std::uint8_t version{1};
+  for (const auto& path : paths) {
+    version = std::max(
+        version,
+        DbnFileStore{ILogReceiver::Default(), path, VersionUpgradePolicy::AsIs}
+            .GetMetadata()
+            .version);
+  }
+  // `DbnFileStore` isn't movable
+  std::deque<DbnFileStore> stores;
+  for (const auto& path : paths) {
+    stores.emplace_back(ILogReceiver::Default(), path, UpgradePolicyTo(version));
+  }
+
+  std::optional<Metadata> metadata;
+  for (auto& store : stores) {
+    if (metadata) {
+      detail::MergeMetadata(&*metadata, Metadata{store.GetMetadata()});
+    } else {
+      metadata = store.GetMetadata();
+    }
+  }
+  if (!metadata) {
+    return;
+  }
+  metadata->start = datetime_range.start;
+  metadata->end = datetime_range.end;
+  if (metadata_callback) {
+    metadata_callback(std::move(*metadata));
+  }
+  for (std::size_t i = 0; i < stores.size(); ++i) {
+    const Record* record;
+    while ((record = stores[i].NextRecord()) != nullptr) {
+      const auto index_ts = record->IndexTs();
+      if (index_ts >= replays[i].end) {
+        break;
+      }
+      if (index_ts < replays[i].start) {
+        continue;
+      }
+      if (record_callback(*record) == KeepGoing::Stop) {
+        return;
+      }
+    }
+  }
+}
+
+std::filesystem::path TimeseriesCache::CacheDir(const std::string& dataset,
+                                                const std::vector<std::string>& symbols,
+                                                Schema schema, SType stype_in,
+                                                SType stype_out) const {
+  // Order of symbols doesn't affect the response
+  const auto hash = detail::HashSymbols(symbols);
+  std::ostringstream dir_name;
+  dir_name << dataset << '_' << schema << '_' << stype_in << '_' << stype_out << '_'
+           << std::hex << std::setfill('0') << std::setw(16) << hash;
+  // Different symbols can have the same hash, so each directory records its
+  // symbols and colliding requests get the next free suffix
+  const auto sorted_symbols = SortSymbols(symbols);
+  auto dir = cache_dir_ / dir_name.str();
+  for (int suffix = 1;; ++suffix) {
+    const auto dir_symbols = ReadSymbolsFile(dir);
+    if (!dir_symbols || *dir_symbols == sorted_symbols) {
+      return dir;
+    }
+    dir = cache_dir_ / (dir_name.str() + '_' + std::to_string(suffix));
+  }
+}
+
+std::vector<TimeseriesCacheSegment> TimeseriesCache::ListSegments(
+    const std::filesystem::path& dir) {
+  std::vector<TimeseriesCacheSegment> res;
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator{dir, ec}) {
+    if (!entry.is_regular_file()) {
+      continue;
+    }
+    // Skips temporary files from in-progress or failed requests
+    const auto range = ParseSegmentFileName(entry.path().filename().string());
+    if (range) {
+      res.emplace_back(
+          TimeseriesCacheSegment{range->first, range->second, entry.path()});
+    }
+  }
+  std::sort(res.begin(), res.end(),
+            [](const TimeseriesCacheSegment& lhs, const TimeseriesCacheSegment& rhs) {
+              return lhs.start < rhs.start;
+            });
+  return res;
+}
@@ -9,7 +9,7 @@
 #include "databento/record.hpp"
 #include "databento/v2.hpp"
 #include "databento/v3.hpp"
-#include "stream_op_helper.hpp"  // MakeString, StreamOpBuilder
+#include "format_helper.hpp"  // FormatBuilder
 
 namespace databento::v1 {
 v2::InstrumentDefMsg InstrumentDefMsg::ToV2() const {
@@ -249,9 +249,8 @@ v2::ErrorMsg ErrorMsg::Upgrade() const {
   return ToV2();
 }
 
-std::string ToString(const ErrorMsg& error_msg) { return MakeString(error_msg); }
-std::ostream& operator<<(std::ostream& stream, const ErrorMsg& error_msg) {
-  return StreamOpBuilder{stream}
+void FormatTo(FormatBuffer& buffer, const ErrorMsg& error_msg) {
+  FormatBuilder{buffer}
       .SetSpacer("\n    ")
       .SetTypeName("ErrorMsg")
       .Build()
@@ -259,6 +258,10 @@ std::ostream& operator<<(std::ostream& stream, const ErrorMsg& error_msg) {
       .AddField("err", error_msg.err)
       .Finish();
 }
+std::string ToString(const ErrorMsg& error_msg) { return FormatToString(error_msg); }
+std::ostream& operator<<(std::ostream& stream, const ErrorMsg& error_msg) {
+  return FormatToStream(stream, error_msg);
+}
 
 bool operator==(const InstrumentDefMsg& lhs, const InstrumentDefMsg& rhs) {
   return lhs.hd == rhs.hd && lhs.ts_recv == rhs.ts_recv &&
@@ -326,12 +329,8 @@ v3::InstrumentDefMsg InstrumentDefMsg::Upgrade() const {
   return ToV3();
 }
 
-std::string ToString(const InstrumentDefMsg& instrument_def_msg) {
-  return MakeString(instrument_def_msg);
-}
-std::ostream& operator<<(std::ostream& stream,
-                         const InstrumentDefMsg& instrument_def_msg) {
-  return StreamOpBuilder{stream}
+void FormatTo(FormatBuffer& buffer, const InstrumentDefMsg& instrument_def_msg) {
+  FormatBuilder{buffer}
       .SetSpacer("\n    ")
       .SetTypeName("InstrumentDefMsg")
       .Build()
@@ -404,15 +403,21 @@ std::ostream& operator<<(std::ostream& stream,
       .AddField("tick_rule", instrument_def_msg.tick_rule)
       .Finish();
 }
+std::string ToString(const InstrumentDefMsg& instrument_def_msg) {
+  return FormatToString(instrument_def_msg);
+}
+std::ostream& operator<<(std::ostream& stream,
+                         const InstrumentDefMsg& instrument_def_msg) {
+  return FormatToStream(stream, instrument_def_msg);
+}
 
 template <>
 v3::StatMsg StatMsg::Upgrade() const {
   return ToV3();
 }
 
-std::string ToString(const StatMsg& stat_msg) { return MakeString(stat_msg); }
-std::ostream& operator<<(std::ostream& stream, const StatMsg& stat_msg) {
-  return StreamOpBuilder{stream}
+void FormatTo(FormatBuffer& buffer, const StatMsg& stat_msg) {
+  FormatBuilder{buffer}
       .SetSpacer("\n    ")
       .SetTypeName("StatMsg")
       .Build()
@@ -429,18 +434,18 @@ std::ostream& operator<<(std::ostream& stream, const StatMsg& stat_msg) {
       .AddField("stat_flags", stat_msg.stat_flags)
       .Finish();
 }
+std::string ToString(const StatMsg& stat_msg) { return FormatToString(stat_msg); }
+std::ostream& operator<<(std::ostream& stream, const StatMsg& stat_msg) {
+  return FormatToStream(stream, stat_msg);
+}
 
 template <>
 v2::SymbolMappingMsg SymbolMappingMsg::Upgrade() const {
   return ToV2();
 }
 
-std::string ToString(const SymbolMappingMsg& symbol_mapping_msg) {
-  return MakeString(symbol_mapping_msg);
-}
-std::ostream& operator<<(std::ostream& stream,
-                         const SymbolMappingMsg& symbol_mapping_msg) {
-  return StreamOpBuilder{stream}
+void FormatTo(FormatBuffer& buffer, const SymbolMappingMsg& symbol_mapping_msg) {
+  FormatBuilder{buffer}
       .SetSpacer("\n    ")
       .SetTypeName("SymbolMappingMsg")
       .Build()
@@ -451,15 +456,21 @@ std::ostream& operator<<(std::ostream& stream,
       .AddField("end_ts", symbol_mapping_msg.end_ts)
       .Finish();
 }
+std::string ToString(const SymbolMappingMsg& symbol_mapping_msg) {
+  return FormatToString(symbol_mapping_msg);
+}
+std::ostream& operator<<(std::ostream& stream,
+                         const SymbolMappingMsg& symbol_mapping_msg) {
+  return FormatToStream(stream, symbol_mapping_msg);
+}
 
 template <>
 v2::SystemMsg SystemMsg::Upgrade() const {
   return ToV2();
 }
 
-std::string ToString(const SystemMsg& system_msg) { return MakeString(system_msg); }
-std::ostream& operator<<(std::ostream& stream, const SystemMsg& system_msg) {
-  return StreamOpBuilder{stream}
+void FormatTo(FormatBuffer& buffer, const SystemMsg& system_msg) {
+  FormatBuilder{buffer}
       .SetSpacer("\n    ")
       .SetTypeName("SystemMsg")
       .Build()
@@ -467,5 +478,9 @@ std::ostream& operator<<(std::ostream& stream, const SystemMsg& system_msg) {
       .AddField("msg", system_msg.msg)
       .Finish();
 }
+std::string ToString(const SystemMsg& system_msg) { return FormatToString(system_msg); }
+std::ostream& operator<<(std::ostream& stream, const SystemMsg& system_msg) {
+  return FormatToStream(stream, system_msg);
+}
 
 }  // namespace databento::v1
@@ -2,7 +2,7 @@
 
 #include "databento/pretty.hpp"  // Px
 #include "databento/v3.hpp"
-#include "stream_op_helper.hpp"
+#include "format_helper.hpp"
 
 namespace databento::v2 {
 databento::v3::InstrumentDefMsg InstrumentDefMsg::ToV3() const {
@@ -154,12 +154,8 @@ databento::InstrumentDefMsg InstrumentDefMsg::Upgrade() const {
   return ToV3();
 }
 
-std::string ToString(const InstrumentDefMsg& instrument_def_msg) {
-  return MakeString(instrument_def_msg);
-}
-std::ostream& operator<<(std::ostream& stream,
-                         const InstrumentDefMsg& instrument_def_msg) {
-  return StreamOpBuilder{stream}
+void FormatTo(FormatBuffer& buffer, const InstrumentDefMsg& instrument_def_msg) {
+  FormatBuilder{buffer}
       .SetSpacer("\n    ")
       .SetTypeName("InstrumentDefMsg")
       .Build()
@@ -232,5 +228,12 @@ std::ostream& operator<<(std::ostream& stream,
       .AddField("tick_rule", instrument_def_msg.tick_rule)
       .Finish();
 }
+std::string ToString(const InstrumentDefMsg& instrument_def_msg) {
+  return FormatToString(instrument_def_msg);
+}
+std::ostream& operator<<(std::ostream& stream,
+                         const InstrumentDefMsg& instrument_def_msg) {
+  return FormatToStream(stream, instrument_def_msg);
+}
 
 }  // namespace databento::v2
@@ -19,6 +19,7 @@ using ssize_t = SSIZE_T;
 #include <string>
 #include <vector>
 
+#include "databento/dbn.hpp"                   // Metadata
 #include "databento/detail/scoped_fd.hpp"      // ScopedFd
 #include "databento/detail/scoped_thread.hpp"  // ScopedThread
 #include "databento/enums.hpp"                 // Schema, SType
@@ -57,6 +58,8 @@ class MockLsgServer {
   void SubscribeWithSnapshot(const std::vector<std::string>& symbols, Schema schema,
                              SType stype, bool is_last);
   void Start();
+  // Like `Start`, but sends `metadata` instead of the default metadata.
+  void Start(const Metadata& metadata);
   std::size_t Send(const std::string& msg);
   ::ssize_t UncheckedSend(const std::string& msg);
   template <typename Rec>
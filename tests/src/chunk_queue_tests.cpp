@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <numeric>  // iota
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "databento/detail/chunk_queue.hpp"
+#include "databento/detail/scoped_thread.hpp"
+
+namespace databento::detail::tests {
+TEST(ChunkQueueTests, TestCoalescesWrites) {
+  ChunkQueue target{2, 8};
+  ASSERT_TRUE(target.Write("abc", 3));
+  ASSERT_TRUE(target.Write("defgh", 5));
+  ASSERT_TRUE(target.Write("ij", 2));
+  target.Finish({});
+
+  std::vector<std::byte> chunk;
+  ASSERT_TRUE(target.Read(&chunk));
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(chunk.data()), chunk.size()),
+            "abcdefgh");
+  ASSERT_TRUE(target.Read(&chunk));
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(chunk.data()), chunk.size()),
+            "ij");
+  EXPECT_FALSE(target.Read(&chunk));
+  const auto stats = target.GetStats();
+  EXPECT_EQ(stats.bytes_written, 10);
+  EXPECT_EQ(stats.chunks_read, 2);
+  EXPECT_EQ(stats.max_depth, 2);
+  EXPECT_EQ(stats.producer_waits, 0);
+}
+
+TEST(ChunkQueueTests, TestBackpressure) {
+  constexpr std::size_t kSize = 100'000;
+  std::vector<char> input(kSize);
+  std::iota(input.begin(), input.end(), char{});
+  ChunkQueue target{2, 64};
+  const ScopedThread producer{[&target, &input] {
+    for (std::size_t i = 0; i < input.size(); i += 100) {
+      ASSERT_TRUE(target.Write(&input[i], 100));
+    }
+    target.Finish({});
+  }};
+  std::vector<char> output;
+  std::vector<std::byte> chunk;
+  while (target.Read(&chunk)) {
+    EXPECT_LE(chunk.size(), 64);
+    const auto* data = reinterpret_cast<const char*>(chunk.data());
+    output.insert(output.end(), data, data + chunk.size());
+  }
+  EXPECT_EQ(output, input);
+  EXPECT_LE(target.GetStats().max_depth, 2);
+}
+
+TEST(ChunkQueueTests, TestCancel) {
+  ChunkQueue target{1, 4};
+  bool write_res = true;
+  {
+    const ScopedThread producer{[&target, &write_res] {
+      // Fills the only buffer, then blocks waiting for another
+      write_res = target.Write("abcdefgh", 8);
+    }};
+    std::vector<std::byte> chunk;
+    ASSERT_TRUE(target.Read(&chunk));
+    EXPECT_EQ(chunk.size(), 4);
+    target.Cancel();
+  }  // joins
+  EXPECT_FALSE(write_res);
+  EXPECT_FALSE(target.Write("a", 1));
+}
+
+TEST(ChunkQueueTests, TestFinishWithException) {
+  ChunkQueue target{1, 4};
+  target.Finish(std::make_exception_ptr(std::runtime_error{"Test failure"}));
+  std::vector<std::byte> chunk;
+  EXPECT_THROW(target.Read(&chunk), std::runtime_error);
+}
+}  // namespace databento::detail::tests
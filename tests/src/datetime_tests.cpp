@@ -1,6 +1,15 @@
 #include <gtest/gtest.h>
 
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "databento/constants.hpp"
 #include "databento/datetime.hpp"
+#include "databento/exceptions.hpp"
 
 namespace databento::tests {
 TEST(DateFromIso8601IntTests, TestValid) {
@@ -10,4 +19,78 @@ TEST(DateFromIso8601IntTests, TestValid) {
 TEST(DateFromIso8601IntTests, TestPadding) {
   ASSERT_EQ(databento::DateFromIso8601Int(20190801), "2019-08-01");
 }
+
+TEST(FormatIso8601Tests, TestFormat) {
+  // Alternates days to exercise the cached date prefix
+  const std::vector<std::pair<std::uint64_t, std::string>> cases{
+      {0, "1970-01-01T00:00:00.000000000Z"},
+      {951'782'400'123'456'789, "2000-02-29T00:00:00.123456789Z"},
+      {951'868'799'999'999'999, "2000-02-29T23:59:59.999999999Z"},
+      {951'868'800'000'000'000, "2000-03-01T00:00:00.000000000Z"},
+      {86'399'999'999'999, "1970-01-01T23:59:59.999999999Z"},
+      {4'107'542'400'000'000'000, "2100-03-01T00:00:00.000000000Z"},
+      {kUndefTimestamp - 1, "2554-07-21T23:34:33.709551614Z"},
+      {kUndefTimestamp, "UNDEF_TIMESTAMP"}};
+  std::array<char, kMaxIso8601Len> buf;
+  for (const auto& [count, exp] : cases) {
+    const UnixNanos ts{std::chrono::nanoseconds{count}};
+    const auto len = FormatIso8601(ts, buf.data());
+    EXPECT_EQ(std::string(buf.data(), len), exp);
+    EXPECT_EQ(ToIso8601(ts), exp);
+  }
+}
+TEST(ParseIso8601Tests, TestValid) {
+  const std::vector<std::pair<std::string, std::uint64_t>> cases{
+      {"1970-01-01", 0},
+      {"2000-02-29", 951'782'400'000'000'000},
+      {"2000-02-29T00:00", 951'782'400'000'000'000},
+      {"2000-02-29 00:00:01", 951'782'401'000'000'000},
+      {"2000-02-29T00:00:00.5Z", 951'782'400'500'000'000},
+      {"2000-02-29T00:00:00.123456789", 951'782'400'123'456'789},
+      {"2023-10-10T16:57:52.000020500Z", 1'696'957'072'000'020'500},
+      {"2554-07-21T23:34:33.709551614Z", kUndefTimestamp - 1},
+      {"UNDEF_TIMESTAMP", kUndefTimestamp}};
+  for (const auto& [str, exp] : cases) {
+    EXPECT_EQ(ParseIso8601(str).time_since_epoch().count(), exp) << str;
+  }
+}
+
+TEST(ParseIso8601Tests, TestRoundTrip) {
+  constexpr std::uint64_t kStep = kUndefTimestamp / 997;
+  for (std::uint64_t count = 0; count < kUndefTimestamp - kStep; count += kStep) {
+    const UnixNanos ts{std::chrono::nanoseconds{count}};
+    EXPECT_EQ(ParseIso8601(ToIso8601(ts)), ts);
+  }
+}
+
+TEST(ParseIso8601Tests, TestDateTimeRange) {
+  const DateTimeRange<UnixNanos> range{ParseIso8601("2024-01-02T09:30"),
+                                       ParseIso8601("2024-01-02T16:00")};
+  EXPECT_EQ(range.end - range.start, std::chrono::minutes{390});
+}
+
+TEST(ParseIso8601Tests, TestInvalid) {
+  const std::vector<std::string> cases{"",
+                                       "2024",
+                                       "2024-1-02",
+                                       "2024-01-02T",
+                                       "2024-01-02T9:30",
+                                       "2024-01-02T09:30:",
+                                       "2024-01-02T09:30:00.",
+                                       "2024-01-02T09:30:00.1234567890",
+                                       "2024-01-02T09:30:00+01:00",
+                                       "2024-01-02X09:30",
+                                       "2024-00-02",
+                                       "2024-13-02",
+                                       "2023-02-29",
+                                       "2024-01-32",
+                                       "2024-01-02T24:00",
+                                       "2024-01-02T09:60",
+                                       "1969-12-31",
+                                       "2554-07-21T23:34:33.709551615Z",
+                                       "9999-12-31"};
+  for (const auto& str : cases) {
+    EXPECT_THROW(ParseIso8601(str), InvalidArgumentError) << str;
+  }
+}
 }  // namespace databento::tests
@@ -1,6 +1,8 @@
 #include <date/date.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>  // search
+#include <array>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
@@ -217,6 +219,89 @@ TEST_F(DbnDecoderTests, TestUpgradeMbp1WithTsOut) {
   ASSERT_EQ(&orig, &upgraded);
 }
 
+TEST_F(DbnDecoderTests, TestDecodeArenaMetadataManyMappings) {
+  Metadata metadata{kDbnVersion,
+                    dataset::kGlbxMdp3,
+                    Schema::Trades,
+                    {},
+                    {},
+                    {},
+                    SType::RawSymbol,
+                    SType::InstrumentId,
+                    false,
+                    kSymbolCstrLen,
+                    {},
+                    {"ESM5"},
+                    {"NQZ9"},
+                    {}};
+  for (int i = 0; i < 100; ++i) {
+    const auto symbol = "SYM" + std::to_string(i);
+    metadata.symbols.emplace_back(symbol);
+    metadata.mappings.emplace_back(SymbolMapping{
+        symbol,
+        {MappingInterval{date::year{2023} / 7 / 1, date::year{2023} / 7 / 2,
+                         std::to_string(i)},
+         MappingInterval{date::year{2023} / 7 / 2, date::year{2023} / 7 / 3,
+                         std::to_string(i + 1000)}}});
+  }
+  detail::Buffer buf_io;
+  DbnEncoder::EncodeMetadata(metadata, &buf_io);
+  DbnDecoder decoder{&logger_, std::make_unique<detail::Buffer>(std::move(buf_io)),
+                     VersionUpgradePolicy::AsIs};
+
+  auto arena_metadata = decoder.DecodeArenaMetadata();
+  EXPECT_EQ(arena_metadata.dataset, dataset::kGlbxMdp3);
+  ASSERT_EQ(arena_metadata.symbols.size(), 100);
+  EXPECT_EQ(arena_metadata.symbols[42], "SYM42");
+  ASSERT_EQ(arena_metadata.mappings.size(), 100);
+  ASSERT_EQ(arena_metadata.intervals.size(), 200);
+  const auto intervals = arena_metadata.Intervals(arena_metadata.mappings[99]);
+  ASSERT_EQ(intervals.size(), 2);
+  EXPECT_EQ(intervals[0].symbol, "99");
+  EXPECT_EQ(intervals[1].symbol, "1099");
+  EXPECT_EQ(intervals[1].start_date, date::year{2023} / 7 / 2);
+  EXPECT_EQ(arena_metadata.ToMetadata(), metadata);
+  // Views must remain valid after a move
+  const auto moved = std::move(arena_metadata);
+  EXPECT_EQ(moved.mappings[0].raw_symbol, "SYM0");
+  EXPECT_EQ(moved.ToMetadata(), metadata);
+}
+
+TEST_F(DbnDecoderTests, TestDecodeArenaMetadataInvalidIntervalCount) {
+  const Metadata metadata{kDbnVersion,
+                          dataset::kGlbxMdp3,
+                          Schema::Trades,
+                          {},
+                          {},
+                          {},
+                          SType::RawSymbol,
+                          SType::InstrumentId,
+                          false,
+                          kSymbolCstrLen,
+                          {},
+                          {},
+                          {},
+                          {SymbolMapping{"ESM5",
+                                         {MappingInterval{date::year{2023} / 7 / 1,
+                                                          date::year{2023} / 7 / 2,
+                                                          "1"}}}}};
+  detail::Buffer buf_io;
+  DbnEncoder::EncodeMetadata(metadata, &buf_io);
+  // Corrupt the interval count following the raw symbol
+  const std::array<std::byte, 4> raw_symbol{std::byte{'E'}, std::byte{'S'},
+                                            std::byte{'M'}, std::byte{'5'}};
+  auto* const interval_count =
+      std::search(buf_io.ReadBegin(), buf_io.ReadEnd(), raw_symbol.begin(),
+                  raw_symbol.end()) +
+      kSymbolCstrLen;
+  ASSERT_LT(interval_count, buf_io.ReadEnd());
+  const auto huge_count = std::numeric_limits<std::uint32_t>::max();
+  std::memcpy(interval_count, &huge_count, sizeof(huge_count));
+  DbnDecoder decoder{&logger_, std::make_unique<detail::Buffer>(std::move(buf_io)),
+                     VersionUpgradePolicy::AsIs};
+  ASSERT_THROW(decoder.DecodeArenaMetadata(), DbnResponseError);
+}
+
 class DbnDecoderSchemaTests
     : public DbnDecoderTests,
       public testing::WithParamInterface<std::pair<const char*, std::uint8_t>> {};
@@ -882,6 +967,32 @@ TEST_P(DbnDecoderSchemaTests, TestDecodeDefinition) {
   }
 }
 
+TEST_P(DbnDecoderSchemaTests, TestDecodeArenaMetadata) {
+  const auto [extension, version] = GetParam();
+  ReadFromFile("definition", extension, version);
+  const Metadata expected = target_->DecodeMetadata();
+  ReadFromFile("definition", extension, version);
+
+  const auto metadata = target_->DecodeArenaMetadata();
+  EXPECT_EQ(metadata.version, version);
+  EXPECT_EQ(metadata.dataset, dataset::kXnasItch);
+  ASSERT_EQ(metadata.symbols.size(), 1);
+  EXPECT_EQ(metadata.symbols[0], "MSFT");
+  ASSERT_EQ(metadata.mappings.size(), 1);
+  const auto& mapping = metadata.mappings[0];
+  EXPECT_EQ(mapping.raw_symbol, "MSFT");
+  const auto intervals = metadata.Intervals(mapping);
+  ASSERT_EQ(intervals.size(), 62);
+  EXPECT_EQ(intervals[0].symbol, "6819");
+  EXPECT_EQ(intervals[0].start_date, date::year{2021} / 10 / 4);
+  EXPECT_EQ(intervals[0].end_date, date::year{2021} / 10 / 5);
+  EXPECT_EQ(metadata.ToMetadata(), expected);
+
+  ASSERT_NE(target_->DecodeRecord(), nullptr);
+  ASSERT_NE(target_->DecodeRecord(), nullptr);
+  ASSERT_EQ(target_->DecodeRecord(), nullptr);
+}
+
 TEST_P(DbnDecoderSchemaTests, TestDecodeImbalance) {
   const auto [extension, version] = GetParam();
   ReadFromFile("imbalance", extension, version);
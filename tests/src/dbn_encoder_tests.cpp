@@ -2,7 +2,10 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "databento/constants.hpp"
 #include "databento/datetime.hpp"
@@ -11,7 +14,9 @@
 #include "databento/dbn_encoder.hpp"
 #include "databento/detail/buffer.hpp"
 #include "databento/exceptions.hpp"
+#include "databento/iwritable.hpp"
 #include "databento/log.hpp"
+#include "databento/record.hpp"
 #include "mock/mock_log_receiver.hpp"
 
 namespace databento::tests {
@@ -61,4 +66,145 @@ TEST(DbnEncoderTests, TestEncodeNewerMetadataErrors) {
   ASSERT_THROW(DbnEncoder::EncodeMetadata(metadata, &io),
                databento::InvalidArgumentError);
 }
+
+namespace {
+class CountingWritable : public IWritable {
+ public:
+  void WriteAll(const std::byte* buffer, std::size_t length) override {
+    if (should_fail) {
+      throw Exception{"write failed"};
+    }
+    ++write_count;
+    bytes.insert(bytes.end(), buffer, buffer + length);
+  }
+
+  bool should_fail{};
+  std::size_t write_count{};
+  std::vector<std::byte> bytes;
+};
+
+TradeMsg MakeTrade(std::uint32_t i) {
+  return TradeMsg{
+      RecordHeader{
+          static_cast<std::uint8_t>(sizeof(TradeMsg) / RecordHeader::kLengthMultiplier),
+          RType::Mbp0, 1, i, UnixNanos{std::chrono::nanoseconds{i}}},
+      std::int64_t{i} * kFixedPriceScale,
+      i,
+      Action::Trade,
+      Side::Ask,
+      {},
+      0,
+      UnixNanos{std::chrono::nanoseconds{i + 1}},
+      TimeDeltaNanos{},
+      i};
+}
+
+Metadata MakeTradesMetadata() {
+  return Metadata{kDbnVersion,
+                  dataset::kXnasItch,
+                  Schema::Trades,
+                  {},
+                  {},
+                  0,
+                  SType::RawSymbol,
+                  SType::InstrumentId,
+                  false,
+                  kSymbolCstrLen,
+                  {"AAPL"},
+                  {},
+                  {},
+                  {}};
+}
+}  // namespace
+
+TEST(DbnEncoderTests, TestBufferedMatchesUnbuffered) {
+  const auto metadata = MakeTradesMetadata();
+  CountingWritable unbuffered_io;
+  CountingWritable small_buffer_io;
+  CountingWritable large_buffer_io;
+  {
+    DbnEncoder unbuffered{metadata, &unbuffered_io};
+    // Smaller than the metadata and some records so writes bypass it
+    DbnEncoder small_buffer{metadata, &small_buffer_io, 100};
+    DbnEncoder large_buffer{metadata, &large_buffer_io, 1 << 20};
+    for (std::uint32_t i = 0; i < 100; ++i) {
+      const auto trade = MakeTrade(i);
+      unbuffered.EncodeRecord(trade);
+      small_buffer.EncodeRecord(trade);
+      large_buffer.EncodeRecord(trade);
+    }
+    EXPECT_EQ(large_buffer_io.write_count, 0);
+    large_buffer.Flush();
+    EXPECT_EQ(large_buffer_io.write_count, 1);
+    small_buffer.EncodeRecord(MakeTrade(100));
+    // Flushed by destructor
+  }
+  EXPECT_EQ(unbuffered_io.write_count, 101);
+  EXPECT_LT(small_buffer_io.write_count, unbuffered_io.write_count);
+  ASSERT_EQ(small_buffer_io.bytes.size(),
+            unbuffered_io.bytes.size() + sizeof(TradeMsg));
+  small_buffer_io.bytes.resize(unbuffered_io.bytes.size());
+  EXPECT_EQ(small_buffer_io.bytes, unbuffered_io.bytes);
+  EXPECT_EQ(large_buffer_io.bytes, unbuffered_io.bytes);
+}
+
+TEST(DbnEncoderTests, TestFailedFlushNotResent) {
+  CountingWritable io;
+  {
+    DbnEncoder encoder{MakeTradesMetadata(), &io, 1 << 20};
+    encoder.EncodeRecord(MakeTrade(0));
+    io.should_fail = true;
+    ASSERT_THROW(encoder.Flush(), Exception);
+    io.should_fail = false;
+  }
+  EXPECT_EQ(io.write_count, 0);
+}
+
+TEST(DbnEncoderTests, TestAssignmentFlushes) {
+  const auto metadata = MakeTradesMetadata();
+  CountingWritable first_io;
+  CountingWritable second_io;
+  std::size_t metadata_size{};
+  {
+    DbnEncoder encoder{metadata, &first_io, 1 << 20};
+    encoder.EncodeRecord(MakeTrade(0));
+    encoder = DbnEncoder{metadata, &second_io, 1 << 20};
+    ASSERT_EQ(first_io.write_count, 1);
+    metadata_size = first_io.bytes.size() - sizeof(TradeMsg);
+    EXPECT_EQ(second_io.write_count, 0);
+    encoder.EncodeRecord(MakeTrade(1));
+    // The copy shares the output but not the buffered record
+    DbnEncoder copy{encoder};
+    copy.EncodeRecord(MakeTrade(2));
+    copy = encoder;
+    EXPECT_EQ(second_io.write_count, 1);
+  }
+  EXPECT_EQ(first_io.write_count, 1);
+  EXPECT_EQ(second_io.write_count, 2);
+  EXPECT_EQ(second_io.bytes.size(), metadata_size + 2 * sizeof(TradeMsg));
+}
+
+TEST(DbnEncoderTests, TestEncodeRecords) {
+  auto logger = mock::MockLogReceiver::AssertNoLogs(LogLevel::Warning);
+  const auto metadata = MakeTradesMetadata();
+  std::vector<TradeMsg> trades;
+  for (std::uint32_t i = 0; i < 10; ++i) {
+    trades.emplace_back(MakeTrade(i));
+  }
+  auto io = std::make_unique<detail::Buffer>();
+  {
+    DbnEncoder encoder{metadata, io.get()};
+    encoder.EncodeRecords(trades.data(), 4);
+    encoder.EncodeRecords(reinterpret_cast<const std::byte*>(trades.data() + 4),
+                          (trades.size() - 4) * sizeof(TradeMsg));
+  }
+  DbnDecoder decoder{&logger, std::move(io)};
+  EXPECT_EQ(decoder.DecodeMetadata(), metadata);
+  for (const auto& trade : trades) {
+    const auto* rec = decoder.DecodeRecord();
+    ASSERT_NE(rec, nullptr);
+    EXPECT_EQ(rec->Get<TradeMsg>(), trade);
+  }
+  EXPECT_EQ(decoder.DecodeRecord(), nullptr);
+}
 }  // namespace databento::tests
@@ -1,17 +1,26 @@
+#include <algorithm>  // min
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <iterator>  // istreambuf_iterator
+#include <optional>
+#include <vector>
 
 #include "databento/datetime.hpp"
 #include "databento/dbn.hpp"
 #include "databento/dbn_encoder.hpp"
 #include "databento/dbn_file_store.hpp"
+#include "databento/detail/dbn_file_indexer.hpp"
 #include "databento/detail/zstd_stream.hpp"
 #include "databento/enums.hpp"
 #include "databento/file_stream.hpp"
 #include "databento/flag_set.hpp"
 #include "databento/record.hpp"
 #include "databento/v1.hpp"
+#include "databento/v3.hpp"
 #include "temp_file.hpp"
 
 namespace databento::tests {
@@ -115,4 +124,144 @@ TEST(DbnFileStoreTests, TestDecodeExtended) {
   }
   ASSERT_EQ(count, kExpSize);
 }
+
+namespace {
+constexpr std::uint64_t kIndexRecordCount = 1'000;
+
+Metadata MakeMboMetadata() {
+  return Metadata{kDbnVersion,
+                  ToString(Dataset::GlbxMdp3),
+                  Schema::Mbo,
+                  {},
+                  {},
+                  {},
+                  SType::RawSymbol,
+                  SType::InstrumentId,
+                  false,
+                  kSymbolCstrLen,
+                  {},
+                  {},
+                  {},
+                  {}};
+}
+
+MboMsg MakeIndexedMbo(std::uint64_t i) {
+  MboMsg mbo{};
+  mbo.hd = RecordHeader{sizeof(MboMsg) / RecordHeader::kLengthMultiplier, RType::Mbo,
+                        1, 1, UnixNanos{}};
+  mbo.order_id = i;
+  mbo.ts_recv = UnixNanos{std::chrono::nanoseconds{i * 10}};
+  return mbo;
+}
+
+std::vector<std::byte> ReadFile(const std::filesystem::path& path) {
+  std::ifstream stream{path, std::ios::binary};
+  std::vector<std::byte> bytes;
+  for (auto it = std::istreambuf_iterator<char>{stream};
+       it != std::istreambuf_iterator<char>{}; ++it) {
+    bytes.push_back(static_cast<std::byte>(*it));
+  }
+  return bytes;
+}
+
+// Processes `path` in small chunks, as when downloading it
+DbnFileIndex IndexFile(const std::filesystem::path& path) {
+  const auto bytes = ReadFile(path);
+  detail::DbnFileIndexer indexer;
+  for (std::size_t pos = 0; pos < bytes.size(); pos += 100) {
+    indexer.Process(&bytes[pos], std::min<std::size_t>(100, bytes.size() - pos));
+  }
+  return indexer.Finish();
+}
+}  // namespace
+
+TEST(DbnFileStoreTests, TestIndexZstdFrames) {
+  TempFile temp_file{std::filesystem::temp_directory_path() /
+                     "test_index_frames.dbn.zst"};
+  std::uint64_t second_frame_offset{};
+  {
+    OutFileStream out_file{temp_file.Path()};
+    {
+      detail::ZstdCompressStream stream{&out_file};
+      DbnEncoder encoder{MakeMboMetadata(), &stream};
+      for (std::uint64_t i = 0; i < kIndexRecordCount / 2; ++i) {
+        encoder.EncodeRecord(MakeIndexedMbo(i));
+      }
+    }
+    out_file.Flush();
+    second_frame_offset = std::filesystem::file_size(temp_file.Path());
+    detail::ZstdCompressStream stream{&out_file};
+    for (std::uint64_t i = kIndexRecordCount / 2; i < kIndexRecordCount; ++i) {
+      const auto mbo = MakeIndexedMbo(i);
+      DbnEncoder::EncodeRecord(Record{const_cast<RecordHeader*>(&mbo.hd)}, &stream);
+    }
+  }
+  auto index = IndexFile(temp_file.Path());
+  EXPECT_EQ(index.compression, Compression::Zstd);
+  EXPECT_EQ(index.metadata, MakeMboMetadata());
+  // The first frame begins with the metadata
+  ASSERT_EQ(index.entries.size(), 1);
+  EXPECT_EQ(index.entries[0].offset, second_frame_offset);
+  EXPECT_EQ(index.entries[0].index_ts, MakeIndexedMbo(kIndexRecordCount / 2).ts_recv);
+
+  DbnFileStore target{ILogReceiver::Default(), temp_file.Path(),
+                      VersionUpgradePolicy::UpgradeToV3, std::move(index)};
+  EXPECT_EQ(target.GetMetadata(), MakeMboMetadata());
+  for (const std::uint64_t i : {900U, 100U, 500U, 501U, 0U}) {
+    target.Seek(MakeIndexedMbo(i).ts_recv);
+    const auto* record = target.NextRecord();
+    ASSERT_NE(record, nullptr);
+    EXPECT_EQ(record->Get<MboMsg>(), MakeIndexedMbo(i));
+  }
+  // Continues after the sought record
+  EXPECT_EQ(target.NextRecord()->Get<MboMsg>(), MakeIndexedMbo(1));
+  target.Seek(MakeIndexedMbo(kIndexRecordCount).ts_recv);
+  EXPECT_EQ(target.NextRecord(), nullptr);
+}
+
+TEST(DbnFileStoreTests, TestIndexUncompressed) {
+  TempFile temp_file{std::filesystem::temp_directory_path() / "test_index.dbn"};
+  {
+    OutFileStream out_file{temp_file.Path()};
+    DbnEncoder encoder{MakeMboMetadata(), &out_file};
+    for (std::uint64_t i = 0; i < kIndexRecordCount; ++i) {
+      encoder.EncodeRecord(MakeIndexedMbo(i));
+    }
+  }
+  auto index = IndexFile(temp_file.Path());
+  EXPECT_EQ(index.compression, Compression::None);
+  // Too small for more than the first record to be indexed
+  ASSERT_EQ(index.entries.size(), 1);
+  EXPECT_EQ(index.entries[0].offset,
+            std::filesystem::file_size(temp_file.Path()) -
+                kIndexRecordCount * sizeof(MboMsg));
+  EXPECT_EQ(index.entries[0].index_ts, MakeIndexedMbo(0).ts_recv);
+
+  DbnFileStore target{ILogReceiver::Default(), temp_file.Path(),
+                      VersionUpgradePolicy::UpgradeToV3, std::move(index)};
+  std::optional<Metadata> metadata;
+  std::uint64_t count{};
+  target.Seek(MakeIndexedMbo(10).ts_recv);
+  target.Replay([&metadata](Metadata&& md) { metadata = std::move(md); },
+                [&count](const Record& record) {
+                  EXPECT_EQ(record.Get<MboMsg>(), MakeIndexedMbo(10 + count));
+                  ++count;
+                  return KeepGoing::Continue;
+                });
+  EXPECT_EQ(metadata, MakeMboMetadata());
+  EXPECT_EQ(count, kIndexRecordCount - 10);
+}
+
+TEST(DbnFileStoreTests, TestSeekWithoutIndex) {
+  DbnFileStore target{TEST_DATA_DIR "/test_data.mbo.v3.dbn.zst"};
+  const auto* first = target.NextRecord();
+  ASSERT_NE(first, nullptr);
+  const auto second = target.NextRecord()->Get<MboMsg>();
+  DbnFileStore seek_target{TEST_DATA_DIR "/test_data.mbo.v3.dbn.zst"};
+  seek_target.Seek(second.ts_recv);
+  const auto* record = seek_target.NextRecord();
+  ASSERT_NE(record, nullptr);
+  EXPECT_EQ(record->Get<MboMsg>(), second);
+  EXPECT_EQ(seek_target.NextRecord(), nullptr);
+}
 }  // namespace databento::tests
@@ -0,0 +1,196 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "databento/constants.hpp"
+#include "databento/datetime.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_decoder.hpp"
+#include "databento/dbn_importer.hpp"
+#include "databento/detail/buffer.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+#include "mock/mock_log_receiver.hpp"
+
+namespace databento::tests {
+class DbnImporterTests : public testing::Test {
+ protected:
+  template <typename R>
+  std::vector<R> Import(const DbnImportOptions& options, std::string_view input) {
+    detail::Buffer in_buffer{};
+    in_buffer.WriteAll(input.data(), input.size());
+    auto out_buffer = std::make_unique<detail::Buffer>();
+    DbnImporter target{options};
+    record_count_ = target.Import(&in_buffer, out_buffer.get());
+    DbnDecoder decoder{&logger_, std::move(out_buffer)};
+    metadata_ = decoder.DecodeMetadata();
+    std::vector<R> res;
+    while (const auto* rec = decoder.DecodeRecord()) {
+      res.emplace_back(rec->Get<R>());
+    }
+    return res;
+  }
+
+  static UnixNanos Ts(std::uint64_t count) {
+    return UnixNanos{std::chrono::nanoseconds{count}};
+  }
+
+  mock::MockLogReceiver logger_ = mock::MockLogReceiver::AssertNoLogs(LogLevel::Warning);
+  Metadata metadata_{};
+  std::uint64_t record_count_{};
+};
+
+TEST_F(DbnImporterTests, TestCsvTrades) {
+  DbnImportOptions options;
+  options.dataset = dataset::kXnasItch;
+  options.schema = Schema::Trades;
+  options.publisher_id = 2;
+  options.symbols = {"AAPL"};
+  const auto res = Import<TradeMsg>(options,
+                                    "ts_event,instrument_id,price,size,side,symbol\n"
+                                    "2024-01-02T14:30:00.000000001Z,32,185.5,100,B,AAPL\n"
+                                    "1704205800000000002,32,-0.000000001,5,N,AAPL\n");
+  EXPECT_EQ(record_count_, 2);
+  EXPECT_EQ(metadata_.dataset, dataset::kXnasItch);
+  EXPECT_EQ(metadata_.schema, Schema::Trades);
+  EXPECT_EQ(metadata_.symbols, std::vector<std::string>{"AAPL"});
+  EXPECT_EQ(metadata_.stype_in, SType::RawSymbol);
+  EXPECT_EQ(metadata_.stype_out, SType::InstrumentId);
+  ASSERT_EQ(res.size(), 2);
+  EXPECT_EQ(res[0].hd.rtype, RType::Mbp0);
+  EXPECT_EQ(res[0].hd.publisher_id, 2);
+  EXPECT_EQ(res[0].hd.instrument_id, 32);
+  EXPECT_EQ(res[0].hd.ts_event, Ts(1'704'205'800'000'000'001));
+  EXPECT_EQ(res[0].price, 185'500'000'000);
+  EXPECT_EQ(res[0].size, 100);
+  EXPECT_EQ(res[0].side, Side::Bid);
+  // Defaults for missing columns
+  EXPECT_EQ(res[0].action, Action::None);
+  EXPECT_EQ(res[0].ts_recv, res[0].hd.ts_event);
+  EXPECT_EQ(res[1].hd.ts_event, Ts(1'704'205'800'000'000'002));
+  EXPECT_EQ(res[1].price, -1);
+}
+
+TEST_F(DbnImporterTests, TestCsvColumnNamesAndQuoting) {
+  DbnImportOptions options;
+  options.schema = Schema::Ohlcv1D;
+  options.column_names = {{"ts_event", "date"}, {"volume", "vol"}};
+  options.pretty_px = false;
+  options.delimiter = ';';
+  const auto res = Import<OhlcvMsg>(options,
+                                    "\"date\";open;high;low;close;\"vol\"\r\n"
+                                    "\"2024-01-02\";1;\"4\";-1;2;\"1000\"\r\n"
+                                    "\r\n"
+                                    "2024-01-03;2;;;3;0");
+  ASSERT_EQ(res.size(), 2);
+  EXPECT_EQ(res[0].hd.rtype, RType::Ohlcv1D);
+  EXPECT_EQ(res[0].hd.ts_event, Ts(1'704'153'600'000'000'000));
+  EXPECT_EQ(res[0].open, 1);
+  EXPECT_EQ(res[0].high, 4);
+  EXPECT_EQ(res[0].low, -1);
+  EXPECT_EQ(res[0].close, 2);
+  EXPECT_EQ(res[0].volume, 1000);
+  EXPECT_EQ(res[1].high, kUndefPrice);
+  EXPECT_EQ(res[1].low, kUndefPrice);
+}
+
+TEST_F(DbnImporterTests, TestCsvOrderedAcrossChunks) {
+  DbnImportOptions options;
+  options.schema = Schema::Mbo;
+  options.num_threads = 3;
+  // Much smaller than the input so it's split across many chunks
+  options.chunk_size = 64;
+  options.compress = true;
+  std::string input = "ts_recv,ts_event,order_id,price,size,action,side,sequence\n";
+  for (std::uint32_t i = 0; i < 1000; ++i) {
+    input += std::to_string(2000 + i) + ',' + std::to_string(1000 + i) + ',' +
+             std::to_string(i) + ",1.25,1,A,A," + std::to_string(i) + '\n';
+  }
+  const auto res = Import<MboMsg>(options, input);
+  ASSERT_EQ(res.size(), 1000);
+  for (std::uint32_t i = 0; i < 1000; ++i) {
+    EXPECT_EQ(res[i].order_id, i);
+    EXPECT_EQ(res[i].sequence, i);
+    EXPECT_EQ(res[i].hd.ts_event, Ts(1000 + i));
+    EXPECT_EQ(res[i].ts_recv, Ts(2000 + i));
+  }
+}
+
+TEST_F(DbnImporterTests, TestJsonMbp1) {
+  DbnImportOptions options;
+  options.encoding = Encoding::Json;
+  options.schema = Schema::Mbp1;
+  options.symbols = {"ES.FUT"};
+  options.stype_in = SType::Parent;
+  const auto res = Import<Mbp1Msg>(
+      options,
+      R"({"ts_recv":"2024-01-02T14:30:00.000000002Z","hd":{"ts_event":"2024-01-02T14:30:00.000000001Z","rtype":1,"publisher_id":1,"instrument_id":5},"action":"A","side":"B","depth":0,"price":"10.5","size":2,"flags":130,"ts_in_delta":-5,"sequence":7,"levels":[{"bid_px":"10.5","ask_px":"10.75","bid_sz":2,"ask_sz":3,"bid_ct":1,"ask_ct":1}]})"
+      "\n"
+      R"({"hd":{"ts_event":1704205800000000003,"publisher_id":1,"instrument_id":5},"price":null})"
+      "\n");
+  ASSERT_EQ(res.size(), 2);
+  EXPECT_EQ(res[0].hd.rtype, RType::Mbp1);
+  EXPECT_EQ(res[0].hd.instrument_id, 5);
+  EXPECT_EQ(res[0].hd.ts_event, Ts(1'704'205'800'000'000'001));
+  EXPECT_EQ(res[0].ts_recv, Ts(1'704'205'800'000'000'002));
+  EXPECT_EQ(res[0].action, Action::Add);
+  EXPECT_EQ(res[0].price, 10'500'000'000);
+  EXPECT_EQ(res[0].flags.Raw(), 130);
+  EXPECT_EQ(res[0].ts_in_delta, TimeDeltaNanos{-5});
+  EXPECT_EQ(res[0].sequence, 7);
+  EXPECT_EQ(res[0].levels[0].bid_px, 10'500'000'000);
+  EXPECT_EQ(res[0].levels[0].ask_px, 10'750'000'000);
+  EXPECT_EQ(res[0].levels[0].ask_sz, 3);
+  EXPECT_EQ(res[1].hd.ts_event, Ts(1'704'205'800'000'000'003));
+  EXPECT_EQ(res[1].price, kUndefPrice);
+  EXPECT_EQ(res[1].levels[0].bid_px, kUndefPrice);
+  EXPECT_EQ(metadata_.stype_in, SType::Parent);
+}
+
+TEST_F(DbnImporterTests, TestInvalidLine) {
+  DbnImportOptions options;
+  options.chunk_size = 16;
+  detail::Buffer in_buffer{};
+  const std::string_view input =
+      "ts_event,price\n"
+      "1,1.5\n"
+      "2,2.5\n"
+      "3,3.5x\n"
+      "4,4.5\n";
+  in_buffer.WriteAll(input.data(), input.size());
+  detail::Buffer out_buffer{};
+  DbnImporter target{options};
+  try {
+    target.Import(&in_buffer, &out_buffer);
+    FAIL() << "Expected exception";
+  } catch (const Exception& exc) {
+    EXPECT_THAT(exc.what(), testing::HasSubstr("line 4: invalid price"));
+  }
+}
+
+TEST_F(DbnImporterTests, TestMissingTsEvent) {
+  DbnImportOptions options;
+  detail::Buffer in_buffer{};
+  in_buffer.WriteAll("ts_recv,price\n1,1.5\n", 20);
+  detail::Buffer out_buffer{};
+  DbnImporter target{options};
+  ASSERT_THROW(target.Import(&in_buffer, &out_buffer), InvalidArgumentError);
+}
+
+TEST_F(DbnImporterTests, TestInvalidOptions) {
+  DbnImportOptions options;
+  options.schema = Schema::Definition;
+  ASSERT_THROW(DbnImporter{options}, InvalidArgumentError);
+  options.schema = Schema::Trades;
+  options.column_names = {{"bid_px_00", "bid"}};
+  ASSERT_THROW(DbnImporter{options}, InvalidArgumentError);
+}
+}  // namespace databento::tests
@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <filesystem>
+#include <utility>  // move
 
 #include "databento/exceptions.hpp"
 #include "databento/file_stream.hpp"
@@ -45,4 +46,48 @@ TEST(OutFileStreamTests, TestWriteAllCanBeRead) {
   input.ReadExact(reinterpret_cast<std::byte*>(buf.data()), 8);
   ASSERT_STREQ(buf.data(), data);
 }
+
+TEST(OutFileStreamTests, TestBufferedWriteAll) {
+  constexpr auto data = "abcdefghijklmnopqrst";
+  TempFile temp_file{std::filesystem::temp_directory_path() / "out_buffered"};
+  OutFileStream target{temp_file.Path(), 8};
+  const auto* bytes = reinterpret_cast<const std::byte*>(data);
+  target.WriteAll(bytes, 3);
+  target.WriteAll(bytes + 3, 3);
+  // Not yet written
+  ASSERT_EQ(std::filesystem::file_size(temp_file.Path()), 0);
+  // Doesn't fit in the remaining buffer
+  target.WriteAll(bytes + 6, 3);
+  ASSERT_EQ(std::filesystem::file_size(temp_file.Path()), 6);
+  // Larger than the buffer, written directly
+  target.WriteAll(bytes + 9, 11);
+  ASSERT_EQ(std::filesystem::file_size(temp_file.Path()), 20);
+  target.Flush();
+  InFileStream input{temp_file.Path()};
+  std::vector<char> buf(21);
+  input.ReadExact(reinterpret_cast<std::byte*>(buf.data()), 20);
+  ASSERT_STREQ(buf.data(), data);
+}
+
+TEST(OutFileStreamTests, TestMoveAssignFlushes) {
+  constexpr auto data = "abcdef";
+  const auto* bytes = reinterpret_cast<const std::byte*>(data);
+  TempFile first_file{std::filesystem::temp_directory_path() / "out_first"};
+  TempFile second_file{std::filesystem::temp_directory_path() / "out_second"};
+  {
+    OutFileStream target{first_file.Path(), 8};
+    target.WriteAll(bytes, 3);
+    OutFileStream other{second_file.Path(), 8};
+    other.WriteAll(bytes + 3, 3);
+    target = std::move(other);
+    ASSERT_EQ(std::filesystem::file_size(first_file.Path()), 3);
+    ASSERT_EQ(std::filesystem::file_size(second_file.Path()), 0);
+    target.WriteAll(bytes, 3);
+  }
+  ASSERT_EQ(std::filesystem::file_size(first_file.Path()), 3);
+  InFileStream input{second_file.Path()};
+  std::vector<char> buf(7);
+  input.ReadExact(reinterpret_cast<std::byte*>(buf.data()), 6);
+  ASSERT_STREQ(buf.data(), "defabc");
+}
 }  // namespace databento::tests
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>  // pair
+#include <vector>
+
+#include "databento/constants.hpp"
+#include "databento/datetime.hpp"
+#include "databento/enums.hpp"
+#include "databento/flag_set.hpp"
+#include "databento/pretty.hpp"
+#include "format_helper.hpp"
+
+namespace databento::tests {
+TEST(FormatHelperTests, TestSingleLine) {
+  std::string res;
+  FormatBuffer buffer{res, 6};
+  FormatBuilder{buffer}
+      .SetTypeName("TestClass")
+      .SetSpacer(" ")
+      .Build()
+      .AddField("schema", Schema::Ohlcv1D)
+      .AddField("dataset", std::string{dataset::kXnasItch})
+      .AddField("size", 10)
+      .AddField("i8", static_cast<std::int8_t>(-10))
+      .AddField("u8", static_cast<std::uint8_t>(16))
+      .AddField("is_full", true)
+      .AddField("action", 'A')
+      .Finish();
+  EXPECT_EQ(res,
+            "TestClass { schema = ohlcv-1d, dataset = \"XNAS.ITCH\", size = 10, i8 = "
+            "-10, u8 = 16, is_full = true, action = 'A' }");
+}
+
+TEST(FormatHelperTests, TestIndent) {
+  const std::vector<Encoding> test_data{Encoding::Csv, Encoding::Dbn, Encoding::Json};
+
+  std::string res;
+  FormatBuffer buffer{res, 6};
+  auto target = FormatBuilder{buffer}.SetSpacer("\n    ").SetIndent("    ").Build();
+  for (const auto encoding : test_data) {
+    target.AddItem(encoding);
+  }
+  target.Finish();
+  ASSERT_EQ(res, R"({
+        csv,
+        dbn,
+        json
+    })");
+}
+
+TEST(FormatHelperTests, TestCharArray) {
+  const std::array<char, 5> terminated{'U', 'S', 'D'};
+  const std::array<char, 3> unterminated{'U', 'S', 'D'};
+
+  std::string res;
+  FormatBuffer buffer{res, 6};
+  FormatBuilder{buffer}
+      .Build()
+      .AddField("terminated", terminated)
+      .AddField("unterminated", unterminated)
+      .Finish();
+  ASSERT_EQ(res, R"({terminated = "USD",unterminated = "USD"})");
+}
+
+TEST(FormatHelperTests, TestQuoted) {
+  std::string res;
+  FormatBuffer{res, 6}.AppendQuoted(R"(a "b" \c)");
+  ASSERT_EQ(res, R"("a \"b\" \\c")");
+}
+
+TEST(FormatHelperTests, TestAppendIso8601) {
+  const std::vector<std::pair<std::uint64_t, std::string>> test_data{
+      {0, "1970-01-01T00:00:00.000000000Z"},
+      {1'696'957'072'000'020'500, "2023-10-10T16:57:52.000020500Z"},
+      {951'782'400'123'456'789, "2000-02-29T00:00:00.123456789Z"},
+      {4'102'444'799'999'999'999, "2099-12-31T23:59:59.999999999Z"},
+      {kUndefTimestamp - 1, "2554-07-21T23:34:33.709551614Z"},
+      {kUndefTimestamp, "UNDEF_TIMESTAMP"}};
+  for (const auto& [count, exp] : test_data) {
+    const UnixNanos ts{std::chrono::nanoseconds{count}};
+    std::string res;
+    FormatBuffer{res, 6}.AppendIso8601(ts);
+    EXPECT_EQ(res, exp) << count;
+    EXPECT_EQ(ToIso8601(ts), exp) << count;
+  }
+}
+
+TEST(FormatHelperTests, TestPx) {
+  const auto format_px = [](std::int64_t px, int precision) {
+    std::string res;
+    FormatBuffer{res, precision}.AppendPx(pretty::Px{px});
+    return res;
+  };
+  EXPECT_EQ(format_px(1'234'567'890'123, 9), "1234.567890123");
+  EXPECT_EQ(format_px(1'234'567'890'123, 2), "1234.56");
+  EXPECT_EQ(format_px(1'234'567'890'123, 0), "1234");
+  // Unsupported precisions use full precision
+  EXPECT_EQ(format_px(1'234'567'890'123, 7), "1234.567890123");
+  EXPECT_EQ(format_px(-5, 6), "-0.000000005");
+  EXPECT_EQ(format_px(std::numeric_limits<std::int64_t>::min() + 1, 9),
+            "-9223372036.854775807");
+  EXPECT_EQ(format_px(kUndefPrice, 9), "UNDEF_PRICE");
+}
+
+TEST(FormatHelperTests, TestFlagSet) {
+  std::string res;
+  FormatBuffer{res, 6}.AppendFlagSet(FlagSet{FlagSet::kLast | FlagSet::kSnapshot});
+  EXPECT_EQ(res, "LAST | SNAPSHOT (160)");
+}
+}  // namespace databento::tests
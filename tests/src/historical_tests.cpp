@@ -3,29 +3,45 @@
 #include <gtest/gtest.h>
 #include <httplib.h>
 #include <nlohmann/json_fwd.hpp>
+#include <openssl/sha.h>  // SHA256, SHA256_DIGEST_LENGTH
 
 #include <algorithm>
+#include <array>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <filesystem>
+#include <fstream>
+#include <iomanip>  // setfill, setw
+#include <ios>
+#include <iterator>  // istreambuf_iterator
+#include <limits>
+#include <map>
 #include <optional>
+#include <sstream>
 #include <stdexcept>  // logic_error
-#include <utility>    // move
+#include <string>
+#include <utility>  // move
 
+#include "databento/batch.hpp"
 #include "databento/constants.hpp"
 #include "databento/datetime.hpp"
 #include "databento/dbn.hpp"
+#include "databento/dbn_encoder.hpp"
 #include "databento/dbn_file_store.hpp"
 #include "databento/enums.hpp"
 #include "databento/exceptions.hpp"  // Exception
+#include "databento/file_stream.hpp"
 #include "databento/historical.hpp"
+#include "databento/historical_async.hpp"
 #include "databento/log.hpp"
 #include "databento/metadata.hpp"
 #include "databento/record.hpp"
 #include "databento/symbology.hpp"  // kAllSymbols
+#include "databento/symbology_cache.hpp"
 #include "databento/timeseries.hpp"
+#include "databento/timeseries_cache.hpp"
 #include "mock/mock_http_server.hpp"
 #include "mock/mock_log_receiver.hpp"
 #include "temp_file.hpp"
@@ -296,6 +312,249 @@ TEST_F(HistoricalTests, TestBatchDownloadSingleInvalidFile) {
                InvalidArgumentError);
 }
 
+TEST_F(HistoricalTests, TestBatchDownloadConcurrent) {
+  const auto kJobId = "job123";
+  const TempFile temp_metadata_file{tmp_path_ / "job123/test_metadata.json"};
+  const TempFile temp_dbn_file{tmp_path_ / "job123/test.dbn"};
+  mock_server_.MockGetJson("/v0/batch.list_files", {{"job_id", kJobId}},
+                           kListFilesResp);
+  mock_server_.MockGetDbn("/v0/job_id/test.dbn", {},
+                          TEST_DATA_DIR "/test_data.mbo.v3.dbn");
+  mock_server_.MockGetJson("/v0/job_id/test_metadata.json", {{"key", "value"}});
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target = Client(port);
+  std::optional<BatchDownloadProgress> last_progress;
+  const auto paths = target.BatchDownload(
+      tmp_path_, kJobId,
+      BatchDownloadOptions{2, 0, false, true,
+                           [&last_progress](const BatchDownloadProgress& progress) {
+                             last_progress = progress;
+                           }});
+  ASSERT_EQ(paths.size(), 2);
+  EXPECT_EQ(paths[0].lexically_normal(), temp_dbn_file.Path().lexically_normal());
+  EXPECT_EQ(paths[1].lexically_normal(),
+            temp_metadata_file.Path().lexically_normal());
+  EXPECT_TRUE(temp_metadata_file.Exists());
+  EXPECT_TRUE(temp_dbn_file.Exists());
+  EXPECT_FALSE(std::filesystem::exists(tmp_path_ / "job123/test.dbn.part"));
+  ASSERT_TRUE(last_progress.has_value());
+  EXPECT_EQ(last_progress->files_completed, 2);
+  EXPECT_EQ(last_progress->total_files, 2);
+  EXPECT_EQ(last_progress->bytes_downloaded,
+            std::filesystem::file_size(temp_dbn_file.Path()) +
+                std::filesystem::file_size(temp_metadata_file.Path()));
+}
+
+// Sets the size and hash of a single metadata file to match `content`
+static nlohmann::json ListMetadataFileResp(const std::string& content,
+                                           const std::string& hash) {
+  return {{{"filename", "test_metadata.json"},
+           {"size", content.size()},
+           {"hash", hash},
+           {"urls",
+            {{"https", "https://api.databento.com/v0/job_id/test_metadata.json"},
+             {"ftp", "ftp://ftp.databento.com/job_id/test_metadata.json"}}}}};
+}
+
+static std::string Sha256Hex(const std::string& content) {
+  std::array<unsigned char, SHA256_DIGEST_LENGTH> sha{};
+  ::SHA256(reinterpret_cast<const unsigned char*>(content.data()), content.size(),
+           sha.data());
+  std::ostringstream hex;
+  for (const unsigned char c : sha) {
+    hex << std::hex << std::setw(2) << std::setfill('0')
+        << static_cast<std::uint16_t>(c);
+  }
+  return hex.str();
+}
+
+TEST_F(HistoricalTests, TestBatchDownloadChunkedWithHash) {
+  const auto kJobId = "job456";
+  const nlohmann::json kContent{{"key", "value"}, {"other_key", "other_value"}};
+  const auto content = kContent.dump();
+  const TempFile temp_metadata_file{tmp_path_ / "job456/test_metadata.json"};
+  const auto hash = "sha256:" + Sha256Hex(content);
+  mock_server_.MockGetJson("/v0/batch.list_files", {{"job_id", kJobId}},
+                           ListMetadataFileResp(content, hash));
+  mock_server_.MockGetJson("/v0/job_id/test_metadata.json", kContent);
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target = Client(port);
+  // Split into several byte ranges
+  const auto paths = target.BatchDownload(tmp_path_, kJobId,
+                                          BatchDownloadOptions{3, 8, true, true, {}});
+  ASSERT_EQ(paths.size(), 1);
+  ASSERT_TRUE(temp_metadata_file.Exists());
+  std::ifstream downloaded{temp_metadata_file.Path()};
+  const std::string downloaded_content{std::istreambuf_iterator<char>{downloaded}, {}};
+  EXPECT_EQ(downloaded_content, content);
+  EXPECT_FALSE(std::filesystem::exists(tmp_path_ / "job456/test_metadata.json.part"));
+  EXPECT_FALSE(
+      std::filesystem::exists(tmp_path_ / "job456/test_metadata.json.part.chunks"));
+}
+
+TEST_F(HistoricalTests, TestBatchDownloadHashMismatch) {
+  const auto kJobId = "job789";
+  const nlohmann::json kContent{{"key", "value"}};
+  const TempFile temp_metadata_file{tmp_path_ / "job789/test_metadata.json"};
+  mock_server_.MockGetJson("/v0/batch.list_files", {{"job_id", kJobId}},
+                           ListMetadataFileResp(kContent.dump(), "sha256:0123"));
+  mock_server_.MockGetJson("/v0/job_id/test_metadata.json", kContent);
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target = Client(port);
+  EXPECT_THROW(target.BatchDownload(tmp_path_, kJobId, BatchDownloadOptions{}),
+               Exception);
+  EXPECT_FALSE(temp_metadata_file.Exists());
+  EXPECT_FALSE(std::filesystem::exists(tmp_path_ / "job789/test_metadata.json.part"));
+}
+
+TEST_F(HistoricalTests, TestBatchStream) {
+  const auto kJobId = "job123";
+  mock_server_.MockGetJson("/v0/batch.list_files", {{"job_id", kJobId}},
+                           kListFilesResp);
+  mock_server_.MockGetDbn("/v0/job_id/test.dbn", {},
+                          TEST_DATA_DIR "/test_data.mbo.v3.dbn");
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target = Client(port);
+  std::size_t metadata_calls = 0;
+  std::vector<MboMsg> mbo_records;
+  // The JSON file isn't requested because it's not DBN-encoded
+  target.BatchStream(
+      kJobId,
+      [&metadata_calls](Metadata&& metadata) {
+        ++metadata_calls;
+        EXPECT_EQ(metadata.schema, Schema::Mbo);
+      },
+      [&mbo_records](const Record& record) {
+        mbo_records.emplace_back(record.Get<MboMsg>());
+        return KeepGoing::Continue;
+      });
+  EXPECT_EQ(metadata_calls, 1);
+  EXPECT_EQ(mbo_records.size(), 2);
+}
+
+TEST_F(HistoricalTests, TestBatchStreamMergeWithTee) {
+  const auto kJobId = "job321";
+  const nlohmann::json kResp{
+      {{"filename", "a.dbn"},
+       {"size", {}},
+       {"hash", {}},
+       {"urls",
+        {{"https", "https://api.databento.com/v0/job_id/a.dbn"},
+         {"ftp", "ftp://fpt.databento.com/job_id/a.dbn"}}}},
+      {{"filename", "b.dbn.zst"},
+       {"size", {}},
+       {"hash", {}},
+       {"urls",
+        {{"https", "https://api.databento.com/v0/job_id/b.dbn.zst"},
+         {"ftp", "ftp://fpt.databento.com/job_id/b.dbn.zst"}}}}};
+  const TempFile temp_a_file{tmp_path_ / "job321_tee/a.dbn"};
+  const TempFile temp_b_file{tmp_path_ / "job321_tee/b.dbn.zst"};
+  mock_server_.MockGetJson("/v0/batch.list_files", {{"job_id", kJobId}}, kResp);
+  mock_server_.MockGetDbn("/v0/job_id/a.dbn", {},
+                          TEST_DATA_DIR "/test_data.mbo.v3.dbn");
+  mock_server_.MockGetDbn("/v0/job_id/b.dbn.zst", {},
+                          TEST_DATA_DIR "/test_data.mbo.v3.dbn.zst");
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target = Client(port);
+  std::size_t metadata_calls = 0;
+  std::vector<MboMsg> mbo_records;
+  target.BatchStream(
+      kJobId,
+      BatchStreamOptions{BatchStreamMode::Merge, 2, 4096, tmp_path_ / "job321_tee"},
+      [&metadata_calls](Metadata&&) { ++metadata_calls; },
+      [&mbo_records](const Record& record) {
+        mbo_records.emplace_back(record.Get<MboMsg>());
+        return KeepGoing::Continue;
+      });
+  EXPECT_EQ(metadata_calls, 2);
+  ASSERT_EQ(mbo_records.size(), 4);
+  EXPECT_TRUE(std::is_sorted(
+      mbo_records.begin(), mbo_records.end(),
+      [](const MboMsg& lhs, const MboMsg& rhs) { return lhs.ts_recv < rhs.ts_recv; }));
+  // Both copies of each record are delivered together
+  EXPECT_EQ(mbo_records[0], mbo_records[1]);
+  EXPECT_EQ(mbo_records[2], mbo_records[3]);
+  ASSERT_TRUE(temp_a_file.Exists());
+  ASSERT_TRUE(temp_b_file.Exists());
+  EXPECT_EQ(std::filesystem::file_size(temp_a_file.Path()),
+            std::filesystem::file_size(TEST_DATA_DIR "/test_data.mbo.v3.dbn"));
+  EXPECT_EQ(std::filesystem::file_size(temp_b_file.Path()),
+            std::filesystem::file_size(TEST_DATA_DIR "/test_data.mbo.v3.dbn.zst"));
+}
+
+TEST_F(HistoricalTests, TestBatchStreamMergeMoreFilesThanConnections) {
+  const auto kJobId = "job654";
+  constexpr std::uint64_t kFileCount = 3;
+  // Enough records for each file to be decoded in several batches
+  constexpr std::uint64_t kRecordCount = 5'000;
+  // Reserved because a moved-from `TempFile` would fail to remove its file
+  std::vector<TempFile> files;
+  files.reserve(kFileCount);
+  nlohmann::json resp = nlohmann::json::array();
+  for (std::uint64_t file_idx = 0; file_idx < kFileCount; ++file_idx) {
+    const auto filename = "merge" + std::to_string(file_idx) + ".dbn";
+    const auto& file = files.emplace_back(tmp_path_ / filename);
+    {
+      OutFileStream out_file{file.Path()};
+      DbnEncoder encoder{Metadata{kDbnVersion,
+                                  dataset::kGlbxMdp3,
+                                  Schema::Mbo,
+                                  {},
+                                  {},
+                                  {},
+                                  SType::RawSymbol,
+                                  SType::InstrumentId,
+                                  false,
+                                  kSymbolCstrLen,
+                                  {},
+                                  {},
+                                  {},
+                                  {}},
+                         &out_file};
+      // Interleave the records of the files
+      for (std::uint64_t i = 0; i < kRecordCount; ++i) {
+        MboMsg record{};
+        record.hd = RecordHeader{sizeof(MboMsg) / RecordHeader::kLengthMultiplier,
+                                 RType::Mbo, 1, 1, UnixNanos{}};
+        record.ts_recv = UnixNanos{std::chrono::nanoseconds{i * kFileCount + file_idx}};
+        encoder.EncodeRecord(record);
+      }
+    }
+    resp.push_back({{"filename", filename},
+                    {"size", {}},
+                    {"hash", {}},
+                    {"urls",
+                     {{"https", "https://api.databento.com/v0/job_id/" + filename},
+                      {"ftp", "ftp://fpt.databento.com/job_id/" + filename}}}});
+    mock_server_.MockGetDbn("/v0/job_id/" + filename, {}, file.Path().string());
+  }
+  mock_server_.MockGetJson("/v0/batch.list_files", {{"job_id", kJobId}}, resp);
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target = Client(port);
+  std::size_t metadata_calls = 0;
+  std::vector<MboMsg> mbo_records;
+  // Files without a connection of their own spill past the first batch
+  target.BatchStream(
+      kJobId, BatchStreamOptions{BatchStreamMode::Merge, 1, 1, {}},
+      [&metadata_calls](Metadata&&) { ++metadata_calls; },
+      [&mbo_records](const Record& record) {
+        mbo_records.emplace_back(record.Get<MboMsg>());
+        return KeepGoing::Continue;
+      });
+  EXPECT_EQ(metadata_calls, kFileCount);
+  ASSERT_EQ(mbo_records.size(), kFileCount * kRecordCount);
+  for (std::size_t i = 0; i < mbo_records.size(); ++i) {
+    ASSERT_EQ(mbo_records[i].ts_recv.time_since_epoch().count(),
+              static_cast<std::int64_t>(i));
+  }
+}
+
 TEST_F(HistoricalTests, TestMetadataListPublishers) {
   const nlohmann::json kResp{
       {{"publisher_id", 1},
@@ -567,6 +826,116 @@ TEST_F(HistoricalTests, TestMetadataGetCost_Full) {
   ASSERT_DOUBLE_EQ(res, kResp);
 }
 
+TEST_F(HistoricalTests, TestMetadataGetCostBatch) {
+  const nlohmann::json kResp = 0.25;
+  mock_server_.MockPostJson("/v0/metadata.get_cost",
+                            {{"dataset", dataset::kGlbxMdp3},
+                             {"symbols", "ESZ3"},
+                             {"mode", "historical-streaming"},
+                             {"schema", "mbp-1"},
+                             {"stype_in", "raw_symbol"}},
+                            kResp);
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target =
+      databento::HistoricalBuilder{}
+          .SetLogReceiver(&logger_)
+          .SetKey(kApiKey)
+          .SetAddress("localhost", static_cast<std::uint16_t>(port))
+          .SetMaxConnections(2)
+          .Build();
+  const MetadataQuery query{dataset::kGlbxMdp3,
+                            {UnixNanos{std::chrono::hours{1}},
+                             UnixNanos{std::chrono::hours{2}}},
+                            {"ESZ3"},
+                            Schema::Mbp1};
+  auto futures = target.MetadataGetCostBatch(std::vector<MetadataQuery>(5, query));
+  ASSERT_EQ(futures.size(), 5);
+  for (auto& future : futures) {
+    EXPECT_DOUBLE_EQ(future.get(), kResp);
+  }
+}
+
+TEST_F(HistoricalTests, TestMetadataGetRecordCountBatch_Error) {
+  mock_server_.MockBadPostRequest("/v0/metadata.get_record_count",
+                                  {{"detail", "Invalid symbol"}});
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target = Client(port);
+  const MetadataQuery query{
+      dataset::kGlbxMdp3, {UnixNanos{}, UnixNanos{}}, {"ESZ3"}, Schema::Trades};
+  auto futures = target.MetadataGetRecordCountBatch({query});
+  ASSERT_EQ(futures.size(), 1);
+  EXPECT_THROW(futures[0].get(), HttpResponseError);
+}
+
+TEST_F(HistoricalTests, TestMetadataPlanRequests) {
+  mock_server_.MockPostJson("/v0/metadata.get_billable_size",
+                            {{"dataset", dataset::kGlbxMdp3}, {"schema", "trades"}},
+                            100);
+  mock_server_.MockPostJson("/v0/metadata.get_record_count",
+                            {{"dataset", dataset::kGlbxMdp3}, {"schema", "trades"}},
+                            10);
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target = Client(port);
+  const MetadataQuery query{dataset::kGlbxMdp3,
+                            {UnixNanos{std::chrono::hours{0}},
+                             UnixNanos{std::chrono::hours{4}}},
+                            {"ESZ3", "NQZ3", "RTYZ3"},
+                            Schema::Trades};
+  RequestPlanOptions options;
+  options.max_request_size = 250;
+  options.max_symbols = 2;
+  options.num_slices = 4;
+  const auto res = target.MetadataPlanRequests(query, options);
+  // Pairs of slices are combined for each chunk of symbols
+  ASSERT_EQ(res.size(), 4);
+  for (std::size_t i = 0; i < res.size(); ++i) {
+    const std::chrono::hours start{i % 2 == 0 ? 0 : 2};
+    EXPECT_EQ(res[i].billable_size, 200);
+    EXPECT_EQ(res[i].record_count, 20);
+    EXPECT_EQ(res[i].datetime_range.start, UnixNanos{start});
+    EXPECT_EQ(res[i].datetime_range.end, UnixNanos{start + std::chrono::hours{2}});
+  }
+  EXPECT_EQ(res[0].symbols, (std::vector<std::string>{"ESZ3", "NQZ3"}));
+  EXPECT_EQ(res[3].symbols, std::vector<std::string>{"RTYZ3"});
+}
+
+TEST_F(HistoricalTests, TestMetadataPlanRequests_Refinement) {
+  mock_server_.MockPostJson("/v0/metadata.get_billable_size", {}, 100);
+  mock_server_.MockPostJson("/v0/metadata.get_record_count", {}, 10);
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target = Client(port);
+  const MetadataQuery query{
+      dataset::kGlbxMdp3,
+      {UnixNanos{std::chrono::hours{0}}, UnixNanos{std::chrono::hours{4}}},
+      {"ESZ3"},
+      Schema::Trades};
+  RequestPlanOptions options;
+  options.max_request_size = 50;
+  options.num_slices = 1;
+  options.max_refinements = 1;
+  const auto res = target.MetadataPlanRequests(query, options);
+  // The oversized slice is divided once, and each part still exceeds the
+  // maximum so they aren't combined
+  ASSERT_EQ(res.size(), 2);
+  EXPECT_EQ(res[0].datetime_range.start, UnixNanos{std::chrono::hours{0}});
+  EXPECT_EQ(res[0].datetime_range.end, UnixNanos{std::chrono::hours{2}});
+  EXPECT_EQ(res[1].datetime_range.start, UnixNanos{std::chrono::hours{2}});
+  EXPECT_EQ(res[1].datetime_range.end, UnixNanos{std::chrono::hours{4}});
+  EXPECT_EQ(res[1].billable_size, 100);
+}
+
+TEST_F(HistoricalTests, TestMetadataPlanRequests_InvalidQuery) {
+  databento::Historical target = Client(mock_server_.ListenOnThread());
+  const MetadataQuery query{
+      dataset::kGlbxMdp3, {UnixNanos{std::chrono::hours{1}}, {}}, {"ESZ3"},
+      Schema::Trades};
+  ASSERT_THROW(target.MetadataPlanRequests(query, {}), InvalidArgumentError);
+}
+
 TEST_F(HistoricalTests, TestSymbologyResolve) {
   const nlohmann::json kResp{
       {"result",
@@ -614,6 +983,180 @@ TEST_F(HistoricalTests, TestSymbologyResolve) {
   EXPECT_EQ(esm2_mapping.symbol, "3403");
 }
 
+TEST_F(HistoricalTests, TestSymbologyCache) {
+  const auto resp = [](const char* d0, const char* d1, const char* symbol) {
+    return nlohmann::json{
+        {"result", {{"ESM2", {{{"d0", d0}, {"d1", d1}, {"s", symbol}}}}}},
+        {"partial", nlohmann::json::array()},
+        {"not_found", nlohmann::json::array()},
+    };
+  };
+  const auto params = [](const char* start_date, const char* end_date) {
+    return std::map<std::string, std::string>{{"dataset", dataset::kGlbxMdp3},
+                                              {"start_date", start_date},
+                                              {"end_date", end_date},
+                                              {"symbols", "ESM2"},
+                                              {"stype_in", "raw_symbol"},
+                                              {"stype_out", "instrument_id"}};
+  };
+  mock_server_.MockPostJson("/v0/symbology.resolve",
+                            params("2022-06-06", "2022-06-10"),
+                            resp("2022-06-06", "2022-06-10", "3403"));
+  // Only the dates missing from the cache should be requested
+  mock::MockHttpServer ext_server{kApiKey};
+  ext_server.MockPostJson("/v0/symbology.resolve", params("2022-06-10", "2022-06-14"),
+                          resp("2022-06-10", "2022-06-14", "3403"));
+
+  const auto cache_dir = tmp_path_ / "test_symbology_cache";
+  std::filesystem::remove_all(cache_dir);
+  SymbologyCache cache{cache_dir};
+  const TempFile cache_file{cache.CachePath(dataset::kGlbxMdp3, {"ESM2"},
+                                            SType::RawSymbol, SType::InstrumentId)};
+  {
+    auto client = Client(mock_server_.ListenOnThread());
+    const auto res =
+        cache.Resolve(&client, dataset::kGlbxMdp3, {"ESM2"}, SType::RawSymbol,
+                      SType::InstrumentId, date::year{2022} / 6 / 6,
+                      date::year{2022} / 6 / 10);
+    ASSERT_EQ(res.mappings.at("ESM2").size(), 1);
+    EXPECT_TRUE(cache_file.Exists());
+  }
+  {
+    auto client = Client(ext_server.ListenOnThread());
+    const auto res =
+        cache.Resolve(&client, dataset::kGlbxMdp3, {"ESM2"}, SType::RawSymbol,
+                      SType::InstrumentId, date::year{2022} / 6 / 8,
+                      date::year{2022} / 6 / 14);
+    const auto& intervals = res.mappings.at("ESM2");
+    // Adjacent intervals with the same symbol are joined and clipped to the
+    // requested range
+    ASSERT_EQ(intervals.size(), 1);
+    EXPECT_EQ(intervals[0].start_date, date::year{2022} / 6 / 8);
+    EXPECT_EQ(intervals[0].end_date, date::year{2022} / 6 / 14);
+    EXPECT_EQ(intervals[0].symbol, "3403");
+  }
+  // Fully cached, no client requests
+  const auto res = cache.Resolve(nullptr, dataset::kGlbxMdp3, {"ESM2"},
+                                 SType::RawSymbol, SType::InstrumentId,
+                                 date::year{2022} / 6 / 6, date::year{2022} / 6 / 14);
+  ASSERT_EQ(res.mappings.at("ESM2").size(), 1);
+  EXPECT_EQ(res.mappings.at("ESM2")[0].start_date, date::year{2022} / 6 / 6);
+  const auto entry = SymbologyCache::Read(cache_file.Path());
+  ASSERT_TRUE(entry.has_value());
+  EXPECT_EQ(entry->start_date, date::year{2022} / 6 / 6);
+  EXPECT_EQ(entry->end_date, date::year{2022} / 6 / 14);
+}
+
+TEST_F(HistoricalTests, TestSymbologyCacheCorruptFile) {
+  mock_server_.MockPostJson(
+      "/v0/symbology.resolve",
+      {{"dataset", dataset::kGlbxMdp3},
+       {"start_date", "2022-06-06"},
+       {"end_date", "2022-06-10"},
+       {"symbols", "ESM2"},
+       {"stype_in", "raw_symbol"},
+       {"stype_out", "instrument_id"}},
+      {{"result",
+        {{"ESM2", {{{"d0", "2022-06-06"}, {"d1", "2022-06-10"}, {"s", "3403"}}}}}},
+       {"partial", nlohmann::json::array()},
+       {"not_found", nlohmann::json::array()}});
+
+  const auto cache_dir = tmp_path_ / "test_symbology_cache_corrupt_file";
+  std::filesystem::remove_all(cache_dir);
+  SymbologyCache cache{cache_dir};
+  const TempFile cache_file{cache.CachePath(dataset::kGlbxMdp3, {"ESM2"},
+                                            SType::RawSymbol, SType::InstrumentId)};
+  SymbologyCache::Write(cache_file.Path(),
+                        {dataset::kGlbxMdp3,
+                         {"ESM2"},
+                         date::year{2022} / 6 / 6,
+                         date::year{2022} / 6 / 10,
+                         {{}, {}, {}, SType::RawSymbol, SType::InstrumentId}});
+  {
+    // Corrupt the mapping count, which is followed by the partial and not_found
+    // counts, so reading would attempt a huge allocation if unchecked
+    std::fstream file{cache_file.Path(),
+                      std::ios::binary | std::ios::in | std::ios::out | std::ios::ate};
+    file.seekp(-3 * static_cast<std::streamoff>(sizeof(std::uint32_t)), std::ios::end);
+    const auto mapping_count = std::numeric_limits<std::uint32_t>::max();
+    file.write(reinterpret_cast<const char*>(&mapping_count), sizeof(mapping_count));
+  }
+  auto client = Client(mock_server_.ListenOnThread());
+  const auto res = cache.Resolve(&client, dataset::kGlbxMdp3, {"ESM2"},
+                                 SType::RawSymbol, SType::InstrumentId,
+                                 date::year{2022} / 6 / 6, date::year{2022} / 6 / 10);
+  ASSERT_EQ(res.mappings.at("ESM2").size(), 1);
+  EXPECT_EQ(res.mappings.at("ESM2")[0].symbol, "3403");
+  // Replaced with a valid file
+  EXPECT_TRUE(SymbologyCache::Read(cache_file.Path()).has_value());
+}
+
+TEST_F(HistoricalTests, TestTimeseriesCache) {
+  const auto params = [](const char* start, const char* end) {
+    return std::map<std::string, std::string>{
+        {"dataset", dataset::kGlbxMdp3}, {"symbols", "ESH1"}, {"schema", "mbo"},
+        {"start", start},                {"end", end},        {"encoding", "dbn"}};
+  };
+  const UnixNanos start{std::chrono::nanoseconds{1609160400000000000}};
+  const UnixNanos mid{std::chrono::nanoseconds{1609160400000710000}};
+  const UnixNanos end{std::chrono::nanoseconds{1609160400001000000}};
+  // Both responses contain both records, but each segment only replays the
+  // records within its range
+  mock_server_.MockPostDbn("/v0/timeseries.get_range",
+                           params("1609160400000000000", "1609160400000710000"),
+                           TEST_DATA_DIR "/test_data.mbo.v3.dbn.zst");
+  // Only the range missing from the cache should be requested
+  mock::MockHttpServer ext_server{kApiKey};
+  ext_server.MockPostDbn("/v0/timeseries.get_range",
+                         params("1609160400000710000", "1609160400001000000"),
+                         TEST_DATA_DIR "/test_data.mbo.v3.dbn.zst");
+
+  const auto cache_dir = tmp_path_ / "test_timeseries_cache";
+  std::filesystem::remove_all(cache_dir);
+  TimeseriesCache cache{cache_dir};
+  const auto get_range = [&cache](Historical* client,
+                                  const DateTimeRange<UnixNanos>& datetime_range) {
+    std::vector<MboMsg> records;
+    cache.GetRange(
+        client, dataset::kGlbxMdp3, datetime_range, {"ESH1"}, Schema::Mbo,
+        SType::RawSymbol, SType::InstrumentId,
+        [&datetime_range](Metadata&& metadata) {
+          EXPECT_EQ(metadata.start, datetime_range.start);
+          EXPECT_EQ(metadata.end, datetime_range.end);
+        },
+        [&records](const Record& record) {
+          records.emplace_back(record.Get<MboMsg>());
+          return KeepGoing::Continue;
+        });
+    return records;
+  };
+  {
+    auto client = Client(mock_server_.ListenOnThread());
+    const auto records = get_range(&client, {start, mid});
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records[0].ts_recv.time_since_epoch().count(), 1609160400000704060);
+  }
+  {
+    auto client = Client(ext_server.ListenOnThread());
+    const auto records = get_range(&client, {start, end});
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(records[0].ts_recv.time_since_epoch().count(), 1609160400000704060);
+    EXPECT_EQ(records[1].ts_recv.time_since_epoch().count(), 1609160400000711344);
+  }
+  // Fully cached, no client requests
+  EXPECT_EQ(get_range(nullptr, {start, end}).size(), 2);
+  const auto subrange = get_range(
+      nullptr, {UnixNanos{std::chrono::nanoseconds{1609160400000705000}}, end});
+  ASSERT_EQ(subrange.size(), 1);
+  EXPECT_EQ(subrange[0].ts_recv.time_since_epoch().count(), 1609160400000711344);
+  EXPECT_EQ(TimeseriesCache::ListSegments(
+                cache.CacheDir(dataset::kGlbxMdp3, {"ESH1"}, Schema::Mbo,
+                               SType::RawSymbol, SType::InstrumentId))
+                .size(),
+            2);
+  std::filesystem::remove_all(cache_dir);
+}
+
 TEST_F(HistoricalTests, TestTimeseriesGetRange_Basic) {
   mock_server_.MockPostDbn("/v0/timeseries.get_range",
                            {{"dataset", dataset::kGlbxMdp3},
@@ -794,6 +1337,212 @@ TEST_F(HistoricalTests, TestTimeseriesGetRange_UnreadBytes) {
   ASSERT_EQ(logger_.CallCount(), 1);
 }
 
+TEST_F(HistoricalTests, TestTimeseriesGetRangeBuffered) {
+  Mbp1Msg mbp1{RecordHeader{sizeof(Mbp1Msg) / kRecordHeaderLengthMultiplier,
+                            RType::Mbp1,
+                            static_cast<std::uint16_t>(Publisher::IfusImpactIfus),
+                            10005,
+                            {}}};
+  constexpr auto kRecordCount = 50'000;
+  mock_server_.MockPostDbn("/v0/timeseries.get_range",
+                           {{"dataset", ToString(Dataset::IfusImpact)}},
+                           Record{&mbp1.hd}, kRecordCount, 75'000);
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target = Client(port);
+  std::size_t counter = 0;
+  const auto stats = target.TimeseriesGetRangeBuffered(
+      ToString(Dataset::IfusImpact), {"2024-05", "2025-05"}, kAllSymbols,
+      Schema::Mbp1, SType::RawSymbol, SType::InstrumentId, {}, {2, 4096}, {},
+      [&counter, &mbp1](const Record& record) {
+        ++counter;
+        EXPECT_TRUE(record.Holds<Mbp1Msg>());
+        EXPECT_EQ(record.Get<Mbp1Msg>(), mbp1);
+        return KeepGoing::Continue;
+      });
+  EXPECT_EQ(counter, kRecordCount);
+  EXPECT_GT(stats.bytes_received, 0);
+  EXPECT_GT(stats.buffers_decoded, 0);
+  EXPECT_LE(stats.max_queue_depth, 2);
+}
+
+TEST_F(HistoricalTests, TestTimeseriesGetRangeBuffered_Cancellation) {
+  mock_server_.MockPostDbn("/v0/timeseries.get_range", {},
+                           TEST_DATA_DIR "/test_data.mbo.v3.dbn.zst");
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target = Client(port);
+  std::uint32_t call_count = 0;
+  target.TimeseriesGetRangeBuffered(
+      dataset::kGlbxMdp3,
+      {UnixNanos{std::chrono::nanoseconds{1609160400000711344}},
+       UnixNanos{std::chrono::nanoseconds{1609160800000711344}}},
+      {"ESH1"}, Schema::Mbo, SType::RawSymbol, SType::InstrumentId, 2, {},
+      [](Metadata&&) {},
+      [&call_count](const Record&) {
+        ++call_count;
+        return KeepGoing::Stop;
+      });
+  ASSERT_EQ(call_count, 1);
+}
+
+TEST_F(HistoricalTests, TestTimeseriesGetRangeBuffered_CallbackException) {
+  mock_server_.MockPostDbn("/v0/timeseries.get_range", {},
+                           TEST_DATA_DIR "/test_data.mbo.v3.dbn.zst");
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target = Client(port);
+  ASSERT_THROW(target.TimeseriesGetRangeBuffered(
+                   dataset::kGlbxMdp3,
+                   {UnixNanos{std::chrono::nanoseconds{1609160400000711344}},
+                    UnixNanos{std::chrono::nanoseconds{1609160800000711344}}},
+                   {"ESH1"}, Schema::Mbo, SType::RawSymbol, SType::InstrumentId, 2, {},
+                   [](Metadata&&) { throw std::logic_error{"Test failure"}; },
+                   [](const Record&) { return KeepGoing::Continue; }),
+               std::logic_error);
+}
+
+TEST_F(HistoricalTests, TestTimeseriesGetRangeSplit) {
+  Mbp1Msg mbp1{RecordHeader{sizeof(Mbp1Msg) / kRecordHeaderLengthMultiplier,
+                            RType::Mbp1,
+                            static_cast<std::uint16_t>(Publisher::IfusImpactIfus),
+                            10005,
+                            {}}};
+  constexpr auto kRecordCount = 10'000;
+  constexpr std::size_t kNumSplits = 3;
+  // Every sub-request receives the same response
+  mock_server_.MockPostDbn("/v0/timeseries.get_range",
+                           {{"dataset", ToString(Dataset::IfusImpact)},
+                            {"symbols", "ALL_SYMBOLS"},
+                            {"schema", "mbp-1"}},
+                           Record{&mbp1.hd}, kRecordCount, 75'000);
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target = Client(port);
+  const DateTimeRange<UnixNanos> datetime_range{
+      UnixNanos{std::chrono::nanoseconds{1609160400000711344}},
+      UnixNanos{std::chrono::nanoseconds{1609160800000711344}}};
+  std::size_t metadata_calls = 0;
+  std::size_t counter = 0;
+  target.TimeseriesGetRangeSplit(
+      ToString(Dataset::IfusImpact), datetime_range, kAllSymbols, Schema::Mbp1,
+      SType::RawSymbol, SType::InstrumentId,
+      // Small buffer to exercise backpressure
+      {kNumSplits, 4096},
+      [&metadata_calls, &datetime_range](Metadata&& metadata) {
+        ++metadata_calls;
+        EXPECT_EQ(metadata.start, datetime_range.start);
+        EXPECT_EQ(metadata.end, datetime_range.end);
+      },
+      [&counter, &mbp1](const Record& record) {
+        ++counter;
+        EXPECT_TRUE(record.Holds<Mbp1Msg>());
+        EXPECT_EQ(record.Get<Mbp1Msg>(), mbp1);
+        return KeepGoing::Continue;
+      });
+  EXPECT_EQ(metadata_calls, 1);
+  EXPECT_EQ(counter, kRecordCount * kNumSplits);
+}
+
+TEST_F(HistoricalTests, TestTimeseriesGetRangeSplit_Cancellation) {
+  Mbp1Msg mbp1{RecordHeader{sizeof(Mbp1Msg) / kRecordHeaderLengthMultiplier,
+                            RType::Mbp1,
+                            static_cast<std::uint16_t>(Publisher::IfusImpactIfus),
+                            10005,
+                            {}}};
+  mock_server_.MockPostDbn("/v0/timeseries.get_range", {}, Record{&mbp1.hd}, 50'000,
+                           75'000);
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target = Client(port);
+  std::size_t counter = 0;
+  target.TimeseriesGetRangeSplit(
+      ToString(Dataset::IfusImpact),
+      {UnixNanos{std::chrono::nanoseconds{1609160400000711344}},
+       UnixNanos{std::chrono::nanoseconds{1609160800000711344}}},
+      kAllSymbols, Schema::Mbp1, SType::RawSymbol, SType::InstrumentId, {4, 4096},
+      {}, [&counter](const Record&) {
+        ++counter;
+        return counter == 5 ? KeepGoing::Stop : KeepGoing::Continue;
+      });
+  EXPECT_EQ(counter, 5);
+}
+
+TEST_F(HistoricalTests, TestTimeseriesGetRangeSplit_InvalidRange) {
+  databento::Historical target = Client(mock_server_.ListenOnThread());
+  ASSERT_THROW(target.TimeseriesGetRangeSplit(
+                   dataset::kGlbxMdp3,
+                   {UnixNanos{std::chrono::nanoseconds{1609160400000711344}}, {}},
+                   {"ESH1"}, Schema::Mbo, SType::RawSymbol, SType::InstrumentId, {},
+                   {}, [](const Record&) { return KeepGoing::Continue; }),
+               InvalidArgumentError);
+}
+
+TEST_F(HistoricalTests, TestHistoricalAsync) {
+  mock_server_.MockPostJson("/v0/metadata.get_record_count",
+                            {{"dataset", dataset::kGlbxMdp3},
+                             {"symbols", "ESH1"},
+                             {"schema", "mbo"}},
+                            42);
+  mock_server_.MockPostDbn("/v0/timeseries.get_range", {},
+                           TEST_DATA_DIR "/test_data.mbo.v3.dbn.zst");
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical historical = Client(port);
+  HistoricalAsync target{&historical, 2};
+  const DateTimeRange<UnixNanos> range{
+      UnixNanos{std::chrono::nanoseconds{1609160400000711344}},
+      UnixNanos{std::chrono::nanoseconds{1609160800000711344}}};
+  auto count = target.MetadataGetRecordCount(dataset::kGlbxMdp3, range, {"ESH1"},
+                                             Schema::Mbo);
+  std::vector<MboMsg> mbo_records;
+  auto done = target.TimeseriesGetRange(
+      dataset::kGlbxMdp3, range, {"ESH1"}, Schema::Mbo, SType::RawSymbol,
+      SType::InstrumentId, {}, {}, [&mbo_records](const Record& record) {
+        mbo_records.emplace_back(record.Get<MboMsg>());
+        return KeepGoing::Continue;
+      });
+  EXPECT_EQ(count.get(), 42);
+  done.get();
+  EXPECT_EQ(mbo_records.size(), 2);
+}
+
+TEST_F(HistoricalTests, TestHistoricalAsync_Cancellation) {
+  mock_server_.MockPostDbn("/v0/timeseries.get_range", {},
+                           TEST_DATA_DIR "/test_data.mbo.v3.dbn.zst");
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical historical = Client(port);
+  HistoricalAsync target{&historical, 1};
+  CancellationToken token;
+  std::uint32_t call_count = 0;
+  auto done = target.TimeseriesGetRange(
+      dataset::kGlbxMdp3,
+      {UnixNanos{std::chrono::nanoseconds{1609160400000711344}},
+       UnixNanos{std::chrono::nanoseconds{1609160800000711344}}},
+      {"ESH1"}, Schema::Mbo, SType::RawSymbol, SType::InstrumentId, {}, {},
+      [&call_count, token](const Record&) mutable {
+        ++call_count;
+        token.Cancel();
+        return KeepGoing::Continue;
+      },
+      token);
+  done.get();
+  // Stops after the first record, even though there are two records in the file
+  EXPECT_EQ(call_count, 1);
+}
+
+TEST_F(HistoricalTests, TestHistoricalAsync_CancelledBeforeStart) {
+  databento::Historical historical = Client(mock_server_.ListenOnThread());
+  HistoricalAsync target{&historical};
+  CancellationToken token;
+  token.Cancel();
+  auto res = target.SymbologyResolve(dataset::kGlbxMdp3, {"ESM2"}, SType::RawSymbol,
+                                     SType::InstrumentId,
+                                     {"2022-06-06", "2022-06-10"}, token);
+  EXPECT_THROW(res.get(), Exception);
+}
+
 TEST_F(HistoricalTests, TestTimeseriesGetRangeToFile) {
   mock_server_.MockPostDbn("/v0/timeseries.get_range",
                            {{"dataset", dataset::kGlbxMdp3},
@@ -845,6 +1594,11 @@ TEST(HistoricalBuilderTests, TestMissingKey) {
   ASSERT_THROW(databento::HistoricalBuilder().Build(), Exception);
 }
 
+TEST(HistoricalBuilderTests, TestZeroMaxConnections) {
+  ASSERT_THROW(databento::HistoricalBuilder().SetMaxConnections(0),
+               InvalidArgumentError);
+}
+
 TEST(HistoricalBuilderTests, TestSetKeyFromEnv) {
   constexpr auto kKey = "SECRET_KEY";
   ASSERT_EQ(::setenv("DATABENTO_API_KEY", kKey, 1), 0)
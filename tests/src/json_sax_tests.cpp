@@ -0,0 +1,158 @@
+#include <date/date.h>
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <string>
+
+#include "databento/batch.hpp"
+#include "databento/detail/json_sax.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+
+namespace databento::detail::tests {
+constexpr auto kEndpoint = "Test";
+
+TEST(JsonSaxTests, TestSymbologyResolution) {
+  const auto json = R"({
+    "result": {
+      "ESM2": [{"d0": "2022-06-06", "d1": "2022-06-08", "s": "3403"},
+               {"d0": "2022-06-08", "d1": "2022-06-10", "s": "3404"}],
+      "NQM2": [{"s": "3405", "d1": "2022-06-10", "d0": "2022-06-06", "extra": [1, {}]}]
+    },
+    "symbols": ["ESM2", "NQM2", "ZZZZ", "YYYY"],
+    "stype_in": "raw_symbol",
+    "partial": ["NQM2"],
+    "not_found": ["ZZZZ", "YYYY"],
+    "message": "OK",
+    "status": 0
+  })";
+  SymbologyResolutionSax target{kEndpoint, SType::RawSymbol, SType::InstrumentId};
+  ASSERT_TRUE(nlohmann::json::sax_parse(json, &target));
+  const auto& res = target.Result();
+  EXPECT_EQ(res.stype_in, SType::RawSymbol);
+  EXPECT_EQ(res.stype_out, SType::InstrumentId);
+  ASSERT_EQ(res.mappings.size(), 2);
+  const auto& esm2 = res.mappings.at("ESM2");
+  ASSERT_EQ(esm2.size(), 2);
+  EXPECT_EQ(esm2[0].start_date, date::year{2022} / 6 / 6);
+  EXPECT_EQ(esm2[0].end_date, date::year{2022} / 6 / 8);
+  EXPECT_EQ(esm2[0].symbol, "3403");
+  EXPECT_EQ(esm2[1].start_date, date::year{2022} / 6 / 8);
+  EXPECT_EQ(esm2[1].symbol, "3404");
+  const auto& nqm2 = res.mappings.at("NQM2");
+  ASSERT_EQ(nqm2.size(), 1);
+  EXPECT_EQ(nqm2[0].start_date, date::year{2022} / 6 / 6);
+  EXPECT_EQ(nqm2[0].end_date, date::year{2022} / 6 / 10);
+  EXPECT_EQ(nqm2[0].symbol, "3405");
+  EXPECT_EQ(res.partial, std::vector<std::string>{"NQM2"});
+  EXPECT_EQ(res.not_found, (std::vector<std::string>{"ZZZZ", "YYYY"}));
+}
+
+TEST(JsonSaxTests, TestSymbologyResolutionErrors) {
+  const auto parse = [](const char* json) {
+    SymbologyResolutionSax target{kEndpoint, SType::RawSymbol, SType::InstrumentId};
+    nlohmann::json::sax_parse(json, &target);
+  };
+  EXPECT_THROW(parse("[]"), JsonResponseError);
+  EXPECT_THROW(parse(R"({"result": {}, "partial": []})"), JsonResponseError);
+  EXPECT_THROW(parse(R"({"result": [], "partial": [], "not_found": []})"),
+               JsonResponseError);
+  EXPECT_THROW(
+      parse(R"({"result": {"A": [{"d0": "2022-13-01", "d1": "2022-06-10", "s": "1"}]},
+               "partial": [], "not_found": []})"),
+      JsonResponseError);
+  EXPECT_THROW(parse(R"({"result": {"A": [{"d0": "2022-06-01", "s": "1"}]},
+                         "partial": [], "not_found": []})"),
+               JsonResponseError);
+  EXPECT_THROW(parse(R"({"result": {}, "partial": [1], "not_found": []})"),
+               JsonResponseError);
+  EXPECT_THROW(parse(R"({"result": {})"), JsonResponseError);
+}
+
+TEST(JsonSaxTests, TestBatchJobs) {
+  nlohmann::json job{{"actual_size", 2022690},
+                     {"billed_size", 5156064},
+                     {"compression", "zstd"},
+                     {"cost_usd", 0.119089},
+                     {"dataset", "GLBX.MDP3"},
+                     {"delivery", "download"},
+                     {"encoding", "dbn"},
+                     {"end", "2022-09-27 00:00:00+00:00"},
+                     {"id", "CKXF"},
+                     {"limit", nullptr},
+                     {"package_size", 2026761},
+                     {"packaging", nullptr},
+                     {"pretty_px", false},
+                     {"pretty_ts", false},
+                     {"map_symbols", true},
+                     {"progress", {{"nested", {1, 2}}}},
+                     {"record_count", 107418},
+                     {"schema", "trades"},
+                     {"split_duration", nullptr},
+                     {"split_size", nullptr},
+                     {"split_symbols", false},
+                     {"start", "2022-08-26 00:00:00+00:00"},
+                     {"state", "done"},
+                     {"stype_in", "raw_symbol"},
+                     {"stype_out", "instrument_id"},
+                     {"symbols", "GEZ2"},
+                     {"ts_expiration", "2022-11-30 15:27:10.148788+00:00"},
+                     {"ts_process_done", "2022-10-31 15:27:10.148788+00:00"},
+                     {"ts_process_start", "2022-10-31 15:27:08.018759+00:00"},
+                     {"ts_queued", "2022-10-31 15:26:58.654241+00:00"},
+                     {"ts_received", "2022-10-31 15:26:58.112496+00:00"},
+                     {"user_id", "A_USER"}};
+  nlohmann::json job2 = job;
+  job2["id"] = "8UPL";
+  job2["symbols"] = {"GEZ2", "GEH3"};
+  job2["compression"] = nullptr;
+  job2["split_duration"] = "week";
+
+  BatchJobsSax target{kEndpoint};
+  ASSERT_TRUE(nlohmann::json::sax_parse(nlohmann::json{job, job2}.dump(), &target));
+  const auto& res = target.Result();
+  ASSERT_EQ(res.size(), 2);
+  EXPECT_EQ(res[0].id, "CKXF");
+  EXPECT_EQ(res[0].user_id, "A_USER");
+  EXPECT_DOUBLE_EQ(res[0].cost_usd, 0.119089);
+  EXPECT_EQ(res[0].symbols, std::vector<std::string>{"GEZ2"});
+  EXPECT_EQ(res[0].stype_in, SType::RawSymbol);
+  EXPECT_EQ(res[0].schema, Schema::Trades);
+  EXPECT_EQ(res[0].limit, 0);
+  EXPECT_EQ(res[0].compression, Compression::Zstd);
+  EXPECT_TRUE(res[0].map_symbols);
+  EXPECT_EQ(res[0].split_duration, SplitDuration::None);
+  EXPECT_EQ(res[0].delivery, Delivery::Download);
+  EXPECT_EQ(res[0].record_count, 107418);
+  EXPECT_EQ(res[0].state, JobState::Done);
+  EXPECT_EQ(res[0].ts_expiration, "2022-11-30 15:27:10.148788+00:00");
+  EXPECT_EQ(res[1].id, "8UPL");
+  EXPECT_EQ(res[1].symbols, (std::vector<std::string>{"GEZ2", "GEH3"}));
+  EXPECT_EQ(res[1].compression, Compression::None);
+  EXPECT_EQ(res[1].split_duration, SplitDuration::Week);
+  // A single job object is parsed with the same field mapping. Round trip
+  // through a string so numbers are unsigned as in a response
+  EXPECT_EQ(ToString(ParseBatchJob(kEndpoint, nlohmann::json::parse(job.dump()))),
+            ToString(res[0]));
+  EXPECT_EQ(ToString(ParseBatchJob(kEndpoint, nlohmann::json::parse(job2.dump()))),
+            ToString(res[1]));
+}
+
+TEST(JsonSaxTests, TestBatchJobsErrors) {
+  const auto parse = [](const std::string& json) {
+    BatchJobsSax target{kEndpoint};
+    nlohmann::json::sax_parse(json, &target);
+  };
+  EXPECT_THROW(parse("{}"), JsonResponseError);
+  EXPECT_THROW(parse("[1]"), JsonResponseError);
+  // Missing keys
+  EXPECT_THROW(parse(R"([{"id": "CKXF"}])"), JsonResponseError);
+  EXPECT_THROW(parse(R"([{"pretty_px": "false"}])"), JsonResponseError);
+  EXPECT_THROW(parse("[{"), JsonResponseError);
+  EXPECT_THROW(ParseBatchJob(kEndpoint, nlohmann::json::array()), JsonResponseError);
+  EXPECT_THROW(ParseBatchJob(kEndpoint, {{"id", "CKXF"}}), JsonResponseError);
+  BatchJobsSax target{kEndpoint};
+  ASSERT_TRUE(nlohmann::json::sax_parse("[]", &target));
+  EXPECT_TRUE(target.Result().empty());
+}
+}  // namespace databento::detail::tests
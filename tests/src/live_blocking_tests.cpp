@@ -17,6 +17,7 @@
 #include "databento/exceptions.hpp"
 #include "databento/live.hpp"
 #include "databento/live_blocking.hpp"
+#include "databento/live_latency.hpp"
 #include "databento/live_subscription.hpp"
 #include "databento/log.hpp"
 #include "databento/record.hpp"
@@ -426,6 +427,50 @@ TEST_F(LiveBlockingTests, TestNextRecordWithTsOut) {
   }
 }
 
+TEST_F(LiveBlockingTests, TestNextRecordLatencyStats) {
+  const auto kRecCount = 5;
+  constexpr auto kTsOut = true;
+  const WithTsOut<TradeMsg> send_rec{
+      {DummyHeader<TradeMsg>(RType::Mbp0),
+       1,
+       2,
+       Action::Add,
+       Side::Ask,
+       {},
+       1,
+       UnixNanos{std::chrono::seconds{1678910279}},
+       {},
+       2},
+      UnixNanos{std::chrono::seconds{1678910280}}};
+  const mock::MockLsgServer mock_server{
+      dataset::kXnasItch, kTsOut, [send_rec, kRecCount](mock::MockLsgServer& self) {
+        self.Accept();
+        self.Authenticate();
+        for (size_t i = 0; i < kRecCount; ++i) {
+          self.SendRecord(send_rec);
+        }
+      }};
+
+  LiveLatencyStats latency_stats;
+  LiveBlocking target = builder_.SetDataset(dataset::kXnasItch)
+                            .SetSendTsOut(kTsOut)
+                            .SetLatencyStats(&latency_stats)
+                            .SetAddress(kLocalhost, mock_server.Port())
+                            .BuildBlocking();
+  EXPECT_EQ(target.LatencyStats(), &latency_stats);
+  for (size_t i = 0; i < kRecCount; ++i) {
+    const auto rec = target.NextRecord();
+    ASSERT_TRUE(rec.Holds<WithTsOut<TradeMsg>>()) << "Failed on call " << i;
+  }
+  EXPECT_EQ(latency_stats.TsOutLatency().Count(), kRecCount);
+  EXPECT_EQ(latency_stats.TsRecvLatency().Count(), kRecCount);
+  // Local receive time is after the timestamps in the record
+  EXPECT_GT(latency_stats.TsRecvLatency().Min(), latency_stats.TsOutLatency().Max());
+  const auto* entry = latency_stats.Find(RType::Mbp0, 1);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->ts_out_latency.Count(), kRecCount);
+}
+
 TEST_F(LiveBlockingTests, TestStop) {
   constexpr auto kTsOut = true;
   const WithTsOut<TradeMsg> send_rec{
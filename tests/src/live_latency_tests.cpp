@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+
+#include "databento/datetime.hpp"
+#include "databento/enums.hpp"
+#include "databento/live_latency.hpp"
+#include "databento/record.hpp"
+#include "databento/with_ts_out.hpp"
+
+namespace databento::tests {
+TEST(LatencyHistogramTests, TestBucketIndex) {
+  // Small values are exact
+  for (std::uint64_t i = 0; i < LatencyHistogram::kSubBucketCount; ++i) {
+    EXPECT_EQ(LatencyHistogram::BucketIndex(i), i);
+    EXPECT_EQ(LatencyHistogram::BucketUpperBound(i), i);
+  }
+  EXPECT_EQ(LatencyHistogram::BucketIndex(64), 64);
+  EXPECT_EQ(LatencyHistogram::BucketIndex(65), 64);
+  EXPECT_EQ(LatencyHistogram::BucketUpperBound(64), 65);
+  EXPECT_EQ(LatencyHistogram::BucketIndex(66), 65);
+  EXPECT_EQ(LatencyHistogram::BucketIndex(UINT64_MAX),
+            LatencyHistogram::kBucketCount - 1);
+  EXPECT_EQ(LatencyHistogram::BucketUpperBound(LatencyHistogram::kBucketCount - 1),
+            UINT64_MAX);
+  // Every value is at most its bucket's upper bound and above the previous
+  // bucket's
+  for (std::uint64_t value = 1; value < std::uint64_t{1} << 40; value = value * 3 + 1) {
+    const auto index = LatencyHistogram::BucketIndex(value);
+    EXPECT_LE(value, LatencyHistogram::BucketUpperBound(index));
+    EXPECT_GT(value, LatencyHistogram::BucketUpperBound(index - 1));
+    // Relative error below 1/32
+    EXPECT_LT(LatencyHistogram::BucketUpperBound(index) - value, value / 32 + 1);
+  }
+}
+
+TEST(LatencyHistogramTests, TestPercentiles) {
+  LatencyHistogram target;
+  EXPECT_EQ(target.Count(), 0);
+  EXPECT_EQ(target.Percentile(0.5), std::chrono::nanoseconds{});
+  EXPECT_EQ(target.Min(), std::chrono::nanoseconds{});
+  for (int i = 1; i <= 100; ++i) {
+    target.Add(std::chrono::microseconds{i});
+  }
+  EXPECT_EQ(target.Count(), 100);
+  EXPECT_EQ(target.Min(), std::chrono::microseconds{1});
+  EXPECT_EQ(target.Max(), std::chrono::microseconds{100});
+  EXPECT_EQ(target.Mean(), std::chrono::nanoseconds{50500});
+  const auto p50 = target.Percentile(0.5);
+  EXPECT_GE(p50, std::chrono::microseconds{50});
+  EXPECT_LT(p50, std::chrono::nanoseconds{50000 + 50000 / 32});
+  const auto p99 = target.Percentile(0.99);
+  EXPECT_GE(p99, std::chrono::microseconds{99});
+  EXPECT_LE(p99, std::chrono::microseconds{100});
+  EXPECT_EQ(target.Percentile(1.0), std::chrono::microseconds{100});
+}
+
+TEST(LatencyHistogramTests, TestNegativeLatency) {
+  LatencyHistogram target;
+  target.Add(std::chrono::nanoseconds{-100});
+  EXPECT_EQ(target.Count(), 1);
+  EXPECT_EQ(target.Max(), std::chrono::nanoseconds{});
+}
+
+TEST(LiveLatencyStatsTests, TestAdd) {
+  constexpr UnixNanos kTsRecv{std::chrono::seconds{1'700'000'000}};
+  constexpr auto kTsOut = kTsRecv + std::chrono::microseconds{10};
+  constexpr auto kLocalRecv = kTsRecv + std::chrono::microseconds{60};
+  const RecordHeader mbo_header{sizeof(MboMsg) / RecordHeader::kLengthMultiplier,
+                                RType::Mbo, 1, 2, kTsRecv - std::chrono::microseconds{5}};
+  WithTsOut<MboMsg> mbo{
+      MboMsg{mbo_header, {}, {}, {}, {}, {}, {}, {}, kTsRecv, {}, {}}, kTsOut};
+  const RecordHeader trade_header{
+      sizeof(TradeMsg) / RecordHeader::kLengthMultiplier, RType::Mbp0, 2, 2, kTsRecv};
+  WithTsOut<TradeMsg> trade{
+      TradeMsg{trade_header, {}, {}, {}, {}, {}, {}, kTsRecv, {}, {}}, kTsOut};
+
+  LiveLatencyStats target;
+  target.Add(Record{&mbo.rec.hd}, true, kLocalRecv);
+  target.Add(Record{&mbo.rec.hd}, true, kLocalRecv);
+  target.Add(Record{&trade.rec.hd}, true, kLocalRecv);
+  target.Add(Record{&trade.rec.hd}, false, kLocalRecv);
+
+  EXPECT_EQ(target.TsRecvLatency().Count(), 4);
+  EXPECT_EQ(target.TsRecvLatency().Max(), std::chrono::microseconds{60});
+  EXPECT_EQ(target.TsOutLatency().Count(), 3);
+  EXPECT_EQ(target.TsOutLatency().Max(), std::chrono::microseconds{50});
+  EXPECT_EQ(target.DroppedEntryCount(), 0);
+
+  const auto entries = target.Entries();
+  ASSERT_EQ(entries.size(), 2);
+  EXPECT_EQ(entries[0]->rtype, RType::Mbp0);
+  EXPECT_EQ(entries[0]->publisher_id, 2);
+  EXPECT_EQ(entries[0]->ts_out_latency.Count(), 1);
+  EXPECT_EQ(entries[0]->ts_recv_latency.Count(), 2);
+  EXPECT_EQ(entries[1]->rtype, RType::Mbo);
+  EXPECT_EQ(entries[1]->publisher_id, 1);
+  EXPECT_EQ(entries[1]->ts_out_latency.Count(), 2);
+  EXPECT_EQ(entries[1], target.Find(RType::Mbo, 1));
+  EXPECT_EQ(target.Find(RType::Mbo, 2), nullptr);
+}
+
+TEST(LiveLatencyStatsTests, TestMaxEntries) {
+  LiveLatencyStats target;
+  // OHLCV records are indexed by `ts_event`
+  RecordHeader header{sizeof(RecordHeader) / RecordHeader::kLengthMultiplier,
+                      RType::Ohlcv1S, 0, 1, UnixNanos{std::chrono::seconds{1}}};
+  for (std::size_t i = 0; i < LiveLatencyStats::kMaxEntries + 10; ++i) {
+    header.publisher_id = static_cast<std::uint16_t>(i);
+    target.Add(Record{&header}, false, UnixNanos{std::chrono::seconds{2}});
+  }
+  EXPECT_EQ(target.Entries().size(), LiveLatencyStats::kMaxEntries);
+  EXPECT_EQ(target.DroppedEntryCount(), 10);
+  EXPECT_EQ(target.TsRecvLatency().Count(), LiveLatencyStats::kMaxEntries + 10);
+  EXPECT_NE(target.Find(RType::Ohlcv1S, 0), nullptr);
+}
+}  // namespace databento::tests
@@ -0,0 +1,354 @@
+// A load generator for benchmarking the live clients offline. It serves
+// synthetic MBO or MBP-10 records, or the records of a DBN file, from a
+// `MockLsgServer` at a configurable rate and reports the throughput and
+// end-to-end latency observed by `LiveBlocking` or `LiveThreaded`. Latency is
+// measured from the `ts_out` the server stamps on each burst when it's sent.
+
+#include <algorithm>  // min, sort
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>  // EXIT_FAILURE, EXIT_SUCCESS, strtoull
+#include <cstring>  // memcpy
+#include <exception>
+#include <iomanip>  // setprecision
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>  // this_thread
+#include <vector>
+
+#include "databento/constants.hpp"  // dataset, kDbnVersion, kSymbolCstrLen
+#include "databento/datetime.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_file_store.hpp"
+#include "databento/enums.hpp"
+#include "databento/live.hpp"
+#include "databento/live_blocking.hpp"
+#include "databento/live_threaded.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+#include "databento/symbology.hpp"  // kAllSymbols
+#include "databento/timeseries.hpp"
+#include "databento/with_ts_out.hpp"
+#include "mock/mock_lsg_server.hpp"
+
+namespace {
+using databento::tests::mock::MockLsgServer;
+
+constexpr auto kKey = "32-character-with-lots-of-filler";
+constexpr auto kLocalhost = "127.0.0.1";
+constexpr auto kDataset = databento::dataset::kGlbxMdp3;
+// The number of distinct synthetic records to cycle through
+constexpr std::size_t kSyntheticRecordCount = 1024;
+
+struct Options {
+  databento::Schema schema{databento::Schema::Mbo};
+  std::string file;
+  std::uint64_t count{1'000'000};
+  // Records per second, 0 to send as fast as possible
+  std::uint64_t rate{};
+  // Records per send
+  std::size_t burst{64};
+  // Whether to split each burst across two packets in the middle of a record
+  bool split{};
+  bool threaded{};
+};
+
+void PrintUsage(const char* program) {
+  std::cerr << "Usage: " << program << " [options]\n"
+            << "  --schema mbo|mbp-10         Synthetic record schema (default mbo)\n"
+            << "  --file PATH                 Replay the records of a DBN file\n"
+            << "  --count N                   Records to send (default 1000000)\n"
+            << "  --rate N                    Records per second, 0 for line rate\n"
+            << "  --burst N                   Records per send (default 64)\n"
+            << "  --split                     Split each burst across two packets\n"
+            << "  --client blocking|threaded  Client to benchmark (default blocking)\n";
+}
+
+std::optional<Options> ParseArgs(int argc, char* argv[]) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg{argv[i]};
+    if (arg == "--split") {
+      options.split = true;
+      continue;
+    }
+    if (i + 1 == argc) {
+      return std::nullopt;
+    }
+    const std::string_view value{argv[++i]};
+    if (arg == "--schema" && value == "mbo") {
+      options.schema = databento::Schema::Mbo;
+    } else if (arg == "--schema" && value == "mbp-10") {
+      options.schema = databento::Schema::Mbp10;
+    } else if (arg == "--file") {
+      options.file = value;
+    } else if (arg == "--count") {
+      options.count = std::strtoull(value.data(), nullptr, 10);
+    } else if (arg == "--rate") {
+      options.rate = std::strtoull(value.data(), nullptr, 10);
+    } else if (arg == "--burst") {
+      options.burst =
+          static_cast<std::size_t>(std::strtoull(value.data(), nullptr, 10));
+    } else if (arg == "--client" && (value == "blocking" || value == "threaded")) {
+      options.threaded = value == "threaded";
+    } else {
+      return std::nullopt;
+    }
+  }
+  if (options.count == 0 || options.burst == 0) {
+    return std::nullopt;
+  }
+  return options;
+}
+
+std::int64_t NowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+// Appends `rec` followed by space for `ts_out`.
+template <typename R>
+void AppendWithTsOut(const R& rec, std::vector<std::string>* records) {
+  const databento::WithTsOut<R> with_ts_out{rec, {}};
+  records->emplace_back(reinterpret_cast<const char*>(&with_ts_out),
+                        sizeof(with_ts_out));
+}
+
+std::vector<std::string> SyntheticRecords(databento::Schema schema) {
+  using databento::Action;
+  using databento::RType;
+  using databento::Side;
+  std::mt19937_64 rng{};
+  std::uniform_int_distribution<std::uint32_t> instrument_id{1, 100};
+  std::uniform_int_distribution<std::int64_t> price_ticks{4'000, 6'000};
+  std::uniform_int_distribution<std::uint32_t> size{1, 500};
+  constexpr std::int64_t kTickSize = 250'000'000;
+  const auto publisher_id =
+      static_cast<std::uint16_t>(databento::Publisher::GlbxMdp3Glbx);
+  std::vector<std::string> records;
+  records.reserve(kSyntheticRecordCount);
+  for (std::size_t i = 0; i < kSyntheticRecordCount; ++i) {
+    const databento::RecordHeader hd{
+        0, schema == databento::Schema::Mbo ? RType::Mbo : RType::Mbp10, publisher_id,
+        instrument_id(rng), databento::UnixNanos{}};
+    const auto side = i % 2 == 0 ? Side::Bid : Side::Ask;
+    const auto price = price_ticks(rng) * kTickSize;
+    if (schema == databento::Schema::Mbo) {
+      AppendWithTsOut(databento::MboMsg{hd,
+                                        i + 1,
+                                        price,
+                                        size(rng),
+                                        {},
+                                        0,
+                                        i % 3 == 0 ? Action::Cancel : Action::Add,
+                                        side,
+                                        {},
+                                        {},
+                                        static_cast<std::uint32_t>(i)},
+                      &records);
+    } else {
+      databento::Mbp10Msg mbp10{hd,
+                                price,
+                                size(rng),
+                                Action::Add,
+                                side,
+                                {},
+                                0,
+                                {},
+                                {},
+                                static_cast<std::uint32_t>(i),
+                                {}};
+      for (std::size_t level = 0; level < mbp10.levels.size(); ++level) {
+        const auto offset = static_cast<std::int64_t>(level) * kTickSize;
+        mbp10.levels[level] = {
+            price - offset, price + kTickSize + offset, size(rng), size(rng), 1, 1};
+      }
+      AppendWithTsOut(mbp10, &records);
+    }
+  }
+  return records;
+}
+
+std::vector<std::string> FileRecords(const std::string& file) {
+  databento::DbnFileStore store{file};
+  std::vector<std::string> records;
+  const databento::Record* record;
+  while ((record = store.NextRecord()) != nullptr) {
+    const auto size = record->Size();
+    std::string rec_str(size + sizeof(databento::UnixNanos), '\0');
+    std::memcpy(rec_str.data(), &record->Header(), size);
+    // Adjust length for `ts_out`
+    reinterpret_cast<databento::RecordHeader*>(rec_str.data())->length =
+        static_cast<std::uint8_t>(rec_str.size() /
+                                  databento::RecordHeader::kLengthMultiplier);
+    records.emplace_back(std::move(rec_str));
+  }
+  return records;
+}
+
+void Serve(MockLsgServer& server, const Options& options,
+           const std::vector<std::string>& records) {
+  server.Accept();
+  server.Authenticate();
+  server.Subscribe(databento::kAllSymbols, options.schema,
+                   databento::SType::RawSymbol, true);
+  server.Start(databento::Metadata{databento::kDbnVersion,
+                                   kDataset,
+                                   {},
+                                   {},
+                                   {},
+                                   0,
+                                   {},
+                                   databento::SType::InstrumentId,
+                                   true,
+                                   databento::kSymbolCstrLen,
+                                   {},
+                                   {},
+                                   {},
+                                   {}});
+  const std::chrono::nanoseconds burst_interval{
+      options.rate == 0
+          ? 0
+          : static_cast<std::int64_t>(1'000'000'000 * options.burst / options.rate)};
+  auto next_burst = std::chrono::steady_clock::now();
+  std::string burst;
+  std::size_t next_record = 0;
+  for (std::uint64_t sent = 0; sent < options.count;) {
+    if (burst_interval.count() > 0) {
+      std::this_thread::sleep_until(next_burst);
+      next_burst += burst_interval;
+    }
+    const auto ts_out = static_cast<std::uint64_t>(NowNanos());
+    const auto burst_count =
+        std::min<std::uint64_t>(options.burst, options.count - sent);
+    burst.clear();
+    for (std::uint64_t i = 0; i < burst_count; ++i) {
+      burst.append(records[next_record]);
+      next_record = (next_record + 1) % records.size();
+      std::memcpy(&burst[burst.size() - sizeof(ts_out)], &ts_out, sizeof(ts_out));
+    }
+    if (options.split) {
+      // Split at an offset that isn't on a record boundary
+      const auto split_at = burst.size() / 2 + 3;
+      server.Send(burst.substr(0, split_at));
+      server.Send(burst.substr(split_at));
+    } else {
+      server.Send(burst);
+    }
+    sent += burst_count;
+  }
+}
+
+// Collects the statistics of the received records.
+class Stats {
+ public:
+  explicit Stats(std::uint64_t count) { latencies_.reserve(count); }
+
+  void OnRecord(const databento::Record& record) {
+    const auto now = NowNanos();
+    if (latencies_.empty()) {
+      first_ = std::chrono::steady_clock::now();
+    }
+    // `ts_out` is always the last field
+    std::int64_t ts_out{};
+    std::memcpy(&ts_out,
+                reinterpret_cast<const std::byte*>(&record.Header()) +
+                    record.Size() - sizeof(ts_out),
+                sizeof(ts_out));
+    latencies_.emplace_back(now - ts_out);
+    bytes_ += record.Size();
+  }
+
+  std::uint64_t Count() const { return latencies_.size(); }
+
+  void Print() {
+    const std::chrono::duration<double> duration{std::chrono::steady_clock::now() -
+                                                 first_};
+    const auto secs = duration.count();
+    std::sort(latencies_.begin(), latencies_.end());
+    const auto percentile = [this](double p) {
+      const auto idx =
+          static_cast<std::size_t>(p * static_cast<double>(latencies_.size() - 1));
+      return static_cast<double>(latencies_[idx]) / 1e3;
+    };
+    const auto bytes = static_cast<double>(bytes_);
+    const auto count = static_cast<double>(Count());
+    std::cout << std::fixed << std::setprecision(1) << "Received " << Count()
+              << " records (" << bytes / 1e6 << " MB) in " << secs * 1e3 << " ms\n"
+              << "Throughput: " << count / secs / 1e6 << " M records/s, "
+              << bytes / secs / 1e6 << " MB/s\n"
+              << "Latency (us): p50 " << percentile(0.5) << ", p90 "
+              << percentile(0.9) << ", p99 " << percentile(0.99) << ", p99.9 "
+              << percentile(0.999) << ", max " << percentile(1.0) << '\n';
+  }
+
+ private:
+  std::chrono::steady_clock::time_point first_;
+  std::vector<std::int64_t> latencies_;
+  std::uint64_t bytes_{};
+};
+
+void RunBlocking(databento::LiveBuilder builder, const Options& options, Stats* stats) {
+  auto client = builder.BuildBlocking();
+  client.Subscribe(databento::kAllSymbols, options.schema,
+                   databento::SType::RawSymbol);
+  client.Start();
+  while (stats->Count() < options.count) {
+    stats->OnRecord(client.NextRecord());
+  }
+}
+
+void RunThreaded(databento::LiveBuilder builder, const Options& options,
+                 Stats* stats) {
+  auto client = builder.BuildThreaded();
+  client.Subscribe(databento::kAllSymbols, options.schema,
+                   databento::SType::RawSymbol);
+  client.Start([stats, &options](const databento::Record& record) {
+    stats->OnRecord(record);
+    return stats->Count() < options.count ? databento::KeepGoing::Continue
+                                          : databento::KeepGoing::Stop;
+  });
+  client.BlockForStop();
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const auto options = ParseArgs(argc, argv);
+  if (!options) {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  try {
+    const auto records = options->file.empty() ? SyntheticRecords(options->schema)
+                                               : FileRecords(options->file);
+    if (records.empty()) {
+      std::cerr << "No records to send\n";
+      return EXIT_FAILURE;
+    }
+    MockLsgServer server{kDataset, true, [&options, &records](MockLsgServer& self) {
+                           Serve(self, *options, records);
+                         }};
+    auto builder = databento::LiveBuilder{}
+                       .SetLogReceiver(databento::ILogReceiver::Default())
+                       .SetKey(kKey)
+                       .SetDataset(kDataset)
+                       .SetSendTsOut(true)
+                       .SetAddress(kLocalhost, server.Port());
+    Stats stats{options->count};
+    if (options->threaded) {
+      RunThreaded(std::move(builder), *options, &stats);
+    } else {
+      RunBlocking(std::move(builder), *options, &stats);
+    }
+    stats.Print();
+  } catch (const std::exception& exc) {
+    std::cerr << "Error: " << exc.what() << '\n';
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
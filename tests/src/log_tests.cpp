@@ -1,7 +1,12 @@
 #include <gmock/gmock.h>
 
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "databento/log.hpp"
 #include "databento/system.hpp"
@@ -51,4 +56,88 @@ TEST(ILogReceiverTests, TestLogPlatformInfo) {
   LogPlatformInfo(&receiver);
   ASSERT_EQ(receiver.CallCount(), 1);
 }
+
+TEST(AsyncLogReceiverTests, TestForwards) {
+  std::vector<std::string> msgs;
+  std::thread::id receive_thread_id;
+  mock::MockLogReceiver downstream{
+      LogLevel::Info, [&](auto, LogLevel level, const std::string& msg) {
+        EXPECT_EQ(level, LogLevel::Warning);
+        receive_thread_id = std::this_thread::get_id();
+        msgs.emplace_back(msg);
+      }};
+  AsyncLogReceiver target{&downstream};
+  EXPECT_FALSE(target.ShouldLog(LogLevel::Debug));
+  EXPECT_TRUE(target.ShouldLog(LogLevel::Warning));
+  target.Receive(LogLevel::Debug, "filtered");
+  const std::string long_msg(AsyncLogReceiver::kMessageCapacity * 2, 'a');
+  for (int i = 0; i < 100; ++i) {
+    target.Receive(LogLevel::Warning, i % 10 == 0 ? long_msg : std::to_string(i));
+  }
+  target.Flush();
+  ASSERT_EQ(msgs.size(), 100);
+  EXPECT_EQ(msgs[0], long_msg);
+  EXPECT_EQ(msgs[1], "1");
+  EXPECT_EQ(msgs[99], "99");
+  EXPECT_NE(receive_thread_id, std::this_thread::get_id());
+  EXPECT_EQ(target.DroppedCount(), 0);
+}
+
+TEST(AsyncLogReceiverTests, TestMultipleProducers) {
+  constexpr int kThreadCount = 4;
+  constexpr int kMsgCount = 1000;
+  std::vector<int> counts(kThreadCount);
+  mock::MockLogReceiver downstream{[&](auto, LogLevel, const std::string& msg) {
+    ++counts[static_cast<std::size_t>(std::stoi(msg))];
+  }};
+  {
+    AsyncLogReceiver target{&downstream, kThreadCount * kMsgCount};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreadCount; ++i) {
+      threads.emplace_back([&target, i] {
+        const auto msg = std::to_string(i);
+        for (int j = 0; j < kMsgCount; ++j) {
+          target.Receive(LogLevel::Info, msg);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    // Destructor forwards remaining messages
+  }
+  for (const auto count : counts) {
+    EXPECT_EQ(count, kMsgCount);
+  }
+}
+
+TEST(AsyncLogReceiverTests, TestDropsWhenFull) {
+  std::mutex mutex;
+  std::vector<std::string> msgs;
+  bool is_blocked = true;
+  std::condition_variable cv;
+  mock::MockLogReceiver downstream{[&](auto, LogLevel, const std::string& msg) {
+    std::unique_lock<std::mutex> lock{mutex};
+    cv.wait(lock, [&is_blocked] { return !is_blocked; });
+    msgs.emplace_back(msg);
+  }};
+  AsyncLogReceiver target{&downstream, 4};
+  // The first message may be taken off the queue before blocking
+  for (int i = 0; i < 10; ++i) {
+    target.Receive(LogLevel::Info, std::to_string(i));
+  }
+  const auto dropped_count = target.DroppedCount();
+  EXPECT_GE(dropped_count, 5U);
+  EXPECT_LE(dropped_count, 6U);
+  {
+    const std::lock_guard<std::mutex> lock{mutex};
+    is_blocked = false;
+    cv.notify_all();
+  }
+  target.Flush();
+  ASSERT_EQ(msgs.size(), 10 - dropped_count + 1);
+  EXPECT_EQ(msgs[0], "0");
+  EXPECT_THAT(msgs.back(), testing::HasSubstr(
+                               "Dropped " + std::to_string(dropped_count) + " log"));
+}
 }  // namespace databento::tests
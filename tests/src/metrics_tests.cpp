@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+
+#include "databento/dbn_file_store.hpp"
+#include "databento/enums.hpp"
+#include "databento/log.hpp"
+#include "databento/metrics.hpp"
+#include "databento/record.hpp"
+#include "mock/mock_log_receiver.hpp"
+
+namespace databento::tests {
+namespace {
+class CountingMetricsSink : public IMetricsSink {
+ public:
+  void Increment(MetricCounter counter, std::uint64_t value) override {
+    counters[static_cast<std::size_t>(counter)] += value;
+  }
+  void OnRecordDecoded(RType rtype) override {
+    ++records[static_cast<std::size_t>(rtype)];
+  }
+
+  std::array<std::atomic<std::uint64_t>, kMetricCounterCount> counters{};
+  std::array<std::atomic<std::uint64_t>, 256> records{};
+};
+}  // namespace
+
+class MetricsTests : public testing::Test {
+ protected:
+  void SetUp() override {
+    if (!MetricsEnabled()) {
+      GTEST_SKIP() << "Built without metrics";
+    }
+    SetMetricsSink(&sink_);
+  }
+  void TearDown() override { SetMetricsSink(nullptr); }
+
+  std::uint64_t Counter(MetricCounter counter) const {
+    return sink_.counters[static_cast<std::size_t>(counter)];
+  }
+
+  CountingMetricsSink sink_;
+  mock::MockLogReceiver logger_ =
+      mock::MockLogReceiver::AssertNoLogs(LogLevel::Warning);
+};
+
+TEST_F(MetricsTests, TestGetMetricsSink) {
+  EXPECT_EQ(GetMetricsSink(), &sink_);
+  SetMetricsSink(nullptr);
+  EXPECT_EQ(GetMetricsSink(), nullptr);
+}
+
+TEST_F(MetricsTests, TestDecode) {
+  DbnFileStore target{TEST_DATA_DIR "/test_data.mbo.v3.dbn.zst"};
+  target.GetMetadata();
+  std::uint64_t record_count = 0;
+  while (target.NextRecord() != nullptr) {
+    ++record_count;
+  }
+  EXPECT_EQ(record_count, 2);
+  EXPECT_EQ(sink_.records[static_cast<std::size_t>(RType::Mbo)], record_count);
+  EXPECT_GT(Counter(MetricCounter::ZstdBytesRead), 0);
+  EXPECT_GT(Counter(MetricCounter::ZstdBytesDecompressed),
+            record_count * sizeof(MboMsg));
+  EXPECT_EQ(Counter(MetricCounter::CompatUpgrades), 0);
+}
+
+TEST_F(MetricsTests, TestDecodeUpgrade) {
+  DbnFileStore target{&logger_, TEST_DATA_DIR "/test_data.definition.v1.dbn.zst",
+                      VersionUpgradePolicy::UpgradeToV3};
+  target.GetMetadata();
+  std::uint64_t record_count = 0;
+  while (target.NextRecord() != nullptr) {
+    ++record_count;
+  }
+  EXPECT_GT(record_count, 0);
+  EXPECT_EQ(sink_.records[static_cast<std::size_t>(RType::InstrumentDef)],
+            record_count);
+  EXPECT_EQ(Counter(MetricCounter::CompatUpgrades), record_count);
+}
+
+TEST(MetricCounterTests, TestToString) {
+  std::ostringstream ss;
+  ss << MetricCounter::LiveReconnects;
+  EXPECT_EQ(ss.str(), "live_reconnects");
+  EXPECT_STREQ(ToString(MetricCounter::TcpBytesRead), "tcp_bytes_read");
+}
+}  // namespace databento::tests
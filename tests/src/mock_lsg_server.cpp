@@ -161,24 +161,27 @@ void MockLsgServer::Subscribe(const std::vector<std::string>& symbols, Schema sc
 }
 
 void MockLsgServer::Start() {
+  Start(Metadata{1,
+                 dataset_,
+                 {},
+                 {},
+                 UnixNanos{std::chrono::nanoseconds{kUndefTimestamp}},
+                 0,
+                 {},
+                 SType::InstrumentId,
+                 false,
+                 kSymbolCstrLenV1,
+                 {},
+                 {},
+                 {},
+                 {}});
+}
+
+void MockLsgServer::Start(const Metadata& metadata) {
   const auto received = Receive();
   EXPECT_EQ(received, "start_session\n");
 
   SocketStream writable{conn_fd_.Get()};
-  Metadata metadata{1,
-                    dataset_,
-                    {},
-                    {},
-                    UnixNanos{std::chrono::nanoseconds{kUndefTimestamp}},
-                    0,
-                    {},
-                    SType::InstrumentId,
-                    false,
-                    kSymbolCstrLenV1,
-                    {},
-                    {},
-                    {},
-                    {}};
   DbnEncoder::EncodeMetadata(metadata, &writable);
 }
 
@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
 
+#include <array>
 #include <chrono>
+#include <cstdint>
 #include <iomanip>
+#include <limits>
 #include <sstream>
 #include <string>
 #include <tuple>
@@ -9,6 +12,7 @@
 
 #include "databento/constants.hpp"
 #include "databento/datetime.hpp"
+#include "databento/exceptions.hpp"
 #include "databento/pretty.hpp"
 
 namespace databento::pretty::tests {
@@ -108,4 +112,61 @@ TEST(PrettyTests, TestPrettyTs) {
     ss.str("");
   }
 }
+
+TEST(PrettyTests, TestFormatPx) {
+  std::vector<std::tuple<std::int64_t, int, std::string>> cases{
+      {-100'000, 6, "-0.000100000"},
+      {1'234'567'890'123, 9, "1234.567890123"},
+      {1'234'567'890'123, 5, "1234.56789"},
+      {1'234'567'890'123, 1, "1234.5"},
+      {1'234'567'890'123, 0, "1234"},
+      {-1'234'567'890'123, 0, "-1234"},
+      {std::numeric_limits<std::int64_t>::min(), 9, "-9223372036.854775808"},
+      {kUndefPrice, 2, "UNDEF_PRICE"}};
+  std::array<char, kMaxPxLen> buf;
+  for (const auto& [num, precision, exp] : cases) {
+    const auto len = FormatPx(num, precision, buf.data());
+    EXPECT_EQ(std::string(buf.data(), len), exp);
+  }
+  EXPECT_EQ(PxToString(32'500'000'000), "32.500000000");
+}
+TEST(PrettyTests, TestParsePx) {
+  const std::vector<std::pair<std::string, std::int64_t>> cases{
+      {"0", 0},
+      {"-0.0001", -100'000},
+      {"32.5", 32'500'000'000},
+      {"101.005000000", 101'005'000'000},
+      {"00012345678.9", 12'345'678'900'000'000},
+      {"0.000000001", 1},
+      {"9223372036.854775806", std::numeric_limits<std::int64_t>::max() - 1},
+      {"-9223372036.854775808", std::numeric_limits<std::int64_t>::min()},
+      {"UNDEF_PRICE", kUndefPrice}};
+  for (const auto& [str, exp] : cases) {
+    EXPECT_EQ(ParsePx(str), exp) << str;
+  }
+  const std::vector<std::int64_t> round_trip_cases{-100'000, 1'234'567'890'123, 0,
+                                                   kUndefPrice};
+  for (const auto px : round_trip_cases) {
+    EXPECT_EQ(ParsePx(PxToString(px)), px);
+  }
+}
+
+TEST(PrettyTests, TestParsePxInvalid) {
+  const std::vector<std::string> cases{"",
+                                       "-",
+                                       ".5",
+                                       "1.",
+                                       "1.2.3",
+                                       "+1",
+                                       "1e9",
+                                       " 1",
+                                       "0.0000000001",
+                                       "9223372036.854775808",
+                                       "-9223372036.854775809",
+                                       "100000000000",
+                                       "12345678901234567890"};
+  for (const auto& str : cases) {
+    EXPECT_THROW(ParsePx(str), InvalidArgumentError) << str;
+  }
+}
 }  // namespace databento::pretty::tests
@@ -2,6 +2,8 @@
 
 #include <chrono>
 #include <cstdint>
+#include <iomanip>
+#include <sstream>
 
 #include "databento/constants.hpp"
 #include "databento/datetime.hpp"  // TimeDeltaNanos, UnixNanos
@@ -296,4 +298,32 @@ TEST(RecordTests, TestImbalanceMsgToString) {
     significant_imbalance = 'N'
 })");
 }
+
+TEST(RecordTests, TestStreamOpRespectsPrecision) {
+  const TradeMsg target{RecordHeader{sizeof(TradeMsg) / RecordHeader::kLengthMultiplier,
+                                     RType::Mbp0, 1, 1, UnixNanos{}},
+                        1'234'567'890'123,
+                        500,
+                        Action::Trade,
+                        Side::Ask,
+                        {},
+                        0,
+                        UnixNanos{},
+                        {},
+                        1};
+  std::ostringstream stream;
+  stream << std::setprecision(2) << target;
+  EXPECT_EQ(stream.str(), R"(TradeMsg {
+    hd = RecordHeader { length = 12, rtype = mbp-0, publisher_id = 1, instrument_id = 1, ts_event = 1970-01-01T00:00:00.000000000Z },
+    price = 1234.56,
+    size = 500,
+    action = Trade,
+    side = Ask,
+    flags = 0,
+    depth = 0,
+    ts_recv = 1970-01-01T00:00:00.000000000Z,
+    ts_in_delta = 0,
+    sequence = 1
+})");
+}
 }  // namespace databento::tests
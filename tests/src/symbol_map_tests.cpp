@@ -1,20 +1,28 @@
 #include <date/date.h>
 #include <gtest/gtest.h>
 
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <cstring>
+#include <memory>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 
+#include "databento/arena_metadata.hpp"
 #include "databento/compat.hpp"
 #include "databento/constants.hpp"
 #include "databento/datetime.hpp"
 #include "databento/dbn.hpp"
+#include "databento/dbn_decoder.hpp"
+#include "databento/dbn_encoder.hpp"
+#include "databento/detail/buffer.hpp"
 #include "databento/exceptions.hpp"
 #include "databento/publishers.hpp"
 #include "databento/record.hpp"
 #include "databento/symbol_map.hpp"
+#include "mock/mock_log_receiver.hpp"
 
 namespace databento::tests {
 Metadata GenMetadata() {
@@ -212,6 +220,113 @@ TEST(TsSymbolMapTests, TestInsertStartEndDateSame) {
   ASSERT_TRUE(target.Map().empty());
 }
 
+TEST(CompactTsSymbolMapTests, TestMatchesTsSymbolMap) {
+  const auto metadata = GenMetadata();
+  const TsSymbolMap expected{metadata};
+  const CompactTsSymbolMap target{metadata};
+  // Far fewer intervals than days
+  EXPECT_LT(target.Size(), expected.Size());
+  EXPECT_EQ(target.SymbolCount(), 5);
+  for (const auto& [key, symbol] : expected.Map()) {
+    EXPECT_EQ(target.At(key.first, key.second), *symbol);
+  }
+  EXPECT_EQ(target.Find(date::year{2023} / 8 / 1, 32), nullptr);
+  EXPECT_EQ(target.Find(date::year{2023} / 7 / 10, 8029), nullptr);
+  EXPECT_EQ(target.Find(date::year{2023} / 6 / 30, 8029), nullptr);
+  EXPECT_EQ(target.Find(date::year{2023} / 7 / 31, 7994), nullptr);
+  EXPECT_EQ(target.Find(date::year{2023} / 7 / 3, 1), nullptr);
+  EXPECT_THROW(target.At(date::year{2023} / 8 / 1, 32), std::out_of_range);
+
+  const CompactTsSymbolMap inverse_target{GenInverseMetadata()};
+  ASSERT_EQ(inverse_target.Size(), target.Size());
+  for (const auto& [key, symbol] : expected.Map()) {
+    EXPECT_EQ(inverse_target.At(key.first, key.second), *symbol);
+  }
+}
+
+TEST(CompactTsSymbolMapTests, TestFindRecord) {
+  const CompactTsSymbolMap target{GenMetadata()};
+  MboMsg record{};
+  record.hd.instrument_id = 10172;
+  record.hd.ts_event =
+      UnixNanos{date::sys_days{date::year{2023} / 7 / 24}} + std::chrono::hours{23};
+  record.ts_recv =
+      UnixNanos{date::sys_days{date::year{2023} / 7 / 25}} + std::chrono::minutes{155};
+  const auto* symbol = target.Find(record);
+  ASSERT_NE(symbol, nullptr);
+  EXPECT_EQ(*symbol, "TSLA");
+  EXPECT_EQ(target.At(record), "TSLA");
+}
+
+TEST(CompactTsSymbolMapTests, TestFromArenaMetadata) {
+  const auto metadata = GenMetadata();
+  detail::Buffer buffer;
+  DbnEncoder::EncodeMetadata(metadata, &buffer);
+  auto log_receiver = mock::MockLogReceiver::AssertNoLogs(LogLevel::Warning);
+  DbnDecoder decoder{&log_receiver, std::make_unique<detail::Buffer>(std::move(buffer)),
+                     VersionUpgradePolicy::AsIs};
+  const CompactTsSymbolMap target{decoder.DecodeArenaMetadata()};
+  const TsSymbolMap expected{metadata};
+  EXPECT_EQ(target.SymbolCount(), 5);
+  for (const auto& [key, symbol] : expected.Map()) {
+    EXPECT_EQ(target.At(key.first, key.second), *symbol);
+  }
+}
+
+TEST(CompactTsSymbolMapTests, TestInsert) {
+  CompactTsSymbolMap target;
+  target.Insert(1, date::year{2023} / 12 / 3, date::year{2023} / 12 / 3, "test");
+  ASSERT_TRUE(target.IsEmpty());
+  target.Insert(1, date::year{2023} / 12 / 10, date::year{2024} / 1 / 10, "B");
+  target.Insert(1, date::year{2023} / 12 / 1, date::year{2023} / 12 / 10, "A");
+  target.Insert(2, date::year{2023} / 12 / 1, date::year{2023} / 12 / 10, "A");
+  EXPECT_EQ(target.Size(), 3);
+  EXPECT_EQ(target.SymbolCount(), 2);
+  EXPECT_EQ(target.At(date::year{2023} / 12 / 9, 1), "A");
+  EXPECT_EQ(target.At(date::year{2023} / 12 / 10, 1), "B");
+  EXPECT_EQ(target.At(date::year{2024} / 1 / 9, 1), "B");
+  EXPECT_EQ(target.Find(date::year{2024} / 1 / 10, 1), nullptr);
+  EXPECT_EQ(&target.At(date::year{2023} / 12 / 1, 1),
+            &target.At(date::year{2023} / 12 / 1, 2));
+  ASSERT_THROW(
+      target.Insert(1, date::year{2023} / 12 / 3, date::year{2023} / 12 / 2, "test"),
+      InvalidArgumentError);
+}
+
+TEST(CompactTsSymbolMapTests, TestOverlappingIntervals) {
+  auto metadata = GenMetadata();
+  // Continuous symbol resolving to the same instruments as MSFT and AAPL
+  metadata.mappings.push_back(
+      {"MSFT.c.0",
+       {{date::year{2023} / 7 / 2, date::year{2023} / 7 / 4, "6854"},
+        {date::year{2023} / 6 / 25, date::year{2023} / 7 / 20, "32"}}});
+  const TsSymbolMap expected{metadata};
+  const CompactTsSymbolMap target{metadata};
+  for (const auto& [key, symbol] : expected.Map()) {
+    EXPECT_EQ(target.At(key.first, key.second), *symbol);
+  }
+  EXPECT_EQ(target.At(date::year{2023} / 6 / 30, 32), "MSFT.c.0");
+  EXPECT_EQ(target.At(date::year{2023} / 7 / 3, 6854), "MSFT.c.0");
+
+  CompactTsSymbolMap inserted;
+  inserted.Insert(1, date::year{2023} / 12 / 1, date::year{2023} / 12 / 10, "A");
+  inserted.Insert(1, date::year{2023} / 12 / 5, date::year{2023} / 12 / 20, "B");
+  inserted.Insert(1, date::year{2023} / 11 / 25, date::year{2023} / 12 / 25, "C");
+  EXPECT_EQ(inserted.Size(), 4);
+  EXPECT_EQ(inserted.At(date::year{2023} / 11 / 30, 1), "C");
+  EXPECT_EQ(inserted.At(date::year{2023} / 12 / 9, 1), "A");
+  EXPECT_EQ(inserted.At(date::year{2023} / 12 / 10, 1), "B");
+  EXPECT_EQ(inserted.At(date::year{2023} / 12 / 19, 1), "B");
+  EXPECT_EQ(inserted.At(date::year{2023} / 12 / 20, 1), "C");
+  EXPECT_EQ(inserted.Find(date::year{2023} / 12 / 25, 1), nullptr);
+}
+
+TEST(CompactTsSymbolMapTests, TestSTypeError) {
+  auto metadata = GenMetadata();
+  metadata.stype_out = SType::RawSymbol;
+  ASSERT_THROW(CompactTsSymbolMap{metadata}, InvalidArgumentError);
+}
+
 TEST(PitSymbolMapTests, TestFromMetadata) {
   auto metadata = GenMetadata();
   auto target = metadata.CreateSymbolMapForDate(date::year{2023} / 7 / 31);
@@ -273,4 +388,130 @@ TEST(PitSymbolMapTests, TestOnRecord) {
   target.OnRecord(Record{&sm2.hd});
   ASSERT_EQ(target[1], "MSFT");
 }
+
+TEST(FlatPitSymbolMapTests, TestFromMetadata) {
+  const auto metadata = GenMetadata();
+  const FlatPitSymbolMap target{metadata, date::year{2023} / 7 / 31};
+  const auto expected = metadata.CreateSymbolMapForDate(date::year{2023} / 7 / 31);
+  ASSERT_EQ(target.Size(), expected.Size());
+  for (const auto& [iid, symbol] : expected.Map()) {
+    EXPECT_EQ(target.At(iid), symbol);
+  }
+  EXPECT_EQ(target.Find(7298), nullptr);
+  EXPECT_THROW(target.At(7298), std::out_of_range);
+  ASSERT_THROW((FlatPitSymbolMap{metadata, date::year{2023} / 8 / 1}),
+               InvalidArgumentError);
+}
+
+TEST(FlatPitSymbolMapTests, TestOnRecord) {
+  FlatPitSymbolMap target;
+  auto sm1 = GenMapping<SymbolMappingMsgV1>(1, "AAPL");
+  target.OnRecord(Record{&sm1.hd});
+  auto sm2 = GenMapping<SymbolMappingMsgV2>(2, "TSLA");
+  target.OnRecord(Record{&sm2.hd});
+  sm1 = GenMapping<SymbolMappingMsgV1>(3, "MSFT");
+  target.OnRecord(Record{&sm1.hd});
+  EXPECT_EQ(target.Size(), 3);
+  EXPECT_EQ(target.At(1), "AAPL");
+  EXPECT_EQ(target.At(2), "TSLA");
+  EXPECT_EQ(target.At(Record{&sm1.hd}), "MSFT");
+  EXPECT_EQ(target.At(sm2), "TSLA");
+  sm1 = GenMapping<SymbolMappingMsgV1>(10, "AAPL");
+  target.OnRecord(Record{&sm1.hd});
+  // Interned
+  EXPECT_EQ(target.SymbolCount(), 3);
+  EXPECT_EQ(target.Find(10), target.Find(1));
+  sm2 = GenMapping<SymbolMappingMsgV2>(1, "MSFT");
+  target.OnRecord(Record{&sm2.hd});
+  EXPECT_EQ(target.At(1), "MSFT");
+  EXPECT_EQ(target.Size(), 4);
+  EXPECT_EQ(target.SymbolCount(), 3);
+  // Unchanged symbol
+  const auto* before = target.Find(1);
+  target.OnSymbolMapping(GenMapping<SymbolMappingMsgV2>(1, "MSFT"));
+  EXPECT_EQ(target.Find(1), before);
+}
+
+TEST(FlatPitSymbolMapTests, TestGrow) {
+  FlatPitSymbolMap target;
+  for (std::uint32_t iid = 0; iid < 10'000; ++iid) {
+    target.Insert(iid * 7, std::to_string(iid % 100));
+  }
+  EXPECT_EQ(target.Size(), 10'000);
+  EXPECT_EQ(target.SymbolCount(), 100);
+  for (std::uint32_t iid = 0; iid < 10'000; ++iid) {
+    ASSERT_EQ(target.At(iid * 7), std::to_string(iid % 100));
+  }
+  EXPECT_EQ(target.Find(1), nullptr);
+}
+
+TEST(FlatPitSymbolMapTests, TestPowerOfTwoStride) {
+  FlatPitSymbolMap target;
+  // IDs sharing their low bits
+  for (std::uint32_t iid = 0; iid < 1'000; ++iid) {
+    target.Insert(iid << 20, std::to_string(iid));
+  }
+  EXPECT_EQ(target.Size(), 1'000);
+  for (std::uint32_t iid = 0; iid < 1'000; ++iid) {
+    ASSERT_EQ(target.At(iid << 20), std::to_string(iid));
+  }
+  EXPECT_EQ(target.Find(1 << 19), nullptr);
+}
+
+TEST(PitSymbolIndexTests, TestFromMetadata) {
+  const auto metadata = GenMetadata();
+  const PitSymbolIndex target{metadata, date::year{2023} / 7 / 31};
+  const auto expected = metadata.CreateSymbolMapForDate(date::year{2023} / 7 / 31);
+  ASSERT_EQ(target.Size(), expected.Size());
+  for (const auto& [iid, symbol] : expected.Map()) {
+    EXPECT_EQ(target.SymbolAt(iid), symbol);
+    EXPECT_EQ(target.InstrumentIdAt(symbol), iid);
+  }
+  EXPECT_EQ(target.FindInstrumentId("PLTR"), std::nullopt);
+  EXPECT_THROW(target.InstrumentIdAt("PLTR"), std::out_of_range);
+  EXPECT_EQ(target.FindSymbol(7298), nullptr);
+}
+
+TEST(PitSymbolIndexTests, TestOnRecord) {
+  PitSymbolIndex target;
+  auto sm1 = GenMapping<SymbolMappingMsgV1>(1, "ESZ3");
+  target.OnRecord(Record{&sm1.hd});
+  auto sm2 = GenMapping<SymbolMappingMsgV2>(2, "ESH4");
+  target.OnRecord(Record{&sm2.hd});
+  EXPECT_EQ(target.InstrumentIdAt("ESZ3"), 1);
+  EXPECT_EQ(target.InstrumentIdAt("ESH4"), 2);
+  // Lookup by fixed-length symbol array
+  std::array<char, kSymbolCstrLen> raw_symbol{};
+  std::strncpy(raw_symbol.data(), "ESH4", raw_symbol.size());
+  EXPECT_EQ(target.FindInstrumentId(raw_symbol), 2);
+  EXPECT_EQ(target.InstrumentIdAt(sm1.stype_out_symbol), 1);
+  // Instrument ID remapped to a new symbol
+  sm2 = GenMapping<SymbolMappingMsgV2>(1, "ESM4");
+  target.OnRecord(Record{&sm2.hd});
+  EXPECT_EQ(target.SymbolAt(1), "ESM4");
+  EXPECT_EQ(target.InstrumentIdAt("ESM4"), 1);
+  EXPECT_EQ(target.FindInstrumentId("ESZ3"), std::nullopt);
+  // Symbol remapped to a new instrument ID
+  target.OnSymbolMapping(GenMapping<SymbolMappingMsgV2>(3, "ESH4"));
+  EXPECT_EQ(target.InstrumentIdAt("ESH4"), 3);
+  EXPECT_EQ(target.FindSymbol(2), nullptr);
+  EXPECT_EQ(target.Size(), 2);
+}
+
+TEST(PitSymbolIndexTests, TestSymbolRemapErasesOldInstrument) {
+  PitSymbolIndex target;
+  target.Insert(1, "NVDA");
+  target.Insert(2, "NVDA");
+  EXPECT_EQ(target.FindSymbol(1), nullptr);
+  EXPECT_THROW(target.SymbolAt(1), std::out_of_range);
+  EXPECT_EQ(target.SymbolAt(2), "NVDA");
+  EXPECT_EQ(target.InstrumentIdAt("NVDA"), 2);
+  EXPECT_EQ(target.Size(), 1);
+  // The old instrument can be mapped again without affecting the new one
+  target.Insert(1, "AMD");
+  EXPECT_EQ(target.SymbolAt(1), "AMD");
+  EXPECT_EQ(target.InstrumentIdAt("AMD"), 1);
+  EXPECT_EQ(target.InstrumentIdAt("NVDA"), 2);
+  EXPECT_EQ(target.Size(), 2);
+}
 }  // namespace databento::tests
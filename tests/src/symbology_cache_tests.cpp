@@ -0,0 +1,115 @@
+#include <date/date.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "databento/constants.hpp"
+#include "databento/detail/temp_path.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/symbology.hpp"
+#include "databento/symbology_cache.hpp"
+#include "temp_file.hpp"
+
+namespace databento::tests {
+class SymbologyCacheTests : public testing::Test {
+ protected:
+  void TearDown() override { std::filesystem::remove_all(cache_dir_); }
+
+  // Unique so concurrently running tests don't remove each other's files
+  std::filesystem::path cache_dir_{detail::TempPath(
+      std::filesystem::temp_directory_path() / "databento_symbology_cache_tests")};
+  SymbologyCache target_{cache_dir_};
+};
+
+TEST_F(SymbologyCacheTests, TestWriteRead) {
+  const SymbologyCacheEntry entry{
+      dataset::kGlbxMdp3,
+      {"ESM2", "NQM2", "ZZZZ"},
+      date::year{2022} / 6 / 6,
+      date::year{2022} / 6 / 10,
+      {{{"ESM2", {{date::year{2022} / 6 / 6, date::year{2022} / 6 / 10, "3403"}}},
+        {"NQM2",
+         {{date::year{2022} / 6 / 6, date::year{2022} / 6 / 8, "3401"},
+          {date::year{2022} / 6 / 8, date::year{2022} / 6 / 10, "3402"}}}},
+       {"NQM2"},
+       {"ZZZZ"},
+       SType::RawSymbol,
+       SType::InstrumentId}};
+  const TempFile temp_file{cache_dir_ / "test_write_read.dbsc"};
+  SymbologyCache::Write(temp_file.Path(), entry);
+
+  const auto res = SymbologyCache::Read(temp_file.Path());
+  ASSERT_TRUE(res.has_value());
+  EXPECT_EQ(res->dataset, entry.dataset);
+  EXPECT_EQ(res->symbols, entry.symbols);
+  EXPECT_EQ(res->start_date, entry.start_date);
+  EXPECT_EQ(res->end_date, entry.end_date);
+  EXPECT_EQ(res->resolution.stype_in, SType::RawSymbol);
+  EXPECT_EQ(res->resolution.stype_out, SType::InstrumentId);
+  EXPECT_EQ(res->resolution.partial, entry.resolution.partial);
+  EXPECT_EQ(res->resolution.not_found, entry.resolution.not_found);
+  ASSERT_EQ(res->resolution.mappings.size(), 2);
+  EXPECT_EQ(res->resolution.mappings.at("ESM2"), entry.resolution.mappings.at("ESM2"));
+  EXPECT_EQ(res->resolution.mappings.at("NQM2"), entry.resolution.mappings.at("NQM2"));
+}
+
+TEST_F(SymbologyCacheTests, TestReadMissing) {
+  EXPECT_EQ(SymbologyCache::Read(cache_dir_ / "missing.dbsc"), std::nullopt);
+}
+
+TEST_F(SymbologyCacheTests, TestReadInvalid) {
+  const TempFile temp_file{cache_dir_ / "test_read_invalid.dbsc"};
+  {
+    std::ofstream out{temp_file.Path()};
+    out << "DBSC";
+  }
+  EXPECT_THROW(SymbologyCache::Read(temp_file.Path()), InvalidArgumentError);
+  {
+    std::ofstream out{temp_file.Path()};
+    out << "DBN\x03 not a cache file";
+  }
+  EXPECT_THROW(SymbologyCache::Read(temp_file.Path()), InvalidArgumentError);
+}
+
+TEST_F(SymbologyCacheTests, TestReadCorruptCount) {
+  const SymbologyCacheEntry entry{dataset::kGlbxMdp3,
+                                  {"ESM2"},
+                                  date::year{2022} / 6 / 6,
+                                  date::year{2022} / 6 / 10,
+                                  {{}, {}, {}, SType::RawSymbol, SType::InstrumentId}};
+  const TempFile temp_file{cache_dir_ / "test_read_corrupt_count.dbsc"};
+  SymbologyCache::Write(temp_file.Path(), entry);
+  {
+    // The mapping count is followed by the empty partial and not_found counts
+    std::fstream file{temp_file.Path(),
+                      std::ios::binary | std::ios::in | std::ios::out | std::ios::ate};
+    file.seekp(-3 * static_cast<std::streamoff>(sizeof(std::uint32_t)), std::ios::end);
+    const auto mapping_count = std::numeric_limits<std::uint32_t>::max();
+    file.write(reinterpret_cast<const char*>(&mapping_count), sizeof(mapping_count));
+  }
+  // Not `std::bad_alloc`
+  EXPECT_THROW(SymbologyCache::Read(temp_file.Path()), InvalidArgumentError);
+}
+
+TEST_F(SymbologyCacheTests, TestCachePath) {
+  const auto path = target_.CachePath(dataset::kGlbxMdp3, {"ESM2", "NQM2"},
+                                      SType::RawSymbol, SType::InstrumentId);
+  EXPECT_EQ(path.parent_path(), cache_dir_);
+  // Independent of symbol order
+  EXPECT_EQ(path, target_.CachePath(dataset::kGlbxMdp3, {"NQM2", "ESM2"},
+                                    SType::RawSymbol, SType::InstrumentId));
+  EXPECT_NE(path, target_.CachePath(dataset::kGlbxMdp3, {"ESM2"}, SType::RawSymbol,
+                                    SType::InstrumentId));
+  EXPECT_NE(path, target_.CachePath(dataset::kGlbxMdp3, {"ESM2", "NQM2"},
+                                    SType::Parent, SType::InstrumentId));
+  EXPECT_NE(path, target_.CachePath(dataset::kXnasItch, {"ESM2", "NQM2"},
+                                    SType::RawSymbol, SType::InstrumentId));
+}
+}  // namespace databento::tests
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <utility>  // move, pair
+
+#include "databento/constants.hpp"
+#include "databento/datetime.hpp"
+#include "databento/dbn.hpp"
+#include "databento/detail/temp_path.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/record.hpp"
+#include "databento/timeseries.hpp"
+#include "databento/timeseries_cache.hpp"
+
+namespace databento::tests {
+class TimeseriesCacheTests : public testing::Test {
+ protected:
+  void TearDown() override { std::filesystem::remove_all(cache_dir_); }
+
+  // Unique so concurrently running tests don't remove each other's files
+  std::filesystem::path cache_dir_{detail::TempPath(
+      std::filesystem::temp_directory_path() / "databento_timeseries_cache_tests")};
+  TimeseriesCache target_{cache_dir_};
+};
+
+TEST_F(TimeseriesCacheTests, TestCacheDir) {
+  const auto dir = target_.CacheDir(dataset::kGlbxMdp3, {"ESM2", "NQM2"}, Schema::Mbo,
+                                    SType::RawSymbol, SType::InstrumentId);
+  EXPECT_EQ(dir.parent_path(), cache_dir_);
+  // Independent of symbol order
+  EXPECT_EQ(dir, target_.CacheDir(dataset::kGlbxMdp3, {"NQM2", "ESM2"}, Schema::Mbo,
+                                  SType::RawSymbol, SType::InstrumentId));
+  EXPECT_NE(dir, target_.CacheDir(dataset::kGlbxMdp3, {"ESM2", "NQM2"}, Schema::Trades,
+                                  SType::RawSymbol, SType::InstrumentId));
+  EXPECT_NE(dir, target_.CacheDir(dataset::kGlbxMdp3, {"ESM2"}, Schema::Mbo,
+                                  SType::RawSymbol, SType::InstrumentId));
+}
+
+TEST_F(TimeseriesCacheTests, TestListSegments) {
+  const auto dir = target_.CacheDir(dataset::kGlbxMdp3, {"ESM2"}, Schema::Mbo,
+                                    SType::RawSymbol, SType::InstrumentId);
+  EXPECT_TRUE(TimeseriesCache::ListSegments(dir).empty());
+  std::filesystem::create_directories(dir);
+  for (const auto* file_name :
+       {"300_400.dbn.zst", "100_200.dbn.zst", "200_300.dbn.zst.tmp",
+        "200_300.dbn.zst.0123456789abcdef.tmp", "200_100.dbn.zst", "100_200.dbn",
+        "a_b.dbn.zst"}) {
+    std::ofstream{dir / file_name};
+  }
+  const auto segments = TimeseriesCache::ListSegments(dir);
+  ASSERT_EQ(segments.size(), 2);
+  EXPECT_EQ(segments[0].start, UnixNanos{std::chrono::nanoseconds{100}});
+  EXPECT_EQ(segments[0].end, UnixNanos{std::chrono::nanoseconds{200}});
+  EXPECT_EQ(segments[0].path, dir / "100_200.dbn.zst");
+  EXPECT_EQ(segments[1].start, UnixNanos{std::chrono::nanoseconds{300}});
+  EXPECT_EQ(segments[1].end, UnixNanos{std::chrono::nanoseconds{400}});
+}
+
+TEST_F(TimeseriesCacheTests, TestGetRangeInvalidRange) {
+  EXPECT_THROW(target_.GetRange(nullptr, dataset::kGlbxMdp3,
+                                {UnixNanos{std::chrono::nanoseconds{100}}, {}},
+                                {"ESM2"}, Schema::Mbo, SType::RawSymbol,
+                                SType::InstrumentId, {},
+                                [](const Record&) { return KeepGoing::Continue; }),
+               InvalidArgumentError);
+}
+
+TEST_F(TimeseriesCacheTests, TestGetRangeUncachedWithoutClient) {
+  EXPECT_THROW(target_.GetRange(nullptr, dataset::kGlbxMdp3,
+                                {UnixNanos{std::chrono::nanoseconds{100}},
+                                 UnixNanos{std::chrono::nanoseconds{200}}},
+                                {"ESM2"}, Schema::Mbo, SType::RawSymbol,
+                                SType::InstrumentId, {},
+                                [](const Record&) { return KeepGoing::Continue; }),
+               InvalidArgumentError);
+}
+
+TEST_F(TimeseriesCacheTests, TestCacheDirCollision) {
+  const auto dir = target_.CacheDir(dataset::kGlbxMdp3, {"ESM2"}, Schema::Mbo,
+                                    SType::RawSymbol, SType::InstrumentId);
+  std::filesystem::create_directories(dir);
+  // Simulate other symbols with the same hash
+  std::ofstream{dir / "symbols.txt"} << "NQM2\n";
+  const auto other_dir = target_.CacheDir(dataset::kGlbxMdp3, {"ESM2"}, Schema::Mbo,
+                                          SType::RawSymbol, SType::InstrumentId);
+  EXPECT_EQ(other_dir.string(), dir.string() + "_1");
+  EXPECT_EQ(target_.CacheDir(dataset::kGlbxMdp3, {"NQM2"}, Schema::Mbo,
+                             SType::RawSymbol, SType::InstrumentId)
+                .parent_path(),
+            cache_dir_);
+}
+
+TEST_F(TimeseriesCacheTests, TestGetRangeUpgradesMixedVersions) {
+  const auto dir = target_.CacheDir(dataset::kGlbxMdp3, {"ESM2"}, Schema::Mbo,
+                                    SType::RawSymbol, SType::InstrumentId);
+  std::filesystem::create_directories(dir);
+  // The index timestamps of the two records in each file
+  static constexpr std::uint64_t kFirstTs = 1609160400000704060;
+  static constexpr std::uint64_t kSecondTs = 1609160400000711344;
+  const auto segment_name = [](std::uint64_t start, std::uint64_t end) {
+    return std::to_string(start) + '_' + std::to_string(end) + ".dbn.zst";
+  };
+  std::filesystem::copy_file(TEST_DATA_DIR "/test_data.mbo.v1.dbn.zst",
+                             dir / segment_name(kFirstTs, kSecondTs));
+  std::filesystem::copy_file(TEST_DATA_DIR "/test_data.mbo.v3.dbn.zst",
+                             dir / segment_name(kSecondTs, kSecondTs + 1));
+  const auto get_range = [this](std::uint64_t end) {
+    std::optional<Metadata> metadata;
+    std::size_t record_count{};
+    target_.GetRange(nullptr, dataset::kGlbxMdp3,
+                     {UnixNanos{std::chrono::nanoseconds{kFirstTs}},
+                      UnixNanos{std::chrono::nanoseconds{end}}},
+                     {"ESM2"}, Schema::Mbo, SType::RawSymbol, SType::InstrumentId,
+                     [&metadata](Metadata&& md) { metadata = std::move(md); },
+                     [&record_count](const Record&) {
+                       ++record_count;
+                       return KeepGoing::Continue;
+                     });
+    EXPECT_TRUE(metadata.has_value());
+    return std::pair<std::uint8_t, std::size_t>{metadata ? metadata->version : 0,
+                                                record_count};
+  };
+  // Only the version 1 segment is replayed as-is
+  EXPECT_EQ(get_range(kSecondTs), (std::pair<std::uint8_t, std::size_t>{1, 1}));
+  EXPECT_EQ(get_range(kSecondTs + 1), (std::pair<std::uint8_t, std::size_t>{3, 2}));
+}
+}  // namespace databento::tests
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <future>
+#include <memory>  // make_shared
+#include <mutex>
+#include <vector>
+
+#include "databento/detail/worker_pool.hpp"
+
+namespace databento::detail::tests {
+TEST(WorkerPoolTests, TestRunsAllTasks) {
+  std::atomic<int> count{};
+  std::vector<std::future<void>> futures;
+  {
+    WorkerPool target{4};
+    for (int i = 0; i < 100; ++i) {
+      auto task = std::make_shared<std::packaged_task<void()>>([&count] { ++count; });
+      futures.emplace_back(task->get_future());
+      target.Submit([task] { (*task)(); });
+    }
+    for (auto& future : futures) {
+      future.wait();
+    }
+  }  // joins
+  EXPECT_EQ(count, 100);
+}
+
+TEST(WorkerPoolTests, TestRunsConcurrently) {
+  constexpr std::size_t kNumThreads = 3;
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::size_t num_waiting{};
+  WorkerPool target{kNumThreads};
+  std::vector<std::future<void>> futures;
+  for (std::size_t i = 0; i < kNumThreads; ++i) {
+    auto task = std::make_shared<std::packaged_task<void()>>([&] {
+      std::unique_lock<std::mutex> lock{mutex};
+      ++num_waiting;
+      cv.notify_all();
+      // Only completes once every task is running at the same time
+      cv.wait(lock, [&] { return num_waiting == kNumThreads; });
+    });
+    futures.emplace_back(task->get_future());
+    target.Submit([task] { (*task)(); });
+  }
+  for (auto& future : futures) {
+    future.get();
+  }
+  EXPECT_EQ(num_waiting, kNumThreads);
+}
+}  // namespace databento::detail::tests
@@ -1,14 +1,18 @@
 #include <gtest/gtest.h>
+#include <zstd.h>
 
+#include <algorithm>  // copy_n, equal
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <numeric>  // iota
 #include <vector>
 
 #include "databento/compat.hpp"
 #include "databento/detail/buffer.hpp"
 #include "databento/detail/zstd_stream.hpp"
 #include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
 #include "databento/file_stream.hpp"
 
 namespace databento::detail::tests {
@@ -45,4 +49,82 @@ TEST(ZstdStreamTests, TestIdentity) {
   };
   decode.ReadExact(res.data(), size);
 }
+
+TEST(ZstdStreamTests, TestIdentityWithOptions) {
+  std::vector<std::int64_t> source_data(1'000'000);
+  std::iota(source_data.begin(), source_data.end(), 0);
+  const auto* source_bytes = reinterpret_cast<const std::byte*>(source_data.data());
+  const auto size = source_data.size() * sizeof(std::int64_t);
+  ZstdCompressOptions options;
+  options.level = 1;
+  // Zstd may have been built without multithreading support
+  if (::ZSTD_cParam_getBounds(ZSTD_c_nbWorkers).upperBound > 0) {
+    options.num_workers = 2;
+    options.job_size = 1 << 20;
+  }
+  options.long_distance_matching = true;
+  options.window_log = 20;
+  auto mock_io = std::make_unique<detail::Buffer>();
+  {
+    ZstdCompressStream compressor{mock_io.get(), options};
+    // Mix of small writes that are buffered and large ones that aren't
+    std::size_t pos = 0;
+    for (const std::size_t write_size : {std::size_t{100}, size / 2, std::size_t{1000},
+                                         std::size_t{10}}) {
+      compressor.WriteAll(source_bytes + pos, write_size);
+      pos += write_size;
+    }
+    compressor.WriteAll(source_bytes + pos, size - pos);
+  }
+  std::vector<std::int64_t> res(source_data.size());
+  ZstdDecodeStream decode{std::move(mock_io)};
+  decode.ReadExact(reinterpret_cast<std::byte*>(res.data()), size);
+  EXPECT_EQ(res, source_data);
+}
+
+TEST(ZstdStreamTests, TestDictionary) {
+  // Small batches of similar records like live data
+  constexpr std::size_t kSampleCount = 1000;
+  constexpr std::size_t kSampleSize = 8 * sizeof(std::int64_t);
+  std::vector<std::int64_t> samples;
+  for (std::size_t i = 0; i < kSampleCount * kSampleSize / sizeof(std::int64_t); ++i) {
+    samples.emplace_back(static_cast<std::int64_t>(i % 8 == 0 ? i : i % 8));
+  }
+  std::vector<std::byte> sample_bytes(kSampleCount * kSampleSize);
+  std::copy_n(reinterpret_cast<const std::byte*>(samples.data()), sample_bytes.size(),
+              sample_bytes.begin());
+  ZstdCompressOptions options;
+  options.dictionary = TrainZstdDictionary(
+      sample_bytes, std::vector<std::size_t>(kSampleCount, kSampleSize), 4096);
+  ASSERT_FALSE(options.dictionary.empty());
+  ASSERT_THROW(TrainZstdDictionary(sample_bytes, {sample_bytes.size() + 1}, 4096),
+               InvalidArgumentError);
+
+  const auto compress = [&sample_bytes](const ZstdCompressOptions& opts) {
+    auto io = std::make_unique<detail::Buffer>();
+    {
+      ZstdCompressStream compressor{io.get(), opts};
+      compressor.WriteAll(sample_bytes.data(), kSampleSize);
+    }
+    return io;
+  };
+  auto dict_io = compress(options);
+  const auto no_dict_io = compress({});
+  EXPECT_LT(dict_io->ReadCapacity(), no_dict_io->ReadCapacity());
+
+  std::vector<std::byte> res(kSampleSize);
+  ZstdDecodeStream decode{std::move(dict_io), options.dictionary};
+  decode.ReadExact(res.data(), res.size());
+  EXPECT_TRUE(std::equal(res.begin(), res.end(), sample_bytes.begin()));
+}
+
+TEST(ZstdStreamTests, TestInvalidOptions) {
+  detail::Buffer mock_io;
+  ZstdCompressOptions options;
+  options.window_log = 30;
+  ASSERT_THROW((ZstdCompressStream{&mock_io, options}), InvalidArgumentError);
+  // Below zstd's minimum
+  options.window_log = 5;
+  ASSERT_THROW((ZstdCompressStream{&mock_io, options}), InvalidArgumentError);
+}
 }  // namespace databento::detail::tests